@@ -26,6 +26,9 @@ static const QString kCompRootfsName = "--name";
 static const QString kCompJsonFormat = "--json";
 // current user(non root)
 static const QString kCompUser = "user";
+// debconf preseed file for batch config install
+static const QString kParamPreseed = "preseed";
+static const QString kDebConfSetSelections = "debconf-set-selections";
 
 // for disable DebConf
 static const QString kDebConfEnv = "DEBIAN_FRONTEND";
@@ -74,6 +77,8 @@ void InstallDebThread::setParam(const QStringList &arguments)
     m_parser.addOption(rootfsOpt);
     QCommandLineOption userOpt(kCompUser, "", "current user");
     m_parser.addOption(userOpt);
+    QCommandLineOption preseedOpt(kParamPreseed, "", "preseed file");
+    m_parser.addOption(preseedOpt);
 
     m_parser.process(arguments);
 
@@ -88,6 +93,9 @@ void InstallDebThread::setParam(const QStringList &arguments)
     if (m_parser.isSet(userOpt)) {
         m_user = m_parser.value(userOpt);
     }
+    if (m_parser.isSet(preseedOpt)) {
+        m_preseed = m_parser.value(preseedOpt);
+    }
 
     m_listParam = m_parser.positionalArguments();
 }
@@ -197,6 +205,11 @@ void InstallDebThread::installConfig()
         return;
     }
 
+    if (!m_preseed.isEmpty() || m_listParam.size() > 1) {
+        installConfigBatch();
+        return;
+    }
+
     QString debPath = m_listParam.first();
     const QFileInfo info(debPath);
     const QFile debFile(debPath);
@@ -227,6 +240,86 @@ void InstallDebThread::installConfig()
     }
 }
 
+/**
+   @brief Install a group of packages containing DebConf in one noninteractive job.
+       The answers are loaded from the preseed file before install if set, the remaining
+       questions use the default value, no input is required during the install.
+       Each package is installed by its own dpkg run and gets its own result.
+ */
+void InstallDebThread::installConfigBatch()
+{
+    // empty path for the invalid packages, keep the result order of the arguments.
+    QStringList debPaths;
+    bool hasValidPackage = false;
+    for (const QString &path : m_listParam) {
+        QString debPath = path;
+        const QFileInfo info(debPath);
+        if (!info.exists() || !info.isFile() || info.suffix().toLower() != "deb") {
+            qWarning() << "Skip invalid package:" << debPath;
+            debPaths << QString();
+            continue;
+        }
+
+        if (debPath.contains(" ") || debPath.contains("&") || debPath.contains(";") || debPath.contains("|") ||
+            debPath.contains("`")) {
+            // the file name contains the special characters too, use a fixed name, link() appends _N.
+            debPath = SymbolicLink(debPath, "installPackage");
+        }
+        debPaths << debPath;
+        hasValidPackage = true;
+    }
+
+    if (!hasValidPackage) {
+        return;
+    }
+
+    if (!m_preseed.isEmpty()) {
+        const QFileInfo preseedInfo(m_preseed);
+        if (!preseedInfo.isFile() || !preseedInfo.isReadable()) {
+            qWarning() << "Invalid preseed file:" << m_preseed;
+            m_resultFlag = 1;
+            return;
+        }
+
+        // e.g.: debconf-set-selections [preseed file]
+        QProcess preseedProc;
+        preseedProc.setProcessChannelMode(QProcess::ForwardedChannels);
+        preseedProc.start(kDebConfSetSelections, {m_preseed});
+        preseedProc.waitForFinished(-1);
+        if (QProcess::NormalExit != preseedProc.exitStatus() || 0 != preseedProc.exitCode()) {
+            qWarning() << "Load preseed file failed:" << m_preseed << preseedProc.exitCode();
+            m_resultFlag = preseedProc.exitCode() ? preseedProc.exitCode() : 1;
+            return;
+        }
+    }
+
+    qInfo() << "StartInstallAptConfig";
+
+    m_resultFlag = 0;
+    m_proc->setEnv(kDebConfEnv, kDebConfDisable);
+    for (const QString &debPath : debPaths) {
+        if (debPath.isEmpty()) {
+            m_packageResults << 1;
+            m_resultFlag = 1;
+            continue;
+        }
+
+        // e.g.: dpkg -i [deb file]
+        m_proc->setProgram("dpkg", QStringList() << "-i" << debPath);
+        qInfo() << "Exec:" << qPrintable(m_proc->program().join(' '));
+
+        m_proc->start();
+        m_proc->waitForFinished(-1);
+        const int result = (QProcess::NormalExit == m_proc->exitStatus()) ? m_proc->exitCode() : 1;
+        m_proc->close();
+
+        m_packageResults << result;
+        if (0 != result) {
+            m_resultFlag = result;
+        }
+    }
+}
+
 /**
    @brief Install / remove package in compatible mode.
  */
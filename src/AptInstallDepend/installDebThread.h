@@ -46,6 +46,8 @@ public:
     void run();
 
     inline int retFlag() const { return m_resultFlag; }
+    // result of each package of the batch config install, in the order of the arguments.
+    inline const QList<int> &packageResults() const { return m_packageResults; }
 
 public slots:
     void onFinished(int num, QProcess::ExitStatus exitStatus);
@@ -54,6 +56,7 @@ public slots:
 private:
     void installWine();
     void installConfig();
+    void installConfigBatch();
     void compatibleProcess();
     void immutableProcess();
     void uabProcessCli();
@@ -70,10 +73,12 @@ private:
     Commands m_cmds;
     QString m_rootfs;  // for comaptible mode : select rootfs
     QString m_user;
+    QString m_preseed;  // debconf preseed file for batch config install
 
     KProcess *m_proc;
     QStringList m_listParam;
     QList<QString> m_listDescribeData;
     int m_resultFlag = -1;
+    QList<int> m_packageResults;
 };
 #endif  // INSTALLDEBTHREAD_H
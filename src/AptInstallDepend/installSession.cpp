@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "installSession.h"
+#include "installDebThread.h"
+#include "helper_session_protocol.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+InstallSession::InstallSession(const QString &program, const QString &channelPath)
+    : m_program(program)
+    , m_channelPath(channelPath)
+{
+}
+
+InstallSession::~InstallSession()
+{
+    if (m_channel >= 0) {
+        ::close(m_channel);
+    }
+}
+
+/**
+   @brief Run jobs read from the channel until quit, the channel closed or timeout.
+   @return 0 if the session quit normally.
+ */
+int InstallSession::exec()
+{
+    if (!connectChannel()) {
+        return 1;
+    }
+
+    writeEvent(HelperSession::kEventReady);
+
+    QStringList arguments;
+    while (waitForJob(HelperSession::kJobTimeoutMs) && readJob(&arguments)) {
+        if (arguments.isEmpty()) {
+            continue;
+        }
+
+        qInfo() << "Session job:" << qPrintable(arguments.join(' '));
+
+        InstallDebThread job;
+        job.setParam(QStringList{m_program} + arguments);
+        job.run();
+
+        QByteArray event = QByteArray(HelperSession::kEventFinished) + QByteArray::number(job.retFlag());
+        for (const int result : job.packageResults()) {
+            event += HelperSession::kEventResultSeparator + QByteArray::number(result);
+        }
+        writeEvent(event);
+    }
+
+    qInfo() << "Session quit";
+    return 0;
+}
+
+/**
+   @brief Connect to the channel the installer listens on, only the parent process,
+    which is checked by isValidInvoker(), is accepted as peer.
+ */
+bool InstallSession::connectChannel()
+{
+    struct ::sockaddr_un addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+
+    const QByteArray path = m_channelPath.toLocal8Bit();
+    if (path.isEmpty() || path.size() >= static_cast<int>(sizeof(addr.sun_path))) {
+        qWarning() << "Session invalid channel:" << m_channelPath;
+        return false;
+    }
+    ::memcpy(addr.sun_path, path.constData(), static_cast<size_t>(path.size()));
+
+    // the jobs must not inherit the channel.
+    m_channel = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_channel < 0 || 0 != ::connect(m_channel, reinterpret_cast<struct ::sockaddr *>(&addr), sizeof(addr))) {
+        qWarning() << "Session connect channel failed:" << ::strerror(errno);
+        return false;
+    }
+
+    struct ::ucred cred;
+    ::socklen_t length = sizeof(cred);
+    if (0 != ::getsockopt(m_channel, SOL_SOCKET, SO_PEERCRED, &cred, &length) || cred.pid != ::getppid()) {
+        qWarning() << "Session reject channel peer, not the invoker";
+        ::close(m_channel);
+        m_channel = -1;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+   @return true if the job line is readable within \a msecs.
+ */
+bool InstallSession::waitForJob(int msecs)
+{
+    if (m_buffer.contains('\n')) {
+        return true;
+    }
+
+    struct ::pollfd fd = {m_channel, POLLIN, 0};
+    int ret = -1;
+    do {
+        ret = ::poll(&fd, 1, msecs);
+    } while (ret < 0 && EINTR == errno);
+
+    if (0 == ret) {
+        qWarning() << "Session wait job timeout";
+    }
+    return ret > 0;
+}
+
+/**
+   @brief Read the next line from the channel into \a line.
+   @return false if the channel closed or the line is too long.
+ */
+bool InstallSession::readLine(QByteArray *line)
+{
+    int index = -1;
+    while (-1 == (index = m_buffer.indexOf('\n'))) {
+        if (m_buffer.size() > HelperSession::kMaxLineSize) {
+            qWarning() << "Session line too long";
+            return false;
+        }
+
+        char data[4096];
+        const ::ssize_t readed = ::recv(m_channel, data, sizeof(data), 0);
+        if (readed < 0 && EINTR == errno) {
+            continue;
+        }
+        if (readed <= 0) {
+            return false;
+        }
+        m_buffer.append(data, static_cast<int>(readed));
+    }
+
+    *line = m_buffer.left(index);
+    m_buffer.remove(0, index + 1);
+    return true;
+}
+
+/**
+   @brief Read the next job into \a arguments, empty if the line is not a valid job.
+   @return false if the channel closed or the quit job.
+ */
+bool InstallSession::readJob(QStringList *arguments)
+{
+    arguments->clear();
+
+    QByteArray data;
+    if (!readLine(&data)) {
+        return false;
+    }
+
+    data = data.trimmed();
+    if (data == HelperSession::kJobQuit) {
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(data, &error);
+    if (QJsonParseError::NoError != error.error || !doc.isArray()) {
+        qWarning() << "Session ignore invalid job:" << error.errorString();
+        return true;
+    }
+
+    QStringList jobArguments;
+    for (const QJsonValue &value : doc.array()) {
+        if (!value.isString()) {
+            qWarning() << "Session ignore invalid job argument";
+            return true;
+        }
+        jobArguments.append(value.toString());
+    }
+
+    if (!isAllowedJob(jobArguments)) {
+        qWarning() << "Session ignore not allowed job";
+        return true;
+    }
+
+    *arguments = jobArguments;
+    return true;
+}
+
+/**
+   @return true if \a arguments is the config install job, other jobs are not run as root in the session.
+ */
+bool InstallSession::isAllowedJob(const QStringList &arguments)
+{
+    if (arguments.size() < 2 || arguments.first() != HelperSession::kJobInstallConfig) {
+        return false;
+    }
+
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString &arg = arguments.at(i);
+        if (arg == HelperSession::kJobPreseed) {
+            // skip the preseed file
+            ++i;
+        } else if (arg.startsWith('-')) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+   @brief Write the event line to the channel, the job output on the pty is flushed before.
+ */
+void InstallSession::writeEvent(const QByteArray &event)
+{
+    ::fflush(stderr);
+    ::fflush(stdout);
+
+    const QByteArray line = event + '\n';
+    const char *data = line.constData();
+    ::size_t remain = static_cast<::size_t>(line.size());
+    while (remain > 0) {
+        const ::ssize_t written = ::send(m_channel, data, remain, MSG_NOSIGNAL);
+        if (written < 0 && EINTR == errno) {
+            continue;
+        }
+        if (written <= 0) {
+            qWarning() << "Session write event failed:" << ::strerror(errno);
+            return;
+        }
+        data += written;
+        remain -= static_cast<::size_t>(written);
+    }
+}
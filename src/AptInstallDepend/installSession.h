@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef INSTALLSESSION_H
+#define INSTALLSESSION_H
+
+#include <QByteArray>
+#include <QStringList>
+
+/**
+   @brief Session mode of the helper, runs a queue of jobs after a single authorization.
+    @sa helper_session_protocol.h
+ */
+class InstallSession
+{
+public:
+    InstallSession(const QString &program, const QString &channelPath);
+    ~InstallSession();
+
+    int exec();
+
+private:
+    bool connectChannel();
+    bool waitForJob(int msecs);
+    bool readLine(QByteArray *line);
+    bool readJob(QStringList *arguments);
+    static bool isAllowedJob(const QStringList &arguments);
+    void writeEvent(const QByteArray &event);
+
+    QString m_program;      // argv[0] of the jobs
+    QString m_channelPath;  // unix socket the installer listens on
+    int m_channel{-1};
+    QByteArray m_buffer;  // received data not read as line yet
+
+    Q_DISABLE_COPY(InstallSession)
+};
+
+#endif  // INSTALLSESSION_H
@@ -15,6 +15,8 @@
 #include <unistd.h>
 
 #include "installDebThread.h"
+#include "installSession.h"
+#include "helper_session_protocol.h"
 
 bool isValidInvoker()
 {
@@ -56,6 +58,13 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // 会话模式：一次授权后依次执行安装器发送的任务
+    const int sessionIndex = app.arguments().indexOf(HelperSession::kParamSession);
+    if (sessionIndex >= 0) {
+        InstallSession session(app.arguments().first(), app.arguments().value(sessionIndex + 1));
+        return session.exec();
+    }
+
     InstallDebThread mThread;
     mThread.setParam(app.arguments());
     mThread.run();
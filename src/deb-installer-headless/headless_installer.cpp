@@ -0,0 +1,340 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "headless_installer.h"
+
+#include "package/Package.h"
+#include "status/PackageStatus.h"
+#include "installer/PackageInstaller.h"
+
+#include <QDir>
+#include <QDebug>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <QApt/DebFile>
+
+#include <cstdio>
+#include <functional>
+#include <set>
+
+static QString dependsStatusName(DependsStatus status)
+{
+    switch (status) {
+        case DependsOk:
+            return "ok";
+        case DependsAvailable:
+            return "available";
+        case DependsBreak:
+            return "break";
+        case DependsAuthCancel:
+            return "auth_cancel";
+        case ArchBreak:
+            return "arch_break";
+        default:
+            return "unknown";
+    }
+}
+
+static QString installStatusName(InstallStatus status)
+{
+    switch (status) {
+        case NotInstalled:
+            return "not_installed";
+        case InstalledSameVersion:
+            return "installed_same_version";
+        case InstalledEarlierVersion:
+            return "installed_earlier_version";
+        case InstalledLaterVersion:
+            return "installed_later_version";
+        default:
+            return "unknown";
+    }
+}
+
+HeadlessInstaller::HeadlessInstaller(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_status(new PackageStatus)
+{
+}
+
+HeadlessInstaller::~HeadlessInstaller()
+{
+    delete m_installer;
+    delete m_status;
+}
+
+QStringList HeadlessInstaller::collectDebFiles(const QStringList &inputs, QStringList *missing)
+{
+    QStringList debFiles;
+    for (const QString &input : inputs) {
+        const QFileInfo info(input);
+        if (info.isDir()) {
+            const QFileInfoList entries = QDir(input).entryInfoList({"*.deb"}, QDir::Files | QDir::Readable, QDir::Name);
+            for (const QFileInfo &entry : entries) {
+                debFiles.append(entry.absoluteFilePath());
+            }
+        } else if (info.isFile()) {
+            debFiles.append(info.absoluteFilePath());
+        } else if (missing) {
+            missing->append(input);
+        }
+    }
+    return debFiles;
+}
+
+int HeadlessInstaller::exec(const QStringList &debFiles)
+{
+    m_timer.start();
+
+    analyze(debFiles);
+
+    if (!m_items.isEmpty()) {
+        if (!m_status->backend()) {
+            writeRecord("error", {{"error", "failed to initialize apt backend"}});
+            return ExitFailed;
+        }
+        checkStatus();
+    }
+
+    if (!m_options.analyzeOnly && !m_items.isEmpty()) {
+        m_installer = new PackageInstaller(m_status->backend());
+
+        bool stopped = false;
+        for (int index : installOrder()) {
+            Item &item = m_items[index];
+            if (stopped) {
+                ++m_failedCount;
+                writeRecord("skipped", {{"path", item.path}, {"reason", "stopped on previous error"}});
+                continue;
+            }
+
+            if (!install(item) && m_options.stopOnError) {
+                stopped = true;
+            }
+        }
+    }
+
+    writeRecord("summary",
+                {{"total", debFiles.size()},
+                 {"packages", m_items.size()},
+                 {"failed", m_failedCount},
+                 {"elapsed_ms", m_timer.elapsed()}});
+
+    return m_failedCount > 0 ? ExitFailed : ExitSuccess;
+}
+
+void HeadlessInstaller::analyze(const QStringList &debFiles)
+{
+    // deb parse, md5 and signature check are independent for each file, run in parallel.
+    std::function<Item(const QString &)> analyzeFile = [](const QString &path) {
+        QElapsedTimer timer;
+        timer.start();
+
+        Item item;
+        item.path = path;
+        item.package.reset(new Package(path));
+
+        if (item.package->getValid()) {
+            QApt::DebFile deb(path);
+            const QList<QApt::DependencyItem> dependsList = deb.preDepends() + deb.depends();
+            for (const QApt::DependencyItem &depend : dependsList) {
+                for (const QApt::DependencyInfo &info : depend) {
+                    item.depends.append(info.packageName());
+                }
+            }
+        }
+
+        item.analyzeMs = timer.elapsed();
+        return item;
+    };
+    const QList<Item> analyzed = QtConcurrent::blockingMapped<QList<Item>>(debFiles, analyzeFile);
+
+    QSet<QByteArray> md5Set;
+    for (const Item &item : analyzed) {
+        if (!item.package->getValid()) {
+            ++m_failedCount;
+            writeRecord("skipped", {{"path", item.path}, {"reason", "invalid package"}, {"elapsed_ms", item.analyzeMs}});
+            continue;
+        }
+
+        const QByteArray md5 = item.package->getMd5();
+        if (md5Set.contains(md5)) {
+            writeRecord("duplicate", {{"path", item.path}, {"md5", QString::fromLatin1(md5)}});
+            continue;
+        }
+
+        md5Set.insert(md5);
+        m_items.append(item);
+    }
+}
+
+void HeadlessInstaller::checkStatus()
+{
+    // QApt backend is not thread safe, depends status check run in sequence.
+    for (Item &item : m_items) {
+        QElapsedTimer timer;
+        timer.start();
+
+        const DependsStatus dependsStatus = m_status->getPackageDependsStatus(item.path);
+        item.package->setPackageDependStatus(dependsStatus);
+        if (DependsAvailable == dependsStatus) {
+            item.package->setPackageAvailableDepends(m_status->getPackageAvailableDepends(item.path));
+        }
+        const InstallStatus installStatus = m_status->getPackageInstallStatus(item.path);
+        item.package->setPackageInstallStatus(installStatus);
+
+        const bool installable = DependsOk == dependsStatus || DependsAvailable == dependsStatus;
+        if (m_options.analyzeOnly && !installable) {
+            ++m_failedCount;
+        }
+
+        writeRecord("analyzed",
+                    {{"path", item.path},
+                     {"package", item.package->getName()},
+                     {"version", item.package->getVersion()},
+                     {"architecture", item.package->getArchitecture()},
+                     {"md5", QString::fromLatin1(item.package->getMd5())},
+                     {"signature", item.package->getSigntureStatus()},
+                     {"depends", dependsStatusName(dependsStatus)},
+                     {"install_status", installStatusName(installStatus)},
+                     {"available_depends", QJsonArray::fromStringList(item.package->getPackageAvailableDepends())},
+                     {"elapsed_ms", item.analyzeMs + timer.elapsed()}});
+    }
+}
+
+QList<int> HeadlessInstaller::installOrder() const
+{
+    // Packages depended by others in the batch are installed first,
+    // otherwise keep the input order. Packages in a depends cycle are appended at last.
+    QHash<QString, int> nameIndex;
+    for (int i = 0; i < m_items.size(); ++i) {
+        nameIndex.insert(m_items[i].package->getName(), i);
+    }
+
+    QVector<int> inDegree(m_items.size(), 0);
+    QVector<QList<int>> dependents(m_items.size());
+    for (int i = 0; i < m_items.size(); ++i) {
+        QSet<int> dependIndexes;
+        for (const QString &depend : m_items[i].depends) {
+            const int dependIndex = nameIndex.value(depend, -1);
+            if (-1 != dependIndex && i != dependIndex) {
+                dependIndexes.insert(dependIndex);
+            }
+        }
+        for (int dependIndex : dependIndexes) {
+            dependents[dependIndex].append(i);
+            ++inDegree[i];
+        }
+    }
+
+    std::set<int> ready;
+    for (int i = 0; i < m_items.size(); ++i) {
+        if (0 == inDegree[i]) {
+            ready.insert(i);
+        }
+    }
+
+    QList<int> order;
+    QVector<bool> ordered(m_items.size(), false);
+    while (!ready.empty()) {
+        const int current = *ready.begin();
+        ready.erase(ready.begin());
+        order.append(current);
+        ordered[current] = true;
+
+        for (int dependent : dependents[current]) {
+            if (0 == --inDegree[dependent]) {
+                ready.insert(dependent);
+            }
+        }
+    }
+
+    for (int i = 0; i < m_items.size(); ++i) {
+        if (!ordered[i]) {
+            order.append(i);
+        }
+    }
+    return order;
+}
+
+bool HeadlessInstaller::install(Item &item)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // the depends may be satisfied by the packages installed before in this batch
+    if (DependsOk != item.package->getDependStatus()) {
+        const DependsStatus dependsStatus = m_status->getPackageDependsStatus(item.path);
+        item.package->setPackageDependStatus(dependsStatus);
+        if (DependsAvailable == dependsStatus) {
+            item.package->setPackageAvailableDepends(m_status->getPackageAvailableDepends(item.path));
+        }
+    }
+
+    bool finished = false;
+    QApt::ExitStatus exitStatus = QApt::ExitFailed;
+    int errorCode = 0;
+    QString errorDetail;
+
+    QEventLoop loop;
+    const QMetaObject::Connection errorConnection =
+        connect(m_installer, &PackageInstaller::signal_installError, this, [&](int code, const QString &detail) {
+            // keep the first error, later ones are usually caused by it
+            if (errorDetail.isEmpty()) {
+                errorCode = code;
+                errorDetail = detail;
+            }
+        });
+    const QMetaObject::Connection finishConnection =
+        connect(m_installer, &PackageInstaller::signal_installFinished, this, [&](QApt::ExitStatus status) {
+            finished = true;
+            exitStatus = status;
+            loop.quit();
+        });
+
+    m_installer->appendPackage(item.package.data());
+    m_installer->installPackage();
+    // break depends finished synchronously
+    if (!finished) {
+        loop.exec();
+    }
+
+    disconnect(errorConnection);
+    disconnect(finishConnection);
+
+    const bool success = QApt::ExitSuccess == exitStatus;
+    if (!success) {
+        ++m_failedCount;
+    }
+
+    writeRecord("installed",
+                {{"path", item.path},
+                 {"package", item.package->getName()},
+                 {"success", success},
+                 {"exit_status", static_cast<int>(exitStatus)},
+                 {"error_code", errorCode},
+                 {"error", errorDetail},
+                 {"elapsed_ms", timer.elapsed()}});
+
+    // refresh the cache so that the next package sees what was installed
+    m_status->backend()->reloadCache();
+    return success;
+}
+
+void HeadlessInstaller::writeRecord(const QString &event, QJsonObject record)
+{
+    record.insert("event", event);
+
+    // one compact object per line, flushed so that the caller can stream the output
+    const QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact) + '\n';
+    fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stdout);
+    fflush(stdout);
+}
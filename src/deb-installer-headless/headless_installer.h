@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HEADLESS_INSTALLER_H
+#define HEADLESS_INSTALLER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QStringList>
+
+class Package;
+class PackageStatus;
+class PackageInstaller;
+
+/**
+   @brief Batch deb installer without any widget, for provisioning scripts.
+
+    The pipeline is: parallel analysis (deb parse, md5, signature) -> sequential
+    depends / install status check on the shared apt backend -> install ordering
+    by the depends inside the batch -> sequential install.
+    Each step writes one JSON object per line to stdout.
+ */
+class HeadlessInstaller : public QObject
+{
+    Q_OBJECT
+public:
+    struct Options
+    {
+        bool analyzeOnly{false};  // only output analysis result, not install
+        bool stopOnError{false};  // stop the remaining install when one package failed
+    };
+
+    enum ExitCode {
+        ExitSuccess = 0,
+        ExitFailed = 1,
+        ExitUsageError = 2,
+    };
+
+    explicit HeadlessInstaller(const Options &options, QObject *parent = nullptr);
+    ~HeadlessInstaller() override;
+
+    // Expand directories to the *.deb files inside (sorted), files are kept as is.
+    [[nodiscard]] static QStringList collectDebFiles(const QStringList &inputs, QStringList *missing = nullptr);
+
+    // Run the whole pipeline, blocking until finished, return ExitCode.
+    int exec(const QStringList &debFiles);
+
+private:
+    struct Item
+    {
+        QString path;
+        QSharedPointer<Package> package;
+        QStringList depends;  // depends package names, used for ordering
+        qint64 analyzeMs{0};
+    };
+
+    void analyze(const QStringList &debFiles);
+    void checkStatus();
+    [[nodiscard]] QList<int> installOrder() const;
+    bool install(Item &item);
+
+    void writeRecord(const QString &event, QJsonObject record);
+
+    Options m_options;
+    QList<Item> m_items;
+    int m_failedCount{0};
+
+    PackageStatus *m_status{nullptr};
+    PackageInstaller *m_installer{nullptr};
+    QElapsedTimer m_timer;
+};
+
+#endif  // HEADLESS_INSTALLER_H
@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "headless_installer.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("deepin");
+    app.setApplicationName("deepin-deb-installer-headless");
+    app.setApplicationVersion(VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Install deb packages without GUI, results are written to stdout as JSON lines.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption analyzeOnlyOption("analyze-only", "Analyze the packages without installing them.");
+    QCommandLineOption stopOnErrorOption("stop-on-error", "Skip the remaining packages once an install failed.");
+    parser.addOption(analyzeOnlyOption);
+    parser.addOption(stopOnErrorOption);
+    parser.addPositionalArgument("paths", "Deb files or directories containing deb files.", "paths...");
+    parser.process(app);
+
+    QStringList missing;
+    const QStringList debFiles = HeadlessInstaller::collectDebFiles(parser.positionalArguments(), &missing);
+    for (const QString &path : missing) {
+        qWarning() << "[Headless]" << "path not found:" << path;
+    }
+    if (debFiles.isEmpty() || !missing.isEmpty()) {
+        parser.showHelp(HeadlessInstaller::ExitUsageError);
+    }
+
+    HeadlessInstaller::Options options;
+    options.analyzeOnly = parser.isSet(analyzeOnlyOption);
+    options.stopOnError = parser.isSet(stopOnErrorOption);
+
+    HeadlessInstaller installer(options);
+    return installer.exec(debFiles);
+}
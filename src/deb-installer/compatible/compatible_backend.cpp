@@ -6,14 +6,21 @@
 #include "compatible_json_parser.h"
 
 #include <QApplication>
+#include <QCryptographicHash>
+#include <QFile>
 #include <QProcess>
 #include <QtConcurrent/QtConcurrentRun>
-#include <QTextStream>
-#include <QRegExp>
 #include <QStandardPaths>
 
+#include <cctype>
+#include <cstring>
 #include <mutex>
 
+// real app check through the privileged helper, disabled for now: all rootfs are treated as supported.
+#ifndef COMPATIBLE_APP_CHECK
+#define COMPATIBLE_APP_CHECK 0
+#endif
+
 namespace Compatible {
 
 // compatible controller params
@@ -29,6 +36,73 @@ static const QString kCompRemove = "remove";
 static const QString kCompCheck = "check";
 static const QString kCompPS = "ps";
 
+namespace {
+
+// calls onLine(begin, end) for each non blank line after the first skipLines lines.
+template <typename Fn>
+void forEachRawLine(const QByteArray &output, int skipLines, Fn onLine)
+{
+    const char *pos = output.constData();
+    const char *end = pos + output.size();
+
+    for (int lineIndex = 0; pos < end; ++lineIndex) {
+        const char *lineEnd = static_cast<const char *>(::memchr(pos, '\n', static_cast<size_t>(end - pos)));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+
+        if (lineIndex >= skipLines) {
+            const char *first = pos;
+            while (first < lineEnd && ::isspace(static_cast<unsigned char>(*first))) {
+                ++first;
+            }
+            if (first < lineEnd) {
+                onLine(pos, lineEnd);
+            }
+        }
+
+        pos = lineEnd + 1;
+    }
+}
+
+// next whitespace separated token of the line, an empty span at the end.
+QPair<const char *, const char *> nextRawToken(const char **pos, const char *end)
+{
+    const char *begin = *pos;
+    while (begin < end && ::isspace(static_cast<unsigned char>(*begin))) {
+        ++begin;
+    }
+    const char *tokenEnd = begin;
+    while (tokenEnd < end && !::isspace(static_cast<unsigned char>(*tokenEnd))) {
+        ++tokenEnd;
+    }
+    *pos = tokenEnd;
+    return {begin, tokenEnd};
+}
+
+// position of the first yyyy-mm-dd date, nullptr if none.
+const char *findRawDate(const char *begin, const char *end)
+{
+    static const char kPattern[] = "dddd-dd-dd";
+    const int patternLength = static_cast<int>(sizeof(kPattern) - 1);
+
+    for (const char *pos = begin; end - pos >= patternLength; ++pos) {
+        int i = 0;
+        for (; i < patternLength; ++i) {
+            const char c = pos[i];
+            if ('-' == kPattern[i] ? '-' != c : (c < '0' || c > '9')) {
+                break;
+            }
+        }
+        if (patternLength == i) {
+            return pos;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
 CompatibleBackend::CompatibleBackend(QObject *parent)
     : QObject{parent}
 {
@@ -122,122 +196,213 @@ bool CompatibleBackend::checkPackageSupportRootfs(const CompPkgInfo::Ptr &checkP
         return false;
     }
 
-    QString captureFilePath = checkPtr->filePath;
-    captureFilePath.detach();
-    QThreadPool::globalInstance()->start(
-        [=]() {
-
-#if 1
-            // This is a temporary change
-            QList<RootfsInfo::Ptr> rootfs;
-            QProcess queryProcess;
-            queryProcess.setProgram(kCompatibleBin);
-
-            // FIXME: we need init rootfs?
-            queryProcess.setArguments({kCompApp, kCompPS});
-            queryProcess.start();
-            // 30s not enough for init, up to 20mins.
-            if (queryProcess.waitForFinished(20 * 60 * 1000)) {
-                queryProcess.setArguments({kCompRootFs, kCompList});
-                queryProcess.start();
-                if (queryProcess.waitForFinished()) {
-                    QByteArray output = queryProcess.readAllStandardOutput();
-                    rootfs = parseRootfsFromRawOutputV2(output);
-                }
-            } else {
-                qWarning() << "Delay get(init) rootfs list failed! " << queryProcess.errorString();
-            }
+    if (!m_pendingChecks.contains(checkPtr)) {
+        m_pendingChecks.append(checkPtr);
+    }
 
+    // the running batch picks up pending packages after finished.
+    if (!m_checking) {
+        startCheckBatch();
+    }
+
+    return true;
+}
+
+void CompatibleBackend::startCheckBatch()
+{
+    m_checking = true;
+
+    const QList<CompPkgInfo::Ptr> batch = m_pendingChecks;
+    m_pendingChecks.clear();
+
+    QList<CheckItem> items;
+    for (const CompPkgInfo::Ptr &checkPtr : batch) {
+        CheckItem item;
+        item.filePath = checkPtr->filePath;
+        item.filePath.detach();
+        item.md5 = checkPtr->md5;
+        items.append(item);
+    }
+
+    QtConcurrent::run([this, batch, items]() {
+        const CheckResult result = checkSupportRootfs(items);
+
+        // update data on GUI thread
+        QMetaObject::invokeMethod(
+            qApp, [this, batch, result]() { checkBatchFinished(batch, result); }, Qt::QueuedConnection);
+    });
+}
+
+void CompatibleBackend::checkBatchFinished(const QList<CompPkgInfo::Ptr> &batch, const CheckResult &result)
+{
+    // FIXME: we need init rootfs?
+    m_rootfsList = result.rootfsList;
+
+    for (int i = 0; i < batch.size(); ++i) {
+        const CompPkgInfo::Ptr &checkPtr = batch.at(i);
+        checkPtr->checked = true;
+        checkPtr->supportRootfs = result.supportRootfs.value(i);
+        Q_EMIT packageSupportRootfsChanged(checkPtr);
+    }
+
+    m_checking = false;
+    if (!m_pendingChecks.isEmpty()) {
+        startCheckBatch();
+    }
+}
+
+CompatibleBackend::CheckResult CompatibleBackend::checkSupportRootfs(const QList<CheckItem> &items)
+{
+    CheckResult result;
+    // query rootfs once for the whole batch
+    result.rootfsList = queryRootfsList();
+
+    QStringList rootfsNames;
+    for (const RootfsInfo::Ptr &rootfsPtr : result.rootfsList) {
+        rootfsNames.append(rootfsPtr->name);
+    }
+    rootfsNames.sort();
+    const uint rootfsVersion = qHash(rootfsNames.join('\n'));
+
+#if !COMPATIBLE_APP_CHECK
+    // the check is a no-op, do not hash the files only to cache its result.
+    Q_UNUSED(rootfsVersion)
+    for (int i = 0; i < items.size(); ++i) {
+        result.supportRootfs.append(appCheckSupportRootfs(items.at(i).filePath, result.rootfsList));
+    }
 #else
-            // app check require root privileges
-            // e.g.: pkexec deepin-deb-installer-dependsInstall --install_compatible --check [file path] --user [current user]
-            // And real command in backend: deepin-compatible-ctl app --json check [file path]
-            QStringList params{"deepin-deb-installer-dependsInstall", "--install_compatible", "--check", captureFilePath};
-            auto env = QProcessEnvironment::systemEnvironment();
-            QString currentUser = env.value("USER");
-            if (!currentUser.isEmpty()) {
-                params << "--user" << currentUser;
+    for (const CheckItem &item : items) {
+        QByteArray md5 = item.md5;
+        if (md5.isEmpty()) {
+            QFile file(item.filePath);
+            if (file.open(QIODevice::ReadOnly)) {
+                QCryptographicHash hash(QCryptographicHash::Md5);
+                hash.addData(&file);
+                md5 = hash.result().toHex();
             }
+        }
 
-            // up to 10 mins
-            QProcess checkProc;
-            checkProc.start("pkexec", params);
-            checkProc.waitForFinished(1000 * 60 * 10);
-            if (QProcess::UnknownError != checkProc.error()) {
-                qWarning() << "Compatible app check failed: " << checkProc.errorString();
+        const QPair<QByteArray, uint> key(md5, rootfsVersion);
+        if (!md5.isEmpty()) {
+            std::lock_guard<std::mutex> guard(m_checkCacheMutex);
+            auto findItr = m_checkCache.constFind(key);
+            if (findItr != m_checkCache.cend()) {
+                result.supportRootfs.append(findItr.value());
+                continue;
             }
+        }
 
-            QList<RootfsInfo::Ptr> rootfs;
-            // get last json output
-            QByteArray checkOutput = checkProc.readAllStandardOutput().trimmed();
-            int lastLineOffset = checkOutput.lastIndexOf('\n');
+        const QList<RootfsInfo::Ptr> supportRootfs = appCheckSupportRootfs(item.filePath, result.rootfsList);
+        if (!md5.isEmpty()) {
+            std::lock_guard<std::mutex> guard(m_checkCacheMutex);
+            m_checkCache.insert(key, supportRootfs);
+        }
+        result.supportRootfs.append(supportRootfs);
+    }
+#endif
 
-            if (-1 != lastLineOffset) {
-                QByteArray lastLine = checkOutput.mid(lastLineOffset + 1);
-                qInfo() << "Parse app check return" << lastLine;
+    return result;
+}
 
-                auto ret = CompatibleJsonParser::parseCommonField(lastLine);
-                if (ret && CompSuccess == ret->code) {
-                    // parse rootfs info
-                    rootfs = CompatibleJsonParser::parseSupportfsList(ret);
-                }
-            }
-#endif
+QList<RootfsInfo::Ptr> CompatibleBackend::queryRootfsList()
+{
+    QList<RootfsInfo::Ptr> rootfs;
+    QProcess queryProcess;
+    queryProcess.setProgram(kCompatibleBin);
 
-            // update data on GUI thread
-            QMetaObject::invokeMethod(
-                qApp,
-                [=]() {
-                    // FIXME: we need init rootfs?
-                    CompatibleBackend::instance()->m_rootfsList = rootfs;
-
-                    checkPtr->checked = true;
-                    checkPtr->supportRootfs = rootfs;
-                    Q_EMIT CompatibleBackend::instance()->packageSupportRootfsChanged(checkPtr);
-                },
-                Qt::QueuedConnection);
-        },
-        QThread::TimeCriticalPriority);
+    // FIXME: we need init rootfs?
+    queryProcess.setArguments({kCompApp, kCompPS});
+    queryProcess.start();
+    // 30s not enough for init, up to 20mins.
+    if (queryProcess.waitForFinished(20 * 60 * 1000)) {
+        queryProcess.setArguments({kCompRootFs, kCompList});
+        queryProcess.start();
+        if (queryProcess.waitForFinished()) {
+            QByteArray output = queryProcess.readAllStandardOutput();
+            rootfs = parseRootfsFromRawOutputV2(output);
+        }
+    } else {
+        qWarning() << "Delay get(init) rootfs list failed! " << queryProcess.errorString();
+    }
 
-    return true;
+    return rootfs;
 }
 
-QList<RootfsInfo::Ptr> CompatibleBackend::parseRootfsFromRawOutputV1(const QByteArray &output)
+QList<RootfsInfo::Ptr> CompatibleBackend::appCheckSupportRootfs(const QString &filePath, const QList<RootfsInfo::Ptr> &rootfsList)
 {
-    QTextStream stream(output, QIODevice::ReadOnly);
+#if !COMPATIBLE_APP_CHECK
+    // This is a temporary change, all rootfs are treated as supported.
+    Q_UNUSED(filePath)
+    return rootfsList;
 
-    // remove title
-    stream.readLine();
-    stream.readLine();
+#else
+    Q_UNUSED(rootfsList)
+
+    // app check require root privileges, and checks a single file each call.
+    // e.g.: pkexec deepin-deb-installer-dependsInstall --install_compatible --check [file path] --user [current user]
+    // And real command in backend: deepin-compatible-ctl app --json check [file path]
+    QStringList params{"deepin-deb-installer-dependsInstall", "--install_compatible", "--check", filePath};
+    auto env = QProcessEnvironment::systemEnvironment();
+    QString currentUser = env.value("USER");
+    if (!currentUser.isEmpty()) {
+        params << "--user" << currentUser;
+    }
+
+    // up to 10 mins
+    QProcess checkProc;
+    checkProc.start("pkexec", params);
+    checkProc.waitForFinished(1000 * 60 * 10);
+    if (QProcess::UnknownError != checkProc.error()) {
+        qWarning() << "Compatible app check failed: " << checkProc.errorString();
+    }
 
-    bool convert{false};
-    QString temp;
+    QList<RootfsInfo::Ptr> rootfs;
+    // get last json output
+    QByteArray checkOutput = checkProc.readAllStandardOutput().trimmed();
+    int lastLineOffset = checkOutput.lastIndexOf('\n');
+
+    if (-1 != lastLineOffset) {
+        QByteArray lastLine = checkOutput.mid(lastLineOffset + 1);
+        qInfo() << "Parse app check return" << lastLine;
+
+        auto ret = CompatibleJsonParser::parseCommonField(lastLine);
+        if (ret && CompSuccess == ret->code) {
+            // parse rootfs info
+            rootfs = CompatibleJsonParser::parseSupportfsList(ret);
+        }
+    }
+
+    return rootfs;
+#endif
+}
+
+QList<RootfsInfo::Ptr> CompatibleBackend::parseRootfsFromRawOutputV1(const QByteArray &output)
+{
     QList<RootfsInfo::Ptr> rootfsList;
-    QRegExp priorityReg("^\\d+");
-    QRegExp createTimeReg("\\d{4}-\\d{2}-\\d{2}");
 
-    while (!stream.atEnd()) {
+    // remove title
+    forEachRawLine(output, 2, [&](const char *begin, const char *end) {
+        const char *pos = begin;
         auto rootfsPtr = RootfsInfo::Ptr::create();
-        stream >> temp;
-        rootfsPtr->prioriy = temp.toInt(&convert);
-        if (!convert) {
-            int priority = priorityReg.indexIn(temp);
-            if (priority != -1) {
-                rootfsPtr->prioriy = priorityReg.cap().toInt();
-            }
+
+        // priority, maybe followed by other characters
+        const QPair<const char *, const char *> priority = nextRawToken(&pos, end);
+        int priorityValue = 0;
+        for (const char *digit = priority.first; digit < priority.second && *digit >= '0' && *digit <= '9'; ++digit) {
+            priorityValue = priorityValue * 10 + (*digit - '0');
         }
+        rootfsPtr->prioriy = priorityValue;
 
-        stream >> rootfsPtr->name;
+        const QPair<const char *, const char *> name = nextRawToken(&pos, end);
+        rootfsPtr->name = QString::fromUtf8(name.first, static_cast<int>(name.second - name.first));
 
-        // special field: os name ( contains space ), wen
-        temp = stream.readLine();
-        int createTimePos = createTimeReg.indexIn(temp);
-        if (-1 != createTimePos) {
-            rootfsPtr->osName = temp.left(createTimePos).trimmed();
+        // special field: os name ( contains space ), before the create time yyyy-mm-dd
+        if (const char *createTime = findRawDate(pos, end)) {
+            rootfsPtr->osName = QString::fromUtf8(pos, static_cast<int>(createTime - pos)).trimmed();
         }
 
         rootfsList.append(rootfsPtr);
-    }
+    });
 
     return rootfsList;
 }
@@ -250,25 +415,22 @@ QList<RootfsInfo::Ptr> CompatibleBackend::parseRootfsFromRawOutputV2(const QByte
        4aeedabc79a4 uos-rootfs-20          localhost/uos-rootfs-20:latest   Up 6 minutes
     */
 
-    QTextStream stream(output, QIODevice::ReadOnly);
+    QList<RootfsInfo::Ptr> rootfsList;
 
     // remove title
-    stream.readLine();
-    stream.readLine();
-
-    QList<RootfsInfo::Ptr> rootfsList;
-    QString deprecated;
+    forEachRawLine(output, 2, [&](const char *begin, const char *end) {
+        const char *pos = begin;
+        nextRawToken(&pos, end);  // deprecated id
+        const QPair<const char *, const char *> name = nextRawToken(&pos, end);
+        if (name.first == name.second) {
+            return;
+        }
 
-    while (!stream.atEnd()) {
         auto rootfsPtr = RootfsInfo::Ptr::create();
-
-        stream >> deprecated;
-        stream >> rootfsPtr->name;
-        stream.readLine();
-
+        rootfsPtr->name = QString::fromUtf8(name.first, static_cast<int>(name.second - name.first));
         rootfsPtr->osName = rootfsPtr->name;
         rootfsList.append(rootfsPtr);
-    }
+    });
 
     return rootfsList;
 }
@@ -277,22 +439,19 @@ QHash<QString, CompPkgInfo::Ptr> CompatibleBackend::parseAppListFromRawOutput(co
 {
     QHash<QString, CompPkgInfo::Ptr> packageList;
 
-    QTextStream stream(output, QIODevice::ReadOnly);
-
     // remove title
-    stream.readLine();
-    stream.readLine();
-
-    while (!stream.atEnd()) {
+    forEachRawLine(output, 2, [&](const char *begin, const char *end) {
+        const char *pos = begin;
         auto pkgPtr = CompPkgInfo::Ptr::create();
 
-        stream >> pkgPtr->name;
-        stream >> pkgPtr->version;
-        stream >> pkgPtr->arch;
-        stream >> pkgPtr->rootfs;
+        QString *fields[] = {&pkgPtr->name, &pkgPtr->version, &pkgPtr->arch, &pkgPtr->rootfs};
+        for (QString *field : fields) {
+            const QPair<const char *, const char *> token = nextRawToken(&pos, end);
+            *field = QString::fromUtf8(token.first, static_cast<int>(token.second - token.first));
+        }
 
         packageList.insert(pkgPtr->name, pkgPtr);
-    }
+    });
 
     return packageList;
 }
@@ -8,6 +8,8 @@
 #include <QObject>
 #include <QHash>
 
+#include <mutex>
+
 #include "compatible_defines.h"
 
 class QProcess;
@@ -58,6 +60,7 @@ public:
 
     // use app check support rootfs with special package
     [[nodiscard]] bool supportAppCheck() const;
+    // packages requested while a check is running are checked together in the next batch.
     [[nodiscard]] bool checkPackageSupportRootfs(const CompPkgInfo::Ptr &checkPtr);
     Q_SIGNAL void packageSupportRootfsChanged(const CompPkgInfo::Ptr &checkPtr);
 
@@ -74,11 +77,34 @@ private:
     // parse json output data
     static void backendProcessWithJson(CompatibleBackend *backend);
 
+    struct CheckItem
+    {
+        QString filePath;
+        QByteArray md5;
+    };
+    struct CheckResult
+    {
+        QList<RootfsInfo::Ptr> rootfsList;
+        QList<QList<RootfsInfo::Ptr>> supportRootfs;  // same order as the check items
+    };
+    void startCheckBatch();
+    void checkBatchFinished(const QList<CompPkgInfo::Ptr> &batch, const CheckResult &result);
+    [[nodiscard]] CheckResult checkSupportRootfs(const QList<CheckItem> &items);
+    [[nodiscard]] static QList<RootfsInfo::Ptr> queryRootfsList();
+    [[nodiscard]] static QList<RootfsInfo::Ptr> appCheckSupportRootfs(const QString &filePath,
+                                                                     const QList<RootfsInfo::Ptr> &rootfsList);
+
     bool m_init{false};
     bool m_compatibleExists{false};
     QList<RootfsInfo::Ptr> m_rootfsList;          // rootfs list
     QHash<QString, CompPkgInfo::Ptr> m_packages;  // all packages, every package is unique
 
+    bool m_checking{false};
+    QList<CompPkgInfo::Ptr> m_pendingChecks;
+    // app check result, key: (file md5, rootfs list version)
+    std::mutex m_checkCacheMutex;
+    QHash<QPair<QByteArray, uint>, QList<RootfsInfo::Ptr>> m_checkCache;
+
     Q_DISABLE_COPY(CompatibleBackend)
 };
 
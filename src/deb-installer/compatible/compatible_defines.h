@@ -30,6 +30,7 @@ struct CompPkgInfo
     using Ptr = QSharedPointer<CompPkgInfo>;
 
     QString filePath;  // for local file
+    QByteArray md5;    // md5 of local file, calculated by the app check if empty
     QString name;
     QString version;
     QString arch;          // architecture
@@ -5,15 +5,344 @@
 #include "compatible_json_parser.h"
 #include "compatible_backend.h"
 
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
+#include <QDebug>
+
+#include <cstring>
 
 namespace Compatible {
 
-static const QString kFieldCode = "Code";
-static const QString kFieldMsg = "Msg";
-static const QString kFieldExt = "Ext";
+namespace {
+
+inline bool isDelimiter(char c)
+{
+    return ',' == c || '}' == c || ']' == c || ' ' == c || '\t' == c || '\r' == c || '\n' == c;
+}
+
+/**
+   @brief Forward only cursor over json bytes.
+
+    Walks the buffer once and decodes only the values asked for, strings are
+    decoded to UTF-8 bytes, no QJsonDocument or QString is built for values
+    that are skipped.
+ */
+class JsonCursor
+{
+public:
+    JsonCursor(const char *begin, const char *end)
+        : m_begin(begin)
+        , m_pos(begin)
+        , m_end(end)
+    {
+    }
+
+    [[nodiscard]] int offset() const { return static_cast<int>(m_pos - m_begin); }
+
+    // next non space char, 0 at end
+    char peek()
+    {
+        while (m_pos < m_end && (' ' == *m_pos || '\t' == *m_pos || '\r' == *m_pos || '\n' == *m_pos)) {
+            ++m_pos;
+        }
+        return m_pos < m_end ? *m_pos : '\0';
+    }
+
+    bool consume(char c)
+    {
+        if (c != peek()) {
+            return false;
+        }
+        ++m_pos;
+        return true;
+    }
+
+    // raw span of a key without escapes, keys of the compatible output are plain ascii.
+    bool readKey(const char **keyBegin, const char **keyEnd)
+    {
+        if (!consume('"')) {
+            return false;
+        }
+        *keyBegin = m_pos;
+        while (m_pos < m_end && '"' != *m_pos) {
+            if ('\\' == *m_pos) {
+                ++m_pos;
+            }
+            ++m_pos;
+        }
+        if (m_pos >= m_end) {
+            return false;
+        }
+        *keyEnd = m_pos++;
+        return consume(':');
+    }
+
+    bool readString(QByteArray *out)
+    {
+        if (!consume('"')) {
+            return false;
+        }
+
+        const char *run = m_pos;
+        out->resize(0);
+        while (m_pos < m_end && '"' != *m_pos) {
+            if ('\\' != *m_pos) {
+                ++m_pos;
+                continue;
+            }
+
+            out->append(run, static_cast<int>(m_pos - run));
+            if (++m_pos >= m_end) {
+                return false;
+            }
+
+            switch (*m_pos++) {
+                case 'n':
+                    out->append('\n');
+                    break;
+                case 't':
+                    out->append('\t');
+                    break;
+                case 'r':
+                    out->append('\r');
+                    break;
+                case 'b':
+                    out->append('\b');
+                    break;
+                case 'f':
+                    out->append('\f');
+                    break;
+                case 'u':
+                    if (!readUnicodeEscape(out)) {
+                        return false;
+                    }
+                    break;
+                default:  // '"', '\\', '/'
+                    out->append(*(m_pos - 1));
+                    break;
+            }
+            run = m_pos;
+        }
+
+        if (m_pos >= m_end) {
+            return false;
+        }
+        out->append(run, static_cast<int>(m_pos - run));
+        ++m_pos;
+        return true;
+    }
+
+    // string value, other values are skipped and give an empty string.
+    bool readStringValue(QString *out)
+    {
+        if ('"' != peek()) {
+            out->clear();
+            return skipValue();
+        }
+
+        // fast path, no escape in the string
+        const char *begin = m_pos + 1;
+        const char *quote = static_cast<const char *>(::memchr(begin, '"', static_cast<size_t>(m_end - begin)));
+        if (quote && !::memchr(begin, '\\', static_cast<size_t>(quote - begin))) {
+            *out = QString::fromUtf8(begin, static_cast<int>(quote - begin));
+            m_pos = quote + 1;
+            return true;
+        }
+
+        if (!readString(&m_scratch)) {
+            return false;
+        }
+        *out = QString::fromUtf8(m_scratch);
+        return true;
+    }
+
+    bool readInt(int *out)
+    {
+        const char c = peek();
+        if ('-' != c && (c < '0' || c > '9')) {
+            *out = 0;
+            return skipValue();
+        }
+
+        const char *begin = m_pos;
+        while (m_pos < m_end && !isDelimiter(*m_pos)) {
+            ++m_pos;
+        }
+        *out = static_cast<int>(QByteArray::fromRawData(begin, static_cast<int>(m_pos - begin)).toDouble());
+        return true;
+    }
+
+    bool skipValue()
+    {
+        const char c = peek();
+        if ('"' == c) {
+            return readString(&m_scratch);
+        }
+
+        if ('{' == c || '[' == c) {
+            int depth = 0;
+            while (m_pos < m_end) {
+                const char current = *m_pos;
+                if ('"' == current) {
+                    if (!readString(&m_scratch)) {
+                        return false;
+                    }
+                    continue;
+                }
+                ++m_pos;
+                if ('{' == current || '[' == current) {
+                    ++depth;
+                } else if (('}' == current || ']' == current) && 0 == --depth) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // number, true, false, null
+        const char *begin = m_pos;
+        while (m_pos < m_end && !isDelimiter(*m_pos)) {
+            ++m_pos;
+        }
+        return m_pos != begin;
+    }
+
+    // calls onField(keyBegin, keyEnd) for each member, which must read or skip the value.
+    template <typename Fn>
+    bool readObject(Fn onField)
+    {
+        if (!consume('{')) {
+            return false;
+        }
+        if (consume('}')) {
+            return true;
+        }
+
+        do {
+            const char *keyBegin = nullptr;
+            const char *keyEnd = nullptr;
+            if (!readKey(&keyBegin, &keyEnd) || !onField(keyBegin, keyEnd)) {
+                return false;
+            }
+        } while (consume(','));
+
+        return consume('}');
+    }
+
+    // calls onItem() for each element, which must read or skip the value.
+    template <typename Fn>
+    bool readArray(Fn onItem)
+    {
+        if (!consume('[')) {
+            return false;
+        }
+        if (consume(']')) {
+            return true;
+        }
+
+        do {
+            if (!onItem()) {
+                return false;
+            }
+        } while (consume(','));
+
+        return consume(']');
+    }
+
+    // move to the first \a c, skip the prefix of the payload, e.g. "成功 ".
+    bool seek(char c)
+    {
+        const char *found = static_cast<const char *>(::memchr(m_pos, c, static_cast<size_t>(m_end - m_pos)));
+        if (!found) {
+            return false;
+        }
+        m_pos = found;
+        return true;
+    }
+
+    // move to the first '{' or '['
+    bool seekContainer()
+    {
+        while (m_pos < m_end && '{' != *m_pos && '[' != *m_pos) {
+            ++m_pos;
+        }
+        return m_pos < m_end;
+    }
+
+private:
+    bool readHex4(uint *code)
+    {
+        if (m_end - m_pos < 4) {
+            return false;
+        }
+        *code = 0;
+        for (int i = 0; i < 4; ++i) {
+            const char c = *m_pos++;
+            *code <<= 4;
+            if (c >= '0' && c <= '9') {
+                *code |= static_cast<uint>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                *code |= static_cast<uint>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                *code |= static_cast<uint>(c - 'A' + 10);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool readUnicodeEscape(QByteArray *out)
+    {
+        uint code = 0;
+        if (!readHex4(&code)) {
+            return false;
+        }
+
+        // surrogate pair
+        if (code >= 0xD800 && code < 0xDC00 && m_end - m_pos >= 6 && '\\' == m_pos[0] && 'u' == m_pos[1]) {
+            m_pos += 2;
+            uint low = 0;
+            if (!readHex4(&low)) {
+                return false;
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+
+        if (code < 0x80) {
+            out->append(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out->append(static_cast<char>(0xC0 | (code >> 6)));
+            out->append(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out->append(static_cast<char>(0xE0 | (code >> 12)));
+            out->append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out->append(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out->append(static_cast<char>(0xF0 | (code >> 18)));
+            out->append(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out->append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out->append(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+        return true;
+    }
+
+    const char *m_begin;
+    const char *m_pos;
+    const char *m_end;
+    QByteArray m_scratch;  // reused for decoded strings
+};
+
+template <size_t N>
+inline bool keyIs(const char *begin, const char *end, const char (&key)[N])
+{
+    return static_cast<size_t>(end - begin) == N - 1 && 0 == ::memcmp(begin, key, N - 1);
+}
+
+inline void parseFailed(const JsonCursor &cursor)
+{
+    qWarning() << QString("Parse compatible result failed: offset:%1").arg(cursor.offset());
+}
+
+}  // namespace
 
 CompatibleJsonParser::CompatibleJsonParser() {}
 
@@ -25,6 +354,8 @@ CompatibleJsonParser::CompatibleJsonParser() {}
     {\n    \"name\": \"hello\",\n    \"version\": \"2.10-2\",\n    \"arch\": \"amd64\"\n  },\n
     {\n    \"name\": \"tree\",\n    \"version\": \"1.8.0-1\",\n    \"arch\": \"amd64\"\n  }\n]"]}}
 
+    The first message of "Ext" is kept undecoded in ext.detailMessage, it is parsed by
+    parseAppList(), parseRootfsList() or parseSupportfsList() without another envelope parse.
  */
 CompatibleRet::Ptr CompatibleJsonParser::parseCommonField(const QByteArray &jsonString)
 {
@@ -32,23 +363,50 @@ CompatibleRet::Ptr CompatibleJsonParser::parseCommonField(const QByteArray &json
         return {};
     }
 
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(jsonString, &err);
-    if (QJsonParseError::NoError != err.error) {
-        qWarning() << QString("Parse compatible result failed: %1 offset:%2").arg(err.errorString()).arg(err.offset);
-        return {};
-    }
+    auto ret = CompatibleRet::Ptr::create();
+    JsonCursor cursor(jsonString.constData(), jsonString.constData() + jsonString.size());
 
-    auto rootObj = doc.object();
+    auto readExt = [&](const char *keyBegin, const char *keyEnd) {
+        if (keyIs(keyBegin, keyEnd, "Code")) {
+            return cursor.readInt(&ret->ext.code);
+        }
+        if (keyIs(keyBegin, keyEnd, "Msg")) {
+            if ('"' == cursor.peek()) {
+                return cursor.readString(&ret->ext.detailMessage);
+            }
+            if ('[' != cursor.peek()) {
+                return cursor.skipValue();
+            }
+
+            bool first = true;
+            return cursor.readArray([&]() {
+                if (first && '"' == cursor.peek()) {
+                    first = false;
+                    return cursor.readString(&ret->ext.detailMessage);
+                }
+                first = false;
+                return cursor.skipValue();
+            });
+        }
+        return cursor.skipValue();
+    };
 
-    auto ret = CompatibleRet::Ptr::create();
-    ret->code = rootObj.value(kFieldCode).toInt();
-    ret->message = rootObj.value(kFieldMsg).toString();
+    const bool parsed = cursor.readObject([&](const char *keyBegin, const char *keyEnd) {
+        if (keyIs(keyBegin, keyEnd, "Code")) {
+            return cursor.readInt(&ret->code);
+        }
+        if (keyIs(keyBegin, keyEnd, "Msg")) {
+            return cursor.readStringValue(&ret->message);
+        }
+        if (keyIs(keyBegin, keyEnd, "Ext") && '{' == cursor.peek()) {
+            return cursor.readObject(readExt);
+        }
+        return cursor.skipValue();
+    });
 
-    auto extObj = rootObj.value(kFieldExt).toObject();
-    if (!extObj.isEmpty()) {
-        ret->ext.code = extObj.value(kFieldCode).toInt();
-        ret->ext.detailMessage = extObj.value(kFieldMsg);
+    if (!parsed) {
+        parseFailed(cursor);
+        return {};
     }
 
     return ret;
@@ -56,40 +414,44 @@ CompatibleRet::Ptr CompatibleJsonParser::parseCommonField(const QByteArray &json
 
 QHash<QString, CompPkgInfo::Ptr> CompatibleJsonParser::parseAppList(const CompatibleRet::Ptr &ret)
 {
-    if (ret.isNull() || CompError == ret->code) {
+    if (ret.isNull() || CompError == ret->code || ret->ext.detailMessage.isEmpty()) {
         return {};
     }
 
-    auto array = ret->ext.detailMessage.toArray();
-    if (array.empty()) {
-        return {};
-    }
-
-    QString listJson = array.first().toString();
+    const QByteArray &payload = ret->ext.detailMessage;
+    JsonCursor cursor(payload.constData(), payload.constData() + payload.size());
     // remove unnecessary prefix
-    listJson.remove(QRegularExpression("^[^\[]*"));
-
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(listJson.toUtf8(), &err);
-    if (QJsonParseError::NoError != err.error) {
-        qWarning() << QString("Parse compatible result failed: %1 offset:%2").arg(err.errorString()).arg(err.offset);
+    if (!cursor.seek('[')) {
         return {};
     }
 
-    array = doc.array();
     QHash<QString, CompPkgInfo::Ptr> packages;
-    for (const QJsonValue &item : array) {
-        if (!item.isObject()) {
-            continue;
+    const bool parsed = cursor.readArray([&]() {
+        if ('{' != cursor.peek()) {
+            return cursor.skipValue();
         }
-        auto obj = item.toObject();
 
         auto pkgPtr = CompPkgInfo::Ptr::create();
-        pkgPtr->name = obj.value("name").toString();
-        pkgPtr->version = obj.value("version").toString();
-        pkgPtr->arch = obj.value("arch").toString();
+        const bool itemParsed = cursor.readObject([&](const char *keyBegin, const char *keyEnd) {
+            if (keyIs(keyBegin, keyEnd, "name")) {
+                return cursor.readStringValue(&pkgPtr->name);
+            }
+            if (keyIs(keyBegin, keyEnd, "version")) {
+                return cursor.readStringValue(&pkgPtr->version);
+            }
+            if (keyIs(keyBegin, keyEnd, "arch")) {
+                return cursor.readStringValue(&pkgPtr->arch);
+            }
+            return cursor.skipValue();
+        });
 
         packages.insert(pkgPtr->name, pkgPtr);
+        return itemParsed;
+    });
+
+    if (!parsed) {
+        parseFailed(cursor);
+        return {};
     }
 
     return packages;
@@ -103,41 +465,53 @@ QList<RootfsInfo::Ptr> CompatibleJsonParser::parseRootfsList(const CompatibleRet
        }\n  ]\n}"]}}
      */
 
-    if (ret.isNull() || CompError == ret->code) {
-        return {};
-    }
-
-    auto array = ret->ext.detailMessage.toArray();
-    if (array.empty()) {
+    if (ret.isNull() || CompError == ret->code || ret->ext.detailMessage.isEmpty()) {
         return {};
     }
 
-    QString listJson = array.first().toString();
+    const QByteArray &payload = ret->ext.detailMessage;
+    JsonCursor cursor(payload.constData(), payload.constData() + payload.size());
     // remove unnecessary prefix
-    listJson.remove(QRegularExpression("^[^\[]*"));
-
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(listJson.toUtf8(), &err);
-    if (QJsonParseError::NoError != err.error) {
-        qWarning() << QString("Parse compatible result failed: %1 offset:%2").arg(err.errorString()).arg(err.offset);
+    if (!cursor.seekContainer()) {
         return {};
     }
 
-    auto rootObj = doc.object();
-    auto containerArray = rootObj.value("Containers").toArray();
     QList<RootfsInfo::Ptr> rootfs;
+    auto readContainers = [&]() {
+        return cursor.readArray([&]() {
+            if ('{' != cursor.peek()) {
+                return cursor.skipValue();
+            }
+
+            auto rootfsPtr = RootfsInfo::Ptr::create();
+            const bool itemParsed = cursor.readObject([&](const char *keyBegin, const char *keyEnd) {
+                if (keyIs(keyBegin, keyEnd, "Name")) {
+                    return cursor.readStringValue(&rootfsPtr->name);
+                }
+                return cursor.skipValue();
+            });
+
+            rootfsPtr->osName = rootfsPtr->name;
+            rootfs.append(rootfsPtr);
+            return itemParsed;
+        });
+    };
+
+    bool parsed = false;
+    if ('[' == cursor.peek()) {
+        parsed = readContainers();
+    } else {
+        parsed = cursor.readObject([&](const char *keyBegin, const char *keyEnd) {
+            if (keyIs(keyBegin, keyEnd, "Containers") && '[' == cursor.peek()) {
+                return readContainers();
+            }
+            return cursor.skipValue();
+        });
+    }
 
-    for (const QJsonValue &item : containerArray) {
-        if (!item.isObject()) {
-            continue;
-        }
-        auto obj = item.toObject();
-
-        auto rootfsPtr = RootfsInfo::Ptr::create();
-        rootfsPtr->name = obj.value("Name").toString();
-        rootfsPtr->osName = rootfsPtr->name;
-
-        rootfs.append(rootfsPtr);
+    if (!parsed) {
+        parseFailed(cursor);
+        return {};
     }
 
     return rootfs;
@@ -151,39 +525,37 @@ QList<RootfsInfo::Ptr> CompatibleJsonParser::parseSupportfsList(const Compatible
        {"Code":0,"Msg":null,"Ext":{"Code":0,"Msg":["失败 [\n \"NOTFOUND\" \n]"]}}
      */
 
-    if (ret.isNull() || CompError == ret->code) {
-        return {};
-    }
-
-    auto array = ret->ext.detailMessage.toArray();
-    if (array.empty()) {
+    if (ret.isNull() || CompError == ret->code || ret->ext.detailMessage.isEmpty()) {
         return {};
     }
 
-    QString listJson = array.first().toString();
+    const QByteArray &payload = ret->ext.detailMessage;
+    JsonCursor cursor(payload.constData(), payload.constData() + payload.size());
     // remove unnecessary prefix
-    listJson.remove(QRegularExpression("^[^\[]*"));
-
-    QJsonParseError err;
-    QJsonDocument doc = QJsonDocument::fromJson(listJson.toUtf8(), &err);
-    if (QJsonParseError::NoError != err.error) {
-        qWarning() << QString("Parse compatible result failed: %1 offset:%2").arg(err.errorString()).arg(err.offset);
+    if (!cursor.seek('[')) {
         return {};
     }
 
-    array = doc.array();
     QList<RootfsInfo::Ptr> supportRootfs;
+    const auto rootfsList = CompBackend::instance()->rootfsList();
 
-    auto rootfsList = CompBackend::instance()->rootfsList();
-
-    for (const QJsonValue &item : array) {
-        QString itemStr = item.toString();
+    QString itemStr;
+    const bool parsed = cursor.readArray([&]() {
+        if (!cursor.readStringValue(&itemStr)) {
+            return false;
+        }
 
         auto findItr = std::find_if(
             rootfsList.begin(), rootfsList.end(), [&](const RootfsInfo::Ptr &rootfsPtr) { return rootfsPtr->name == itemStr; });
         if (findItr != rootfsList.end()) {
             supportRootfs.append(*findItr);
         }
+        return true;
+    });
+
+    if (!parsed) {
+        parseFailed(cursor);
+        return {};
     }
 
     return supportRootfs;
@@ -5,7 +5,7 @@
 #ifndef COMPATIBLE_JSON_PARSER_H
 #define COMPATIBLE_JSON_PARSER_H
 
-#include <QJsonValue>
+#include <QByteArray>
 
 #include "compatible_defines.h"
 
@@ -20,7 +20,7 @@ struct CompatibleRet
     struct Ext
     {
         int code{0};
-        QJsonValue detailMessage;
+        QByteArray detailMessage;  // first message, decoded json string
     } ext;  // detail info
 };
 
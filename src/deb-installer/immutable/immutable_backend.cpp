@@ -4,7 +4,14 @@
 
 #include "immutable_backend.h"
 
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFutureInterface>
 #include <QProcess>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace Immutable {
 
@@ -13,10 +20,21 @@ static const QString kImmutableStatus = "-s";
 // return e.g. : "immutable mode:[true|false]"
 static const QByteArray kImmutableEnable = "true";
 
+static const QString kBootIdFile = "/proc/sys/kernel/random/boot_id";
+static const QString kCacheFileName = "immutable-status";
+
+static QFuture<bool> readyFuture(bool value)
+{
+    QFutureInterface<bool> futureInterface;
+    futureInterface.reportStarted();
+    futureInterface.reportResult(value);
+    futureInterface.reportFinished();
+    return futureInterface.future();
+}
+
 ImmutableBackend::ImmutableBackend(QObject *parent)
     : QObject{parent}
 {
-    initBackend();
 }
 
 ImmutableBackend *ImmutableBackend::instance()
@@ -25,12 +43,44 @@ ImmutableBackend *ImmutableBackend::instance()
     return &ins;
 }
 
+void ImmutableBackend::initBackend(bool async)
+{
+    std::call_once(m_initFlag, [this, async]() {
+        // not an immutable system, no need to ask.
+        if (QStandardPaths::findExecutable(kImmutableBin).isEmpty()) {
+            m_detectFuture = readyFuture(false);
+            return;
+        }
+
+        const QByteArray boot = bootId();
+        bool enabled = false;
+        if (loadCache(boot, &enabled)) {
+            m_detectFuture = readyFuture(enabled);
+            return;
+        }
+
+        auto detect = [boot]() {
+            const bool result = detectImmutable();
+            saveCache(boot, result);
+            return result;
+        };
+        m_detectFuture = async ? QtConcurrent::run(detect) : readyFuture(detect());
+    });
+}
+
 bool ImmutableBackend::immutableEnabled() const
 {
-    return m_immutableEnabled;
+    return immutableEnabledFuture().result();
 }
 
-void ImmutableBackend::initBackend()
+QFuture<bool> ImmutableBackend::immutableEnabledFuture() const
+{
+    // detect on first use if not started with the deb backend.
+    const_cast<ImmutableBackend *>(this)->initBackend();
+    return m_detectFuture;
+}
+
+bool ImmutableBackend::detectImmutable()
 {
     QProcess process;
     process.setProgram(kImmutableBin);
@@ -39,7 +89,59 @@ void ImmutableBackend::initBackend()
     process.waitForFinished();
     const QByteArray output = process.readAllStandardOutput();
 
-    m_immutableEnabled = output.contains(kImmutableEnable);
+    const bool enabled = output.contains(kImmutableEnable);
+    qInfo() << "[ImmutableBackend]" << "immutable mode:" << enabled;
+    return enabled;
+}
+
+QByteArray ImmutableBackend::bootId()
+{
+    QFile file(kBootIdFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return file.readAll().trimmed();
+}
+
+QString ImmutableBackend::cacheFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QDir::separator() + kCacheFileName;
+}
+
+bool ImmutableBackend::loadCache(const QByteArray &boot, bool *enabled)
+{
+    if (boot.isEmpty()) {
+        return false;
+    }
+
+    // e.g.: "<boot id> true"
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QList<QByteArray> fields = file.readAll().trimmed().split(' ');
+    if (2 != fields.size() || fields.first() != boot) {
+        return false;
+    }
+
+    *enabled = (kImmutableEnable == fields.last());
+    return true;
+}
+
+void ImmutableBackend::saveCache(const QByteArray &boot, bool enabled)
+{
+    if (boot.isEmpty()) {
+        return;
+    }
+
+    QDir().mkpath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    QSaveFile file(cacheFilePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    file.write(boot + ' ' + (enabled ? kImmutableEnable : QByteArray("false")) + '\n');
+    file.commit();
 }
 
 };  // namespace Immutable
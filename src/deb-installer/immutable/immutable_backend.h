@@ -6,6 +6,9 @@
 #define IMMUTABLEBACKEND_H
 
 #include <QObject>
+#include <QFuture>
+
+#include <mutex>
 
 namespace Immutable {
 
@@ -16,15 +19,27 @@ class ImmutableBackend : public QObject
 public:
     static ImmutableBackend *instance();
 
+    // Start the detection, started with the deb backend init. The immutable state
+    // can not change before reboot, the result is cached per boot id.
+    void initBackend(bool async = true);
+
+    // wait for the detection if it is still running.
     [[nodiscard]] bool immutableEnabled() const;
+    // finished immediately if the result is known, e.g. no immutable control tool.
+    [[nodiscard]] QFuture<bool> immutableEnabledFuture() const;
 
 private:
     explicit ImmutableBackend(QObject *parent = nullptr);
     ~ImmutableBackend() override = default;
 
-    void initBackend();
+    [[nodiscard]] static bool detectImmutable();
+    [[nodiscard]] static QByteArray bootId();
+    [[nodiscard]] static QString cacheFilePath();
+    static bool loadCache(const QByteArray &boot, bool *enabled);
+    static void saveCache(const QByteArray &boot, bool enabled);
 
-    bool m_immutableEnabled{false};
+    std::once_flag m_initFlag;
+    QFuture<bool> m_detectFuture;
 
     Q_DISABLE_COPY(ImmutableBackend);
 };
@@ -171,7 +171,9 @@ void ImmutableProcessController::onFinished(int exitCode, int exitStatus)
                 static const int kMaxCheckLen = 512;
                 for (int i = m_outputList.size() - 1; i >= qMax(0, m_outputList.size() - kMaxCheckLen); --i) {
                     if (HierarchicalVerify::instance()->checkTransactionError(m_currentPackage->debInfo()->packageName(),
-                                                                              m_outputList.at(i))) {
+                                                                              m_outputList.at(i),
+                                                                              m_currentPackage->debInfo()->version(),
+                                                                              m_currentPackage->md5())) {
                         // mark hierachical verify failed
                         m_currentPackage->setError(Pkg::DigitalSignatureError, {});
                     }
@@ -8,6 +8,8 @@
 #include "singleInstallerApplication.h"
 #include "environments.h"
 #include "utils/eventlogutils.h"
+#include "utils/metrics.h"
+#include "utils/trace.h"
 
 #include <QCommandLineParser>
 #include <QDebug>
@@ -61,6 +63,11 @@ int main(int argc, char *argv[])
 
     qInfo() << qApp->applicationName() << "started, version = " << qApp->applicationVersion();
 
+    // 性能追踪，DEB_INSTALLER_TRACE 或配置文件开启
+    Trace::Tracer::instance()->initFromEnvironment();
+    // 运行指标文件，DEB_INSTALLER_METRICS_TEXTFILE 或配置文件开启
+    Metrics::Registry::instance()->initFromEnvironment();
+
     QDBusConnection dbus = QDBusConnection::sessionBus();
     if (app.parseCmdLine()) {
         app.activateWindow();
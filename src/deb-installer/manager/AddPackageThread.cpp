@@ -5,6 +5,7 @@
 #include "AddPackageThread.h"
 #include "packagesmanager.h"
 #include "utils/utils.h"
+#include "utils/trace.h"
 
 #include <QApt/Backend>
 #include <QApt/DebFile>
@@ -81,6 +82,7 @@ QString AddPackageThread::dealPackagePath(const QString &packagePath)
 
 void AddPackageThread::run()
 {
+    Trace::ScopedSpan runSpan(Trace::kCatAppend, "AddPackageThread::run", QString::number(m_packages.size()));
     for (QString debPackage : m_packages) {
         // 处理包不在本地的情况。
         if (!dealInvalidPackage(debPackage)) {
@@ -94,6 +96,7 @@ void AddPackageThread::run()
             continue;
         }
 
+        Trace::ScopedSpan packageSpan(Trace::kCatAppend, "add_package", debPackage);
         QApt::DebFile pkgFile(debPackage);
         // 判断当前文件是否是无效文件
         if (!pkgFile.isValid()) {
@@ -104,12 +107,16 @@ void AddPackageThread::run()
         // 获取当前文件的md5的值,防止重复添加
         // 先查看之前检测包有效性时是否获取过md5
         QByteArray md5 = m_allPackages.value(debPkg);
-        if (md5.isEmpty())
+        if (md5.isEmpty()) {
+            Trace::ScopedSpan hashSpan(Trace::kCatAnalyze, "md5sum", debPackage);
             md5 = pkgFile.md5Sum();
+            Metrics::add(Metrics::HashedBytes, static_cast<quint64>(QFileInfo(debPackage).size()));
+        }
 
         // 如果当前已经存在此md5的包,则说明此包已经添加到程序中
         if (m_appendedPackagesMd5.contains(md5)) {
             // 处理重复文件
+            Metrics::add(Metrics::PackagesDeduped);
             Q_EMIT signalAppendFailMessage(Pkg::PackageAlreadyExists);
             continue;
         }
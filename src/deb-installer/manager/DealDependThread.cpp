@@ -44,8 +44,8 @@ void DealDependThread::slotReadOutput()
         emit signalDependResult(DebListModel::CancelAuth, m_index, m_brokenDepend);
     }
 
-    // 检测是否包含分级验签错误信息
-    if (HierarchicalVerify::instance()->checkTransactionError(m_brokenDepend, tmp)) {
+    // 检测是否包含分级验签错误信息，wine依赖来自仓库而非本地deb包，不记录校验结果
+    if (HierarchicalVerify::isVerifyError(tmp)) {
         bVerifyStatusErr = true;
         qWarning() << QString("[Hierarchical] Install Wine dependency not verify, [output]: %1").arg(tmp);
         // 结束后统一发送信号
@@ -61,6 +61,7 @@ void DealDependThread::run()
     bVerifyStatusErr = false;
 
     emit signalDependResult(DebListModel::AuthBefore, m_index, m_brokenDepend);
+    m_procSpan.begin(m_dependsList.join(' '));
     proc->start("pkexec",
                 QStringList() << "deepin-deb-installer-dependsInstall"
                               << "--install_wine" << m_dependsList);
@@ -69,6 +70,8 @@ void DealDependThread::run()
 
 void DealDependThread::slotInstallFinished(int num = -1)
 {
+    m_procSpan.end();
+
     if (bDependsStatusErr) {
         emit signalDependResult(DebListModel::AnalysisErr, m_index, m_brokenDepend);
         bDependsStatusErr = false;
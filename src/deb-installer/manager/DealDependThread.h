@@ -5,6 +5,8 @@
 #ifndef DEALDEPENDTHREAD_H
 #define DEALDEPENDTHREAD_H
 
+#include "utils/trace.h"
+
 #include <QObject>
 #include <QThread>
 #include <QProcess>
@@ -60,6 +62,9 @@ private:
     // 执行下载的进程指针
     QProcess *proc = nullptr;
 
+    // 依赖下载进程的耗时
+    Trace::AsyncSpan m_procSpan{Trace::kCatProcess, "install_wine_depends"};
+
     // 出现问题依赖的下标
     int m_index = -1;
 
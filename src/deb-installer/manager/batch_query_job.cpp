@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "batch_query_job.h"
+
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+
+BatchQueryJob::BatchQueryJob(const QString &jobId, const QStringList &paths, QObject *parent)
+    : QObject(parent)
+    , m_jobId(jobId)
+    , m_paths(paths)
+{
+}
+
+BatchQueryJob::~BatchQueryJob() = default;
+
+void BatchQueryJob::setMainThreadCheck(const Check &check)
+{
+    m_mainThreadCheck = check;
+}
+
+void BatchQueryJob::setConcurrentCheck(const Check &check)
+{
+    m_concurrentCheck = check;
+}
+
+/**
+   @brief Start the job on next event loop iteration, so the job id can be returned to the caller
+    before any result is reported.
+ */
+void BatchQueryJob::start()
+{
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+
+    QTimer::singleShot(0, this, &BatchQueryJob::processNext);
+}
+
+void BatchQueryJob::processNext()
+{
+    if (m_paths.isEmpty()) {
+        Q_EMIT finished(m_jobId);
+        return;
+    }
+
+    const QString path = m_paths.at(m_nextIndex++);
+
+    QVariant result;
+    if (m_mainThreadCheck) {
+        result = m_mainThreadCheck(path);
+    }
+
+    if (!result.isValid() && m_concurrentCheck) {
+        runConcurrent(path);
+    } else {
+        deliver(path, result);
+    }
+
+    // yield to the event loop between packages, keep the dbus / ui responsive.
+    if (m_nextIndex < m_paths.size()) {
+        QTimer::singleShot(0, this, &BatchQueryJob::processNext);
+    }
+}
+
+void BatchQueryJob::runConcurrent(const QString &path)
+{
+    auto watcher = new QFutureWatcher<QVariant>(this);
+    connect(watcher, &QFutureWatcher<QVariant>::finished, this, [this, watcher, path]() {
+        deliver(path, watcher->result());
+        watcher->deleteLater();
+    });
+
+    const Check check = m_concurrentCheck;
+    watcher->setFuture(QtConcurrent::run(QThreadPool::globalInstance(), [check, path]() { return check(path); }));
+}
+
+void BatchQueryJob::deliver(const QString &path, const QVariant &result)
+{
+    ++m_finishedCount;
+    Q_EMIT resultReady(m_jobId, path, result);
+    Q_EMIT progressChanged(m_jobId, m_finishedCount, m_paths.size());
+
+    if (isFinished()) {
+        Q_EMIT finished(m_jobId);
+    }
+}
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BATCH_QUERY_JOB_H
+#define BATCH_QUERY_JOB_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVariant>
+
+#include <functional>
+
+/**
+   @brief Query the status of a batch of packages without blocking the caller.
+
+    Each package first passes the main thread check (apt backend / model access,
+    not thread safe), one package per event loop iteration. If the main thread
+    check returns an invalid QVariant, the package is passed to the concurrent
+    check running on the global thread pool.
+    Results are reported as soon as each package finished, not in input order.
+ */
+class BatchQueryJob : public QObject
+{
+    Q_OBJECT
+public:
+    using Check = std::function<QVariant(const QString &)>;
+
+    explicit BatchQueryJob(const QString &jobId, const QStringList &paths, QObject *parent = nullptr);
+    ~BatchQueryJob() override;
+
+    void setMainThreadCheck(const Check &check);
+    void setConcurrentCheck(const Check &check);
+
+    void start();
+
+    [[nodiscard]] QString jobId() const { return m_jobId; }
+    [[nodiscard]] int total() const { return m_paths.size(); }
+    [[nodiscard]] int finishedCount() const { return m_finishedCount; }
+    [[nodiscard]] bool isFinished() const { return m_finishedCount == m_paths.size(); }
+
+Q_SIGNALS:
+    void resultReady(const QString &jobId, const QString &path, const QVariant &result);
+    void progressChanged(const QString &jobId, int finished, int total);
+    void finished(const QString &jobId);
+
+private:
+    void processNext();
+    void runConcurrent(const QString &path);
+    void deliver(const QString &path, const QVariant &result);
+
+    QString m_jobId;
+    QStringList m_paths;
+    int m_nextIndex{0};
+    int m_finishedCount{0};
+    bool m_started{false};
+
+    Check m_mainThreadCheck;
+    Check m_concurrentCheck;
+};
+
+#endif  // BATCH_QUERY_JOB_H
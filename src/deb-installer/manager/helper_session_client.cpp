@@ -0,0 +1,330 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "helper_session_client.h"
+#include "process/Pty.h"
+#include "process/helper_session_protocol.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSocketNotifier>
+#include <QStandardPaths>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const QString kPkexecBin = "pkexec";
+static const QString kInstallProcessorBin = "deepin-deb-installer-dependsInstall";
+
+HelperSessionClient::HelperSessionClient(Konsole::Pty *pty, QObject *parent)
+    : QObject(parent)
+    , m_pty(pty)
+{
+    connect(m_pty, &Konsole::Pty::receivedData, this, &HelperSessionClient::onReceivedData);
+    connect(m_pty,
+            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this,
+            &HelperSessionClient::onProcessFinished);
+}
+
+HelperSessionClient::~HelperSessionClient()
+{
+    closeListener();
+    closeChannel();
+}
+
+void HelperSessionClient::submit(const QStringList &arguments)
+{
+    m_jobs.append(arguments);
+
+    if (NotRunning == m_state) {
+        startSession();
+    }
+    // otherwise started after authorization or the current job,
+    // or by a new session once the quitting one exits.
+}
+
+void HelperSessionClient::startSession()
+{
+    m_state = Starting;
+    m_buffer.clear();
+
+    if (!listenChannel()) {
+        m_state = NotRunning;
+        dropJobs(-1);
+        return;
+    }
+
+    // e.g.: pkexec deepin-deb-installer-dependsInstall --session [channel]
+    m_pty->start(kPkexecBin, {kPkexecBin, kInstallProcessorBin, HelperSession::kParamSession, m_channelPath}, {}, 0, false);
+}
+
+void HelperSessionClient::startNextJob()
+{
+    if (m_jobs.isEmpty()) {
+        m_state = Quitting;
+        writeLine(HelperSession::kJobQuit);
+        return;
+    }
+
+    m_state = Running;
+    const QStringList arguments = m_jobs.takeFirst();
+    writeLine(QJsonDocument(QJsonArray::fromStringList(arguments)).toJson(QJsonDocument::Compact));
+}
+
+void HelperSessionClient::writeLine(const QByteArray &line)
+{
+    if (m_channelFd < 0) {
+        return;
+    }
+
+    const QByteArray data = line + '\n';
+    const char *pos = data.constData();
+    size_t remain = static_cast<size_t>(data.size());
+    while (remain > 0) {
+        const ssize_t written = ::send(m_channelFd, pos, remain, MSG_NOSIGNAL);
+        if (written < 0 && (EINTR == errno || EAGAIN == errno)) {
+            continue;
+        }
+        if (written <= 0) {
+            qWarning() << "[HelperSession] write channel failed:" << ::strerror(errno);
+            return;
+        }
+        pos += written;
+        remain -= static_cast<size_t>(written);
+    }
+}
+
+/**
+   @brief The session did not run the queued jobs, report the first one failed with \a exitCode .
+ */
+void HelperSessionClient::dropJobs(int exitCode)
+{
+    if (!m_jobs.isEmpty()) {
+        m_jobs.removeFirst();
+    }
+    if (!m_jobs.isEmpty()) {
+        qWarning() << "[HelperSession] drop" << m_jobs.size() << "queued jobs";
+        m_jobs.clear();
+    }
+
+    Q_EMIT jobFinished(exitCode, {});
+}
+
+/**
+   @brief Listen on a private socket in the runtime directory, the helper connects to it once authorized.
+ */
+bool HelperSessionClient::listenChannel()
+{
+    closeListener();
+    closeChannel();
+
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (dir.isEmpty()) {
+        dir = QDir::tempPath();
+    }
+    m_channelPath = QString("%1/deepin-deb-installer-%2-%3.session")
+                        .arg(dir)
+                        .arg(QCoreApplication::applicationPid())
+                        .arg(reinterpret_cast<quintptr>(this), 0, 16);
+
+    struct ::sockaddr_un addr;
+    ::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    const QByteArray path = QFile::encodeName(m_channelPath);
+    if (path.size() >= static_cast<int>(sizeof(addr.sun_path))) {
+        qWarning() << "[HelperSession] channel path too long:" << m_channelPath;
+        return false;
+    }
+    ::memcpy(addr.sun_path, path.constData(), static_cast<size_t>(path.size()));
+
+    ::unlink(path.constData());
+    m_listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (m_listenFd < 0 || 0 != ::bind(m_listenFd, reinterpret_cast<struct ::sockaddr *>(&addr), sizeof(addr)) ||
+        0 != ::listen(m_listenFd, 4)) {
+        qWarning() << "[HelperSession] listen channel failed:" << ::strerror(errno);
+        closeListener();
+        return false;
+    }
+
+    m_listenNotifier = new QSocketNotifier(m_listenFd, QSocketNotifier::Read, this);
+    connect(m_listenNotifier, &QSocketNotifier::activated, this, &HelperSessionClient::onChannelConnected);
+    return true;
+}
+
+void HelperSessionClient::closeListener()
+{
+    if (m_listenNotifier) {
+        m_listenNotifier->setEnabled(false);
+        m_listenNotifier->deleteLater();
+        m_listenNotifier = nullptr;
+    }
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        m_listenFd = -1;
+        ::unlink(QFile::encodeName(m_channelPath).constData());
+    }
+}
+
+void HelperSessionClient::closeChannel()
+{
+    if (m_channelNotifier) {
+        m_channelNotifier->setEnabled(false);
+        m_channelNotifier->deleteLater();
+        m_channelNotifier = nullptr;
+    }
+    if (m_channelFd >= 0) {
+        ::close(m_channelFd);
+        m_channelFd = -1;
+    }
+    m_buffer.clear();
+}
+
+/**
+   @return true if the peer of \a fd is root with the process id \a pid ,
+    pkexec executes the helper in place, so it keeps the pid of the started process.
+ */
+bool HelperSessionClient::isTrustedPeer(int fd, qint64 pid)
+{
+    struct ::ucred cred;
+    ::socklen_t length = sizeof(cred);
+    if (0 != ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &length)) {
+        return false;
+    }
+
+    return pid > 0 && 0 == cred.uid && pid == cred.pid;
+}
+
+void HelperSessionClient::onChannelConnected()
+{
+    const int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+    if (fd < 0) {
+        return;
+    }
+
+    if (Starting != m_state || !isTrustedPeer(fd, m_pty->processId())) {
+        qWarning() << "[HelperSession] reject untrusted channel peer";
+        ::close(fd);
+        return;
+    }
+
+    // only the helper is accepted
+    closeListener();
+    m_channelFd = fd;
+    m_channelNotifier = new QSocketNotifier(m_channelFd, QSocketNotifier::Read, this);
+    connect(m_channelNotifier, &QSocketNotifier::activated, this, &HelperSessionClient::onChannelReadyRead);
+}
+
+void HelperSessionClient::onChannelReadyRead()
+{
+    char data[4096];
+    while (m_channelFd >= 0) {
+        const ssize_t readed = ::recv(m_channelFd, data, sizeof(data), 0);
+        if (readed < 0 && EINTR == errno) {
+            continue;
+        }
+        if (readed < 0 && EAGAIN == errno) {
+            break;
+        }
+        if (readed <= 0) {
+            // the helper exited, handled in onProcessFinished()
+            closeChannel();
+            return;
+        }
+        m_buffer.append(data, static_cast<int>(readed));
+    }
+
+    int index = -1;
+    while (-1 != (index = m_buffer.indexOf('\n'))) {
+        const QByteArray event = m_buffer.left(index);
+        m_buffer.remove(0, index + 1);
+        handleEvent(event);
+    }
+    if (m_buffer.size() > HelperSession::kMaxLineSize) {
+        qWarning() << "[HelperSession] channel line too long";
+        m_buffer.clear();
+    }
+}
+
+/**
+   @brief Forward the job output, the output never changes the session state.
+ */
+void HelperSessionClient::onReceivedData(const char *data, int length, bool isCommandExec)
+{
+    Q_EMIT outputReceived(data, length, isCommandExec);
+}
+
+void HelperSessionClient::handleEvent(const QByteArray &event)
+{
+    static const int kFinishedSize = static_cast<int>(sizeof(HelperSession::kEventFinished) - 1);
+
+    if (event == HelperSession::kEventReady) {
+        if (Starting != m_state) {
+            return;
+        }
+
+        qInfo() << "[HelperSession] session ready";
+        startNextJob();
+
+    } else if (event.startsWith(HelperSession::kEventFinished)) {
+        // finished;<code>[;<package result>...]
+        const QList<QByteArray> fields = event.mid(kFinishedSize).split(HelperSession::kEventResultSeparator);
+        bool ok = false;
+        const int exitCode = fields.first().toInt(&ok);
+        QList<int> packageResults;
+        for (int i = 1; ok && i < fields.size(); ++i) {
+            packageResults << fields.at(i).toInt(&ok);
+        }
+        if (Running != m_state) {
+            return;
+        }
+
+        // forward the output of the job still buffered in the pty before the result.
+        if (m_pty->pty()->isOpen()) {
+            m_pty->pty()->waitForReadyRead(0);
+        }
+
+        // the receiver may submit the next job, queue it before the session quits.
+        Q_EMIT jobFinished(ok ? exitCode : -1, ok ? packageResults : QList<int>());
+        if (Running == m_state) {
+            startNextJob();
+        }
+
+    } else {
+        qWarning() << "[HelperSession] unknown session event:" << event;
+    }
+}
+
+void HelperSessionClient::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    const State state = m_state;
+    m_state = NotRunning;
+    closeListener();
+    closeChannel();
+
+    qInfo() << "[HelperSession] session exit" << exitCode << exitStatus;
+
+    // session exited without finishing the job, e.g. authorization canceled.
+    if (Starting == state) {
+        dropJobs(0 == exitCode && QProcess::NormalExit == exitStatus ? -1 : exitCode);
+    } else if (Running == state) {
+        if (!m_jobs.isEmpty()) {
+            qWarning() << "[HelperSession] drop" << m_jobs.size() << "queued jobs";
+            m_jobs.clear();
+        }
+        Q_EMIT jobFinished(0 == exitCode && QProcess::NormalExit == exitStatus ? -1 : exitCode, {});
+    } else if (Quitting == state && !m_jobs.isEmpty()) {
+        // jobs submitted after the quit job was written.
+        startSession();
+    }
+}
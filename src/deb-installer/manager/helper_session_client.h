@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HELPER_SESSION_CLIENT_H
+#define HELPER_SESSION_CLIENT_H
+
+#include <QObject>
+#include <QList>
+#include <QStringList>
+#include <QProcess>
+
+class QSocketNotifier;
+
+namespace Konsole {
+class Pty;
+}  // namespace Konsole
+
+/**
+   @brief Client of the privileged helper session.
+
+    The helper `deepin-deb-installer-dependsInstall --session` is started
+    through pkexec on the first submitted job, jobs queued meanwhile run in the
+    same session. A batch install pays the polkit authorization and the helper
+    startup once instead of once per package. The session quits as soon as the
+    queue drains, the root helper is not kept waiting for jobs.
+    The job output on the pty is forwarded as is. Jobs and job status use a
+    private unix socket, the helper is accepted by its credentials.
+    @sa helper_session_protocol.h
+ */
+class HelperSessionClient : public QObject
+{
+    Q_OBJECT
+public:
+    explicit HelperSessionClient(Konsole::Pty *pty, QObject *parent = nullptr);
+    ~HelperSessionClient() override;
+
+    // queue the job with one-shot mode \a arguments, e.g. {"--install_config", debPath}
+    void submit(const QStringList &arguments);
+
+    [[nodiscard]] bool isRunning() const { return NotRunning != m_state; }
+    [[nodiscard]] bool isBusy() const { return Running == m_state || !m_jobs.isEmpty(); }
+
+Q_SIGNALS:
+    void outputReceived(const char *data, int length, bool isCommandExec);
+    // the current job finished, or the session exited before, e.g. authorization canceled.
+    // \a packageResults holds the result of each package of a batch job, empty otherwise.
+    void jobFinished(int exitCode, const QList<int> &packageResults);
+
+private:
+    enum State {
+        NotRunning,
+        Starting,  // waiting for authorization and the channel
+        Running,
+        Quitting,  // queue drained, waiting for the helper exit
+    };
+
+    void startSession();
+    void startNextJob();
+    void writeLine(const QByteArray &line);
+    void dropJobs(int exitCode);
+
+    bool listenChannel();
+    void closeListener();
+    void closeChannel();
+    static bool isTrustedPeer(int fd, qint64 pid);
+
+    void onChannelConnected();
+    void onChannelReadyRead();
+    void onReceivedData(const char *data, int length, bool isCommandExec);
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void handleEvent(const QByteArray &event);
+
+    Konsole::Pty *m_pty{nullptr};
+    State m_state{NotRunning};
+    QList<QStringList> m_jobs;
+
+    QString m_channelPath;
+    int m_listenFd{-1};
+    int m_channelFd{-1};
+    QSocketNotifier *m_listenNotifier{nullptr};
+    QSocketNotifier *m_channelNotifier{nullptr};
+    QByteArray m_buffer;  // received channel data not handled as line yet
+};
+
+#endif  // HELPER_SESSION_CLIENT_H
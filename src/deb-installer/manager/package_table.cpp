@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "package_table.h"
+#include "utils/deb_package.h"
+
+void PackageRecord::resetOperation()
+{
+    operateStatus = Pkg::Prepare;
+    failCode = 0;
+    failReason.clear();
+}
+
+PackageHandle PackageTable::append(const QString &filePath, const QByteArray &md5)
+{
+    if (m_md5Index.contains(md5)) {
+        return {};
+    }
+
+    int slot = -1;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<int>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    Slot &current = m_slots[static_cast<size_t>(slot)];
+    current.used = true;
+    current.record.filePath = filePath;
+    current.record.md5 = md5;
+    current.row = m_rows.size();
+
+    const PackageHandle newHandle{slot, current.generation};
+    m_rows.append(newHandle);
+    m_md5Index.insert(md5, newHandle);
+    return newHandle;
+}
+
+bool PackageTable::remove(PackageHandle handle)
+{
+    if (!isAlive(handle)) {
+        return false;
+    }
+
+    const int row = m_slots[static_cast<size_t>(handle.slot)].row;
+    m_rows.remove(row);
+    releaseSlot(handle.slot);
+    refreshRows(row);
+    return true;
+}
+
+bool PackageTable::removeAt(int row)
+{
+    return remove(handleAt(row));
+}
+
+void PackageTable::clear()
+{
+    for (const PackageHandle &rowHandle : m_rows) {
+        releaseSlot(rowHandle.slot);
+    }
+    m_rows.clear();
+    m_md5Index.clear();
+}
+
+bool PackageTable::isAlive(PackageHandle handle) const
+{
+    if (handle.slot < 0 || handle.slot >= static_cast<int>(m_slots.size())) {
+        return false;
+    }
+
+    const Slot &current = m_slots[static_cast<size_t>(handle.slot)];
+    return current.used && current.generation == handle.generation;
+}
+
+PackageHandle PackageTable::handleAt(int row) const
+{
+    if (row < 0 || row >= m_rows.size()) {
+        return {};
+    }
+    return m_rows.at(row);
+}
+
+int PackageTable::rowOf(PackageHandle handle) const
+{
+    if (!isAlive(handle)) {
+        return -1;
+    }
+    return m_slots[static_cast<size_t>(handle.slot)].row;
+}
+
+PackageRecord *PackageTable::record(PackageHandle handle)
+{
+    if (!isAlive(handle)) {
+        return nullptr;
+    }
+    return &m_slots[static_cast<size_t>(handle.slot)].record;
+}
+
+const PackageRecord *PackageTable::record(PackageHandle handle) const
+{
+    if (!isAlive(handle)) {
+        return nullptr;
+    }
+    return &m_slots[static_cast<size_t>(handle.slot)].record;
+}
+
+QString PackageTable::filePathAt(int row) const
+{
+    if (auto current = recordAt(row)) {
+        return current->filePath;
+    }
+    return {};
+}
+
+QByteArray PackageTable::md5At(int row) const
+{
+    if (auto current = recordAt(row)) {
+        return current->md5;
+    }
+    return {};
+}
+
+void PackageTable::setRowOrder(const QList<QByteArray> &md5Order)
+{
+    QVector<PackageHandle> rows;
+    rows.reserve(m_rows.size());
+
+    for (const QByteArray &md5 : md5Order) {
+        const PackageHandle orderHandle = handle(md5);
+        if (!isAlive(orderHandle)) {
+            continue;
+        }
+
+        Slot &current = m_slots[static_cast<size_t>(orderHandle.slot)];
+        // row -2 marks the record already placed
+        if (-2 == current.row) {
+            continue;
+        }
+        current.row = -2;
+        rows.append(orderHandle);
+    }
+
+    for (const PackageHandle &rowHandle : m_rows) {
+        if (-2 != m_slots[static_cast<size_t>(rowHandle.slot)].row) {
+            rows.append(rowHandle);
+        }
+    }
+
+    m_rows.swap(rows);
+    refreshRows(0);
+}
+
+QList<QString> PackageTable::filePaths() const
+{
+    QList<QString> paths;
+    paths.reserve(m_rows.size());
+    for (const PackageHandle &rowHandle : m_rows) {
+        paths.append(m_slots[static_cast<size_t>(rowHandle.slot)].record.filePath);
+    }
+    return paths;
+}
+
+QList<QByteArray> PackageTable::md5List() const
+{
+    QList<QByteArray> md5s;
+    md5s.reserve(m_rows.size());
+    for (const PackageHandle &rowHandle : m_rows) {
+        md5s.append(m_slots[static_cast<size_t>(rowHandle.slot)].record.md5);
+    }
+    return md5s;
+}
+
+QSet<QByteArray> PackageTable::md5Set() const
+{
+    QSet<QByteArray> md5s;
+    md5s.reserve(m_rows.size());
+    for (const PackageHandle &rowHandle : m_rows) {
+        md5s.insert(m_slots[static_cast<size_t>(rowHandle.slot)].record.md5);
+    }
+    return md5s;
+}
+
+void PackageTable::releaseSlot(int slot)
+{
+    Slot &current = m_slots[static_cast<size_t>(slot)];
+    m_md5Index.remove(current.record.md5);
+
+    // release shared data hold by the record
+    current.record = PackageRecord();
+    current.row = -1;
+    current.used = false;
+    ++current.generation;
+
+    m_freeSlots.push_back(slot);
+}
+
+void PackageTable::refreshRows(int from)
+{
+    for (int row = from; row < m_rows.size(); ++row) {
+        m_slots[static_cast<size_t>(m_rows.at(row).slot)].row = row;
+    }
+}
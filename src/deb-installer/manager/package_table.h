@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PACKAGE_TABLE_H
+#define PACKAGE_TABLE_H
+
+#include "manager/PackageDependsStatus.h"
+#include "utils/package_defines.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include <vector>
+
+namespace Deb {
+class DebPackage;
+};  // namespace Deb
+
+/**
+   @brief Dense handle of a record in PackageTable.
+    The slot generation is bumped each time the slot is released,
+    so stale handles are rejected instead of pointing to a reused record.
+ */
+struct PackageHandle
+{
+    int slot{-1};
+    quint32 generation{0};
+
+    [[nodiscard]] bool isValid() const { return slot >= 0; }
+    bool operator==(const PackageHandle &other) const { return slot == other.slot && generation == other.generation; }
+    bool operator!=(const PackageHandle &other) const { return !(*this == other); }
+};
+
+/**
+   @brief All runtime state of one appended deb package.
+ */
+struct PackageRecord
+{
+    QString filePath;
+    QByteArray md5;
+
+    // detected by PackagesManager
+    bool dependsCached{false};
+    PackageDependsStatus dependsStatus;
+    int installStatus{-1};                          // Pkg::PackageInstallStatus, -1 means not detected yet
+    Pkg::DependsPair dependsDetail;                 // available / broken depends
+    QSharedPointer<Deb::DebPackage> markedDepends;  // packages NewInstall/ToUpgrade/ToRemove by this package
+    int dependsAuthError{-1};                       // DebListModel::DependsAuthStatus of wine depends, -1 means no error
+
+    // updated by DebListModel while installing
+    int operateStatus{Pkg::Prepare};  // Pkg::PackageOperationStatus
+    int failCode{0};                  // Pkg::ErrorCode or QApt::ErrorCode
+    QString failReason;
+    QSharedPointer<Deb::DebPackage> packagePtr;
+
+    void resetOperation();
+};
+
+/**
+   @brief PackageTable stores the package records in one contiguous slot array,
+    replace the parallel md5 keyed maps in PackagesManager / DebListModel.
+
+    Records are addressed by PackageHandle, released slots are recycled through
+    a free list. The row order (install queue order) is kept separately and
+    each slot records its current row, so row <-> handle is O(1) in both directions.
+ */
+class PackageTable
+{
+public:
+    PackageTable() = default;
+
+    PackageHandle append(const QString &filePath, const QByteArray &md5);
+    bool remove(PackageHandle handle);
+    bool removeAt(int row);
+    void clear();
+
+    [[nodiscard]] int size() const { return m_rows.size(); }
+    [[nodiscard]] bool isEmpty() const { return m_rows.isEmpty(); }
+    [[nodiscard]] bool contains(const QByteArray &md5) const { return m_md5Index.contains(md5); }
+    [[nodiscard]] bool isAlive(PackageHandle handle) const;
+
+    [[nodiscard]] PackageHandle handle(const QByteArray &md5) const { return m_md5Index.value(md5); }
+    [[nodiscard]] PackageHandle handleAt(int row) const;
+    [[nodiscard]] int rowOf(PackageHandle handle) const;
+
+    PackageRecord *record(PackageHandle handle);
+    const PackageRecord *record(PackageHandle handle) const;
+    PackageRecord *recordAt(int row) { return record(handleAt(row)); }
+    const PackageRecord *recordAt(int row) const { return record(handleAt(row)); }
+    PackageRecord *recordOf(const QByteArray &md5) { return record(handle(md5)); }
+    const PackageRecord *recordOf(const QByteArray &md5) const { return record(handle(md5)); }
+
+    [[nodiscard]] QString filePathAt(int row) const;
+    [[nodiscard]] QByteArray md5At(int row) const;
+
+    // Reorder rows, md5 not in \a md5Order are kept in the tail with previous order.
+    void setRowOrder(const QList<QByteArray> &md5Order);
+
+    [[nodiscard]] QList<QString> filePaths() const;
+    [[nodiscard]] QList<QByteArray> md5List() const;
+    [[nodiscard]] QSet<QByteArray> md5Set() const;
+
+    template <typename Func>
+    void forEachRecord(Func func)
+    {
+        for (const PackageHandle &rowHandle : m_rows) {
+            func(m_slots[static_cast<size_t>(rowHandle.slot)].record);
+        }
+    }
+
+private:
+    struct Slot
+    {
+        PackageRecord record;
+        quint32 generation{0};
+        int row{-1};
+        bool used{false};
+    };
+
+    void releaseSlot(int slot);
+    void refreshRows(int from);
+
+    std::vector<Slot> m_slots;
+    std::vector<int> m_freeSlots;
+    QVector<PackageHandle> m_rows;
+    QHash<QByteArray, PackageHandle> m_md5Index;
+};
+
+#endif  // PACKAGE_TABLE_H
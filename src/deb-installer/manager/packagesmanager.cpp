@@ -14,6 +14,7 @@
 #include "singleInstallerApplication.h"
 #include "compatible/compatible_backend.h"
 #include "utils/qtcompat.h"
+#include "utils/trace.h"
 
 #include <DRecentManager>
 
@@ -155,6 +156,8 @@ PackageDependsStatus PackagesManager::checkDependsStatus(const QString &package_
     DebFile debFile(package_path);
     if (!debFile.isValid())
         return PackageDependsStatus::_break("");
+    // the package is not in the package table, depends detail will not be recorded.
+    m_currentHandle = PackageHandle();
     m_currentPkgName = debFile.packageName();
     m_orDepends.clear();
     m_checkedOrDependsStatus.clear();
@@ -227,8 +230,6 @@ PackageDependsStatus PackagesManager::checkDependsStatus(const QString &package_
             isDependsExists = false;                           // mark multi-schema dependency conflicts
             m_pair.first.clear();                              // clear available dependencies
             m_pair.second.clear();                             // clear the broken dependency
-            if (m_dependsPackages.contains(m_currentPkgMd5))
-                m_dependsPackages.remove(m_currentPkgMd5);
 
             dependsStatus = checkDependsPackageStatus(choose_set, debFile.architecture(), debFile.depends());
             // 删除无用冗余的日志
@@ -293,7 +294,7 @@ QString PackagesManager::checkPackageValid(const QStringList &package_path)
             md5 = pkgFile.md5Sum();
 
         // 如果当前已经存在此md5的包,则说明此包已经添加到程序中
-        if (m_appendedPackagesMd5.contains(md5)) {
+        if (m_packageTable.contains(md5)) {
             return "The deb package Already Added";
         }
     }
@@ -308,7 +309,7 @@ PackagesManager::PackagesManager(QObject *parent)
     connect(m_installWineThread, &DealDependThread::signalEnableCloseButton, this, &PackagesManager::signalEnableCloseButton);
 
     // 批量打开 分批加载线程
-    m_pAddPackageThread = new AddPackageThread(m_appendedPackagesMd5);
+    m_pAddPackageThread = new AddPackageThread(m_packageTable.md5Set());
 
     // 添加经过检查的包到软件中
     connect(m_pAddPackageThread,
@@ -334,7 +335,7 @@ bool PackagesManager::isBackendReady()
 
 bool PackagesManager::isArchError(const int idx)
 {
-    if (idx < 0 || idx >= m_preparedPackages.size())
+    if (idx < 0 || idx >= m_packageTable.size())
         return true;
 
     Backend *backend = PackageAnalyzer::instance().backendPtr();
@@ -342,7 +343,7 @@ bool PackagesManager::isArchError(const int idx)
         qWarning() << "Failed to load libqapt backend";
         return true;
     }
-    DebFile deb(m_preparedPackages[idx]);
+    DebFile deb(m_packageTable.filePathAt(idx));
 
     if (!deb.isValid())
         return false;
@@ -381,10 +382,10 @@ bool PackagesManager::isArchErrorQstring(const QString &package_name)
 
 const ConflictResult PackagesManager::packageConflictStat(const int index)
 {
-    if (index < 0 || index >= m_preparedPackages.size())
+    if (index < 0 || index >= m_packageTable.size())
         return ConflictResult::err("");
 
-    DebFile debfile(m_preparedPackages[index]);
+    DebFile debfile(m_packageTable.filePathAt(index));
     if (!debfile.isValid())
         return ConflictResult::err("");
     ConflictResult ConflictResult = isConflictSatisfy(debfile.architecture(), debfile.conflicts(), debfile.replaces());
@@ -753,18 +754,14 @@ const ConflictResult PackagesManager::isConflictSatisfy(const QString &arch, con
 
 int PackagesManager::packageInstallStatus(const int index)
 {
-    if (index < 0 || index >= m_preparedPackages.size())
+    PackageRecord *record = m_packageTable.recordAt(index);
+    if (!record)
         return -1;
-    // 修改安装状态的存放方式，将安装状态与MD5绑定，而非与index绑定
-    // 如果此时已经刷新过安装状态，则直接返回。
-    // PS: 修改原因见头文件
+    // 安装状态存储在包记录中，如果此时已经刷新过安装状态，则直接返回。
+    if (record->installStatus >= 0)
+        return record->installStatus;
 
-    // 提前获取当前的md5
-    auto currentPackageMd5 = m_packageMd5[index];
-    if (m_packageInstallStatus.contains(currentPackageMd5))
-        return m_packageInstallStatus[currentPackageMd5];
-
-    DebFile debFile(m_preparedPackages[index]);
+    DebFile debFile(record->filePath);
     if (!debFile.isValid())
         return Pkg::PackageInstallStatus::NotInstalled;
     const QString packageName = debFile.packageName();
@@ -796,8 +793,7 @@ int PackagesManager::packageInstallStatus(const int index)
         ret = Pkg::PackageInstallStatus::InstalledEarlierVersion;
 
     // 存储包的安装状态
-    // 2020-11-19 修改安装状态的存储绑定方式
-    m_packageInstallStatus[currentPackageMd5] = ret;
+    record->installStatus = ret;
     return ret;
 }
 
@@ -806,8 +802,10 @@ int PackagesManager::packageInstallStatus(const int index)
  */
 QStringList PackagesManager::removePackages(const QByteArray &md5) const
 {
-    if (auto markedPtr = m_markedDepends.value(md5)) {
-        return markedPtr->removePackages();
+    if (auto record = m_packageTable.recordOf(md5)) {
+        if (record->markedDepends) {
+            return record->markedDepends->removePackages();
+        }
     }
 
     return {};
@@ -815,37 +813,43 @@ QStringList PackagesManager::removePackages(const QByteArray &md5) const
 
 void PackagesManager::slotDealDependResult(int iAuthRes, int iIndex, const QString &dependName)
 {
-    if (iIndex < 0 || iIndex > m_preparedPackages.size())
+    if (iIndex < 0 || iIndex > m_packageTable.size())
         return;
-    if (iAuthRes == DebListModel::AuthDependsSuccess) {
-        for (int num = 0; num < m_dependInstallMark.size(); num++) {
-            m_packageMd5DependsStatus[m_dependInstallMark.at(num)].status = Pkg::DependsStatus::DependsOk;  // 更换依赖的存储结构
+
+    // 更新所有被标记需要下载wine依赖的包的依赖状态
+    auto updateMarkedStatus = [this](int status) {
+        for (const QByteArray &md5 : m_dependInstallMark) {
+            if (auto record = m_packageTable.recordOf(md5)) {
+                record->dependsStatus.status = status;
+                record->dependsCached = true;
+            }
         }
-        m_errorIndex.clear();
+    };
+
+    if (iAuthRes == DebListModel::AuthDependsSuccess) {
+        updateMarkedStatus(Pkg::DependsStatus::DependsOk);
+        m_packageTable.forEachRecord([](PackageRecord &record) { record.dependsAuthError = -1; });
     }
     if (iAuthRes == DebListModel::CancelAuth || iAuthRes == DebListModel::AnalysisErr) {
-        for (int num = 0; num < m_dependInstallMark.size(); num++) {
-            m_packageMd5DependsStatus[m_dependInstallMark.at(num)].status =
-                Pkg::DependsStatus::DependsAuthCancel;  // 更换依赖的存储结构
-        }
+        updateMarkedStatus(Pkg::DependsStatus::DependsAuthCancel);
         emit signalEnableCloseButton(true);
     }
     if (iAuthRes == DebListModel::AuthDependsErr || iAuthRes == DebListModel::AnalysisErr ||
         iAuthRes == DebListModel::VerifyDependsErr) {
-        for (int num = 0; num < m_dependInstallMark.size(); num++) {
-            m_packageMd5DependsStatus[m_dependInstallMark.at(num)].status =
-                Pkg::DependsStatus::DependsBreak;  // 更换依赖的存储结构
-            if (!m_errorIndex.contains(m_dependInstallMark[num]))
-                m_errorIndex.insert(m_dependInstallMark[num], iAuthRes);
+        updateMarkedStatus(Pkg::DependsStatus::DependsBreak);
+        for (const QByteArray &md5 : m_dependInstallMark) {
+            auto record = m_packageTable.recordOf(md5);
+            if (record && record->dependsAuthError < 0)
+                record->dependsAuthError = iAuthRes;
         }
 
         // If the download of a wine dependency fails, might be the dependency is missing
         if (GlobalStatus::winePreDependsInstalling()) {
             qInfo() << "check wine depends again !" << iIndex;
             getPackageDependsStatus(iIndex);
-            if (!m_dependsPackages.isEmpty()) {
-                qInfo() << m_dependsPackages.size() << m_dependsPackages.value(m_currentPkgMd5).second.size();
-                if (m_preparedPackages.size() > 1) {
+            if (auto record = m_packageTable.record(m_currentHandle)) {
+                qInfo() << m_packageTable.size() << record->dependsDetail.second.size();
+                if (m_packageTable.size() > 1) {
                     GlobalStatus::setWinePreDependsInstalling(false);
                 }
             }
@@ -865,9 +869,7 @@ void PackagesManager::slotDealDependResult(int iAuthRes, int iIndex, const QStri
  */
 QByteArray PackagesManager::getPackageMd5(const int index)
 {
-    if (index < m_packageMd5.size())
-        return m_packageMd5[index];
-    return nullptr;
+    return m_packageTable.md5At(index);
 }
 
 /**
@@ -877,18 +879,22 @@ QByteArray PackagesManager::getPackageMd5(const int index)
  */
 PackageDependsStatus PackagesManager::getPackageDependsStatus(const int index)
 {
-    // 提前获取需要的md5
-    if (index < 0 || index >= m_preparedPackages.size()) {
+    const PackageHandle handle = m_packageTable.handleAt(index);
+    const PackageRecord *record = m_packageTable.record(handle);
+    if (!record) {
         qWarning() << "invalid param index";
         return PackageDependsStatus::_break("");
     }
-    auto currentPackageMd5 = m_packageMd5[index];
-    m_currentPkgMd5 = currentPackageMd5;
+    m_currentHandle = handle;
+
+    if (record->dependsCached)
+        return record->dependsStatus;
 
-    if (m_packageMd5DependsStatus.contains(currentPackageMd5))
-        return m_packageMd5DependsStatus[currentPackageMd5];
+    Trace::ScopedSpan span(Trace::kCatAnalyze, "resolve_depends", record->filePath, Metrics::DependsResolveSeconds);
 
-    DebFile debFile(m_preparedPackages[index]);
+    // 检测过程中可能触发界面刷新，不持有记录指针，通过句柄重新获取
+    const QByteArray currentPackageMd5 = record->md5;
+    DebFile debFile(record->filePath);
     if (!debFile.isValid())
         return PackageDependsStatus::_break("");
     m_currentPkgName = debFile.packageName();
@@ -907,7 +913,7 @@ PackageDependsStatus PackagesManager::getPackageDependsStatus(const int index)
     if (isBlackApplication(debFile.packageName())) {
         dependsStatus.status = Pkg::DependsStatus::Prohibit;
         dependsStatus.package = debFile.packageName();
-        m_packageMd5DependsStatus.insert(currentPackageMd5, dependsStatus);
+        storeDependsStatus(handle, dependsStatus);
         qWarning() << debFile.packageName() << "In the blacklist";
         return dependsStatus;
     }
@@ -915,7 +921,7 @@ PackageDependsStatus PackagesManager::getPackageDependsStatus(const int index)
     if (isArchError(index)) {
         dependsStatus.status = Pkg::DependsStatus::ArchBreak;  // 添加ArchBreak错误。
         dependsStatus.package = debFile.packageName();
-        m_packageMd5DependsStatus.insert(currentPackageMd5, dependsStatus);  // 更换依赖的存储方式
+        storeDependsStatus(handle, dependsStatus);
         return dependsStatus;
     }
 
@@ -968,8 +974,8 @@ PackageDependsStatus PackagesManager::getPackageDependsStatus(const int index)
             isDependsExists = false;                           // mark multi-schema dependency conflicts
             m_pair.first.clear();                              // clear available dependencies
             m_pair.second.clear();                             // clear the broken dependency
-            if (m_dependsPackages.contains(m_currentPkgMd5))
-                m_dependsPackages.remove(m_currentPkgMd5);
+            if (auto current = m_packageTable.record(handle))
+                current->dependsDetail = {};
 
             dependsStatus = checkDependsPackageStatus(choose_set, debFile.architecture(), debFile.depends());
             // 删除无用冗余的日志
@@ -1031,17 +1037,25 @@ PackageDependsStatus PackagesManager::getPackageDependsStatus(const int index)
 
     // If depends need install
     if (Pkg::DependsOk == dependsStatus.status || Pkg::DependsAvailable == dependsStatus.status) {
-        refreshPackageMarkedInfo(currentPackageMd5, debFile.filePath());
+        refreshPackageMarkedInfo(m_packageTable.record(handle));
     }
 
-    m_packageMd5DependsStatus.insert(currentPackageMd5, dependsStatus);
+    storeDependsStatus(handle, dependsStatus);
     return dependsStatus;
 }
 
 bool PackagesManager::cachedPackageDependStatus(const int index) const
 {
-    auto currentPackageMd5 = m_packageMd5[index];
-    return m_packageMd5DependsStatus.contains(currentPackageMd5);
+    const PackageRecord *record = m_packageTable.recordAt(index);
+    return record && record->dependsCached;
+}
+
+void PackagesManager::storeDependsStatus(PackageHandle handle, const PackageDependsStatus &dependsStatus)
+{
+    if (auto record = m_packageTable.record(handle)) {
+        record->dependsStatus = dependsStatus;
+        record->dependsCached = true;
+    }
 }
 
 void PackagesManager::getPackageOrDepends(const QString &package, const QString &arch, bool flag)
@@ -1164,8 +1178,7 @@ void PackagesManager::getPackageOrDepends(const QString &package, const QString
 
 const QString PackagesManager::packageInstalledVersion(const int index)
 {
-    // 更换安装状态的存储结构
-    DebFile debFile(m_preparedPackages[index]);
+    DebFile debFile(m_packageTable.filePathAt(index));
     if (!debFile.isValid())
         return "";
     const QString packageName = debFile.packageName();
@@ -1186,7 +1199,7 @@ const QString PackagesManager::packageInstalledVersion(const int index)
 
 const QStringList PackagesManager::packageAvailableDepends(const int index)
 {
-    return debFileAvailableDepends(m_preparedPackages[index]);
+    return debFileAvailableDepends(m_packageTable.filePathAt(index));
 }
 
 QStringList PackagesManager::debFileAvailableDepends(const QString &filePath)
@@ -1459,40 +1472,36 @@ bool PackagesManager::isNegativeReverseDepend(const QString &packageName, const
 
 void PackagesManager::reset()
 {
-    m_errorIndex.clear();
     m_dependInstallMark.clear();
-    m_preparedPackages.clear();
-    m_packageInstallStatus.clear();
-    m_packageMd5DependsStatus.clear();  // 修改依赖状态的存储结构，此处清空存储的依赖状态数据
-    m_markedDepends.clear();
-    m_appendedPackagesMd5.clear();
-    m_packageMd5.clear();
+    m_packageTable.clear();  // 清空所有包的记录（路径、md5及各项状态）
+    m_currentHandle = PackageHandle();
     m_dependGraph.reset();
 
     // reloadCache必须要加
     PackageAnalyzer::instance().backendPtr()->reloadCache();
-    m_dependsPackages.clear();
+    Metrics::add(Metrics::CacheReloads);
 }
 
 void PackagesManager::resetPackageDependsStatus(const int index)
 {
     // 查看此包是否已经存储依赖状态。
-    // 提前获取package 的md5
-    auto currentPackageMd5 = m_packageMd5[index];
-    if (!m_packageMd5DependsStatus.contains(currentPackageMd5)) {
+    PackageRecord *record = m_packageTable.recordAt(index);
+    if (!record || !record->dependsCached) {
         return;
     } else {
         // 针对wine依赖做一个特殊处理，如果wine依赖break,则直接返回。
-        if ((m_packageMd5DependsStatus[currentPackageMd5].package == "deepin-wine") &&
-            m_packageMd5DependsStatus[currentPackageMd5].status != Pkg::DependsStatus::DependsOk)
+        if ((record->dependsStatus.package == "deepin-wine") &&
+            record->dependsStatus.status != Pkg::DependsStatus::DependsOk)
             return;
     }
     // reload backend cache
     // reloadCache必须要加
     PackageAnalyzer::instance().backendPtr()->reloadCache();
-    m_packageMd5DependsStatus.remove(currentPackageMd5);  // 删除当前包的依赖状态（之后会重新获取此包的依赖状态）
+    Metrics::add(Metrics::CacheReloads);
+    record->dependsCached = false;  // 删除当前包的依赖状态（之后会重新获取此包的依赖状态）
+    record->dependsStatus = PackageDependsStatus();
 
-    // we don't need reset m_markedDepends on installing
+    // we don't need reset markedDepends on installing
 }
 
 /**
@@ -1501,7 +1510,8 @@ void PackagesManager::resetPackageDependsStatus(const int index)
  */
 void PackagesManager::removePackage(int index)
 {
-    if (index < 0 || index >= m_preparedPackages.size()) {
+    const PackageHandle handle = m_packageTable.handleAt(index);
+    if (!m_packageTable.isAlive(handle)) {
         qWarning() << "[PackagesManager]"
                    << "[removePackage]"
                    << "Subscript boundary check error";
@@ -1509,29 +1519,25 @@ void PackagesManager::removePackage(int index)
     }
 
     // 如果此前的文件已经被修改,则获取到的MD5的值与之前不同,因此从现有的md5中寻找.
-    const auto md5 = m_packageMd5[index];
+    const auto md5 = m_packageTable.record(handle)->md5;
 
     // 提前删除标记list中的md5 否则在删除最后一个的时候会崩溃
     if (m_dependInstallMark.contains(md5))  // 如果这个包是wine包，则在wine标记list中删除
         m_dependInstallMark.removeOne(md5);
 
-    m_preparedPackages.removeAt(index);
-
-    m_appendedPackagesMd5.remove(md5);  // 在判断是否重复的md5的集合中删除掉当前包的md5
-    m_markedDepends.remove(md5);
-    m_packageMd5DependsStatus.remove(md5);  // 删除指定包的依赖状态
-    m_packageMd5.removeAt(index);           // 在索引map中删除指定的项
-    m_dependsPackages.remove(md5);          // 删除指定包的依赖关系
+    // 删除包记录，记录中的依赖状态、依赖关系等一并释放，句柄随之失效
+    m_packageTable.remove(handle);
 
     m_dependGraph.remove(md5);  // 从依赖关系图中删除对应节点
 
-    m_packageInstallStatus.clear();
+    // 安装状态需重新检测
+    m_packageTable.forEachRecord([](PackageRecord &record) { record.installStatus = -1; });
 
     // 告诉model md5更新了
-    emit signalPackageMd5Changed(m_packageMd5);
+    emit signalPackageMd5Changed(m_packageTable.md5List());
 
     // notify data changed
-    Q_EMIT signalPackageCountChanged(m_preparedPackages.size());
+    Q_EMIT signalPackageCountChanged(m_packageTable.size());
 }
 
 /**
@@ -1545,6 +1551,8 @@ void PackagesManager::appendPackage(QStringList packages)
     if (packages.isEmpty())  // 当前放进来的包列表为空（可能拖入的是文件夹）
         return;
 
+    Trace::ScopedSpan span(Trace::kCatAppend, "PackagesManager::appendPackage", QString::number(packages.size()));
+
     // convert url path (if valid) to local path.
     for (auto &package : packages) {
         QUrl url(package);
@@ -1568,7 +1576,7 @@ void PackagesManager::appendPackage(QStringList packages)
         if (!m_allPackages.isEmpty())
             m_pAddPackageThread->setSamePackageMd5(m_allPackages);
         m_pAddPackageThread->setPackages(packages, m_validPackageCount);   // 传递要添加的包到添加线程中
-        m_pAddPackageThread->setAppendPackagesMd5(m_appendedPackagesMd5);  // 传递当前已经添加的包的MD5 判重时使用
+        m_pAddPackageThread->setAppendPackagesMd5(m_packageTable.md5Set());  // 传递当前已经添加的包的MD5 判重时使用
 
         m_pAddPackageThread->start();  // 开始添加线程
     }
@@ -1584,6 +1592,7 @@ void PackagesManager::checkInvalid(const QStringList &packages)
     int validCount = 0;    // 计入有效包的数量
     QSet<qint64> pkgSize;  // 存储安装包的安装大小,初步去除无效包以及可能重复的包
     for (auto package : packages) {
+        Trace::ScopedSpan parseSpan(Trace::kCatAnalyze, "parse_control", package);
         QApt::DebFile file(package);
         if (!file.isValid()) {
             m_validPackageCount--;
@@ -1604,7 +1613,9 @@ void PackagesManager::checkInvalid(const QStringList &packages)
             QApt::DebFile pkgFile(package);
             if (!pkgFile.isValid())
                 continue;
+            Trace::ScopedSpan hashSpan(Trace::kCatAnalyze, "md5sum", package);
             auto md5 = pkgFile.md5Sum();
+            Metrics::add(Metrics::HashedBytes, static_cast<quint64>(QFileInfo(package).size()));
             m_allPackages.insert(package, md5);
             if (!pkgMd5.isEmpty() && !pkgMd5.contains(md5)) {  // 根据md5判断，有不是重复的包，刷新批量界面
                 m_validPackageCount = 2;
@@ -1671,8 +1682,8 @@ QString PackagesManager::dealPackagePath(const QString &packagePath)
 
 Pkg::DependsPair PackagesManager::getPackageDependsDetail(const int index)
 {
-    if (index < m_packageMd5.size() && index >= 0)
-        return m_dependsPackages.value(m_packageMd5[index]);
+    if (auto record = m_packageTable.recordAt(index))
+        return record->dependsDetail;
     return {};
 }
 
@@ -1698,6 +1709,7 @@ void PackagesManager::appendNoThread(const QStringList &packages, int allPackage
             continue;
         }
 
+        Trace::ScopedSpan packageSpan(Trace::kCatAppend, "add_package", debPackage);
         QApt::DebFile pkgFile(debPackage);
         // 判断当前文件是否是无效文件
         if (!pkgFile.isValid()) {
@@ -1707,12 +1719,16 @@ void PackagesManager::appendNoThread(const QStringList &packages, int allPackage
         // 获取当前文件的md5的值,防止重复添加
         // 在checkInvalid中已经获取过md5,避免2次获取影响性能
         QByteArray md5 = m_allPackages.value(debPkg);
-        if (md5.isEmpty())
+        if (md5.isEmpty()) {
+            Trace::ScopedSpan hashSpan(Trace::kCatAnalyze, "md5sum", debPackage);
             md5 = pkgFile.md5Sum();
+            Metrics::add(Metrics::HashedBytes, static_cast<quint64>(QFileInfo(debPackage).size()));
+        }
 
         // 如果当前已经存在此md5的包,则说明此包已经添加到程序中
-        if (m_appendedPackagesMd5.contains(md5)) {
+        if (m_packageTable.contains(md5)) {
             // 处理重复文件
+            Metrics::add(Metrics::PackagesDeduped);
             Q_EMIT signalAppendFailMessage(Pkg::PackageAlreadyExists);
             continue;
         }
@@ -1729,7 +1745,7 @@ void PackagesManager::appendNoThread(const QStringList &packages, int allPackage
 
     // 所有包都添加结束.
     if (1 == allPackageSize) {
-        emit signalAppendFinished(m_packageMd5);  // 添加一个包时 发送添加结束信号,启用安装按钮
+        emit signalAppendFinished(m_packageTable.md5List());  // 添加一个包时 发送添加结束信号,启用安装按钮
     }
 }
 
@@ -1740,7 +1756,7 @@ void PackagesManager::appendNoThread(const QStringList &packages, int allPackage
 void PackagesManager::refreshPage(int validPkgCount)
 {
     // 获取当前已经添加到程序中的包的数量
-    const int packageCount = m_preparedPackages.size();
+    const int packageCount = m_packageTable.size();
 
     Q_EMIT signalPackageCountChanged(packageCount);
     // If current first append and only one package, will append directly.
@@ -1756,33 +1772,28 @@ void PackagesManager::slotAppendPackageFinished()
 {
     // 告诉前端，此次添加已经结束
     // 向model传递 md5
-    emit signalAppendFinished(m_packageMd5);
+    emit signalAppendFinished(m_packageTable.md5List());
 }
 
 void PackagesManager::addPackage(int validPkgCount, const QString &packagePath, const QByteArray &packageMd5Sum)
 {
     // 预先校验包是否有效或是否重复
     DebFile currentDebfile(packagePath);
-    if (!currentDebfile.isValid() || m_appendedPackagesMd5.contains(packageMd5Sum)) {
+    if (!currentDebfile.isValid() || m_packageTable.contains(packageMd5Sum)) {
         return;
     }
 
-    // 加入md5集合
-    m_appendedPackagesMd5 << packageMd5Sum;
+    // 加入包记录表
+    const PackageHandle handle = m_packageTable.append(packagePath, packageMd5Sum);
+    Metrics::add(Metrics::PackagesAppended);
 
     // 使用依赖图计算安装顺序
     auto currentDebDepends = currentDebfile.depends();
     m_dependGraph.addNode(packagePath, packageMd5Sum, currentDebfile.packageName(), currentDebDepends);  // 添加图节点
     auto installQueue = m_dependGraph.getBestInstallQueue();  // 输出最佳安装顺序
-    m_preparedPackages = installQueue.first;
-    m_packageMd5 = installQueue.second;
-    int indexRow = 0;
-    for (; indexRow != m_packageMd5.size(); ++indexRow) {
-        if (m_packageMd5[indexRow] == packageMd5Sum) {
-            break;
-        }
-    }
-    if (indexRow == m_packageMd5.size()) {  // error
+    m_packageTable.setRowOrder(installQueue.second);
+    const int indexRow = m_packageTable.rowOf(handle);
+    if (indexRow < 0) {  // error
         return;
     }
 
@@ -1852,7 +1863,8 @@ const PackageDependsStatus PackagesManager::checkDependsPackageStatus(QSet<QStri
 
     m_pair.first.append(available_list);
     m_pair.second.append(break_list);
-    m_dependsPackages.insert(m_currentPkgMd5, m_pair);
+    if (auto record = m_packageTable.record(m_currentHandle))
+        record->dependsDetail = m_pair;
     return dependsStatus;
 }
 
@@ -2336,7 +2348,7 @@ bool PackagesManager::rmTempDir()
 
 QString PackagesManager::package(const int index) const
 {
-    return m_preparedPackages[index];
+    return m_packageTable.filePathAt(index);
 }
 
 void PackagesManager::getBlackApplications()
@@ -2417,17 +2429,18 @@ void PackagesManager::filterNeedInstallWinePackage(QStringList &dependList,
     dependList.erase(removedIter, dependList.end());
 }
 
-void PackagesManager::refreshPackageMarkedInfo(const QByteArray &md5, const QString &filePath)
+void PackagesManager::refreshPackageMarkedInfo(PackageRecord *record)
 {
-    if (m_markedDepends.contains(md5)) {
+    if (!record || record->markedDepends) {
         return;
     }
 
+    const QString filePath = record->filePath;
     const QStringList availableDepends = debFileAvailableDepends(filePath);
     auto markedPtr = Deb::DebPackage::Ptr::create(filePath);
     markedPtr->setMarkedPackages(availableDepends);
 
-    m_markedDepends.insert(md5, markedPtr);
+    record->markedDepends = markedPtr;
 }
 
 bool PackagesManager::isBlackApplication(const QString &applicationName)
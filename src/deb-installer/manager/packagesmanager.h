@@ -8,6 +8,7 @@
 #include "utils/package_defines.h"
 #include "utils/result.h"
 #include "model/dependgraph.h"
+#include "manager/package_table.h"
 
 #include <QApt/Backend>
 #include <QApt/DebFile>
@@ -485,62 +486,25 @@ private:
                                       const DebFile &debFile,
                                       const QHash<QString, DependencyInfo> &dependInfoMap);
 
-    void refreshPackageMarkedInfo(const QByteArray &md5, const QString &filePath);
-
-private:
-    QMap<QByteArray, int> m_errorIndex;  // wine依赖错误的包的下标 QMap<MD5, DebListModel::DependsAuthStatus>
-
-    // 存放包路径的列表
-    QList<QString> m_preparedPackages = {};
-
-    // 存放包MD5的集合
-    QSet<QByteArray> m_appendedPackagesMd5 = {};
-
-    QMap<QString, QByteArray> m_allPackages;  // 存放有效包路径及md5，避免二次获取消耗时间
-
-    // 包MD5与下标绑定的list
-    QList<QByteArray> m_packageMd5 = {};
+    void refreshPackageMarkedInfo(PackageRecord *record);
 
     /**
-     * @brief m_packageMd5DependsStatus 包的依赖状态的Map
-     * QByteArray 包的下标
-     * PackageDependsStatus 依赖的状态
-     *
-     * 此前将下标与安装状态绑定
-     * 此时使用MD5与依赖状态绑定
-     * 修改原因：
-     * 1.修改添加方式从添加到插入到最前方
-     * 2.使用之前的方式会导致所有包的依赖状态错乱
+       @brief 缓存依赖检测结果，句柄已失效（包已被删除）时忽略
      */
-    QMap<QByteArray, PackageDependsStatus> m_packageMd5DependsStatus;
+    void storeDependsStatus(PackageHandle handle, const PackageDependsStatus &dependsStatus);
 
+private:
     /**
-       @brief The key is md5, the value is the dependent info of the package,
-            marked packages NewInstall/ToUpgrade/ToRemove...
-            If the status of other packages is not changed, the value is nullptr.
+     * @brief m_packageTable 已添加包的记录表
+     * 每个包的路径、md5、依赖状态、安装状态、依赖详情、wine依赖错误及操作状态存放在同一条记录中
+     * 行序即安装顺序，通过 PackageHandle 访问记录，删除包时句柄失效
      */
-    QMap<QByteArray, QSharedPointer<Deb::DebPackage>> m_markedDepends;
+    PackageTable m_packageTable;
 
-    /**
-     * @brief m_packageInstallStatus 包安装状态的Map
-     * int: 包的下标
-     * int: 包的安装状态
-     * 此前的安装状态将下标与安装状态绑定
-     * 此时使用MD5与安装状态绑定
-     * 修改原因：
-     * 1.修改添加方式从添加到插入到最前方
-     * 2.使用之前的方式会导致所有包的安装状态都是第一个包的安装状态
-     */
-    QMap<QByteArray, int> m_packageInstallStatus = {};
+    QMap<QString, QByteArray> m_allPackages;  // 存放本次待添加包路径及md5，避免二次获取消耗时间
 
-    QByteArray m_currentPkgMd5;  // 当前包的md5
+    PackageHandle m_currentHandle;  // 当前检测依赖的包
 
-    /**
-     * @brief m_dependsPackages  包依赖关系的map
-     * QPair<QList<dependInfo>, QList<dependInfo>> 仓库可获取依赖与仓库不可获取依赖
-     * 与md5进行绑定
-     */
-    QMap<QByteArray, Pkg::DependsPair> m_dependsPackages;
     Pkg::DependInfo m_dinfo;  // 依赖包的包名及版本
 
     /**
@@ -576,8 +540,6 @@ private:
 
     int m_validPackageCount = 0;
 
-    qint64 dependsStatusTotalTime = 0;
-
     QString m_brokenDepend = "";
 
     QString m_currentPkgName = "";
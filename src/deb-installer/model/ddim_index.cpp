@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "ddim_index.h"
+#include "packageanalyzer.h"
+#include "packageselectmodel.h"
+#include "utils/deb_file_walker.h"
+#include "utils/trace.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+static const char kIndexFileName[] = ".ddim-index";
+
+// fixed stream version, the file may be read by an installer built with another Qt
+static const QDataStream::Version kStreamVersion = QDataStream::Qt_5_6;
+
+// smallest serialized path + Entry: length prefixes of the strings, md5 and list, plus size and mtime
+static const qint64 kMinEntryBytes = 4 + 8 + 8 + 4 + 4 * 4 + 4;
+
+static QDataStream &operator<<(QDataStream &stream, const DdimIndex::Entry &entry)
+{
+    return stream << entry.size << entry.mtime << entry.md5 << entry.packageName << entry.version << entry.architecture
+                  << entry.shortDescription << entry.virtualPackages;
+}
+
+static QDataStream &operator>>(QDataStream &stream, DdimIndex::Entry &entry)
+{
+    return stream >> entry.size >> entry.mtime >> entry.md5 >> entry.packageName >> entry.version >> entry.architecture >>
+           entry.shortDescription >> entry.virtualPackages;
+}
+
+DdimIndex::DdimIndex(const QString &ddimDir)
+    : m_ddimDir(QDir::cleanPath(ddimDir))
+{
+}
+
+QString DdimIndex::indexFilePath(const QString &ddimDir)
+{
+    return QDir::cleanPath(ddimDir) + QDir::separator() + kIndexFileName;
+}
+
+bool DdimIndex::load()
+{
+    Trace::ScopedSpan span(Trace::kCatAnalyze, "load_ddim_index", m_ddimDir);
+
+    QFile file(indexFilePath(m_ddimDir));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(kStreamVersion);
+
+    quint32 magic = 0;
+    quint32 formatVersion = 0;
+    qint32 count = 0;
+    stream >> magic >> formatVersion >> count;
+    if (kMagic != magic || kFormatVersion != formatVersion || count < 0) {
+        qWarning() << "[DdimIndex]" << "ignore index of unknown format:" << file.fileName();
+        return false;
+    }
+
+    // the index lives next to the bundle and may be truncated or forged, never trust the count
+    if (count > (file.size() - file.pos()) / kMinEntryBytes) {
+        qWarning() << "[DdimIndex]" << "ignore corrupted index:" << file.fileName();
+        return false;
+    }
+
+    QHash<QString, Entry> entries;
+    entries.reserve(count);
+    for (qint32 i = 0; i < count && QDataStream::Ok == stream.status(); ++i) {
+        QString path;
+        Entry entry;
+        stream >> path >> entry;
+        entries.insert(path, entry);
+    }
+
+    if (QDataStream::Ok != stream.status()) {
+        qWarning() << "[DdimIndex]" << "ignore corrupted index:" << file.fileName();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_entries = entries;
+    m_dirty = false;
+    qInfo() << "[DdimIndex]" << "loaded" << m_entries.size() << "entries from" << file.fileName();
+    return true;
+}
+
+bool DdimIndex::save()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (!m_dirty) {
+        return true;
+    }
+
+    // the bundle may be on read only media, the index is optional
+    QSaveFile file(indexFilePath(m_ddimDir));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[DdimIndex]" << "failed to write index" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(kStreamVersion);
+    stream << kMagic << kFormatVersion << static_cast<qint32>(m_entries.size());
+    for (auto iter = m_entries.cbegin(); iter != m_entries.cend(); ++iter) {
+        stream << iter.key() << iter.value();
+    }
+
+    if (QDataStream::Ok != stream.status() || !file.commit()) {
+        qWarning() << "[DdimIndex]" << "failed to write index" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+bool DdimIndex::lookup(const QString &debPath, DebIr *ir) const
+{
+    Entry entry;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto iter = m_entries.constFind(relativePath(debPath));
+        if (iter == m_entries.cend()) {
+            return false;
+        }
+        entry = iter.value();
+    }
+
+    const QFileInfo info(debPath);
+    if (info.size() != entry.size || info.lastModified().toMSecsSinceEpoch() != entry.mtime) {
+        return false;
+    }
+
+    ir->filePath = debPath;
+    ir->md5 = entry.md5;
+    ir->packageName = entry.packageName;
+    ir->version = entry.version;
+    ir->architecture = entry.architecture;
+    ir->shortDescription = entry.shortDescription;
+    ir->virtualPackages = entry.virtualPackages;
+    ir->isValid = true;
+    return true;
+}
+
+void DdimIndex::insert(const DebIr &ir)
+{
+    if (!ir.isValid) {
+        return;
+    }
+
+    const QFileInfo info(ir.filePath);
+    Entry entry;
+    entry.size = info.size();
+    entry.mtime = info.lastModified().toMSecsSinceEpoch();
+    entry.md5 = ir.md5;
+    entry.packageName = ir.packageName;
+    entry.version = ir.version;
+    entry.architecture = ir.architecture;
+    entry.shortDescription = ir.shortDescription;
+    entry.virtualPackages = ir.virtualPackages;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_entries.insert(relativePath(ir.filePath), entry);
+    m_dirty = true;
+}
+
+bool DdimIndex::isDirty() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_dirty;
+}
+
+int DdimIndex::size() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_entries.size();
+}
+
+bool DdimIndex::build(const QString &ddimDir)
+{
+    QStringList searchDirs;
+    for (const char *subDir : {"/Softwares", "/Depends", "/Updates"}) {
+        if (QDir(ddimDir + subDir).exists()) {
+            searchDirs.append(ddimDir + subDir);
+        }
+    }
+
+    QStringList debPaths;
+    for (const QStringList &paths : DebFileWalker().walk(searchDirs)) {
+        debPaths.append(paths);
+    }
+
+    DdimIndex index(ddimDir);
+    QtConcurrent::blockingMap(debPaths, [&index](const QString &debPath) {
+        DebIr ir;
+        PackageAnalyzer::instance().parseDebFile(debPath, &ir);
+        index.insert(ir);
+    });
+
+    index.m_dirty = true;  // write an empty index as well
+    qInfo() << "[DdimIndex]" << "indexed" << index.size() << "of" << debPaths.size() << "packages in" << ddimDir;
+    return index.save();
+}
+
+QString DdimIndex::relativePath(const QString &debPath) const
+{
+    return QDir(m_ddimDir).relativeFilePath(debPath);
+}
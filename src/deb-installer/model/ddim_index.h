@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DDIM_INDEX_H
+#define DDIM_INDEX_H
+
+#include <QHash>
+#include <QStringList>
+
+#include <mutex>
+
+struct DebIr;
+
+/**
+   @brief Binary sidecar index of the packages in a DDIM bundle.
+
+    Stored as ".ddim-index" next to the .ddim manifest, either written by the
+    installer after the first analysis or generated ahead of time by the media
+    producer with `deepin-deb-installer --build-ddim-index <manifest.ddim>`.
+    Each entry keeps the analysis result of one deb (md5 of the whole file and
+    the control fields), keyed by the path relative to the bundle and validated
+    by the file size and mtime, so a hit never reads the package data.
+    Depends are not stored, QApt has no public parser to rebuild them, the
+    control member of the packages kept after filtering is still read.
+ */
+class DdimIndex
+{
+public:
+    struct Entry
+    {
+        qint64 size{0};
+        qint64 mtime{0};  // msecs since epoch
+        QByteArray md5;
+        QString packageName;
+        QString version;
+        QString architecture;
+        QString shortDescription;
+        QStringList virtualPackages;
+    };
+
+    explicit DdimIndex(const QString &ddimDir);
+
+    [[nodiscard]] static QString indexFilePath(const QString &ddimDir);
+
+    // read the index file, false if missing, corrupted or of another format version.
+    bool load();
+    // write the index file if changed since load(), the file is replaced atomically.
+    bool save();
+
+    // fill \a ir from the entry of \a debPath, false if no entry or the file changed.
+    [[nodiscard]] bool lookup(const QString &debPath, DebIr *ir) const;
+    // add or replace the entry of a valid ir, thread safe.
+    void insert(const DebIr &ir);
+
+    [[nodiscard]] bool isDirty() const;
+    [[nodiscard]] int size() const;
+
+    // parse all packages of the bundle and write a new index file.
+    static bool build(const QString &ddimDir);
+
+    static constexpr quint32 kMagic = 0x44444958;  // "DDIX"
+    static constexpr quint32 kFormatVersion = 1;
+
+private:
+    [[nodiscard]] QString relativePath(const QString &debPath) const;
+
+    QString m_ddimDir;
+    mutable std::mutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    bool m_dirty{false};
+
+    Q_DISABLE_COPY(DdimIndex)
+};
+
+#endif  // DDIM_INDEX_H
@@ -5,6 +5,7 @@
 #include "deblistmodel.h"
 #include "manager/packagesmanager.h"
 #include "manager/PackageDependsStatus.h"
+#include "manager/helper_session_client.h"
 #include "packageanalyzer.h"
 #include "view/pages/AptConfigMessage.h"
 #include "view/pages/settingdialog.h"
@@ -26,7 +27,9 @@
 #include <QDir>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QSettings>
 #include <QSize>
+#include <QStandardPaths>
 #include <QtConcurrent>
 
 #include <QApt/Backend>
@@ -34,6 +37,11 @@
 
 using namespace QApt;
 
+// debconf 预置应答文件路径, "debconf/preseed" in deepin-deb-installer.conf
+// 连续的配置包总是合并为一次非交互安装，未预置应答的配置项使用默认值；
+// 设置该文件后，批量安装前先通过 debconf-set-selections 载入其中的应答
+static const QString kDebconfPreseedSettingKey = "debconf/preseed";
+
 /**
  * @brief isDpkgRunning 判断当前dpkg 是否在运行
  * @return
@@ -47,6 +55,11 @@ DebListModel::DebListModel(QObject *parent)
 
     // 配置包安装的进程
     m_procInstallConfig = new Konsole::Pty;
+    m_configSession = new HelperSessionClient(m_procInstallConfig, this);
+
+    const QString confPath =
+        QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + QDir::separator() + "deepin-deb-installer.conf";
+    m_debconfPreseed = QSettings(confPath, QSettings::IniFormat).value(kDebconfPreseedSettingKey).toString();
     configWindow = new AptConfigMessage;
 
     // 链接信号与槽
@@ -156,15 +169,14 @@ void DebListModel::initInstallConnections()
 {
     // 安装成功后，根据安装结果排序
     connect(this, &DebListModel::signalWorkerFinished, this, &DebListModel::slotUpWrongStatusRow);
+    // 每轮安装结束后刷新指标文件
+    connect(this, &DebListModel::signalWorkerFinished, this, []() { Metrics::Registry::instance()->flushTextFile(); });
 
     // 配置安装结束
-    connect(m_procInstallConfig,
-            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this,
-            &DebListModel::slotConfigInstallFinish);
+    connect(m_configSession, &HelperSessionClient::jobFinished, this, &DebListModel::slotConfigInstallFinish);
 
     // 配置安装的过程数据
-    connect(m_procInstallConfig, &Konsole::Pty::receivedData, this, &DebListModel::slotConfigReadOutput);
+    connect(m_configSession, &HelperSessionClient::outputReceived, this, &DebListModel::slotConfigReadOutput);
 
     // 向安装进程中写入配置信息（一般是配置的序号）
     connect(configWindow, &AptConfigMessage::AptConfigInputStr, this, &DebListModel::slotConfigInputWrite);
@@ -205,13 +217,16 @@ void DebListModel::slotDealDependResult(int authType, int dependIndex, const QSt
     m_brokenDepend = dependName;
     switch (authType) {
         case DebListModel::CancelAuth:
-            m_packageOperateStatus[m_packagesManager->getPackageMd5(dependIndex)] =
-                Pkg::PackageOperationStatus::Prepare;  // 取消授权后，缺失wine依赖的包的操作状态修改为prepare
+            if (auto record = m_packagesManager->m_packageTable.recordAt(dependIndex)) {
+                record->operateStatus = Pkg::PackageOperationStatus::Prepare;  // 取消授权后，缺失wine依赖的包的操作状态修改为prepare
+            }
             break;
         case DebListModel::AuthConfirm:  // 确认授权后，状态的修改由debinstaller进行处理
             break;
         case DebListModel::AuthDependsSuccess:  // 安装成功后，状态的修改由debinstaller进行处理
-            m_packageOperateStatus[m_packagesManager->getPackageMd5(dependIndex)] = Pkg::PackageOperationStatus::Prepare;
+            if (auto record = m_packagesManager->m_packageTable.recordAt(dependIndex)) {
+                record->operateStatus = Pkg::PackageOperationStatus::Prepare;
+            }
             m_workerStatus = WorkerPrepare;
             break;
         case DebListModel::AuthDependsErr:  // 安装失败后，状态的修改由debinstaller进行处理
@@ -232,7 +247,7 @@ bool DebListModel::isReady() const
 
 const QList<QString> DebListModel::preparedPackages() const
 {
-    return m_packagesManager->m_preparedPackages;
+    return m_packagesManager->m_packageTable.filePaths();
 }
 
 QModelIndex DebListModel::first() const
@@ -244,14 +259,14 @@ int DebListModel::rowCount(const QModelIndex &parent) const
 {
     Q_UNUSED(parent);
 
-    return m_packagesManager->m_preparedPackages.size();
+    return m_packagesManager->m_packageTable.size();
 }
 
 QVariant DebListModel::data(const QModelIndex &index, int role) const
 {
     const int currentRow = index.row();
     // 判断当前下标是否越界
-    if (currentRow < 0 || currentRow >= m_packagesManager->m_preparedPackages.size()) {
+    if (currentRow < 0 || currentRow >= m_packagesManager->m_packageTable.size()) {
         return QVariant();
     }
     // 当前给出的路径文件已不可访问.直接删除该文件
@@ -299,9 +314,8 @@ QVariant DebListModel::data(const QModelIndex &index, int role) const
         case PackageFailReasonRole:
             return packageFailedReason(currentRow);  // 获取当前index包的安装失败的原因
         case PackageOperateStatusRole: {
-            auto md5 = m_packagesManager->getPackageMd5(currentRow);
-            if (m_packageOperateStatus.contains(md5))  // 获取当前包的操作状态
-                return m_packageOperateStatus[md5];
+            if (auto record = m_packagesManager->m_packageTable.recordAt(currentRow))  // 获取当前包的操作状态
+                return record->operateStatus;
             else
                 return Pkg::PackageOperationStatus::Prepare;
         }
@@ -343,7 +357,7 @@ bool DebListModel::setData(const QModelIndex &index, const QVariant &value, int
 {
     const int currentRow = index.row();
     // 判断当前下标是否越界
-    if (currentRow < 0 || currentRow >= m_packagesManager->m_preparedPackages.size()) {
+    if (currentRow < 0 || currentRow >= m_packagesManager->m_packageTable.size()) {
         return false;
     }
 
@@ -375,12 +389,35 @@ bool DebListModel::slotInstallPackages()
     m_workerStatus = WorkerProcessing;  // 刷新包安装器的工作状态
     m_operatingIndex = 0;               // 初始化当前操作的index
     m_operatingStatusIndex = 0;
-    m_operatingPackageMd5 = m_packageMd5[m_operatingIndex];
+    m_operatingHandle = m_packagesManager->m_packageTable.handleAt(m_operatingIndex);
     m_hierarchicalVerifyError = false;
 
     // start first
     initRowStatus();  // 初始化包的操作状态
 
+    // 分级管控首次查询未返回时，收到查询结果后再开始安装，不阻塞等待DBus返回
+    if (HierarchicalVerify::instance()->isProbing()) {
+        if (!m_hierarchicalProbeConnection) {
+            m_hierarchicalProbeConnection =
+                connect(HierarchicalVerify::instance(), &HierarchicalVerify::interfaceProbed, this, [this]() {
+                    disconnect(m_hierarchicalProbeConnection);
+                    m_hierarchicalProbeConnection = {};
+                    startInstallPackages();
+                });
+        }
+        return true;
+    }
+
+    return startInstallPackages();
+}
+
+bool DebListModel::startInstallPackages()
+{
+    // 等待分级管控查询期间安装流程已被重置
+    if (WorkerProcessing != m_workerStatus) {
+        return false;
+    }
+
     // 检查当前应用是否在黑名单中
     // 非开发者模式且数字签名验证失败
     if (checkBlackListApplication() || !checkDigitalSignature())
@@ -394,7 +431,7 @@ bool DebListModel::slotUninstallPackage(int index)
 {
     m_workerStatus = WorkerProcessing;  // 刷新当前包安装器的工作状态
     m_operatingIndex = index;           // 获取卸载的包的indx
-    m_operatingPackageMd5 = m_packageMd5[m_operatingIndex];
+    m_operatingHandle = m_packagesManager->m_packageTable.handleAt(m_operatingIndex);
     // fix bug : 卸载失败时不提示卸载失败。
     m_operatingStatusIndex = index;  // 刷新操作状态的index
     m_hierarchicalVerifyError = false;
@@ -492,17 +529,11 @@ void DebListModel::removePackage(const int idx)
     if (WorkerPrepare != m_workerStatus) {
         qWarning() << "installer status error";
     }
-    // 去除操作状态 中的index
-    int packageOperateStatusCount = m_packageOperateStatus.size() - 1;
-    m_packageOperateStatus.clear();
-    for (int i = 0; i < packageOperateStatusCount; i++) {
-        m_packageOperateStatus[m_packagesManager->getPackageMd5(i)] = Pkg::PackageOperationStatus::Prepare;
-    }
-
-    if (0 <= idx && idx < m_packagesManager->m_packageMd5.size()) {
-        m_packagePtrMap.remove(m_packagesManager->m_packageMd5[idx]);
-    }
+    // 重置所有包的操作状态
+    m_packagesManager->m_packageTable.forEachRecord(
+        [](PackageRecord &record) { record.operateStatus = Pkg::PackageOperationStatus::Prepare; });
 
+    // 包记录（包括缓存的 DebPackage）随包一并删除
     m_packagesManager->removePackage(idx);  // 在packageManager中删除标记的下标
 }
 
@@ -518,24 +549,30 @@ Pkg::DependsStatus DebListModel::checkDependsStatus(const QString &package_path)
 
 int DebListModel::checkDigitalSignature(const QString &package_path)
 {
+    int result = Utils::VerifySuccess;
+    if (!digitalSignatureVerifyRequired(package_path, result)) {
+        return result;
+    }
+
+    return Utils::Digital_Verify(package_path);  // 判断是否有数字签名
+}
+
+bool DebListModel::digitalSignatureVerifyRequired(const QString &package_path, int &result)
+{
+    result = Utils::VerifySuccess;
+
     // 分级管控可用时，交由分级管控进行签名验证
     if (HierarchicalVerify::instance()->isValid()) {
-        return Utils::VerifySuccess;
+        return false;
     }
 
     const auto stat = m_packagesManager->checkDependsStatus(package_path);  // 获取包的依赖状态
     if (stat.isBreak() || stat.isAuthCancel())
-        return Utils::VerifySuccess;
+        return false;
     SettingDialog dialog;
     m_isDigitalVerify = dialog.isDigitalVerified();
-    int digitalSigntual = Utils::Digital_Verify(package_path);  // 判断是否有数字签名
-    if (m_isDevelopMode && !m_isDigitalVerify) {                // 开发者模式且未设置验签功能
-        return Utils::VerifySuccess;
-    } else if (m_isDevelopMode && m_isDigitalVerify) {  // 开发者模式且设置验签功能
-        return digitalSigntual;
-    } else {  // 非开发者模式
-        return digitalSigntual;
-    }
+    // 开发者模式且未设置验签功能，无需验签；其它情况均需调用验签工具
+    return !(m_isDevelopMode && !m_isDigitalVerify);
 }
 
 QStringList DebListModel::getPackageInfo(const QString &package_path)
@@ -586,36 +623,28 @@ void DebListModel::reset()
 {
     m_workerStatus = WorkerPrepare;  // 工作状态重置为准备态
     m_operatingIndex = 0;            // 当前操作的index置为0
-    m_operatingPackageMd5 = nullptr;
+    m_operatingHandle = PackageHandle();
     m_operatingStatusIndex = 0;  // 当前操作状态的index置为0
 
-    m_packagePtrMap.clear();
-
-    m_packageOperateStatus.clear();  // 清空操作状态列表
-    m_packageFailCode.clear();       // 清空错误原因列表
-    m_packageFailReason.clear();
-    m_packagesManager->reset();  // 重置packageManager
+    m_packagesManager->reset();  // 重置packageManager，清空操作状态及错误原因
 
     m_hierarchicalVerifyError = false;  // 复位分级管控安装状态
 }
 
 int DebListModel::getInstallFileSize()
 {
-    return m_packagesManager->m_preparedPackages.size();
+    return m_packagesManager->m_packageTable.size();
 }
 
 void DebListModel::resetFileStatus()
 {
-    m_packageOperateStatus.clear();  // 重置包的操作状态
-    m_packageFailReason.clear();     // 重置包的错误状态
-    m_packageFailCode.clear();
+    // 重置包的操作状态及错误状态
+    m_packagesManager->m_packageTable.forEachRecord([](PackageRecord &record) { record.resetOperation(); });
 }
 
 void DebListModel::resetInstallStatus()
 {
-    m_packageOperateStatus.clear();  // 重置包的操作状态
-    m_packageFailReason.clear();     // 重置包的错误状态
-    m_packageFailCode.clear();
+    resetFileStatus();
 
     initPrepareStatus();
 }
@@ -625,7 +654,7 @@ void DebListModel::bumpInstallIndex()
     if (m_currentTransaction.isNull()) {
         qWarning() << "previous transaction not finished";
     }
-    if (++m_operatingIndex >= m_packagesManager->m_preparedPackages.size()) {
+    if (++m_operatingIndex >= m_packagesManager->m_packageTable.size()) {
         m_workerStatus = WorkerFinished;       // 设置包安装器的工作状态为Finish
         emit signalWorkerFinished();           // 发送安装完成信号
         emit signalWholeProgressChanged(100);  // 修改安装进度
@@ -633,7 +662,7 @@ void DebListModel::bumpInstallIndex()
         return;
     }
     ++m_operatingStatusIndex;
-    m_operatingPackageMd5 = m_packageMd5[m_operatingIndex];
+    m_operatingHandle = m_packagesManager->m_packageTable.handleAt(m_operatingIndex);
     emit signalCurrentProcessPackageIndex(m_operatingIndex);  // 修改当前操作的下标
     // install next
     qInfo() << "DebListModel:"
@@ -656,10 +685,7 @@ void DebListModel::slotTransactionErrorOccurred()
         return;
     // 失败时刷新操作状态为failed,并记录失败原因
     refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);
-    m_packageOperateStatus[m_operatingPackageMd5] = Pkg::PackageOperationStatus::Failed;
-
-    m_packageFailCode[m_operatingPackageMd5] = transaction->error();
-    m_packageFailReason[m_operatingPackageMd5] = transaction->errorString();
+    setOperatingPackageFailure(transaction->error(), transaction->errorString());
 
     if (!transaction->errorString().contains("proper authorization was not provided"))
         emit signalAppendOutputInfo(transaction->errorString());
@@ -696,17 +722,35 @@ void DebListModel::slotTransactionErrorOccurred()
 
 void DebListModel::refreshOperatingPackageStatus(Pkg::PackageOperationStatus operationStatus)
 {
-    m_packageOperateStatus[m_operatingPackageMd5] = operationStatus;  // 将失败包的索引和状态修改保存,用于更新
+    if (auto record = operatingRecord()) {
+        record->operateStatus = operationStatus;  // 将失败包的索引和状态修改保存,用于更新
+    }
 
     const QModelIndex modelIndex = index(m_operatingStatusIndex);
 
     emit dataChanged(modelIndex, modelIndex);  // 发送状态已经修改的信号
 }
 
+void DebListModel::setOperatingPackageFailure(int failCode, const QString &failReason)
+{
+    if (auto record = operatingRecord()) {
+        record->failCode = failCode;
+        record->failReason = failReason;
+    }
+}
+
+PackageRecord *DebListModel::operatingRecord() const
+{
+    return m_packagesManager->m_packageTable.record(m_operatingHandle);
+}
+
 QString DebListModel::packageFailedReason(const int idx) const
 {
     const auto dependStatus = m_packagesManager->getPackageDependsStatus(idx);  // 获取包的依赖状态
-    const auto md5 = m_packagesManager->getPackageMd5(idx);                     // 获取包的md5值
+    const PackageRecord *record = m_packagesManager->m_packageTable.recordAt(idx);
+    if (!record) {
+        return {};
+    }
     if (m_packagesManager->isArchError(idx))
         return tr("Unmatched package architecture");  // 判断是否架构冲突
 
@@ -747,8 +791,8 @@ QString DebListModel::packageFailedReason(const int idx) const
             Q_FALLTHROUGH();
         case Pkg::DependsAuthCancel: {  // 依赖状态错误
             if (!dependStatus.package.isEmpty() || !m_brokenDepend.isEmpty()) {
-                if (m_packagesManager->m_errorIndex.contains(md5)) {  // 修改wine依赖的标记方式
-                    auto ret = static_cast<DebListModel::DependsAuthStatus>(m_packagesManager->m_errorIndex.value(md5));
+                if (record->dependsAuthError >= 0) {  // 修改wine依赖的标记方式
+                    auto ret = static_cast<DebListModel::DependsAuthStatus>(record->dependsAuthError);
                     switch (ret) {
                         case DebListModel::VerifyDependsErr:
                             return m_brokenDepend + tr("Invalid digital signature");
@@ -771,7 +815,7 @@ QString DebListModel::packageFailedReason(const int idx) const
     }
 
     // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
-    return workerErrorString(m_packageFailCode[md5], m_packageFailReason[md5]);  // 根据错误代码和错误原因返回具体的错误原因
+    return workerErrorString(record->failCode, record->failReason);  // 根据错误代码和错误原因返回具体的错误原因
 }
 
 void DebListModel::slotTransactionFinished()
@@ -785,10 +829,11 @@ void DebListModel::slotTransactionFinished()
         return;
     // prevent next signal
     disconnect(transaction, &Transaction::finished, this, &DebListModel::slotTransactionFinished);  // 不再接收trans结束的信号
+    m_transactionSpan.end();
 
     // report new progress
     // 更新安装进度（批量安装进度控制）
-    int progressValue = static_cast<int>(100. * (m_operatingIndex + 1) / m_packagesManager->m_preparedPackages.size());
+    int progressValue = static_cast<int>(100. * (m_operatingIndex + 1) / m_packagesManager->m_packageTable.size());
     emit signalWholeProgressChanged(progressValue);
 
     qInfo() << "DebListModel:"
@@ -801,8 +846,11 @@ void DebListModel::slotTransactionFinished()
         if (errorInfo.isEmpty()) {
             errorInfo = transaction->errorString();
         }
-        QString sPackageName = m_packagesManager->m_preparedPackages[m_operatingIndex];
-        bool verifyError = HierarchicalVerify::instance()->checkTransactionError(sPackageName, errorInfo);
+        bool verifyError = false;
+        if (auto pkgPtr = packagePtr(m_operatingIndex)) {
+            verifyError = HierarchicalVerify::instance()->checkTransactionError(
+                pkgPtr->debInfo()->packageName(), errorInfo, pkgPtr->debInfo()->version(), pkgPtr->md5());
+        }
 
         // 检测安装失败时，弹出对话框提示
         if (verifyError) {
@@ -812,22 +860,22 @@ void DebListModel::slotTransactionFinished()
 
         // 保存错误原因和错误代码
         // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
-        m_packageFailCode[m_operatingPackageMd5] =
-            verifyError ? static_cast<int>(Pkg::DigitalSignatureError) : static_cast<int>(transaction->error());
-        m_packageFailReason[m_operatingPackageMd5] = transaction->errorString();
+        setOperatingPackageFailure(
+            verifyError ? static_cast<int>(Pkg::DigitalSignatureError) : static_cast<int>(transaction->error()),
+            transaction->errorString());
 
         // 刷新操作状态
         refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);
         emit signalAppendOutputInfo(transaction->errorString());
-    } else if (m_packageOperateStatus.contains(m_operatingPackageMd5) &&
-               m_packageOperateStatus[m_operatingPackageMd5] != Pkg::PackageOperationStatus::Failed) {
+    } else if (operatingRecord() && operatingRecord()->operateStatus != Pkg::PackageOperationStatus::Failed) {
         // 安装成功
         refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Success);
 
         // 准备安装下一个包，修改下一个包的状态为正在安装状态
-        if (m_operatingStatusIndex < m_packagesManager->m_preparedPackages.size() - 1) {
-            auto md5 = m_packagesManager->getPackageMd5(m_operatingIndex + 1);
-            m_packageOperateStatus[md5] = Pkg::PackageOperationStatus::Waiting;
+        if (m_operatingStatusIndex < m_packagesManager->m_packageTable.size() - 1) {
+            if (auto record = m_packagesManager->m_packageTable.recordAt(m_operatingIndex + 1)) {
+                record->operateStatus = Pkg::PackageOperationStatus::Waiting;
+            }
         }
     }
     //    delete trans;
@@ -847,6 +895,7 @@ void DebListModel::slotDependsInstallTransactionFinished()  // 依赖安装关
     Transaction *transaction = qobject_cast<Transaction *>(sender());
     if (!transaction)
         return;
+    m_transactionSpan.end();
 
     const auto transExitStatus = transaction->exitStatus();
 
@@ -855,8 +904,7 @@ void DebListModel::slotDependsInstallTransactionFinished()  // 依赖安装关
         // 记录错误原因和错误代码
         // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
         qWarning() << transaction->error() << transaction->errorDetails() << transaction->errorString();  // 向终端打印错误
-        m_packageFailCode[m_operatingPackageMd5] = transaction->error();
-        m_packageFailReason[m_operatingPackageMd5] = transaction->errorString();
+        setOperatingPackageFailure(transaction->error(), transaction->errorString());
         refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);  // 刷新操作状态
         emit signalAppendOutputInfo(transaction->errorString());
     }
@@ -957,9 +1005,8 @@ void DebListModel::installDebs()
         refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);  // 刷新错误状态
 
         // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
-        m_packageFailCode.insert(m_operatingPackageMd5, -1);  // 保存错误原因
-        // 记录详细错误原因
-        m_packageFailReason.insert(m_operatingPackageMd5, packageFailedReason(m_operatingStatusIndex));
+        // 保存错误原因，记录详细错误原因
+        setOperatingPackageFailure(-1, packageFailedReason(m_operatingStatusIndex));
 
         bumpInstallIndex();  // 开始下一步的安装流程
         return;
@@ -967,12 +1014,16 @@ void DebListModel::installDebs()
         if (isDpkgRunning()) {
             qInfo() << "DebListModel:"
                     << "dpkg running, waitting...";
+            if (!m_dpkgLockSpan.isActive()) {
+                m_dpkgLockSpan.begin(deb.filePath());
+            }
             // 缩短检查的时间，每隔1S检查当前dpkg是否正在运行。
             QTimer::singleShot(1000 * 1, this, &DebListModel::installNextDeb);
             return;
         }
+        m_dpkgLockSpan.end();
         // 依赖可用 但是需要下载
-        Q_ASSERT_X(m_packageOperateStatus[m_operatingPackageMd5],
+        Q_ASSERT_X(operatingRecord() && operatingRecord()->operateStatus,
                    Q_FUNC_INFO,
                    "package operate status error when start install availble dependencies");
 
@@ -985,8 +1036,7 @@ void DebListModel::installDebs()
             if (p.contains(" not found")) {                                          // 依赖安装失败
                 refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);  // 刷新当前包的状态
                 // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
-                m_packageFailCode.insert(m_operatingPackageMd5, DownloadDisallowedError);  // 记录错误代码与错误原因
-                m_packageFailReason.insert(m_operatingPackageMd5, p);
+                setOperatingPackageFailure(DownloadDisallowedError, p);  // 记录错误代码与错误原因
                 emit signalAppendOutputInfo(m_packagesManager->package(m_operatingIndex) + "\'s depend " + " " +
                                             p);  // 输出错误原因
                 bumpInstallIndex();              // 开始安装下一个包或结束安装
@@ -1008,10 +1058,14 @@ void DebListModel::installDebs()
         if (isDpkgRunning()) {
             qInfo() << "DebListModel:"
                     << "dpkg running, waitting...";
+            if (!m_dpkgLockSpan.isActive()) {
+                m_dpkgLockSpan.begin(deb.filePath());
+            }
             // 缩短检查的时间，每隔1S检查当前dpkg是否正在运行。
             QTimer::singleShot(1000 * 1, this, &DebListModel::installNextDeb);
             return;
         }
+        m_dpkgLockSpan.end();
         transaction = backend->installFile(deb);  // 触发Qapt授权框和安装线程
         if (!transaction)
             return;
@@ -1037,6 +1091,8 @@ void DebListModel::installDebs()
 
     m_currentTransaction = transaction;
 
+    m_transactionSpan.begin(deb.filePath());
+    Metrics::add(Metrics::Transactions);
     m_currentTransaction->run();
 }
 
@@ -1045,8 +1101,7 @@ void DebListModel::digitalVerifyFailed(Pkg::ErrorCode errorCode)
     if (preparedPackages().size() > 1) {                                     // 批量安装
         refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);  // 刷新操作状态
         // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
-        m_packageFailCode.insert(m_operatingPackageMd5, errorCode);  // 记录错误代码与错误原因
-        m_packageFailReason.insert(m_operatingPackageMd5, "");
+        setOperatingPackageFailure(errorCode, "");  // 记录错误代码与错误原因
         bumpInstallIndex();  // 跳过当前包
     } else if (preparedPackages().size() == 1) {
         if (!m_isDevelopMode) {
@@ -1054,8 +1109,7 @@ void DebListModel::digitalVerifyFailed(Pkg::ErrorCode errorCode)
         } else {  // 开发者模式下，点击取消按钮，返回错误界面
             refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);  // 刷新操作状态
             // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
-            m_packageFailCode.insert(m_operatingPackageMd5, errorCode);  // 记录错误代码与错误原因
-            m_packageFailReason.insert(m_operatingPackageMd5, "");
+            setOperatingPackageFailure(errorCode, "");  // 记录错误代码与错误原因
             emit signalWorkerFinished();
         }
     }
@@ -1103,7 +1157,7 @@ void DebListModel::showNoDigitalErrWindow()
     }
 
     // 批量安装时，如果不是最后一个包，则不弹窗，只记录详细错误原因。
-    if (m_operatingIndex < m_packagesManager->m_preparedPackages.size() - 1) {
+    if (m_operatingIndex < m_packagesManager->m_packageTable.size() - 1) {
         digitalVerifyFailed(Pkg::NoDigitalSignature);  // 刷新安装错误，并记录错误原因
         return;
     }
@@ -1150,7 +1204,7 @@ void DebListModel::showDigitalErrWindow(bool recordError)
     }
 
     // 批量安装时，如果不是最后一个包，则不弹窗，只记录详细错误原因。
-    if (m_operatingIndex < m_packagesManager->m_preparedPackages.size() - 1) {
+    if (m_operatingIndex < m_packagesManager->m_packageTable.size() - 1) {
         if (recordError) {
             digitalVerifyFailed(Pkg::DigitalSignatureError);  // 刷新安装错误，并记录错误原因
         }
@@ -1364,8 +1418,33 @@ bool DebListModel::checkDigitalSignature()
     }
 }
 
+bool DebListModel::hierarchicalVerifyPassed(int index)
+{
+    if (!HierarchicalVerify::instance()->isValid()) {
+        return true;
+    }
+
+    auto pkgPtr = packagePtr(index);
+    if (!pkgPtr || !pkgPtr->debInfo()->isValid()) {
+        return true;
+    }
+
+    return HierarchicalVerify::instance()->pkgVerifyPassed(
+        pkgPtr->debInfo()->packageName(), pkgPtr->debInfo()->version(), pkgPtr->md5());
+}
+
 void DebListModel::installNextDeb()
 {
+    // 有效期内分级管控验签失败的包，不再重复提交安装
+    if (!hierarchicalVerifyPassed(m_operatingIndex)) {
+        qWarning() << "[Hierarchical] package verify failed before, skip" << m_packagesManager->package(m_operatingIndex);
+        m_hierarchicalVerifyError = true;
+        setOperatingPackageFailure(Pkg::DigitalSignatureError, {});
+        refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);
+        bumpInstallIndex();
+        return;
+    }
+
     // If package is first package or install to compatible mode, not need reset status.
     bool isFirstPackageAndCached = (0 == m_operatingStatusIndex) && m_packagesManager->cachedPackageDependStatus(m_operatingStatusIndex);
     if (!isFirstPackageAndCached) {
@@ -1385,15 +1464,17 @@ void DebListModel::installNextDeb()
         bumpInstallIndex();
         return;
     } else {  // 如果当前包的依赖全部安装完毕，则进入配置判断流程
-        QString sPackageName = m_packagesManager->m_preparedPackages[m_operatingIndex];
+        QString sPackageName = m_packagesManager->package(m_operatingIndex);
         if (Utils::checkPackageContainsDebConf(sPackageName)) {  // 检查当前包是否需要配置
-            m_procInstallConfig->start("pkexec",
-                                       QStringList() << "pkexec"
-                                                     << "deepin-deb-installer-dependsInstall"
-                                                     << "--install_config" << sPackageName,
-                                       {},
-                                       0,
-                                       false);  // 配置安装流程
+            m_configProcessSpan.begin(sPackageName);
+
+            // 后续连续的配置包合并为一次非交互安装，验签等耗时检查在线程池中执行
+            const QStringList candidates = collectConfigBatch();
+            if (candidates.isEmpty()) {
+                submitConfigInstall(sPackageName, {});
+            } else {
+                prepareConfigBatch(sPackageName, candidates);
+            }
         } else {
             installDebs();  // 普通安装流程
         }
@@ -1429,13 +1510,11 @@ void DebListModel::slotUninstallFinished()
     if (trans->exitStatus()) {
         m_workerStatus = WorkerFinished;                                     // 刷新包安装器的工作状态
         refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);  // 刷新当前包的操作状态
-        m_packageOperateStatus[m_operatingPackageMd5] = Pkg::PackageOperationStatus::Failed;
         qWarning() << "DebListModel:"
                    << "uninstall finished with finished code:" << trans->error() << "finished details:" << trans->errorString();
     } else {
         m_workerStatus = WorkerFinished;                                      // 刷新包安装器的工作状态
         refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Success);  // 刷新当前包的卸载状态
-        m_packageOperateStatus[m_operatingPackageMd5] = Pkg::PackageOperationStatus::Success;
     }
     emit signalWorkerFinished();  // 发送结束信号（只有单包卸载）卸载结束就是整个流程的结束
     trans->deleteLater();
@@ -1455,87 +1534,93 @@ void DebListModel::slotSetCurrentIndex(const QModelIndex &modelIndex)
 
 void DebListModel::initPrepareStatus()
 {
-    for (int i = 0; i < m_packagesManager->m_preparedPackages.size(); i++) {
-        auto md5 = m_packagesManager->getPackageMd5(i);
-        m_packageOperateStatus.insert(md5, Pkg::PackageOperationStatus::Prepare);  // 刷新当前所有包的状态为Prepare
-    }
+    // 刷新当前所有包的状态为Prepare
+    m_packagesManager->m_packageTable.forEachRecord(
+        [](PackageRecord &record) { record.operateStatus = Pkg::PackageOperationStatus::Prepare; });
 }
 
 void DebListModel::initRowStatus()
 {
-    // 更换状态存储方式后修改更新状态的方式
-    for (auto md5 : m_packageMd5) {
-        m_packageOperateStatus[md5] = Pkg::PackageOperationStatus::Waiting;
-    }
+    m_packagesManager->m_packageTable.forEachRecord(
+        [](PackageRecord &record) { record.operateStatus = Pkg::PackageOperationStatus::Waiting; });
 }
 
 void DebListModel::slotUpWrongStatusRow()
 {
-    if (m_packagesManager->m_preparedPackages.size() == 1)
+    if (m_packagesManager->m_packageTable.size() == 1)
         return;
 
     QList<QByteArray> installErrorPackages;    // 安装错误的包的list
     QList<QByteArray> installSuccessPackages;  // 安装成功的包的list
 
     // 根据包的操作状态，分别找到所有安装成功的包与安装失败的包
-    QMapIterator<QByteArray, int> iteratorpackageOperateStatus(m_packageOperateStatus);
-    while (iteratorpackageOperateStatus.hasNext()) {
-        iteratorpackageOperateStatus.next();
-        // 保存安装成功的包
-        if (iteratorpackageOperateStatus.value() == Pkg::PackageOperationStatus::Failed ||
-            iteratorpackageOperateStatus.value() == Pkg::PackageOperationStatus::VerifyFailed) {  // 安装失败或签名验证失败
-            installErrorPackages.append(iteratorpackageOperateStatus.key());                      // 保存下标
-        }
+    m_packagesManager->m_packageTable.forEachRecord([&](PackageRecord &record) {
         // 保存安装失败的包
-        if (iteratorpackageOperateStatus.value() == Pkg::PackageOperationStatus::Success) {
-            installSuccessPackages.append(iteratorpackageOperateStatus.key());
+        if (record.operateStatus == Pkg::PackageOperationStatus::Failed ||
+            record.operateStatus == Pkg::PackageOperationStatus::VerifyFailed) {  // 安装失败或签名验证失败
+            installErrorPackages.append(record.md5);
         }
-    }
+        // 保存安装成功的包
+        if (record.operateStatus == Pkg::PackageOperationStatus::Success) {
+            installSuccessPackages.append(record.md5);
+        }
+    });
     if (installErrorPackages.size() == 0)  // 全部安装成功 直接退出
         return;
 
-    // 先将包与md5 绑定
-    // 后续要对根据MD5对包的路径进行排序，保证包名和md5的下标统一
-    QMap<QByteArray, QString> md5Packages;
-    for (int i = 0; i < m_packagesManager->m_packageMd5.size(); i++) {
-        md5Packages.insert(m_packagesManager->m_packageMd5[i], m_packagesManager->m_preparedPackages[i]);
-    }
-
-    m_packagesManager->m_packageMd5.clear();
-    m_packagesManager->m_packageMd5.append(installErrorPackages);
-    m_packagesManager->m_packageMd5.append(installSuccessPackages);
-
-    m_packagesManager->m_preparedPackages.clear();
-    for (int i = 0; i < m_packagesManager->m_packageMd5.size(); i++) {
-        m_packagesManager->m_preparedPackages.append(md5Packages[m_packagesManager->m_packageMd5[i]]);
-    }
+    // 失败的包排在前面，包路径与md5保存在同一记录中，无需再次绑定
+    m_packagesManager->m_packageTable.setRowOrder(installErrorPackages + installSuccessPackages);
 
     // update view
     const QModelIndex idxStart = index(0);
-    const QModelIndex idxEnd = index(m_packageOperateStatus.size() - 1);
+    const QModelIndex idxEnd = index(rowCount() - 1);
     emit dataChanged(idxStart, idxEnd);
 
     // update scroll
     emit signalCurrentProcessPackageIndex(-1);
 }
 
-void DebListModel::slotConfigInstallFinish(int installResult)
+void DebListModel::slotConfigInstallFinish(int installResult, const QList<int> &packageResults)
 {
-    if (m_packagesManager->m_preparedPackages.size() == 0)
+    m_configProcessSpan.end();
+    if (m_packagesManager->m_packageTable.size() == 0)
         return;
+
+    // 批量配置安装，按辅助进程返回的每个包的结果刷新状态，未返回时共用安装结果，最后一个包按单包流程处理
+    int batchIndex = 0;
+    for (; m_configBatchSize > 1 && m_operatingIndex + 1 < m_packagesManager->m_packageTable.size();
+         --m_configBatchSize, ++batchIndex) {
+        const int packageResult = packageResults.value(batchIndex, installResult);
+        if (0 == packageResult) {
+            refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Success);
+        } else {
+            refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);
+            setOperatingPackageFailure(packageResult, "Config install failed");
+        }
+
+        ++m_operatingIndex;
+        ++m_operatingStatusIndex;
+        m_operatingHandle = m_packagesManager->m_packageTable.handleAt(m_operatingIndex);
+        emit signalCurrentProcessPackageIndex(m_operatingIndex);
+    }
+    m_configBatchSize = 1;
     int progressValue = static_cast<int>(100. * (m_operatingIndex + 1) /
-                                         m_packagesManager->m_preparedPackages.size());  // 批量安装时对进度进行处理
+                                         m_packagesManager->m_packageTable.size());  // 批量安装时对进度进行处理
     emit signalWholeProgressChanged(progressValue);
-    if (0 == installResult) {  // 安装成功
-        if (m_packagesManager->m_packageMd5DependsStatus[m_packagesManager->m_packageMd5[m_operatingIndex]].status ==
-            Pkg::DependsStatus::DependsOk) {
+    const int packageResult = packageResults.value(batchIndex, installResult);
+    if (0 == packageResult) {  // 安装成功
+        const PackageRecord *record = m_packagesManager->m_packageTable.recordAt(m_operatingIndex);
+        if (record && record->dependsStatus.status == Pkg::DependsStatus::DependsOk) {
             refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Success);  // 刷新安装状态
-            m_procInstallConfig->terminate();                                     // 结束配置
-            m_procInstallConfig->close();
         }
         bumpInstallIndex();  // 开始安装下一个
+    } else if (!packageResults.isEmpty()) {
+        // 批量任务已执行，当前包自身安装失败
+        refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);
+        setOperatingPackageFailure(packageResult, "Config install failed");
+        bumpInstallIndex();
     } else {
-        if (1 == m_packagesManager->m_preparedPackages.size()) {                  // 单包安装
+        if (1 == m_packagesManager->m_packageTable.size()) {                  // 单包安装
             refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Prepare);  // 刷新当前包的操作状态为准备态
             m_workerStatus = WorkerPrepare;
             emit signalAuthCancel();  // 授权取消
@@ -1544,8 +1629,7 @@ void DebListModel::slotConfigInstallFinish(int installResult)
             refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);  // 刷新当前包的状态为失败
 
             // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
-            m_packageFailCode.insert(m_operatingPackageMd5, installResult);  // 保存失败原因
-            m_packageFailReason.insert(m_operatingPackageMd5, "Authentication failed");
+            setOperatingPackageFailure(installResult, "Authentication failed");  // 保存失败原因
             bumpInstallIndex();  // 开始安装下一个
         }
     }
@@ -1593,6 +1677,91 @@ void DebListModel::slotConfigInputWrite(const QString &str)
     m_procInstallConfig->pty()->write("\n");          // 写入换行，配置生效
 }
 
+QStringList DebListModel::collectConfigBatch()
+{
+    QStringList packages;
+    for (int i = m_operatingIndex + 1; i < m_packagesManager->m_packageTable.size(); ++i) {
+        // 仅合并无需其它处理的包，遇到不满足条件的包即结束批次，保持安装顺序
+        // 前面的包安装后依赖状态可能变化，与单包流程相同，先刷新状态
+        m_packagesManager->resetPackageDependsStatus(i);
+        const PackageDependsStatus stat = m_packagesManager->getPackageDependsStatus(i);
+        // 黑名单应用不合并，由 bumpInstallIndex 中 checkBlackListApplication 提示禁止安装
+        if (stat.isProhibit()) {
+            break;
+        }
+        if (Pkg::DependsStatus::DependsOk != stat.status || (stat.canInstallCompatible() && supportCompatible())) {
+            break;
+        }
+
+        if (!hierarchicalVerifyPassed(i)) {
+            break;
+        }
+
+        packages << m_packagesManager->package(i);
+    }
+
+    return packages;
+}
+
+/**
+ * @brief prepareConfigBatch 在线程池中对候选包验签并检查 DebConf 配置，完成后提交批量配置安装
+ *  验签需要调用外部工具解包校验，不在界面线程中执行
+ */
+void DebListModel::prepareConfigBatch(const QString &packagePath, const QStringList &candidates)
+{
+    // 分级管控可用时由分级管控验签，开发者模式且未设置验签功能时无需验签
+    bool verifySignature = false;
+    if (!HierarchicalVerify::instance()->isValid()) {
+        SettingDialog dialog;
+        m_isDigitalVerify = dialog.isDigitalVerified();
+        verifySignature = !(m_isDevelopMode && !m_isDigitalVerify);
+    }
+
+    auto watcher = new QFutureWatcher<int>(this);
+    connect(watcher, &QFutureWatcher<int>::finished, this, [this, watcher, packagePath, candidates]() {
+        watcher->deleteLater();
+        if (WorkerProcessing != m_workerStatus) {
+            return;
+        }
+
+        submitConfigInstall(packagePath, candidates.mid(0, watcher->result()));
+    });
+    watcher->setFuture(QtConcurrent::run(&DebListModel::countConfigBatch, candidates, verifySignature));
+}
+
+/**
+ * @brief countConfigBatch 返回 \a candidates 开头连续的、验签通过且包含 DebConf 配置的包数量，在线程池中执行
+ */
+int DebListModel::countConfigBatch(const QStringList &candidates, bool verifySignature)
+{
+    int count = 0;
+    for (const QString &packagePath : candidates) {
+        if (verifySignature && Utils::VerifySuccess != Utils::Digital_Verify(packagePath)) {
+            break;
+        }
+        if (!Utils::checkPackageContainsDebConf(packagePath)) {
+            break;
+        }
+        ++count;
+    }
+
+    return count;
+}
+
+void DebListModel::submitConfigInstall(const QString &packagePath, const QStringList &batchPackages)
+{
+    m_configBatchSize = 1 + batchPackages.size();
+
+    QStringList params{"--install_config"};
+    if (!m_debconfPreseed.isEmpty() && QFile::exists(m_debconfPreseed)) {
+        params << "--preseed" << m_debconfPreseed;
+    }
+    params << packagePath << batchPackages;
+
+    // 配置安装流程，连续的配置包复用已授权的提权会话，队列为空时会话自动退出
+    m_configSession->submit(params);
+}
+
 void DebListModel::slotCheckInstallStatus(const QString &installInfo)
 {
     // 判断当前的信息是否是错误提示信息
@@ -1603,9 +1772,7 @@ void DebListModel::slotCheckInstallStatus(const QString &installInfo)
         refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);  // 刷新当前包的操作状态
 
         // 修改map存储的数据格式，将错误原因与错误代码与包绑定，而非与下标绑定
-        m_packageOperateStatus[m_operatingPackageMd5] = Pkg::PackageOperationStatus::Failed;
-        m_packageFailCode.insert(m_operatingPackageMd5, 0);  // 保存失败原因
-        m_packageFailReason.insert(m_operatingPackageMd5, "");
+        setOperatingPackageFailure(0, "");  // 保存失败原因
         bumpInstallIndex();
         return;
     }
@@ -1634,8 +1801,8 @@ bool DebListModel::recheckPackagePath(const QString &packagePath) const
 
 void DebListModel::getPackageMd5(const QList<QByteArray> &packagesMD5)
 {
-    m_packageMd5.clear();
-    m_packageMd5 = packagesMD5;
+    // 包的md5由 PackagesManager 的记录表统一维护
+    Q_UNUSED(packagesMD5);
     emit signalAppendFinished();
 }
 
@@ -1646,7 +1813,7 @@ void DebListModel::slotShowProhibitWindow()
 void DebListModel::showProhibitWindow()
 {
     // 批量安装时，如果不是最后一个包，则不弹窗，只记录详细错误原因。
-    if (m_operatingIndex < m_packagesManager->m_preparedPackages.size() - 1) {
+    if (m_operatingIndex < m_packagesManager->m_packageTable.size() - 1) {
         digitalVerifyFailed(Pkg::ApplocationProhibit);  // 刷新安装错误，并记录错误原因
         return;
     }
@@ -1701,6 +1868,7 @@ DebListModel::~DebListModel()
 {
     delete m_packagesManager;
     delete configWindow;
+    delete m_configSession;
     delete m_procInstallConfig;
 }
 
@@ -1770,7 +1938,7 @@ void DebListModel::ensureCompatibleProcessor()
 
         connect(m_compProcessor.data(), &Compatible::CompatibleProcessController::progressChanged, this, [this](float progress) {
             const int progressValue =
-                static_cast<int>((100. / m_packagesManager->m_preparedPackages.size()) * (m_operatingIndex + progress / 100.));
+                static_cast<int>((100. / m_packagesManager->m_packageTable.size()) * (m_operatingIndex + progress / 100.));
             Q_EMIT signalWholeProgressChanged(progressValue);
 
             Q_EMIT signalCurrentPacakgeProgressChanged(static_cast<int>(progress));
@@ -1787,8 +1955,7 @@ void DebListModel::ensureCompatibleProcessor()
             } else {
                 auto pkgPtr = m_compProcessor->currentPackage();
                 if (pkgPtr) {
-                    m_packageFailCode.insert(m_operatingPackageMd5, pkgPtr->errorCode());
-                    m_packageFailReason.insert(m_operatingPackageMd5, pkgPtr->errorString());
+                    setOperatingPackageFailure(pkgPtr->errorCode(), pkgPtr->errorString());
 
                     if (Pkg::DigitalSignatureError == pkgPtr->errorCode()) {
                         m_hierarchicalVerifyError = true;
@@ -1848,7 +2015,7 @@ void DebListModel::ensureImmutableProcessor()
 
         connect(m_immProcessor.data(), &Immutable::ImmutableProcessController::progressChanged, this, [this](float progress) {
             const int progressValue =
-                static_cast<int>((100. / m_packagesManager->m_preparedPackages.size()) * (m_operatingIndex + progress / 100.));
+                static_cast<int>((100. / m_packagesManager->m_packageTable.size()) * (m_operatingIndex + progress / 100.));
             Q_EMIT signalWholeProgressChanged(progressValue);
 
             Q_EMIT signalCurrentPacakgeProgressChanged(static_cast<int>(progress));
@@ -1865,8 +2032,7 @@ void DebListModel::ensureImmutableProcessor()
             } else {
                 auto pkgPtr = m_immProcessor->currentPackage();
                 if (pkgPtr) {
-                    m_packageFailCode.insert(m_operatingPackageMd5, pkgPtr->errorCode());
-                    m_packageFailReason.insert(m_operatingPackageMd5, pkgPtr->errorString());
+                    setOperatingPackageFailure(pkgPtr->errorCode(), pkgPtr->errorString());
 
                     if (Pkg::DigitalSignatureError == pkgPtr->errorCode()) {
                         m_hierarchicalVerifyError = true;
@@ -1911,17 +2077,14 @@ Deb::DebPackage::Ptr DebListModel::packagePtr(int index) const
 {
     Deb::DebPackage::Ptr pkgPtr;
 
-    if (0 <= index && index < m_packagesManager->m_packageMd5.size()) {
-        const QByteArray md5 = m_packagesManager->m_packageMd5[index];
-        if (!m_packagePtrMap.contains(md5)) {
-            const QString packagePath = m_packagesManager->m_preparedPackages[index];
-            pkgPtr = Deb::DebPackage::Ptr::create(packagePath);
-
+    if (auto record = m_packagesManager->m_packageTable.recordAt(index)) {
+        if (!record->packagePtr) {
             // temporary code: wait for use DebPackage replace scattered package data
-            const_cast<DebListModel *>(this)->m_packagePtrMap.insert(md5, pkgPtr);
-        } else {
-            pkgPtr = m_packagePtrMap.value(md5);
+            record->packagePtr = Deb::DebPackage::Ptr::create(record->filePath);
+            // md5 already computed while appending, avoid hashing the deb again on GUI thread
+            record->packagePtr->setMd5(record->md5);
         }
+        pkgPtr = record->packagePtr;
     }
 
     return pkgPtr;
@@ -9,6 +9,7 @@
 #include "process/Pty.h"
 #include "abstract_package_list_model.h"
 #include "utils/deb_package.h"
+#include "utils/trace.h"
 
 #include <QApt/Backend>
 #include <QApt/DebFile>
@@ -29,6 +30,7 @@
 DWIDGET_USE_NAMESPACE
 
 class AptConfigMessage;
+class HelperSessionClient;
 namespace Compatible {
 class CompatibleProcessController;
 }
@@ -169,6 +171,13 @@ public:
      * @param package_path 路径
      */
     int checkDigitalSignature(const QString &package_path);
+    /**
+     * @brief digitalSignatureVerifyRequired 检查指定包是否需要调用验签工具
+     * @param package_path 路径
+     * @param result 无需验签时的签名检查结果
+     * @return 是否需要调用验签工具，验签工具可在工作线程调用
+     */
+    bool digitalSignatureVerifyRequired(const QString &package_path, int &result);
     /**
      * @brief searchPackageInstallInfo 查找指定包信息
      * @param package_path 路径
@@ -252,8 +261,9 @@ public slots:
     /**
      * @brief slotConfigInstallFinish 配置结束
      * @param flag 配置安装的结果
+     * @param packageResults 批量配置安装时每个包的结果，按安装顺序
      */
-    void slotConfigInstallFinish(int flag);
+    void slotConfigInstallFinish(int flag, const QList<int> &packageResults = {});
 
     /**
      * @brief slotConfigInputWrite 配置的输入数据处理
@@ -363,6 +373,19 @@ private:
      */
     void refreshOperatingPackageStatus(Pkg::PackageOperationStatus oprationStatus);
 
+    /**
+     * @brief setOperatingPackageFailure 记录当前操作的包的错误代码与错误原因
+     * @param failCode    错误代码
+     * @param failReason  详细错误信息
+     */
+    void setOperatingPackageFailure(int failCode, const QString &failReason);
+
+    /**
+     * @brief operatingRecord 获取当前操作的包的记录
+     * @return 包已被删除时返回 nullptr
+     */
+    PackageRecord *operatingRecord() const;
+
     /**
      * @brief packageFailedReason  获取包安装失败的原因
      * @param idx       包的下标
@@ -382,6 +405,19 @@ private:
      */
     bool checkDigitalSignature();
 
+    /**
+     * @brief startInstallPackages 检查并开始安装第一个包
+     * @return 是否开始安装
+     */
+    bool startInstallPackages();
+
+    /**
+     * @brief hierarchicalVerifyPassed 查询分级管控验签缓存
+     * @param index 包下标
+     * @return 有效期内未记录验签失败时返回true
+     */
+    bool hierarchicalVerifyPassed(int index);
+
     /**
      * @brief showNoDigitalErrWindow 弹出无数字签名的错误弹窗
      */
@@ -417,6 +453,28 @@ private:
      */
     bool checkBlackListApplication();
 
+    /**
+     * @brief 收集当前包之后可与当前包合并安装的候选配置包，用于批量非交互配置安装。
+     *
+     * @return 连续的、依赖满足且分级管控校验通过的软件包路径，验签及 DebConf 检查由 countConfigBatch 完成
+     */
+    QStringList collectConfigBatch();
+
+    /**
+     * @brief 在线程池中检查候选包，完成后提交配置安装
+     */
+    void prepareConfigBatch(const QString &packagePath, const QStringList &candidates);
+
+    /**
+     * @brief 候选包开头连续的验签通过且包含 DebConf 配置的包数量，可在非界面线程调用
+     */
+    static int countConfigBatch(const QStringList &candidates, bool verifySignature);
+
+    /**
+     * @brief 提交配置安装任务，\a batchPackages 非空时与 \a packagePath 合并为一次非交互安装
+     */
+    void submitConfigInstall(const QString &packagePath, const QStringList &batchPackages);
+
     /**
      * @brief 数字签名校验失败 弹窗处理的槽函数
      *
@@ -479,7 +537,7 @@ private:
 
     // Compatbile interface
     // compatible mode only support single package install/uninstall.
-    [[nodiscard]] inline bool supportCompatible() const { return 1 == m_packagesManager->m_preparedPackages.size(); }
+    [[nodiscard]] inline bool supportCompatible() const { return 1 == m_packagesManager->m_packageTable.size(); }
 
     void ensureCompatibleProcessor();
     [[nodiscard]] bool installCompatiblePackage();
@@ -499,8 +557,8 @@ private:
     // 当前正在操作的状态的index
     int m_operatingStatusIndex = 0;
 
-    // 当前正在处理的包的md5
-    QByteArray m_operatingPackageMd5 = nullptr;
+    // 当前正在处理的包
+    PackageHandle m_operatingHandle;
 
     // 当前的index
     QModelIndex m_currentIdx;
@@ -511,17 +569,21 @@ private:
     // 当前正在运行的Trans
     QPointer<QApt::Transaction> m_currentTransaction;
 
-    // 所有包的操作状态Map
-    QMap<QByteArray, int> m_packageOperateStatus = {};
-    // FailCode 错误代码 ，trans返回的错误代码
-    QMap<QByteArray, int> m_packageFailCode = {};
-    // FailReason , trans返回的详细错误信息
-    QMap<QByteArray, QString> m_packageFailReason = {};
-
-    QList<QByteArray> m_packageMd5 = {};
+    // 包的操作状态、错误代码及错误信息保存在 PackagesManager 的包记录表中
 
     // 配置安装进程
     Konsole::Pty *m_procInstallConfig = {};
+    // 配置安装的提权会话，批量安装时仅授权一次
+    HelperSessionClient *m_configSession = {};
+    // debconf 预置应答文件，设置后批量配置安装前载入其中的应答
+    QString m_debconfPreseed;
+    // 当前配置安装批次包含的软件包数量
+    int m_configBatchSize = 1;
+
+    // 安装流程中跨越事件循环的耗时阶段
+    Trace::AsyncSpan m_dpkgLockSpan{Trace::kCatInstall, "wait_dpkg_lock", Metrics::DpkgLockWaitSeconds};
+    Trace::AsyncSpan m_transactionSpan{Trace::kCatInstall, "transaction", Metrics::TransactionSeconds};
+    Trace::AsyncSpan m_configProcessSpan{Trace::kCatProcess, "install_config", Metrics::ConfigInstallSeconds};
 
     QString m_brokenDepend = "";
 
@@ -534,10 +596,10 @@ private:
 
     // 当前安装是否存在分级管控签名验证失败
     bool m_hierarchicalVerifyError = false;
+    QMetaObject::Connection m_hierarchicalProbeConnection;  // 等待分级管控首次查询结果后开始安装
 
     // Compatible
     Deb::DebPackage::Ptr m_currentPackage;
-    QMap<QByteArray, Deb::DebPackage::Ptr> m_packagePtrMap;
     QScopedPointer<Compatible::CompatibleProcessController> m_compProcessor;
 
     // immutable
@@ -3,17 +3,73 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "packageanalyzer.h"
+#include "ddim_index.h"
 #include "singleInstallerApplication.h"
 #include "compatible/compatible_backend.h"
+#include "immutable/immutable_backend.h"
+#include "utils/hierarchicalverify.h"
+#include "utils/qtcompat.h"
+#include "utils/trace.h"
 
 #include <QtDebug>
+#include <QFileInfo>
 #include <QThread>
 #include <QApplication>
 #include <QMetaType>
+#include <QtConcurrent>
+#include <QThreadPool>
 
 #include <QApt/Backend>
 #include <QApt/DebFile>
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// 候选包索引：包名 -> 下标，提供的虚拟包名 -> 下标，均保持输入顺序
+class DebIrIndex
+{
+public:
+    explicit DebIrIndex(const QList<DebIr> &irs)
+        : irs(irs)
+    {
+        for (int i = 0; i != irs.size(); ++i) {
+            nameIndex[irs[i].packageName].append(i);
+            for (const QString &virtualPackage : irs[i].virtualPackages) {
+                virtualIndex[virtualPackage].append(i);
+            }
+        }
+    }
+
+    // 对每一个或依赖按顺序查找第一个满足的包，找不到返回-1
+    int find(const PackageAnalyzer &analyzer, const QApt::DependencyItem &depend) const
+    {
+        for (const auto &item : depend) {
+            auto name = item.packageName();
+            for (int i : nameIndex.value(name)) {
+                if (analyzer.versionMatched(item.packageVersion(), irs[i].version, item.relationType())) {
+                    return i;
+                }
+            }
+            // 虚拟包没有版本信息，只匹配不限制版本的依赖
+            if (item.relationType() == QApt::NoOperand && virtualIndex.contains(name)) {
+                return virtualIndex.value(name).first();
+            }
+        }
+        return -1;
+    }
+
+private:
+    const QList<DebIr> &irs;
+    QHash<QString, QVector<int>> nameIndex;
+    QHash<QString, QVector<int>> virtualIndex;
+};
+
+}  // namespace
+
 PackageAnalyzer &PackageAnalyzer::instance()
 {
     static PackageAnalyzer analyzer;
@@ -58,6 +114,10 @@ void PackageAnalyzer::initBackend()
     if (CompBackend::instance()->compatibleExists()) {
         CompBackend::instance()->initBackend();
     }
+    ImmBackend::instance()->initBackend();
+    // query hierarchical verify interface asynchronous, handled in the main thread.
+    QMetaObject::invokeMethod(
+        HierarchicalVerify::instance(), []() { HierarchicalVerify::instance()->initInterface(); }, Qt::QueuedConnection);
 
     backend = new QApt::Backend;
     bool initSuccess = backend->init();
@@ -148,9 +208,9 @@ PackageAnalyzer::packageWithArch(const QString &packageName, const QString &sysA
             return package;
     }
 
-    for (auto *virtualPackage : backend->availablePackages()) {
-        if (virtualPackage->name() != packageName && virtualPackage->providesList().contains(packageName)) {
-            return packageWithArch(virtualPackage->name(), sysArch, annotation);
+    for (const QString &provider : virtualPackageProviders(packageName)) {
+        if (provider != packageName) {
+            return packageWithArch(provider, sysArch, annotation);
         }
     }
 
@@ -185,15 +245,39 @@ QString PackageAnalyzer::resolvMultiArchAnnotation(const QString &annotation, co
 
 bool PackageAnalyzer::virtualPackageIsExist(const QString &virtualPackageName) const
 {
-    // 由于没法搜索虚拟包，此处只能进行全包遍历
-    for (auto *package : backend->availablePackages()) {
-        if (package->name() != virtualPackageName && package->providesList().contains(virtualPackageName)) {
+    for (const QString &provider : virtualPackageProviders(virtualPackageName)) {
+        if (provider != virtualPackageName) {
             return true;
         }
     }
     return false;
 }
 
+QStringList PackageAnalyzer::virtualPackageProviders(const QString &virtualPackageName) const
+{
+    std::lock_guard<std::mutex> guard(dependCacheMutex);
+    if (!virtualProvidersIndexed) {
+        // 由于没法搜索虚拟包，此处只能进行全包遍历，遍历结果建立索引
+        for (auto *package : backend->availablePackages()) {
+            const QString name = package->name();
+            for (const QString &provide : package->providesList()) {
+                virtualProviders[provide].append(name);
+            }
+        }
+        virtualProvidersIndexed = true;
+    }
+
+    return virtualProviders.value(virtualPackageName);
+}
+
+void PackageAnalyzer::resetDependCache()
+{
+    std::lock_guard<std::mutex> guard(dependCacheMutex);
+    dependItemReadyCache.clear();
+    virtualProviders.clear();
+    virtualProvidersIndexed = false;
+}
+
 bool PackageAnalyzer::versionMatched(const QString &lhs, const QString &rhs, QApt::RelationType relationType) const
 {
     if (relationType == QApt::NoOperand) {
@@ -220,39 +304,52 @@ bool PackageAnalyzer::versionMatched(const QString &lhs, const QString &rhs, QAp
 
 bool PackageAnalyzer::dependIsReady(const QApt::DependencyItem &depend) const
 {
-    // 1.每个item内部为或关系，只要有一个满足条件，即可认为该依赖已就绪
-    bool isReady = false;
+    // 每个item内部为或关系，只要有一个满足条件，即可认为该依赖已就绪
     for (const auto &item : depend) {
-        // 2.简单检查item是否安装
-
-        // 2.1获取基本数据
-        auto name = item.packageName();
-        auto version = item.packageVersion();
-        auto type = item.relationType();
-        auto arch = item.multiArchAnnotation();
-
-        // 2.2获取包状态
-        auto package = packageWithArch(name, arch, "");
-        if (package != nullptr && package->isInstalled()) {
-            // 如果已安装，则检查版本情况
-            auto pkgVersion = package->version();
-
-            if (versionMatched(version, pkgVersion, type)) {
-                isReady = true;
-                break;
-            }
-        } else if (virtualPackageIsExist(name)) {  // 3.如果没有安装，则检查其作为虚拟包是否已安装
-            isReady = true;
-            break;
+        if (dependItemIsReady(item)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PackageAnalyzer::dependItemIsReady(const QApt::DependencyInfo &item) const
+{
+    // 1.获取基本数据
+    auto name = item.packageName();
+    auto version = item.packageVersion();
+    auto type = item.relationType();
+    auto arch = item.multiArchAnnotation();
+
+    const QString cacheKey = QString("%1:%2|%3|%4").arg(name).arg(arch).arg(static_cast<int>(type)).arg(version);
+    {
+        std::lock_guard<std::mutex> guard(dependCacheMutex);
+        auto cacheIter = dependItemReadyCache.constFind(cacheKey);
+        if (cacheIter != dependItemReadyCache.constEnd()) {
+            return cacheIter.value();
         }
     }
+
+    // 2.获取包状态
+    bool isReady = false;
+    auto package = packageWithArch(name, arch, "");
+    if (package != nullptr && package->isInstalled()) {
+        // 如果已安装，则检查版本情况
+        isReady = versionMatched(version, package->version(), type);
+    } else {
+        // 3.如果没有安装，则检查其作为虚拟包是否已安装
+        isReady = virtualPackageIsExist(name);
+    }
+
+    std::lock_guard<std::mutex> guard(dependCacheMutex);
+    dependItemReadyCache.insert(cacheKey, isReady);
     return isReady;
 }
 
 QList<QApt::DependencyItem> PackageAnalyzer::debDependNotInstalled(const DebIr &ir) const
 {
-    // 获取依赖项
-    auto debDepends = ir.depends;
+    // 获取依赖项，预依赖同样需要满足
+    auto debDepends = ir.preDepends + ir.depends;
 
     // 获取安装状态，已安装的就丢出去
     for (int i = 0; i != debDepends.size(); ++i) {
@@ -289,74 +386,296 @@ QList<DebIr> PackageAnalyzer::analyzeDebFiles(const QFileInfoList &infos,
     QList<DebIr> irs;
     QList<int> appNameNeedRemove;
     for (int i = 0; i != infos.size(); ++i) {
-        qWarning() << __FUNCTION__ << "analyze deb file:" << infos[i].absoluteFilePath();
-
         if (uiExited) {
             break;
         }
 
-        if (pkgWaitToAnalyzeTotal > 0) {
-            emit runAnalyzeDeb(true, alreadyAnalyzed++, pkgWaitToAnalyzeTotal);
-        }
-
-        auto path = infos[i].absoluteFilePath();
-        QApt::DebFile deb(path);
+        reportAnalyzeProgress();
 
-        if (!deb.isValid()) {  // 无效包直接去除
+        DebIr ir;
+        if (!analyzeDebFile(infos[i], excludeArchNotMatched, excludeInstalledOrLaterVersion, &ir)) {
             appNameNeedRemove.append(i);
             continue;
         }
 
-        // 如果需要丢掉不匹配的架构
-        bool archMatched = supportArch(deb.architecture());
-        if (excludeArchNotMatched && !archMatched) {
+        if (md5s->contains(ir.md5)) {  // 包已存在，去重
+            Metrics::add(Metrics::PackagesDeduped);
             appNameNeedRemove.append(i);
             continue;
+        } else {
+            md5s->insert(ir.md5);
         }
 
-        // 如果需要丢掉已安装或已安装高版本
-        if (excludeInstalledOrLaterVersion) {
-            auto pkg = packageWithArch(deb.packageName(), deb.architecture(), "");
-            if (pkg != nullptr && pkg->isInstalled()) {
-                if (QApt::Package::compareVersion(pkg->version(), deb.version()) >= 0) {
-                    appNameNeedRemove.append(i);
-                    continue;
-                }
+        irs.push_back(ir);
+    }
+
+    if (appNames != nullptr && !uiExited) {
+        for (int i = appNameNeedRemove.size() - 1; i != -1; --i) {
+            appNames->removeAt(appNameNeedRemove[i]);
+        }
+    }
+
+    return irs;
+}
+
+QList<QList<DebIr>> PackageAnalyzer::analyzeDebFileGroups(const QList<AnalyzeGroup> &groups, DdimIndex *index)
+{
+    // 包在所有分组中的位置(组下标，组内下标)，按字典序比较，越小优先级越高
+    using Position = QPair<int, int>;
+
+    QVector<Position> positions;
+    std::vector<std::vector<DebIr>> groupIrs(static_cast<size_t>(groups.size()));
+    std::vector<std::vector<char>> groupValid(static_cast<size_t>(groups.size()));
+    std::vector<std::vector<char>> groupIndexed(static_cast<size_t>(groups.size()));
+    for (int group = 0; group != groups.size(); ++group) {
+        const int count = groups[group].infos.size();
+        groupIrs[group].resize(static_cast<size_t>(count));
+        groupValid[group].assign(static_cast<size_t>(count), false);
+        groupIndexed[group].assign(static_cast<size_t>(count), false);
+        for (int index = 0; index != count; ++index) {
+            positions.append({group, index});
+        }
+    }
+
+    // 1.线程池中只解析包文件及计算md5，每个任务只写入自己位置上的结果，无需加锁
+    //   APT后端不是线程安全的，不在此处访问
+    //   当前线程可能也是全局线程池中的线程(如 appendDdimPackages )，等待期间让出占用的线程，
+    //   避免线程池只有一个线程时死锁，以及任务排在当前线程之后
+    QThreadPool::globalInstance()->releaseThread();
+    std::mutex doneMutex;
+    std::condition_variable doneChanged;
+    int done = 0;
+    QFuture<void> future = QtConcurrent::map(positions, [&](const Position &position) {
+        if (!uiExited) {
+            const AnalyzeGroup &group = groups[position.first];
+            bool indexed = false;
+            groupValid[position.first][position.second] = loadDebFile(group.infos[position.second],
+                                                                      group.excludeArchNotMatched,
+                                                                      &groupIrs[position.first][position.second],
+                                                                      index,
+                                                                      &indexed);
+            groupIndexed[position.first][position.second] = indexed;
+        }
+
+        std::lock_guard<std::mutex> guard(doneMutex);
+        ++done;
+        doneChanged.notify_one();
+    });
+
+    // 分析进度由当前线程上报
+    int reported = 0;
+    while (reported != positions.size()) {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneChanged.wait(lock, [&]() { return done != reported; });
+        const int current = done;
+        lock.unlock();
+
+        for (; reported != current; ++reported) {
+            reportAnalyzeProgress();
+        }
+    }
+    future.waitForFinished();
+    QThreadPool::globalInstance()->reserveThread();
+
+    // 2.在当前线程中过滤已安装或已安装高版本的包
+    for (const Position &position : positions) {
+        if (uiExited) {
+            break;
+        }
+
+        char &valid = groupValid[position.first][position.second];
+        if (valid && groups[position.first].excludeInstalledOrLaterVersion &&
+            isInstalledOrLaterVersion(groupIrs[position.first][position.second])) {
+            valid = false;
+        }
+    }
+
+    // 3.索引中不含依赖，只读取保留下来的包的control
+    QVector<Position> needDepends;
+    for (const Position &position : positions) {
+        if (groupValid[position.first][position.second] && groupIndexed[position.first][position.second]) {
+            needDepends.append(position);
+        }
+    }
+    QtConcurrent::blockingMap(needDepends, [&](const Position &position) {
+        const QFileInfo &info = groups[position.first].infos[position.second];
+        if (!readDebDepends(info.absoluteFilePath(), &groupIrs[position.first][position.second])) {
+            groupValid[position.first][position.second] = false;
+        }
+    });
+
+    // 4.去重：每个md5只保留优先级最高的位置
+    QSet<QByteArray> md5s;
+    QList<QList<DebIr>> results;
+    for (int group = 0; group != groups.size(); ++group) {
+        QStringList *appNames = groups[group].appNames;
+        QStringList keptAppNames;
+        QList<DebIr> irs;
+
+        for (int index = 0; index != groups[group].infos.size(); ++index) {
+            if (!groupValid[group][index]) {
+                continue;
+            }
+
+            DebIr &ir = groupIrs[group][index];
+            if (md5s.contains(ir.md5)) {  // 包已存在，去重
+                Metrics::add(Metrics::PackagesDeduped);
+                continue;
             }
+            md5s.insert(ir.md5);
+
+            if (appNames != nullptr && index < appNames->size()) {
+                keptAppNames.append(appNames->at(index));
+            }
+            irs.push_back(std::move(ir));
         }
 
-        auto packageMd5 = deb.md5Sum();
-        if (md5s->contains(packageMd5)) {  // 包已存在，去重
-            appNameNeedRemove.append(i);
-            continue;
-        } else {
-            md5s->insert(packageMd5);
+        if (appNames != nullptr && !uiExited) {
+            *appNames = keptAppNames;
+        }
+        results.append(irs);
+    }
+
+    qInfo() << __FUNCTION__ << "analyzed" << positions.size() << "deb files, kept" << md5s.size();
+    return results;
+}
+
+void PackageAnalyzer::parseDebFile(const QString &path, DebIr *ir) const
+{
+    QApt::DebFile deb(path);
+    ir->filePath = path;
+    ir->isValid = deb.isValid();
+    if (!ir->isValid) {
+        return;
+    }
+
+    ir->version = deb.version();
+    ir->shortDescription = deb.shortDescription();
+    ir->packageName = deb.packageName();
+    ir->architecture = deb.architecture();
+    ir->archMatched = supportArch(ir->architecture);
+    ir->md5 = deb.md5Sum();
+    ir->depends = deb.depends();
+    ir->preDepends = deb.preDepends();
+    Metrics::add(Metrics::HashedBytes, static_cast<quint64>(QFileInfo(path).size()));
+
+    // 提供的虚拟包，格式：name [(= version)] [, ...]
+    const QString provides = deb.controlField("Provides");
+    for (QString provide : provides.split(',', SKIP_EMPTY_PARTS)) {
+        provide = provide.section('(', 0, 0).section(':', 0, 0).trimmed();
+        if (!provide.isEmpty()) {
+            ir->virtualPackages.append(provide);
         }
+    }
+}
+
+void PackageAnalyzer::prefetchDebFile(const QString &path)
+{
+    const QString absolutePath = QFileInfo(path).absoluteFilePath();
 
-        // 生成ir
+    std::lock_guard<std::mutex> guard(prefetchMutex);
+    if (prefetched.contains(absolutePath)) {
+        return;
+    }
+
+    prefetched.insert(absolutePath, QtConcurrent::run([this, absolutePath]() {
+        Trace::ScopedSpan span(Trace::kCatAnalyze, "prefetch_deb", absolutePath);
         DebIr ir;
-        ir.filePath = path;
-        ir.version = deb.version();
-        ir.shortDescription = deb.shortDescription();
-        ir.packageName = deb.packageName();
-        ir.architecture = deb.architecture();
-        ir.archMatched = archMatched;
-        ir.md5 = deb.md5Sum();
-        ir.isValid = deb.isValid();
-        ir.depends = deb.depends();
-
-        // TODO：QApt不支持从deb内部提取提供的虚拟包
+        parseDebFile(absolutePath, &ir);
+        return ir;
+    }));
+}
 
-        irs.push_back(ir);
+void PackageAnalyzer::clearPrefetch()
+{
+    std::lock_guard<std::mutex> guard(prefetchMutex);
+    prefetched.clear();
+}
+
+bool PackageAnalyzer::analyzeDebFile(const QFileInfo &info,
+                                     bool excludeArchNotMatched,
+                                     bool excludeInstalledOrLaterVersion,
+                                     DebIr *ir,
+                                     DdimIndex *index) const
+{
+    bool indexed = false;
+    if (!loadDebFile(info, excludeArchNotMatched, ir, index, &indexed)) {
+        return false;
     }
 
-    if (appNames != nullptr && !uiExited) {
-        for (int i = appNameNeedRemove.size() - 1; i != -1; --i) {
-            appNames->removeAt(appNameNeedRemove[i]);
+    // 如果需要丢掉已安装或已安装高版本
+    if (excludeInstalledOrLaterVersion && isInstalledOrLaterVersion(*ir)) {
+        return false;
+    }
+
+    // 索引中不含依赖，只读取保留下来的包的control，无需计算md5
+    return !indexed || readDebDepends(info.absoluteFilePath(), ir);
+}
+
+bool PackageAnalyzer::loadDebFile(const QFileInfo &info, bool excludeArchNotMatched, DebIr *ir, DdimIndex *index, bool *indexed) const
+{
+    const QString path = info.absoluteFilePath();
+    Trace::ScopedSpan span(Trace::kCatAnalyze, "analyze_deb", path, Metrics::AnalyzeDebSeconds);
+
+    // 优先使用索引，其次使用预解析结果，都没有时当场解析
+    *indexed = index != nullptr && index->lookup(path, ir);
+    if (*indexed) {
+        ir->archMatched = supportArch(ir->architecture);
+    } else {
+        QFuture<DebIr> future;
+        bool isPrefetched = false;
+        {
+            std::lock_guard<std::mutex> guard(prefetchMutex);
+            auto iter = prefetched.find(path);
+            if (iter != prefetched.end()) {
+                future = iter.value();
+                prefetched.erase(iter);
+                isPrefetched = true;
+            }
+        }
+
+        if (isPrefetched) {
+            *ir = future.result();
+        } else {
+            parseDebFile(path, ir);
+        }
+
+        if (index != nullptr) {
+            index->insert(*ir);
         }
     }
 
-    return irs;
+    if (!ir->isValid) {  // 无效包直接去除
+        return false;
+    }
+
+    // 如果需要丢掉不匹配的架构
+    return !excludeArchNotMatched || ir->archMatched;
+}
+
+bool PackageAnalyzer::isInstalledOrLaterVersion(const DebIr &ir) const
+{
+    auto pkg = packageWithArch(ir.packageName, ir.architecture, "");
+    return pkg != nullptr && pkg->isInstalled() && QApt::Package::compareVersion(pkg->version(), ir.version) >= 0;
+}
+
+bool PackageAnalyzer::readDebDepends(const QString &path, DebIr *ir) const
+{
+    QApt::DebFile deb(path);
+    if (!deb.isValid()) {
+        return false;
+    }
+
+    ir->depends = deb.depends();
+    ir->preDepends = deb.preDepends();
+    return true;
+}
+
+void PackageAnalyzer::reportAnalyzeProgress()
+{
+    if (pkgWaitToAnalyzeTotal > 0) {
+        emit runAnalyzeDeb(true, alreadyAnalyzed++, pkgWaitToAnalyzeTotal);
+    }
 }
 
 void PackageAnalyzer::chooseDebFromDepend(QList<DebIr> *result,
@@ -364,36 +683,47 @@ void PackageAnalyzer::chooseDebFromDepend(QList<DebIr> *result,
                                           const QList<QApt::DependencyItem> &depends,
                                           const QList<DebIr> &debIrs) const
 {
-    for (const auto &depend : depends) {  // 对每一个不满足的依赖项
-        bool finded = false;
-        for (const auto &item : depend) {  // 对每一个或依赖
-            auto name = item.packageName();
-            auto version = item.packageVersion();
-            auto type = item.relationType();
-            for (const auto &ir : debIrs) {  // 对每一个候选包
-                if (ir.packageName == name && versionMatched(version, ir.version, type)) {
-                    auto depdeps = debDependNotInstalled(ir);  // 依赖包的依赖
-                    if (!depdeps.isEmpty()) {  // 有未就绪的依赖，在依赖包集合里面执行递归搜索
-                        chooseDebFromDepend(result, md5s, depdeps, debIrs);
-                    }
-                    if (!md5s->contains(ir.md5)) {
-                        md5s->insert(ir.md5);
-                        result->push_back(ir);
-                    }
-                    finded = true;
-                    break;
-                }
-            }
-            if (finded) {
-                break;
+    // 1.候选包索引
+    const DebIrIndex index(debIrs);
+    auto findCandidate = [this, &index](const QApt::DependencyItem &depend) { return index.find(*this, depend); };
+
+    // 2.依赖闭包，使用显式栈深度优先展开，候选包的依赖先于候选包输出
+    //   每个候选包只展开一次，存在循环依赖时也能结束
+    struct Frame
+    {
+        int candidate;
+        QList<QApt::DependencyItem> depends;
+        int next;
+    };
+    QVector<Frame> worklist{{-1, depends, 0}};
+    QSet<int> expanded;
+
+    while (!worklist.isEmpty()) {
+        Frame &frame = worklist.last();
+        if (frame.next < frame.depends.size()) {
+            const int candidate = findCandidate(frame.depends[frame.next++]);
+            if (candidate >= 0 && !expanded.contains(candidate)) {
+                expanded.insert(candidate);
+                // 依赖包的依赖，有未就绪的依赖时继续在依赖包集合里搜索
+                worklist.append({candidate, debDependNotInstalled(debIrs[candidate]), 0});
             }
+            continue;
+        }
+
+        const int candidate = frame.candidate;
+        worklist.removeLast();
+        if (candidate >= 0 && !md5s->contains(debIrs[candidate].md5)) {
+            md5s->insert(debIrs[candidate].md5);
+            result->push_back(debIrs[candidate]);
         }
     }
 }
 
 QList<DebIr> PackageAnalyzer::bestInstallQueue(const QList<DebIr> &installIrs, const QList<DebIr> &dependIrs)
 {
-    // TODO：后面重构的时候需要实现安装顺序计算，本轮需求仅实现抽取需要的包
+    Trace::ScopedSpan span(Trace::kCatAnalyze, "best_install_queue", {}, Metrics::InstallQueueSeconds);
+    // APT缓存在两次计算之间可能已经变化
+    resetDependCache();
 
     // 1.检查依赖是否已就绪，将未就绪的项抽取出来
     QList<QApt::DependencyItem> installDeps;  // 记录每一个安装项的依赖情况
@@ -404,9 +734,7 @@ QList<DebIr> PackageAnalyzer::bestInstallQueue(const QList<DebIr> &installIrs, c
             return QList<DebIr>();
         }
 
-        if (pkgWaitToAnalyzeTotal > 0) {
-            emit runAnalyzeDeb(true, alreadyAnalyzed++, pkgWaitToAnalyzeTotal);
-        }
+        reportAnalyzeProgress();
 
         auto notInstallDepends = debDependNotInstalled(installIr);
         if (!notInstallDepends.isEmpty()) {
@@ -419,6 +747,165 @@ QList<DebIr> PackageAnalyzer::bestInstallQueue(const QList<DebIr> &installIrs, c
     QSet<QByteArray> md5s;
     chooseDebFromDepend(&realDepends, &md5s, installDeps, dependIrs);
 
-    // 3.融合并返回结果
-    return realDepends + installIrs;
+    // 3.融合并按依赖关系排序
+    const auto layers = installLayers(realDepends + installIrs);
+    QList<DebIr> installQueue;
+    for (const auto &layer : layers) {
+        installQueue.append(layer);
+    }
+    qInfo() << __FUNCTION__ << "install" << installQueue.size() << "packages in" << layers.size() << "layers";
+
+    return installQueue;
+}
+
+QList<DebIr> PackageAnalyzer::installOrder(const QList<DebIr> &irs) const
+{
+    QList<DebIr> order;
+    for (const auto &layer : installLayers(irs)) {
+        order.append(layer);
+    }
+
+    return order;
+}
+
+QList<QList<DebIr>> PackageAnalyzer::installLayers(const QList<DebIr> &irs) const
+{
+    const int count = irs.size();
+
+    // 1.建立依赖图，边由包指向它的依赖，只记录集合内的包
+    const DebIrIndex index(irs);
+    std::vector<std::vector<int>> edges(static_cast<size_t>(count));
+    std::vector<std::vector<int>> preEdges(static_cast<size_t>(count));
+    for (int i = 0; i != count; ++i) {
+        for (const auto &depend : irs[i].depends) {
+            const int target = index.find(*this, depend);
+            if (target >= 0 && target != i) {
+                edges[i].push_back(target);
+            }
+        }
+        for (const auto &depend : irs[i].preDepends) {
+            const int target = index.find(*this, depend);
+            if (target >= 0 && target != i) {
+                edges[i].push_back(target);
+                preEdges[i].push_back(target);
+            }
+        }
+    }
+
+    // 2.Tarjan算法求强连通分量（循环依赖组），使用显式栈避免深度递归
+    //   分量按完成顺序编号，依赖所在的分量编号总是更小
+    std::vector<int> component(static_cast<size_t>(count), -1);
+    std::vector<int> visitOrder(static_cast<size_t>(count), -1);
+    std::vector<int> lowLink(static_cast<size_t>(count), 0);
+    std::vector<char> onStack(static_cast<size_t>(count), false);
+    std::vector<int> sccStack;
+    std::vector<std::pair<int, size_t>> callStack;  // 节点，下一条待访问的边
+    int nextOrder = 0;
+    int componentCount = 0;
+
+    auto visit = [&](int node) {
+        visitOrder[node] = lowLink[node] = nextOrder++;
+        sccStack.push_back(node);
+        onStack[node] = true;
+        callStack.push_back({node, 0});
+    };
+
+    for (int root = 0; root != count; ++root) {
+        if (visitOrder[root] >= 0) {
+            continue;
+        }
+
+        visit(root);
+        while (!callStack.empty()) {
+            const int node = callStack.back().first;
+            if (callStack.back().second < edges[node].size()) {
+                const int next = edges[node][callStack.back().second++];
+                if (visitOrder[next] < 0) {
+                    visit(next);
+                } else if (onStack[next]) {
+                    lowLink[node] = std::min(lowLink[node], visitOrder[next]);
+                }
+                continue;
+            }
+
+            if (lowLink[node] == visitOrder[node]) {
+                int member = -1;
+                do {
+                    member = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[member] = false;
+                    component[member] = componentCount;
+                } while (member != node);
+                ++componentCount;
+            }
+
+            callStack.pop_back();
+            if (!callStack.empty()) {
+                const int parent = callStack.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> members(static_cast<size_t>(componentCount));
+    for (int i = 0; i != count; ++i) {
+        members[component[i]].push_back(i);
+    }
+
+    // 3.计算层级：分量排在其依赖的最后一个层级之后
+    //   分量内部的预依赖再拆分为连续的子层级，被预依赖的包在前
+    std::vector<int> layerOf(static_cast<size_t>(count), 0);
+    std::vector<int> subLayer(static_cast<size_t>(count), 0);
+    std::vector<int> componentLastLayer(static_cast<size_t>(componentCount), 0);
+    int layerCount = 0;
+    for (int current = 0; current != componentCount; ++current) {
+        const auto &currentMembers = members[current];
+
+        int firstLayer = 0;
+        for (int member : currentMembers) {
+            for (int target : edges[member]) {
+                if (component[target] != current) {
+                    firstLayer = std::max(firstLayer, componentLastLayer[component[target]] + 1);
+                }
+            }
+        }
+
+        // 预依赖也成环时无法满足，子层级数以分量大小为上限
+        const int memberCount = static_cast<int>(currentMembers.size());
+        bool changed = true;
+        for (int round = 0; changed && round != memberCount; ++round) {
+            changed = false;
+            for (int member : currentMembers) {
+                for (int target : preEdges[member]) {
+                    if (component[target] == current && subLayer[target] + 1 > subLayer[member] &&
+                        subLayer[target] + 1 < memberCount) {
+                        subLayer[member] = subLayer[target] + 1;
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        int lastLayer = firstLayer;
+        for (int member : currentMembers) {
+            layerOf[member] = firstLayer + subLayer[member];
+            lastLayer = std::max(lastLayer, layerOf[member]);
+        }
+        componentLastLayer[current] = lastLayer;
+        layerCount = std::max(layerCount, lastLayer + 1);
+    }
+
+    // 4.按层级输出，层级内保持输入顺序
+    QList<QList<DebIr>> layers;
+    for (int layer = 0; layer != layerCount; ++layer) {
+        layers.append(QList<DebIr>());
+    }
+    for (int i = 0; i != count; ++i) {
+        layers[layerOf[i]].append(irs[i]);
+    }
+    // 预依赖成环时可能出现空层级
+    layers.erase(std::remove_if(layers.begin(), layers.end(), [](const QList<DebIr> &layer) { return layer.isEmpty(); }),
+                 layers.end());
+
+    return layers;
 }
@@ -6,8 +6,11 @@
 #define PACKAGEANALYZER_H
 
 #include <QObject>
+#include <QFuture>
+#include <QHash>
 
 #include <atomic>
+#include <mutex>
 
 #include "model/packageselectmodel.h"
 #include "utils/package_defines.h"
@@ -57,12 +60,36 @@ public:
                                  bool excludeArchNotMatched,
                                  bool excludeInstalledOrLaterVersion);
 
+    // 一组待分析的包，参数含义同 analyzeDebFiles
+    struct AnalyzeGroup
+    {
+        QFileInfoList infos;
+        QStringList *appNames = nullptr;
+        bool excludeArchNotMatched = false;
+        bool excludeInstalledOrLaterVersion = false;
+    };
+
+    // 在线程池中并发解析多组包，APT相关的过滤在当前线程中执行，返回值与groups一一对应
+    // 组间依据md5去重，结果与依次调用 analyzeDebFiles 一致：排在前面的组、组内靠前的包优先保留
+    // 传入index时优先使用索引中的结果，未命中的包分析后写入索引
+    QList<QList<DebIr>> analyzeDebFileGroups(const QList<AnalyzeGroup> &groups, DdimIndex *index = nullptr);
+
+    // 解析包文件生成ir，不做过滤，包无效时ir->isValid为false，可在任意线程调用
+    void parseDebFile(const QString &path, DebIr *ir) const;
+    // 在后台预先解析包，之后分析该包时直接使用解析结果，用于边遍历目录边解析
+    void prefetchDebFile(const QString &path);
+    // 丢弃未被使用的预解析结果
+    void clearPrefetch();
+
     // 提取未安装依赖，传入包名和对应的架构，返回未安装的依赖列表
     QList<QApt::DependencyItem> debDependNotInstalled(const DebIr &ir) const;
 
-    // 依赖是否就绪
+    // 依赖是否就绪，单个依赖项的结果会被缓存
     bool dependIsReady(const QApt::DependencyItem &depend) const;
 
+    // 清空依赖就绪状态及虚拟包索引的缓存，APT缓存可能变化时调用
+    void resetDependCache();
+
     // 虚拟包是否已安装
     bool virtualPackageIsExist(const QString &virtualPackageName) const;
 
@@ -70,7 +97,7 @@ public:
     // rhs是否以relationType的方式匹配lhs
     bool versionMatched(const QString &lhs, const QString &rhs, QApt::RelationType relationType) const;
 
-    // 抽取需要的依赖包
+    // 抽取需要的依赖包，依赖包先于依赖它的包写入result
     void chooseDebFromDepend(QList<DebIr> *result,
                              QSet<QByteArray> *md5s,
                              const QList<QApt::DependencyItem> &depends,
@@ -79,6 +106,13 @@ public:
     // 返回最佳安装顺序
     QList<DebIr> bestInstallQueue(const QList<DebIr> &installIrs, const QList<DebIr> &dependIrs);
 
+    // 按依赖关系将包分层，每层的依赖都在之前的层中（循环依赖的包在同一层），互相独立的依赖链归入同一层，可一并提交安装
+    // 预依赖的包总是在更早的层中；相同输入的结果稳定，层内保持输入顺序
+    QList<QList<DebIr>> installLayers(const QList<DebIr> &irs) const;
+
+    // installLayers() 依次展开的安装顺序，供逐个安装的流程使用
+    QList<DebIr> installOrder(const QList<DebIr> &irs) const;
+
 signals:
     // 正在初始化后端，true：启动，false：完成
     void runBackend(bool inProcess);
@@ -87,6 +121,26 @@ signals:
     void runAnalyzeDeb(bool inProcess, int currentRote, int pkgCount);
 
 private:
+    // 分析单个包，包无效或被过滤时返回false
+    bool analyzeDebFile(const QFileInfo &info,
+                        bool excludeArchNotMatched,
+                        bool excludeInstalledOrLaterVersion,
+                        DebIr *ir,
+                        DdimIndex *index = nullptr) const;
+    // 解析包并按架构过滤，不访问APT后端，可在任意线程调用；indexed返回结果是否来自索引（不含依赖）
+    bool loadDebFile(const QFileInfo &info, bool excludeArchNotMatched, DebIr *ir, DdimIndex *index, bool *indexed) const;
+    // 是否已安装相同或更高版本，访问APT后端，只在分析线程中调用
+    bool isInstalledOrLaterVersion(const DebIr &ir) const;
+    // 读取包的依赖及预依赖
+    bool readDebDepends(const QString &path, DebIr *ir) const;
+    // 分析进度加一，只在分析线程中调用
+    void reportAnalyzeProgress();
+
+    // 单个依赖项是否就绪
+    bool dependItemIsReady(const QApt::DependencyInfo &item) const;
+    // 提供虚拟包的包名，顺序同 availablePackages
+    QStringList virtualPackageProviders(const QString &virtualPackageName) const;
+
     QApt::Package *packageWithArch(const QString &packageName, const QString &sysArch, const QString &annotation) const;
     QString resolvMultiArchAnnotation(const QString &annotation, const QString &debArch, int multiArchType) const;
 
@@ -99,8 +153,19 @@ private:
     std::atomic_bool backendInInit;
     std::atomic_bool inPkgAnalyze;
     int pkgWaitToAnalyzeTotal = -1;
-    int alreadyAnalyzed = 0;
+    std::atomic_int alreadyAnalyzed{0};
     std::atomic_bool uiExited;
+
+    // 依赖查询缓存，key：包名:架构|关系|版本
+    mutable std::mutex dependCacheMutex;
+    mutable QHash<QString, bool> dependItemReadyCache;
+    // 虚拟包名 -> 提供它的包名，首次查询虚拟包时遍历一次全部可用包建立
+    mutable QHash<QString, QStringList> virtualProviders;
+    mutable bool virtualProvidersIndexed = false;
+
+    // 预解析结果，key：包的绝对路径，分析时取出
+    mutable std::mutex prefetchMutex;
+    mutable QHash<QString, QFuture<DebIr>> prefetched;
 };
 
 Q_DECLARE_METATYPE(QList<DebIr>);
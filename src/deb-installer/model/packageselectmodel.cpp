@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "packageselectmodel.h"
+#include "ddim_index.h"
 #include "model/packageanalyzer.h"
 
 #include <QStandardItemModel>
@@ -36,16 +37,25 @@ void PackageSelectModel::appendDdimPackages(const QList<DdimSt> &ddims)
         PackageAnalyzer::instance().startPkgAnalyze(ddim.mustInstallList.size() + ddim.selectList.size() +
                                                     ddim.dependList.size());
 
-        QSet<QByteArray> md5s;
-        auto currentMustInstallInfos =
-            PackageAnalyzer::instance().analyzeDebFiles(ddim.mustInstallList, &md5s, nullptr, true, true);
+        // 三个列表在线程池中并发分析，分组顺序即去重优先级
         QStringList selectAppNameList = ddim.selectAppNameList;
-        auto currentSelectInfos =
-            PackageAnalyzer::instance().analyzeDebFiles(ddim.selectList, &md5s, &selectAppNameList, false, false);
-        auto currentDependInfos = PackageAnalyzer::instance().analyzeDebFiles(ddim.dependList, &md5s, nullptr, true, false);
+        const QList<PackageAnalyzer::AnalyzeGroup> groups{
+            {ddim.mustInstallList, nullptr, true, true},
+            {ddim.selectList, &selectAppNameList, false, false},
+            {ddim.dependList, nullptr, true, false},
+        };
+        const auto groupInfos = PackageAnalyzer::instance().analyzeDebFileGroups(groups, ddim.index.data());
+        auto currentMustInstallInfos = groupInfos.at(0);
+        auto currentSelectInfos = groupInfos.at(1);
+        auto currentDependInfos = groupInfos.at(2);
 
         PackageAnalyzer::instance().stopPkgAnalyze();
 
+        // 新分析的包写回索引，下次打开时无需重新解析
+        if (ddim.index) {
+            ddim.index->save();
+        }
+
         for (int i = 0; i != currentSelectInfos.size(); ++i) {
             currentSelectInfos[i].appName = selectAppNameList[i];
         }
@@ -65,6 +75,9 @@ void PackageSelectModel::appendDdimPackages(const QList<DdimSt> &ddims)
         }
     }
 
+    // 遍历目录时预解析但未被使用的结果不再需要
+    PackageAnalyzer::instance().clearPrefetch();
+
     // 汇聚全部数据（依据ddimIrs目前的情况，刷新selectInfos，dependInfos，mustInstallInfos）
     if (collectData()) {
         emit selectInfosChanged(selectInfos);  // 刷新选择界面
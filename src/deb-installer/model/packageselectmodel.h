@@ -8,8 +8,10 @@
 #include <QObject>
 #include <QFileInfoList>
 #include <QSet>
+#include <QSharedPointer>
 #include <QApt/DependencyInfo>
 
+class DdimIndex;
 class PackageAnalyzer;
 class QStandardItemModel;
 
@@ -24,6 +26,7 @@ struct DdimSt
     QFileInfoList selectList;       // 可选
     QFileInfoList dependList;       // 依赖
     QFileInfoList mustInstallList;  // 必装
+    QSharedPointer<DdimIndex> index;  // ddim目录下的包索引，可能为空
 };
 
 // 单个包的基础信息
@@ -37,8 +40,9 @@ struct DebIr
     QString version;                      // 包版本
     QString shortDescription;             // 短描述
     QByteArray md5;                       // 包的md5码
-    QStringList virtualPackages;          // 提供的虚拟包 QApt似乎不支持读Provides项
+    QStringList virtualPackages;          // 提供的虚拟包，读取自control的Provides项
     QList<QApt::DependencyItem> depends;  // 完整的包依赖
+    QList<QApt::DependencyItem> preDepends;  // 预依赖，必须在安装本包之前完成配置
 
     bool archMatched;  // 是否与当前架构匹配
     bool isValid;  // 包是否有效（根据以前的老代码，此处如果无效，可以暂时当做未安装处理，由后续的apt安装时进行报错）
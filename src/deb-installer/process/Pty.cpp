@@ -30,6 +30,7 @@
 #include "Pty.h"
 #include "kpty.h"
 #include "kptydevice.h"
+#include "pty_output_filter.h"
 
 // System
 #include <sys/types.h>
@@ -462,7 +463,6 @@ void Pty::sendData(const char *data, int length, const QTextCodec *codec)
     }
 
     _isCommandExec = false;
-    _bNeedBlockCommand = false;
 
     //为GBK/GB2312/GB18030编码，且不是输入命令执行的情况（没有按回车）
     if (QString(codec->name()).toUpper().startsWith("GB") && !_isCommandExec) {
@@ -488,80 +488,28 @@ void Pty::sendData(const char *data, int length, const QTextCodec *codec)
 
 void Pty::dataReceived()
 {
-    QByteArray data = pty()->readAll();
-
-    QString recvData = QString(data);
-
-    if (_bNeedBlockCommand) {
-        QString judgeData = recvData;
-        if (recvData.length() > 1) {
-            judgeData = recvData.replace("\r", "");
-            judgeData = judgeData.replace("\n", "");
-        }
-
-        //使用zsh的时候，发送过来的字符会残留一个字母"e"，需要特殊处理下
-        if (_program.endsWith("/zsh")
-                && 1 == judgeData.length()
-                && judgeData.startsWith("e")
-                && -1 == _receiveDataIndex) {
-            _receiveDataIndex = 0;
-            return;
-        }
-
-        //不显示远程登录时候的敏感信息(主要是expect -f命令跟随的明文密码)
-        //同时考虑了zsh的情况
-        if (judgeData.startsWith("expect -f")
-                || judgeData.startsWith("\bexpect")
-                || judgeData.startsWith("\be")
-                || judgeData.startsWith("e\bexpect")
-                || judgeData.startsWith("e\be")) {
-            _receiveDataIndex = 1;
-            return;
-        }
-
-        if (_receiveDataIndex >= 1) {
-            if (judgeData.contains("Press")) {
-                //这里需要置回false，否则后面其他命令也会被拦截
-                _bNeedBlockCommand = false;
-
-                _receiveDataIndex = -1;
-                int pressStringIndex = recvData.indexOf("Press");
-                if (pressStringIndex > 0) {
-                    recvData = recvData.mid(pressStringIndex);
-                }
-                QString helpData = recvData.replace("\n", "");
-                recvData = "\r\n" + helpData + "\r\n";
-                data = recvData.toUtf8();
-                emit receivedData(data.constData(), data.count(), _textCodec);
-            }
-            else {
-                ++_receiveDataIndex;
-            }
-            return;
-        }
-    }
-
-    /******** Modify by m000714 daizhengwen 2020-04-30: 处理上传下载时乱码显示命令不执行****************/
-    // 乱码提示信息不显示
-    if (recvData.contains("bash: $'\\212")
-            || recvData.contains("bash: **0800000000022d：")
-            || recvData.contains("**^XB0800000000022d")
-            || recvData.startsWith("**\u0018B0800000000022d\r\u008A")) {
+    // 读入复用的缓冲区，按字节过滤，常见输出不做拷贝和编码转换
+    const qint64 available = pty()->bytesAvailable();
+    if (available <= 0) {
         return;
     }
 
-    // "\u008A"这个乱码不替换调会导致显示时有\b的效果导致命令错乱bug#23741
-    if (recvData.contains("\u008A")) {
-        recvData.replace("\u008A", "\b \b #");
-        data = recvData.toUtf8();
+    _readBuffer.resize(static_cast<int>(available));
+    const qint64 length = pty()->read(_readBuffer.data(), available);
+    if (length <= 0) {
+        return;
     }
 
-    if (recvData == "rz waiting to receive.") {
-        recvData += "\r\n";
-        data = recvData.toUtf8();
+    switch (PtyOutputFilter::filter(_readBuffer.constData(), static_cast<int>(length), &_filterBuffer)) {
+        case PtyOutputFilter::Drop:
+            break;
+        case PtyOutputFilter::Rewrite:
+            emit receivedData(_filterBuffer.constData(), _filterBuffer.size(), _isCommandExec);
+            break;
+        default:
+            emit receivedData(_readBuffer.constData(), static_cast<int>(length), _isCommandExec);
+            break;
     }
-    /********************* Modify by m000714 daizhengwen End ************************/
-    emit receivedData(data.constData(), data.count(), _isCommandExec);
 }
 
 void Pty::lockPty(bool lock)
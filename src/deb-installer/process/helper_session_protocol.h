@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef HELPERSESSIONPROTOCOL_H
+#define HELPERSESSIONPROTOCOL_H
+
+/**
+   @brief Line protocol between deepin-deb-installer and the privileged helper
+    `deepin-deb-installer-dependsInstall --session <channel>`.
+
+    The helper is started once through pkexec on a pty. The pty only carries the
+    job output and the DebConf input, as in one-shot mode. Jobs and job status
+    use a private unix socket channel: the installer listens on the socket path
+    `<channel>`, the helper connects to it once authorized. Each side checks the
+    peer with SO_PEERCRED before trusting it: the helper accepts only its parent,
+    the validated invoker, and the installer accepts only root with the pid of
+    the pkexec process it started. Output printed by the packages can't fake
+    the job status.
+
+    The helper sends `ready` once connected, and `finished;<code>` at the end of
+    each job. A batch config job appends the result of each package in the
+    order of the job arguments, e.g. `finished;1;0;1`. The installer sends each job as one line: a compact json array of
+    the one-shot arguments, e.g. `["--install_config","/path/to/file.deb"]`.
+    Only the config install job is accepted. The helper runs jobs until it reads
+    the quit job, the channel closes, or no job arrives within kJobTimeoutMs.
+    The installer sends the quit job as soon as its queue drains.
+ */
+namespace HelperSession {
+
+inline constexpr char kParamSession[] = "--session";
+
+inline constexpr char kEventReady[] = "ready";
+inline constexpr char kEventFinished[] = "finished;";
+inline constexpr char kEventResultSeparator = ';';
+
+// lines longer than this are not valid messages.
+inline constexpr int kMaxLineSize = 64 * 1024;
+
+// empty job, the helper exits.
+inline constexpr char kJobQuit[] = "[]";
+
+// the only job accepted, and its options.
+inline constexpr char kJobInstallConfig[] = "--install_config";
+inline constexpr char kJobPreseed[] = "--preseed";
+
+// the helper exits if the next job is not written in time.
+inline constexpr int kJobTimeoutMs = 5000;
+
+}  // namespace HelperSession
+
+#endif  // HELPERSESSIONPROTOCOL_H
@@ -80,17 +80,27 @@ static void qt_ignore_sigpipe()
 
 #define NO_INTR(ret,func) do { ret = func; } while (ret < 0 && errno == EINTR)
 
+// upper bound of the data read per notifier activation before readyRead() is emitted
+static const int KPTY_READ_BATCH = 64 * 1024;
+
 bool KPtyDevicePrivate::_k_canRead()
 {
     Q_Q(KPtyDevice);
     qint64 readBytes = 0;
+    qint64 batchBytes = 0;
 
+    // Drain the pty into pooled chunks until it is idle, the batch is full or
+    // the buffer reaches the high water mark, then notify once for the batch
+    // instead of once per activation.
+    forever {
 #ifdef Q_OS_IRIX // this should use a config define, but how to check it?
-    size_t available;
+        size_t available;
 #else
-    int available;
+        int available;
 #endif
-    if (!::ioctl(q->masterFd(), PTY_BYTES_AVAILABLE, (char *) &available)) {
+        if (::ioctl(q->masterFd(), PTY_BYTES_AVAILABLE, (char *) &available))
+            break;
+
 #ifdef Q_OS_SOLARIS
         // A Pty is a STREAMS module, and those can be activated
         // with 0 bytes available. This happens either when ^C is
@@ -98,7 +108,7 @@ bool KPtyDevicePrivate::_k_canRead()
         // which happens in experiments fairly often. When 0 bytes are
         // available, you must read those 0 bytes to clear the STREAMS
         // module, but we don't want to hit the !readBytes case further down.
-        if (!available) {
+        if (!available && !batchBytes) {
             char c;
             // Read the 0-byte STREAMS message
             NO_INTR(readBytes, read(q->masterFd(), &c, 0));
@@ -111,36 +121,56 @@ bool KPtyDevicePrivate::_k_canRead()
             return true;
         }
 #endif
+        if (!available)
+            break;
 
-        char *ptr = readBuffer.reserve(available);
+        while (available > 0) {
+            int reserved = 0;
+            char *ptr = readBuffer.reserveInChunk((int)available, &reserved);
 #ifdef Q_OS_SOLARIS
-        // Even if available > 0, it is possible for read()
-        // to return 0 on Solaris, due to 0-byte writes in the stream.
-        // Ignore them and keep reading until we hit *some* data.
-        // In Solaris it is possible to have 15 bytes available
-        // and to (say) get 0, 0, 6, 0 and 9 bytes in subsequent reads.
-        // Because the stream is set to O_NONBLOCK in finishOpen(),
-        // an EOF read will return -1.
-        readBytes = 0;
-        while (!readBytes)
+            // Even if available > 0, it is possible for read()
+            // to return 0 on Solaris, due to 0-byte writes in the stream.
+            // Ignore them and keep reading until we hit *some* data.
+            // Because the stream is set to O_NONBLOCK in finishOpen(),
+            // an EOF read will return -1.
+            readBytes = 0;
+            while (!readBytes)
 #endif
-        // Useless block braces except in Solaris
-        {
-          NO_INTR(readBytes, read(q->masterFd(), ptr, available));
-        }
-        if (readBytes < 0) {
-            readBuffer.unreserve(available);
-            q->setErrorString(QLatin1String("Error reading from PTY"));
-            return false;
+            // Useless block braces except in Solaris
+            {
+              NO_INTR(readBytes, read(q->masterFd(), ptr, reserved));
+            }
+            if (readBytes < 0) {
+                readBuffer.unreserve(reserved);
+                if (!batchBytes) {
+                    q->setErrorString(QLatin1String("Error reading from PTY"));
+                    return false;
+                }
+                break;
+            }
+            readBuffer.unreserve(reserved - readBytes); // *should* be a no-op
+            if (!readBytes)
+                break;
+
+            available -= readBytes;
+            batchBytes += readBytes;
         }
-        readBuffer.unreserve(available - readBytes); // *should* be a no-op
+
+        if (readBytes <= 0 || batchBytes >= KPTY_READ_BATCH || readBuffer.size() >= readHighWaterMark)
+            break;
     }
 
-    if (!readBytes) {
+    if (!batchBytes) {
         readNotifier->setEnabled(false);
         emit q->readEof();
         return false;
     } else {
+        // back-pressure, resumed by releaseReadThrottle() once the consumer caught up
+        if (readBuffer.size() >= readHighWaterMark && readNotifier->isEnabled()) {
+            readNotifier->setEnabled(false);
+            readThrottled = true;
+        }
+
         if (!emittedReadyRead) {
             emittedReadyRead = true;
             emit q->readyRead();
@@ -150,6 +180,14 @@ bool KPtyDevicePrivate::_k_canRead()
     }
 }
 
+void KPtyDevicePrivate::releaseReadThrottle()
+{
+    if (readThrottled && readBuffer.size() <= readHighWaterMark / 2) {
+        readThrottled = false;
+        readNotifier->setEnabled(true);
+    }
+}
+
 bool KPtyDevicePrivate::_k_canWrite()
 {
     Q_Q(KPtyDevice);
@@ -337,6 +375,7 @@ void KPtyDevice::close()
 
     delete d->readNotifier;
     delete d->writeNotifier;
+    d->readThrottled = false;
 
     QIODevice::close();
 
@@ -387,6 +426,7 @@ bool KPtyDevice::waitForBytesWritten(int msecs)
 void KPtyDevice::setSuspended(bool suspended)
 {
     Q_D(KPtyDevice);
+    d->readThrottled = false;
     d->readNotifier->setEnabled(!suspended);
 }
 
@@ -396,18 +436,36 @@ bool KPtyDevice::isSuspended() const
     return !d->readNotifier->isEnabled();
 }
 
+void KPtyDevice::setReadHighWaterMark(int bytes)
+{
+    Q_D(KPtyDevice);
+    d->readHighWaterMark = qMax(bytes, CHUNKSIZE);
+    if (masterFd() >= 0)
+        d->releaseReadThrottle();
+}
+
+int KPtyDevice::readHighWaterMark() const
+{
+    Q_D(const KPtyDevice);
+    return d->readHighWaterMark;
+}
+
 // protected
 qint64 KPtyDevice::readData(char *data, qint64 maxlen)
 {
     Q_D(KPtyDevice);
-    return d->readBuffer.read(data, (int)qMin<qint64>(maxlen, KMAXINT));
+    qint64 readBytes = d->readBuffer.read(data, (int)qMin<qint64>(maxlen, KMAXINT));
+    d->releaseReadThrottle();
+    return readBytes;
 }
 
 // protected
 qint64 KPtyDevice::readLineData(char *data, qint64 maxlen)
 {
     Q_D(KPtyDevice);
-    return d->readBuffer.readLine(data, (int)qMin<qint64>(maxlen, KMAXINT));
+    qint64 readBytes = d->readBuffer.readLine(data, (int)qMin<qint64>(maxlen, KMAXINT));
+    d->releaseReadThrottle();
+    return readBytes;
 }
 
 // protected
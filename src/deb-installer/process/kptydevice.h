@@ -116,6 +116,23 @@ public:
      */
     bool isSuspended() const;
 
+    /**
+     * Sets the amount of buffered incoming data at which the KPtyDevice
+     * stops reading from the pty.
+     *
+     * Reading resumes once the consumer has drained the buffer to half of
+     * the mark, so a slow consumer applies back-pressure to the process
+     * writing to the pty instead of growing the buffer without limit.
+     */
+    void setReadHighWaterMark(int bytes);
+
+    /**
+     * Returns the read buffer high water mark.
+     *
+     * See setReadHighWaterMark()
+     */
+    int readHighWaterMark() const;
+
     /**
      * @return always true
      */
@@ -171,6 +188,8 @@ private:
 #include <list>
 
 #define CHUNKSIZE 4096
+// freed chunks kept for reuse, so steady output does not allocate
+#define MAXSPARECHUNKS 16
 
 class KRingBuffer
 {
@@ -183,9 +202,7 @@ public:
     void clear()
     {
         buffers.clear();
-        QByteArray tmp;
-        tmp.resize(CHUNKSIZE);
-        buffers.push_back(tmp);
+        pushChunk();
         head = tail = 0;
         totalSize = 0;
     }
@@ -235,7 +252,7 @@ public:
                 break;
             }
 
-            buffers.pop_front();
+            releaseFront();
             head = 0;
         }
     }
@@ -250,15 +267,32 @@ public:
             tail += bytes;
         } else {
             buffers.back().resize(tail);
-            QByteArray tmp;
-            tmp.resize(qMax(CHUNKSIZE, bytes));
-            ptr = tmp.data();
-            buffers.push_back(tmp);
+            if (bytes <= CHUNKSIZE) {
+                pushChunk();
+                ptr = buffers.back().data();
+            } else {
+                QByteArray tmp;
+                tmp.resize(bytes);
+                ptr = tmp.data();
+                buffers.push_back(tmp);
+            }
             tail = bytes;
         }
         return ptr;
     }
 
+    // reserve up to maxBytes within a single chunk, the reserved size is
+    // returned in *bytes. The chunks come from the spare pool when possible.
+    char *reserveInChunk(int maxBytes, int *bytes)
+    {
+        int room = buffers.back().size() - tail;
+        if (room <= 0) {
+            room = CHUNKSIZE;
+        }
+        *bytes = qMin(maxBytes, room);
+        return reserve(*bytes);
+    }
+
     // release a trailing part of the last reservation
     inline void unreserve(int bytes)
     {
@@ -327,7 +361,31 @@ public:
     }
 
 private:
+    // append a chunk of CHUNKSIZE bytes, taken from the spare pool if any.
+    void pushChunk()
+    {
+        if (!spare.empty()) {
+            buffers.splice(buffers.end(), spare, spare.begin());
+            buffers.back().resize(CHUNKSIZE);
+        } else {
+            QByteArray tmp;
+            tmp.resize(CHUNKSIZE);
+            buffers.push_back(tmp);
+        }
+    }
+
+    // drop the consumed front chunk, regular chunks go back to the pool.
+    void releaseFront()
+    {
+        if (spare.size() < MAXSPARECHUNKS && buffers.front().capacity() < 2 * CHUNKSIZE) {
+            spare.splice(spare.end(), buffers, buffers.begin());
+        } else {
+            buffers.pop_front();
+        }
+    }
+
     std::list<QByteArray> buffers;
+    std::list<QByteArray> spare;
     int head, tail;
     int totalSize;
 };
@@ -339,18 +397,22 @@ struct KPtyDevicePrivate : public KPtyPrivate {
     KPtyDevicePrivate(KPty* parent) :
         KPtyPrivate(parent),
         emittedReadyRead(false), emittedBytesWritten(false),
+        readThrottled(false), readHighWaterMark(256 * 1024),
         readNotifier(nullptr), writeNotifier(nullptr)
     {
     }
 
     bool _k_canRead();
     bool _k_canWrite();
+    void releaseReadThrottle();
 
     bool doWait(int msecs, bool reading);
     void finishOpen(QIODevice::OpenMode mode);
 
     bool emittedReadyRead;
     bool emittedBytesWritten;
+    bool readThrottled;     // read notifier disabled above the high water mark
+    int readHighWaterMark;
     QSocketNotifier *readNotifier;
     QSocketNotifier *writeNotifier;
     KRingBuffer readBuffer;
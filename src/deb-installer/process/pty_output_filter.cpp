@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pty_output_filter.h"
+
+#include <cstring>
+
+namespace Konsole {
+
+namespace {
+
+// garbled zmodem frames, e.g. "**\x18B0800000000022d" shown as "bash: **0800000000022d"
+const char kZmodemHeader[] = "0800000000022d";
+const char *const kZmodemPrefixes[] = {"**", "**\x18", "**^X"};
+// "bash: $'\212" shell error of the garbled zmodem frame
+const char kBashPrefix[] = "bash: ";
+const char kBashGarbled[] = "$'\\212";
+
+const char kRzWaiting[] = "rz waiting to receive.";
+const char kLineBreak[] = "\r\n";
+
+// U+008A in utf-8
+const unsigned char kC1Lead = 0xC2;
+const unsigned char kC1Garbled = 0x8A;
+const char kC1Replacement[] = "\b \b #";
+
+template <size_t N>
+inline bool matchAt(const char *data, int length, int pos, const char (&pattern)[N])
+{
+    const int patternLength = static_cast<int>(N - 1);
+    return pos >= 0 && pos + patternLength <= length && 0 == ::memcmp(data + pos, pattern, patternLength);
+}
+
+bool isZmodemFrame(const char *data, int length, int pos)
+{
+    for (const char *prefix : kZmodemPrefixes) {
+        const int prefixLength = static_cast<int>(::strlen(prefix));
+        if (pos + prefixLength <= length && 0 == ::memcmp(data + pos, prefix, prefixLength)) {
+            int headerPos = pos + prefixLength;
+            if (matchAt(data, length, headerPos, "B")) {  // "**\x18B" or "**^XB"
+                headerPos++;
+            }
+            if (matchAt(data, length, headerPos, kZmodemHeader)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+PtyOutputFilter::Action PtyOutputFilter::filter(const char *data, int length, QByteArray *rewritten)
+{
+    if (matchAt(data, length, 0, kRzWaiting) && static_cast<int>(sizeof(kRzWaiting) - 1) == length) {
+        rewritten->resize(0);
+        rewritten->append(data, length);
+        rewritten->append(kLineBreak);
+        return Rewrite;
+    }
+
+    bool hasGarbledC1 = false;
+    for (int i = 0; i < length; ++i) {
+        const auto c = static_cast<unsigned char>(data[i]);
+        // the common output has none of these bytes, one compare chain per byte.
+        if ('*' != c && '$' != c && kC1Lead != c) {
+            continue;
+        }
+
+        if ('*' == c) {
+            if (isZmodemFrame(data, length, i)) {
+                return Drop;
+            }
+        } else if ('$' == c) {
+            const int prefixPos = i - static_cast<int>(sizeof(kBashPrefix) - 1);
+            if (matchAt(data, length, i, kBashGarbled) && matchAt(data, length, prefixPos, kBashPrefix)) {
+                return Drop;
+            }
+        } else if (i + 1 < length && kC1Garbled == static_cast<unsigned char>(data[i + 1])) {
+            hasGarbledC1 = true;
+        }
+    }
+
+    if (!hasGarbledC1) {
+        return Pass;
+    }
+
+    rewritten->resize(0);
+    int runBegin = 0;
+    for (int i = 0; i + 1 < length; ++i) {
+        if (kC1Lead == static_cast<unsigned char>(data[i]) && kC1Garbled == static_cast<unsigned char>(data[i + 1])) {
+            rewritten->append(data + runBegin, i - runBegin);
+            rewritten->append(kC1Replacement);
+            runBegin = i + 2;
+            ++i;
+        }
+    }
+    rewritten->append(data + runBegin, length - runBegin);
+    return Rewrite;
+}
+
+}  // namespace Konsole
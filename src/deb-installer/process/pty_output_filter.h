@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PTYOUTPUTFILTER_H
+#define PTYOUTPUTFILTER_H
+
+#include <QByteArray>
+
+namespace Konsole {
+
+/**
+   @brief Byte level filter of the output read from the pty.
+
+    Handles the garbled zmodem (rz/sz) output inherited from the terminal:
+    the banners are dropped, U+008A is replaced to avoid the backspace effect,
+    and "rz waiting to receive." gets a line break. The raw bytes are scanned
+    once for the few bytes that can start such a case, the output of dpkg and
+    ll-cli passes through untouched and without copy.
+ */
+class PtyOutputFilter
+{
+public:
+    enum Action {
+        Pass,     // emit the input as is
+        Drop,     // emit nothing
+        Rewrite,  // emit the rewritten data
+    };
+
+    // the rewritten data is written to \a rewritten, which may be reused between calls.
+    [[nodiscard]] static Action filter(const char *data, int length, QByteArray *rewritten);
+};
+
+}  // namespace Konsole
+
+#endif  // PTYOUTPUTFILTER_H
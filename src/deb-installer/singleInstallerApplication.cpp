@@ -5,11 +5,16 @@
 #include "singleInstallerApplication.h"
 #include "view/pages/debinstaller.h"
 #include "uab/uab_backend.h"
+#include "manager/batch_query_job.h"
+#include "utils/utils.h"
+#include "utils/metrics.h"
+#include "model/ddim_index.h"
 
 #include <DWidgetUtil>
 #include <DGuiApplicationHelper>
 
 #include <QCommandLineParser>
+#include <QFileInfo>
 #include <QtDBus/QtDBus>
 const QString kDebInstallManagerService = "com.deepin.DebInstaller";
 const QString kDebInstallManagerIface = "/com/deepin/DebInstaller";
@@ -131,11 +136,73 @@ QString SingleInstallerApplication::getPackageInfo(const QString &debPath)
     return ret;
 }
 
+QString SingleInstallerApplication::checkInstallStatusBatch(const QStringList &debPathList)
+{
+    return startBatchJob(debPathList, [this](const QString &debPath) { return QVariant(checkInstallStatus(debPath)); });
+}
+
+QString SingleInstallerApplication::checkDependsStatusBatch(const QStringList &debPathList)
+{
+    return startBatchJob(debPathList, [this](const QString &debPath) { return QVariant(checkDependsStatus(debPath)); });
+}
+
+QString SingleInstallerApplication::checkDigitalSignatureBatch(const QStringList &debPathList)
+{
+    // 验签前的检查依赖后端，在主线程执行；调用验签工具耗时较长，交由工作线程池执行
+    return startBatchJob(
+        debPathList,
+        [this](const QString &debPath) {
+            int ret = -1;
+            QMetaObject::invokeMethod(m_qspMainWnd.get(),
+                                      "precheckDigitalSignature",
+                                      Qt::DirectConnection,
+                                      Q_RETURN_ARG(int, ret),
+                                      Q_ARG(QString, debPath));
+            return DebInstaller::kDigitalVerifyRequired == ret ? QVariant() : QVariant(ret);
+        },
+        [](const QString &debPath) { return QVariant(static_cast<int>(Utils::Digital_Verify(debPath))); });
+}
+
+QString SingleInstallerApplication::getPackageInfoBatch(const QStringList &debPathList)
+{
+    return startBatchJob(debPathList, [this](const QString &debPath) { return QVariant(getPackageInfo(debPath)); });
+}
+
+QString SingleInstallerApplication::metrics()
+{
+    return Metrics::Registry::instance()->toPrometheusText();
+}
+
+/**
+ * @brief 创建批量查询任务并立即返回任务ID，结果通过信号逐个返回
+ */
+QString SingleInstallerApplication::startBatchJob(const QStringList &debPathList,
+                                                  const BatchCheck &mainThreadCheck,
+                                                  const BatchCheck &concurrentCheck)
+{
+    const QString jobId = QString::number(++m_batchJobSerial);
+
+    auto job = new BatchQueryJob(jobId, debPathList, this);
+    job->setMainThreadCheck(mainThreadCheck);
+    job->setConcurrentCheck(concurrentCheck);
+
+    connect(job, &BatchQueryJob::resultReady, this, [this](const QString &id, const QString &debPath, const QVariant &result) {
+        emit batchJobResult(id, debPath, QDBusVariant(result));
+    });
+    connect(job, &BatchQueryJob::progressChanged, this, &SingleInstallerApplication::batchJobProgress);
+    connect(job, &BatchQueryJob::finished, this, &SingleInstallerApplication::batchJobFinished);
+    connect(job, &BatchQueryJob::finished, job, &BatchQueryJob::deleteLater);
+
+    job->start();
+    return jobId;
+}
+
 bool SingleInstallerApplication::parseCmdLine()
 {
     QCommandLineParser parser;
     parser.setApplicationDescription("Deepin Package Installer.");
     parser.addOption(QCommandLineOption("dbus", "enable daemon mode"));
+    parser.addOption(QCommandLineOption("build-ddim-index", "build the package index of the given ddim files and exit"));
     parser.addHelpOption();
     parser.addVersionOption();
     parser.addPositionalArgument("filename", "Deb package path.", "file [file..]");
@@ -144,11 +211,24 @@ bool SingleInstallerApplication::parseCmdLine()
     m_selectedFiles.clear();
     m_ddimFiles.clear();
 
+    // 制作安装介质时预先生成ddim包索引，不启动界面
+    if (parser.isSet("build-ddim-index")) {
+        for (const QString &ddimFile : parser.positionalArguments()) {
+            const QString ddimDir = QFileInfo(ddimFile).absolutePath();
+            if (!DdimIndex::build(ddimDir)) {
+                qWarning() << "Failed to build ddim index of" << ddimFile;
+            }
+        }
+        return false;
+    }
+
     QDBusConnection conn = QDBusConnection::sessionBus();
 
     if (!conn.registerService(kDebInstallManagerService) ||
         !conn.registerObject(
-            kDebInstallManagerIface, this, QDBusConnection::ExportScriptableSlots)) {  // 注册失败 说明已经存在deb-installer
+            kDebInstallManagerIface,
+            this,
+            QDBusConnection::ExportScriptableSlots | QDBusConnection::ExportScriptableSignals)) {  // 注册失败 说明已经存在deb-installer
         qDebug() << "Failed to register dbus";
         QDBusInterface deb_install(
             kDebInstallManagerService, kDebInstallManagerIface, kDebInstallManagerService, QDBusConnection::sessionBus());
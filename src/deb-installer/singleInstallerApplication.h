@@ -8,6 +8,9 @@
 #include <DApplication>
 #include <DMainWindow>
 #include <QCommandLineParser>
+#include <QDBusVariant>
+
+#include <functional>
 
 DWIDGET_USE_NAMESPACE
 
@@ -103,12 +106,66 @@ public slots:
      */
     Q_SCRIPTABLE QString getPackageInfo(const QString &debPath);
 
+    /**
+     * @brief checkInstallStatusBatch 批量查询包安装状态，不阻塞调用方
+     *
+     * @param debPathList 包路径列表
+     * @return 任务ID，每个包的结果通过 batchJobResult 信号返回，取值同 checkInstallStatus
+     */
+    Q_SCRIPTABLE QString checkInstallStatusBatch(const QStringList &debPathList);
+    /**
+     * @brief checkDependsStatusBatch 批量查询包依赖状态，不阻塞调用方
+     *
+     * @param debPathList 包路径列表
+     * @return 任务ID，每个包的结果通过 batchJobResult 信号返回，取值同 checkDependsStatus
+     */
+    Q_SCRIPTABLE QString checkDependsStatusBatch(const QStringList &debPathList);
+    /**
+     * @brief checkDigitalSignatureBatch 批量查询包的数字签名，验签在工作线程池中并行执行
+     *
+     * @param debPathList 包路径列表
+     * @return 任务ID，每个包的结果通过 batchJobResult 信号返回，取值同 checkDigitalSignature
+     */
+    Q_SCRIPTABLE QString checkDigitalSignatureBatch(const QStringList &debPathList);
+    /**
+     * @brief getPackageInfoBatch 批量查询包信息，不阻塞调用方
+     *
+     * @param debPathList 包路径列表
+     * @return 任务ID，每个包的结果通过 batchJobResult 信号返回，取值同 getPackageInfo
+     */
+    Q_SCRIPTABLE QString getPackageInfoBatch(const QStringList &debPathList);
+
+    /**
+     * @brief metrics 安装器运行指标
+     *
+     * @return Prometheus 文本格式的计数器及耗时直方图
+     */
+    Q_SCRIPTABLE QString metrics();
+
+signals:
+    /**
+     * @brief batchJobResult 批量任务中单个包的查询结果
+     */
+    Q_SCRIPTABLE void batchJobResult(const QString &jobId, const QString &debPath, const QDBusVariant &result);
+    /**
+     * @brief batchJobProgress 批量任务进度
+     */
+    Q_SCRIPTABLE void batchJobProgress(const QString &jobId, int finished, int total);
+    /**
+     * @brief batchJobFinished 批量任务结束，此后不会再有该任务的结果
+     */
+    Q_SCRIPTABLE void batchJobFinished(const QString &jobId);
+
 private:
+    using BatchCheck = std::function<QVariant(const QString &)>;
+    QString startBatchJob(const QStringList &debPathList, const BatchCheck &mainThreadCheck, const BatchCheck &concurrentCheck = {});
+
     QStringList m_selectedFiles;
     QStringList m_ddimFiles;
     QScopedPointer<DMainWindow> m_qspMainWnd;  // MainWindow ptr
 
     bool bIsDbus = false;
+    quint64 m_batchJobSerial = 0;
 };
 
 #endif  // SINGLEFONTAPPLICATION_H
@@ -4,16 +4,25 @@
 
 #include "uab_backend.h"
 
+#include <cstring>
+#include <limits>
 #include <mutex>
 
+#include <elf.h>
+#include <sys/stat.h>
+
 #include <QApplication>
+#include <QDir>
 #include <QFileInfo>
+#include <QHash>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QPointer>
 #include <QProcess>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QTimer>
 #include <QtConcurrent/QtConcurrentRun>
 
 #include "utils/utils.h"
@@ -28,6 +37,22 @@ static const QString kUabJson = "--json";
 static const QString kUabCliList = "list";
 // e.g.: [path to package] --print-meta
 static const QString kUabPkgCmdPrintMeta = "--print-meta";
+// ELF section contains the meta json, same as the output of --print-meta
+static const char kUabMetaSectionName[] = "linglong.meta";
+// installed package snapshot
+static const QString kUabSnapshotFileName = "linglong-packages.json";
+static const QString kUabSnapshotFormat = "format";
+static const QString kUabSnapshotFingerprint = "fingerprint";
+static const QString kUabSnapshotPackages = "packages";
+static const int kUabSnapshotFormatVersion = 1;
+// consecutive installs or removes write the snapshot once
+static const int kUabSnapshotDelayMs = 2000;
+// Linglong repo state, changed by any install / uninstall / upgrade of Linglong packages
+static const QStringList kLinglongRepoStatePaths{
+    "/var/lib/linglong/states.json",
+    "/var/lib/linglong/repo/refs/heads",
+    "/var/lib/linglong/layers",
+};
 // json field
 static const QString kUabLayers = "layers";
 static const QString kUabInfo = "info";
@@ -47,6 +72,14 @@ UabBackend::UabBackend(QObject *parent)
 {
     recheckLinglongExists();
     qRegisterMetaType<QList<UabPkgInfo::Ptr>>("QList<UabPkgInfo::Ptr>");
+
+    m_snapshotTimer = new QTimer(this);
+    m_snapshotTimer->setSingleShot(true);
+    m_snapshotTimer->setInterval(kUabSnapshotDelayMs);
+    connect(m_snapshotTimer, &QTimer::timeout, this, &UabBackend::updateSnapshot);
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &UabBackend::flushSnapshot);
+    }
 }
 
 UabBackend::~UabBackend() {}
@@ -57,31 +90,149 @@ UabBackend *UabBackend::instance()
     return &ins;
 }
 
+namespace {
+
+// the uab file identity, the parsed meta is reused while the file unchanged.
+struct UabFileIdentity
+{
+    dev_t device{0};
+    ino_t inode{0};
+    off_t size{0};
+    qint64 mtimeNs{0};
+
+    bool operator==(const UabFileIdentity &other) const
+    {
+        return device == other.device && inode == other.inode && size == other.size && mtimeNs == other.mtimeNs;
+    }
+};
+
+struct UabMetaCacheEntry
+{
+    UabFileIdentity identity;
+    UabPkgInfo::Ptr infoPtr;  // null if the file is not a valid uab
+    QString errorString;
+};
+
+std::mutex uabMetaCacheMutex;
+QHash<QString, UabMetaCacheEntry> uabMetaCache;  // key: absolute file path
+
+template <typename Ehdr, typename Shdr>
+QByteArray elfSectionData(const uchar *data, quint64 size, const char *sectionName)
+{
+    if (size < sizeof(Ehdr)) {
+        return {};
+    }
+
+    // the mapped file is not aligned for the headers, copy before read.
+    Ehdr ehdr;
+    ::memcpy(&ehdr, data, sizeof(Ehdr));
+    if (sizeof(Shdr) != ehdr.e_shentsize || 0 == ehdr.e_shnum || ehdr.e_shstrndx >= ehdr.e_shnum) {
+        return {};
+    }
+    if (ehdr.e_shoff > size || static_cast<quint64>(ehdr.e_shnum) * sizeof(Shdr) > size - ehdr.e_shoff) {
+        return {};
+    }
+
+    auto sectionHeader = [&](int index) {
+        Shdr shdr;
+        ::memcpy(&shdr, data + ehdr.e_shoff + static_cast<quint64>(index) * sizeof(Shdr), sizeof(Shdr));
+        return shdr;
+    };
+
+    const Shdr names = sectionHeader(ehdr.e_shstrndx);
+    if (names.sh_offset > size || names.sh_size > size - names.sh_offset) {
+        return {};
+    }
+
+    const quint64 nameLength = ::strlen(sectionName);
+    for (int i = 0; i < ehdr.e_shnum; ++i) {
+        const Shdr shdr = sectionHeader(i);
+        if (shdr.sh_name >= names.sh_size || names.sh_size - shdr.sh_name <= nameLength) {
+            continue;
+        }
+
+        // compare with the terminating zero
+        const auto name = reinterpret_cast<const char *>(data + names.sh_offset + shdr.sh_name);
+        if (0 != ::memcmp(name, sectionName, nameLength + 1)) {
+            continue;
+        }
+
+        if (SHT_NOBITS == shdr.sh_type || shdr.sh_offset > size || shdr.sh_size > size - shdr.sh_offset) {
+            return {};
+        }
+        // QByteArray takes an int size
+        if (shdr.sh_size > static_cast<quint64>(std::numeric_limits<int>::max())) {
+            return {};
+        }
+        return QByteArray(reinterpret_cast<const char *>(data + shdr.sh_offset), static_cast<int>(shdr.sh_size));
+    }
+
+    return {};
+}
+
+}  // namespace
+
 /**
- * @brief Check uab package exist and executable.
- *        If executable, execute `uabPath --print-meta` to get package meta data.
+ * @brief Check uab package exist and read the package meta data.
+ *        The meta json is read from the ELF section of the uab file, the uab file is executed
+ *        with `uabPath --print-meta` only if the section not found (uab of earlier format).
+ *        The result is memoized per file identity (device, inode, size and mtime).
  * @return UabPkgInfo::Ptr uab package info, or null if error.
  */
 UabPkgInfo::Ptr UabBackend::packageFromMetaData(const QString &uabPath, QString *errorString)
 {
     const QFileInfo info(uabPath);
-    if (!info.exists()) {
+    const QString absolutePath = info.absoluteFilePath();
+
+    struct stat fileStat;
+    if (0 != ::stat(QFile::encodeName(absolutePath).constData(), &fileStat)) {
         if (errorString) {
             *errorString = QString("uab file not exists");
         }
         return {};
     }
 
-    const QByteArray output = uabExecuteOutput(uabPath, errorString);
+    UabFileIdentity identity;
+    identity.device = fileStat.st_dev;
+    identity.inode = fileStat.st_ino;
+    identity.size = fileStat.st_size;
+    identity.mtimeNs = static_cast<qint64>(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec;
+
+    auto cachedResult = [errorString](const UabMetaCacheEntry &entry) -> UabPkgInfo::Ptr {
+        if (errorString) {
+            *errorString = entry.errorString;
+        }
+        // copy, callers may modify the package info.
+        return entry.infoPtr ? UabPkgInfo::Ptr::create(*entry.infoPtr) : UabPkgInfo::Ptr{};
+    };
+
+    {
+        std::lock_guard<std::mutex> guard(uabMetaCacheMutex);
+        auto itr = uabMetaCache.constFind(absolutePath);
+        if (itr != uabMetaCache.cend() && itr->identity == identity) {
+            return cachedResult(*itr);
+        }
+    }
+
+    UabMetaCacheEntry entry;
+    entry.identity = identity;
+
+    QByteArray output = uabMetaSection(absolutePath, &entry.errorString);
     if (output.isEmpty()) {
-        return {};
+        entry.errorString.clear();
+        output = uabExecuteOutput(absolutePath, &entry.errorString);
     }
 
-    auto uabPtr = UabBackend::packageFromMetaJson(output);
-    if (uabPtr) {
-        uabPtr->filePath = info.absoluteFilePath();
+    if (!output.isEmpty()) {
+        entry.infoPtr = UabBackend::packageFromMetaJson(output, &entry.errorString);
+        if (entry.infoPtr) {
+            entry.infoPtr->filePath = absolutePath;
+        }
     }
-    return uabPtr;
+
+    std::lock_guard<std::mutex> guard(uabMetaCacheMutex);
+    uabMetaCache.insert(absolutePath, entry);
+    return cachedResult(entry);
 }
 
 /**
@@ -96,22 +247,16 @@ UabPkgInfo::Ptr UabBackend::findPackage(const QString &packageId, const QString
         return {};
     }
 
-    if (m_packageList.isEmpty()) {
+    auto findItr = m_packageIndex.constFind(packageId);
+    if (findItr == m_packageIndex.cend()) {
         return {};
     }
 
-    auto itr = std::upper_bound(m_packageList.begin(),
-                                m_packageList.end(),
-                                packageId,
-                                [](const QString &findPkg, const UabPkgInfo::Ptr &uabPtr) { return findPkg <= uabPtr->id; });
-
     // versions with the same ID are listed in descending order
-    while ((m_packageList.end() != itr) && ((*itr)->id == packageId)) {
-        if (version.isEmpty() || ((*itr)->version == version)) {
-            return *itr;
+    for (const UabPkgInfo::Ptr &uabPtr : findItr.value()) {
+        if (version.isEmpty() || (uabPtr->version == version)) {
+            return uabPtr;
         }
-
-        itr++;
     }
 
     return {};
@@ -160,20 +305,73 @@ QString UabBackend::lastError() const
 
 void UabBackend::dumpPackageList() const
 {
-    qInfo() << QString("Uab package list(count %1) support archs:").arg(m_packageList.size()) << m_supportArchSet;
-    for (const auto &uabPtr : m_packageList) {
+    const QList<UabPkgInfo::Ptr> list = packageList();
+    qInfo() << QString("Uab package list(count %1) support archs:").arg(list.size()) << m_supportArchSet;
+    for (const auto &uabPtr : list) {
         qInfo() << "    " << uabPtr;
     }
 }
 
+/**
+   @brief All installed packages, sorted by package id and version, same as sortPackages().
+ */
+QList<UabPkgInfo::Ptr> UabBackend::packageList() const
+{
+    QList<UabPkgInfo::Ptr> list;
+    for (auto itr = m_packageIndex.cbegin(); itr != m_packageIndex.cend(); ++itr) {
+        list.append(itr.value());
+    }
+    return list;
+}
+
+/**
+   @brief Build the package index from \a packageList , which sorted by sortPackages().
+ */
 void UabBackend::backendInitData(const QList<UabPkgInfo::Ptr> &packageList, const QSet<QString> &archs)
 {
-    m_packageList = packageList;
+    m_packageIndex.clear();
+    for (const UabPkgInfo::Ptr &uabPtr : packageList) {
+        m_packageIndex[uabPtr->id].append(uabPtr);
+    }
+
     m_supportArchSet = archs;
     m_init = true;
     Q_EMIT backendInitFinsihed();
 }
 
+static UabPkgInfo::Ptr packageFromListItem(const QJsonObject &item)
+{
+    auto uabPtr = UabPkgInfo::Ptr::create();
+
+    uabPtr->id = item.value(kUabId).toString();
+    uabPtr->appName = item.value(kUabName).toString();
+    uabPtr->version = item.value(kUabVersion).toString();
+    uabPtr->channel = item.value(kUabChannel).toString();
+    uabPtr->module = item.value(kUabModule).toString();
+    uabPtr->description = item.value(kUabDescription).toString();
+
+    QJsonArray archArray = item.value(kUabArch).toArray();
+    for (const auto &archItem : archArray) {
+        uabPtr->architecture.append(archItem.toString());
+    }
+
+    return uabPtr;
+}
+
+// same fields as the item of `ll-cli --json list`
+static QJsonObject packageToListItem(const UabPkgInfo::Ptr &uabPtr)
+{
+    return QJsonObject{
+        {kUabId, uabPtr->id},
+        {kUabName, uabPtr->appName},
+        {kUabVersion, uabPtr->version},
+        {kUabChannel, uabPtr->channel},
+        {kUabModule, uabPtr->module},
+        {kUabDescription, uabPtr->description},
+        {kUabArch, QJsonArray::fromStringList(uabPtr->architecture)},
+    };
+}
+
 bool UabBackend::parsePackagesFromRawJson(const QByteArray &jsonData, QList<UabPkgInfo::Ptr> &packageList)
 {
     QJsonParseError jsonError;
@@ -190,22 +388,7 @@ bool UabBackend::parsePackagesFromRawJson(const QByteArray &jsonData, QList<UabP
             continue;
         }
 
-        QJsonObject item = value.toObject();
-        auto uabPtr = UabPkgInfo::Ptr::create();
-
-        uabPtr->id = item.value(kUabId).toString();
-        uabPtr->appName = item.value(kUabName).toString();
-        uabPtr->version = item.value(kUabVersion).toString();
-        uabPtr->channel = item.value(kUabChannel).toString();
-        uabPtr->module = item.value(kUabModule).toString();
-        uabPtr->description = item.value(kUabDescription).toString();
-
-        QJsonArray archArray = item.value(kUabArch).toArray();
-        for (const auto &archItem : archArray) {
-            uabPtr->architecture.append(archItem.toString());
-        }
-
-        packageList.append(uabPtr);
+        packageList.append(packageFromListItem(value.toObject()));
     }
 
     return true;
@@ -242,20 +425,27 @@ bool UabBackend::parsePackagesFromRawOutput(const QByteArray &output, QList<UabP
 }
 
 /**
-   @brief Get Linglong package list from `ll-cli list`
+   @brief Get Linglong package list from the snapshot, or `ll-cli list` if the snapshot is outdated.
         The packages are sorted by package id and package version.
 
    @note This function will be run in QtConcurrent::run()
 */
 void UabBackend::backendProcess(const QPointer<Uab::UabBackend> &notifyPtr)
 {
-    QProcess process;
-    process.start(kUabCliBin, {kUabJson, kUabCliList});
-    process.waitForFinished();
+    const QString snapshotPath = snapshotFilePath();
+    const QString fingerprint = linglongRepoFingerprint();
 
-    const QByteArray output = process.readAllStandardOutput();
     QList<UabPkgInfo::Ptr> packageList;
-    parsePackagesFromRawJson(output, packageList);
+    if (!loadSnapshot(snapshotPath, fingerprint, packageList)) {
+        QProcess process;
+        process.start(kUabCliBin, {kUabJson, kUabCliList});
+        process.waitForFinished();
+
+        const QByteArray output = process.readAllStandardOutput();
+        if (parsePackagesFromRawJson(output, packageList)) {
+            saveSnapshot(snapshotPath, fingerprint, packageList);
+        }
+    }
     sortPackages(packageList);
 
     // detect deb package init
@@ -302,27 +492,146 @@ void UabBackend::sortPackages(QList<UabPkgInfo::Ptr> &packageList)
     });
 }
 
+// versions in descending order
+static bool versionGreater(const UabPkgInfo::Ptr &left, const UabPkgInfo::Ptr &right)
+{
+    return Utils::compareVersion(left->version, right->version) > 0;
+}
+
 void UabBackend::packageInstalled(const UabPkgInfo::Ptr &appendPtr)
 {
-    m_packageList.append(appendPtr);
-    sortPackages(m_packageList);
+    // keep the versions sorted, insert after the same version.
+    QList<UabPkgInfo::Ptr> &versions = m_packageIndex[appendPtr->id];
+    versions.insert(std::upper_bound(versions.begin(), versions.end(), appendPtr, versionGreater), appendPtr);
+    scheduleSnapshot();
 
     qInfo() << QString("Uab package: %1/%2 installed.").arg(appendPtr->id).arg(appendPtr->version);
 }
 
 void UabBackend::packageRemoved(const UabPkgInfo::Ptr &removePtr)
 {
-    auto findItr = std::find_if(m_packageList.begin(), m_packageList.end(), [&](const UabPkgInfo::Ptr &package) {
-        return (removePtr->id == package->id) && (removePtr->version == package->version) &&
-               (removePtr->architecture == package->architecture);
+    auto indexItr = m_packageIndex.find(removePtr->id);
+    if (indexItr == m_packageIndex.end()) {
+        return;
+    }
+
+    QList<UabPkgInfo::Ptr> &versions = indexItr.value();
+    auto range = std::equal_range(versions.begin(), versions.end(), removePtr, versionGreater);
+    auto findItr = std::find_if(range.first, range.second, [&](const UabPkgInfo::Ptr &package) {
+        return (removePtr->version == package->version) && (removePtr->architecture == package->architecture);
     });
 
-    if (findItr != m_packageList.end()) {
-        m_packageList.erase(findItr);
+    if (findItr != range.second) {
+        versions.erase(findItr);
+        if (versions.isEmpty()) {
+            m_packageIndex.erase(indexItr);
+        }
+        scheduleSnapshot();
 
         qInfo() << QString("Uab package: %1/%2 removed.").arg(removePtr->id).arg(removePtr->version);
     }
-    // remove package dose not require sort.
+}
+
+QString UabBackend::snapshotFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QDir::separator() + kUabSnapshotFileName;
+}
+
+/**
+   @brief The modify time of the Linglong repo state files, empty if none exists.
+ */
+QString UabBackend::linglongRepoFingerprint()
+{
+    QStringList stamps;
+    for (const QString &path : kLinglongRepoStatePaths) {
+        struct stat pathStat;
+        if (0 == ::stat(QFile::encodeName(path).constData(), &pathStat)) {
+            stamps.append(QString("%1:%2.%3").arg(path).arg(pathStat.st_mtim.tv_sec).arg(pathStat.st_mtim.tv_nsec));
+        }
+    }
+
+    return stamps.join(';');
+}
+
+bool UabBackend::loadSnapshot(const QString &filePath, const QString &fingerprint, QList<UabPkgInfo::Ptr> &packageList)
+{
+    if (fingerprint.isEmpty()) {
+        return false;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (kUabSnapshotFormatVersion != root.value(kUabSnapshotFormat).toInt() ||
+        fingerprint != root.value(kUabSnapshotFingerprint).toString()) {
+        return false;
+    }
+
+    packageList.clear();
+    const QJsonArray packages = root.value(kUabSnapshotPackages).toArray();
+    for (const auto &value : packages) {
+        if (value.isObject()) {
+            packageList.append(packageFromListItem(value.toObject()));
+        }
+    }
+
+    return true;
+}
+
+bool UabBackend::saveSnapshot(const QString &filePath, const QString &fingerprint, const QList<UabPkgInfo::Ptr> &packageList)
+{
+    if (fingerprint.isEmpty()) {
+        return false;
+    }
+
+    QJsonArray packages;
+    for (const UabPkgInfo::Ptr &uabPtr : packageList) {
+        packages.append(packageToListItem(uabPtr));
+    }
+
+    const QJsonObject root{
+        {kUabSnapshotFormat, kUabSnapshotFormatVersion},
+        {kUabSnapshotFingerprint, fingerprint},
+        {kUabSnapshotPackages, packages},
+    };
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << qPrintable("Write uab snapshot failed:") << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+/**
+   @brief Write the snapshot after a while, restart the delay if already scheduled.
+ */
+void UabBackend::scheduleSnapshot()
+{
+    m_snapshotTimer->start();
+}
+
+void UabBackend::flushSnapshot()
+{
+    if (m_snapshotTimer->isActive()) {
+        m_snapshotTimer->stop();
+        updateSnapshot();
+    }
+}
+
+/**
+   @brief The backend database is updated the same as the repo after install or remove,
+        record the current repo state, the next start does not need to call `ll-cli list`.
+ */
+void UabBackend::updateSnapshot() const
+{
+    saveSnapshot(snapshotFilePath(), linglongRepoFingerprint(), packageList());
 }
 
 UabPkgInfo::Ptr UabBackend::packageFromMetaJson(const QByteArray &json, QString *errorString)
@@ -381,6 +690,56 @@ UabPkgInfo::Ptr UabBackend::packageFromMetaJson(const QByteArray &json, QString
     return {};
 }
 
+/**
+   @brief Read the meta json from the "linglong.meta" ELF section of the uab file, through mmap.
+   @return The meta json, or empty if the file is not ELF or without the section.
+ */
+QByteArray UabBackend::uabMetaSection(const QString &uabPath, QString *errorString)
+{
+    QFile uabFile(uabPath);
+    if (!uabFile.open(QIODevice::ReadOnly)) {
+        if (errorString) {
+            *errorString = QString("open uab file failed: %1").arg(uabFile.errorString());
+        }
+        return {};
+    }
+
+    const qint64 size = uabFile.size();
+    uchar *data = size > EI_NIDENT ? uabFile.map(0, size) : nullptr;
+    if (!data) {
+        if (errorString) {
+            *errorString = QString("map uab file failed: %1").arg(uabFile.errorString());
+        }
+        return {};
+    }
+
+    QByteArray meta;
+    const bool isElf = 0 == ::memcmp(data, ELFMAG, SELFMAG);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    const bool nativeOrder = ELFDATA2LSB == data[EI_DATA];
+#else
+    const bool nativeOrder = ELFDATA2MSB == data[EI_DATA];
+#endif
+    if (isElf && nativeOrder) {
+        if (ELFCLASS64 == data[EI_CLASS]) {
+            meta = elfSectionData<Elf64_Ehdr, Elf64_Shdr>(data, static_cast<quint64>(size), kUabMetaSectionName);
+        } else if (ELFCLASS32 == data[EI_CLASS]) {
+            meta = elfSectionData<Elf32_Ehdr, Elf32_Shdr>(data, static_cast<quint64>(size), kUabMetaSectionName);
+        }
+    }
+    uabFile.unmap(data);
+
+    // section data may be padded with zero
+    while (meta.endsWith('\0')) {
+        meta.chop(1);
+    }
+
+    if (meta.isEmpty() && errorString) {
+        *errorString = QString("uab meta section not found");
+    }
+    return meta;
+}
+
 QByteArray UabBackend::uabExecuteOutput(const QString &uabPath, QString *errorString)
 {
     QFile uabFile(uabPath);
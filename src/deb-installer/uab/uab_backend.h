@@ -5,12 +5,16 @@
 #ifndef UABBACKEND_H
 #define UABBACKEND_H
 
+#include <QHash>
+#include <QMap>
 #include <QObject>
 #include <QPointer>
 #include <QSet>
 
 #include "uab_defines.h"
 
+class QTimer;
+
 namespace Uab {
 
 class UabBackend : public QObject
@@ -34,6 +38,7 @@ public:
 
     [[nodiscard]] static UabPkgInfo::Ptr packageFromMetaData(const QString &uabPath, QString *errorString = nullptr);
     [[nodiscard]] static UabPkgInfo::Ptr packageFromMetaJson(const QByteArray &json, QString *errorString = nullptr);
+    [[nodiscard]] static QByteArray uabMetaSection(const QString &uabPath, QString *errorString = nullptr);
     [[nodiscard]] static QByteArray uabExecuteOutput(const QString &uabPath, QString *errorString = nullptr);
 
     // internal
@@ -43,20 +48,35 @@ public:
     static bool parsePackagesFromRawOutput(const QByteArray &output, QList<UabPkgInfo::Ptr> &packageList);
     static void sortPackages(QList<UabPkgInfo::Ptr> &packageList);
 
+    // snapshot of the installed packages, valid while the Linglong repo state unchanged.
+    [[nodiscard]] static QString snapshotFilePath();
+    [[nodiscard]] static QString linglongRepoFingerprint();
+    static bool loadSnapshot(const QString &filePath, const QString &fingerprint, QList<UabPkgInfo::Ptr> &packageList);
+    static bool saveSnapshot(const QString &filePath, const QString &fingerprint, const QList<UabPkgInfo::Ptr> &packageList);
+
     // update backend database after controller process finished.
     void packageInstalled(const UabPkgInfo::Ptr &appendPtr);
     void packageRemoved(const UabPkgInfo::Ptr &removePtr);
+    // write the pending snapshot now, at the end of a batch or before exit.
+    void flushSnapshot();
 
 private:
     explicit UabBackend(QObject *parent = nullptr);
     ~UabBackend() override;
 
+    [[nodiscard]] QList<UabPkgInfo::Ptr> packageList() const;
+    void scheduleSnapshot();
+    void updateSnapshot() const;
+
 private:
     bool m_init{false};
     bool m_linglongExists{false};  // check Linglong executable (ll-cli) exists.
-    QList<UabPkgInfo::Ptr> m_packageList;
+    // package id -> installed versions, in descending order (the latest version first).
+    // ordered by id, the package list is read in the sortPackages() order without sorting.
+    QMap<QString, QList<UabPkgInfo::Ptr>> m_packageIndex;
     QSet<QString> m_supportArchSet;
     QString m_lastError;
+    QTimer *m_snapshotTimer{nullptr};  // delays the snapshot write after install or remove
 
     Q_DISABLE_COPY(UabBackend)
 };
@@ -0,0 +1,413 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "uab_output_framer.h"
+
+#include <QDebug>
+
+#include <cstring>
+
+namespace Uab {
+
+namespace {
+
+const char kEsc = '\x1B';
+// initial capacity of the pending buffer, kept while framing.
+const int kPendingReserve = 4 * 1024;
+
+inline bool isSpace(char c)
+{
+    return ' ' == c || '\t' == c || '\r' == c || '\n' == c;
+}
+
+inline const char *skipSpace(const char *p, const char *end)
+{
+    while (p < end && isSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+inline bool keyEquals(const char *begin, const char *end, const char *key)
+{
+    const size_t length = static_cast<size_t>(end - begin);
+    return length == ::strlen(key) && 0 == ::memcmp(begin, key, length);
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// decode the content of a json string with escapes, \uXXXX is appended as UTF-16 code unit.
+QString unescape(const char *begin, const char *end)
+{
+    QString result;
+    const char *run = begin;
+    for (const char *p = begin; p < end; ++p) {
+        if ('\\' != *p) {
+            continue;
+        }
+
+        result.append(QString::fromUtf8(run, static_cast<int>(p - run)));
+        if (++p >= end) {
+            break;
+        }
+
+        switch (*p) {
+            case 'n':
+                result.append(QLatin1Char('\n'));
+                break;
+            case 't':
+                result.append(QLatin1Char('\t'));
+                break;
+            case 'r':
+                result.append(QLatin1Char('\r'));
+                break;
+            case 'b':
+                result.append(QLatin1Char('\b'));
+                break;
+            case 'f':
+                result.append(QLatin1Char('\f'));
+                break;
+            case 'u': {
+                ushort code = 0;
+                int i = 0;
+                for (; i < 4 && p + 1 < end; ++i) {
+                    const int value = hexValue(*(p + 1));
+                    if (value < 0) {
+                        break;
+                    }
+                    code = static_cast<ushort>(code << 4 | value);
+                    ++p;
+                }
+                if (4 == i) {
+                    result.append(QChar(code));
+                }
+                break;
+            }
+            default:  // '"', '\\', '/'
+                result.append(QLatin1Char(*p));
+                break;
+        }
+        run = p + 1;
+    }
+
+    result.append(QString::fromUtf8(run, static_cast<int>(end - run)));
+    return result;
+}
+
+// p points at the opening quote, return the position after the closing quote, nullptr if unterminated.
+const char *scanString(const char *p, const char *end, const char **contentEnd, bool *hasEscape)
+{
+    bool escape = false;
+    for (++p; p < end; ++p) {
+        if ('\\' == *p) {
+            escape = true;
+            if (++p >= end) {
+                break;
+            }
+        } else if ('"' == *p) {
+            if (contentEnd) {
+                *contentEnd = p;
+            }
+            if (hasEscape) {
+                *hasEscape = escape;
+            }
+            return p + 1;
+        }
+    }
+    return nullptr;
+}
+
+const char *parseString(const char *p, const char *end, QString *out)
+{
+    if (p >= end || '"' != *p) {
+        return nullptr;
+    }
+
+    const char *contentBegin = p + 1;
+    const char *contentEnd = nullptr;
+    bool hasEscape = false;
+    p = scanString(p, end, &contentEnd, &hasEscape);
+    if (p) {
+        *out = hasEscape ? unescape(contentBegin, contentEnd)
+                         : QString::fromUtf8(contentBegin, static_cast<int>(contentEnd - contentBegin));
+    }
+    return p;
+}
+
+// number or numeric string, ll-cli writes the percentage as string.
+const char *parseNumber(const char *p, const char *end, double *out, bool *ok)
+{
+    const char *begin = p;
+    const char *valueEnd = nullptr;
+    if (p < end && '"' == *p) {
+        ++begin;
+        p = scanString(p, end, &valueEnd, nullptr);
+        if (!p) {
+            return nullptr;
+        }
+    } else {
+        while (p < end && ',' != *p && '}' != *p && ']' != *p && !isSpace(*p)) {
+            ++p;
+        }
+        valueEnd = p;
+    }
+
+    *out = QByteArray::fromRawData(begin, static_cast<int>(valueEnd - begin)).toDouble(ok);
+    return p;
+}
+
+const char *skipValue(const char *p, const char *end)
+{
+    if (p >= end) {
+        return nullptr;
+    }
+
+    if ('"' == *p) {
+        return scanString(p, end, nullptr, nullptr);
+    }
+
+    if ('{' == *p || '[' == *p) {
+        int depth = 0;
+        for (; p < end; ++p) {
+            if ('"' == *p) {
+                p = scanString(p, end, nullptr, nullptr);
+                if (!p) {
+                    return nullptr;
+                }
+                --p;
+            } else if ('{' == *p || '[' == *p) {
+                ++depth;
+            } else if (('}' == *p || ']' == *p) && 0 == --depth) {
+                return p + 1;
+            }
+        }
+        return nullptr;
+    }
+
+    // number, true, false, null
+    while (p < end && ',' != *p && '}' != *p && ']' != *p && !isSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+}  // namespace
+
+UabOutputFramer::UabOutputFramer()
+{
+    // resize(0) keeps the reserved capacity, the buffer is reused for every split record.
+    m_pending.reserve(kPendingReserve);
+}
+
+/**
+   @brief Output examples of `ll-cli --json install/uninstall [path]` (linglong-bin 1.6.2).
+   @code
+    // progress
+    [
+        {
+            "message": "prepare for installing uab",
+            "percentage": "0",
+            "state": "preInstall"
+        }
+    ]
+
+    // successed
+    {
+        "message": "install uab successfully",
+        "percentage": "100",
+        "state": "Success"
+    }
+
+    // failed
+    {"code":-1,"message":"./libs/linglong/src/linglong/cli/cli.cpp:125 download status:
+   \n./libs/linglong/src/linglong/repo/ostree_repo.cpp:915 import layer dir: main:org.deepin.editor/6.5.2.1/x86_64 exists."}
+
+   @endcode
+ */
+void UabOutputFramer::feed(const char *data, int length, const RecordCallback &onRecord)
+{
+    const char *end = data + length;
+    // begin of the record started in this chunk, nullptr if continued from m_pending.
+    const char *recordBegin = nullptr;
+
+    for (const char *p = data; p < end; ++p) {
+        const char c = *p;
+
+        switch (m_state) {
+            case Text:
+                if ('{' == c || '[' == c) {
+                    m_state = InRecord;
+                    m_depth = 1;
+                    m_inString = false;
+                    m_escaped = false;
+                    m_rawPercent = -1;
+                    recordBegin = p;
+                } else if (kEsc == c) {
+                    m_state = Escape;
+                } else if (m_rawPercent >= 0 && c >= '0' && c <= '9') {
+                    m_rawPercent = m_rawPercent * 10 + (c - '0');
+                    m_rawDigits++;
+                    if (m_rawDigits > 3) {
+                        m_rawPercent = -1;
+                    }
+                } else if (m_rawPercent >= 0 && '%' == c && m_rawDigits > 0) {
+                    Record record;
+                    record.hasPercentage = true;
+                    record.percentage = static_cast<float>(m_rawPercent);
+                    m_rawPercent = -1;
+                    onRecord(record);
+                } else {
+                    m_rawPercent = -1;
+                }
+                break;
+
+            case Escape:
+                m_state = ('[' == c) ? Control : Text;
+                break;
+
+            case Control:
+                // parameter and intermediate bytes until the final byte
+                if (c >= 0x40 && c <= 0x7E) {
+                    m_state = Text;
+                    m_rawPercent = 0;
+                    m_rawDigits = 0;
+                }
+                break;
+
+            case InRecord:
+                if (m_inString) {
+                    if (m_escaped) {
+                        m_escaped = false;
+                    } else if ('\\' == c) {
+                        m_escaped = true;
+                    } else if ('"' == c) {
+                        m_inString = false;
+                    }
+                } else if ('"' == c) {
+                    m_inString = true;
+                } else if ('{' == c || '[' == c) {
+                    m_depth++;
+                } else if (('}' == c || ']' == c) && 0 == --m_depth) {
+                    if (recordBegin) {
+                        emitRecord(recordBegin, p + 1, onRecord);
+                    } else {
+                        m_pending.append(data, static_cast<int>(p + 1 - data));
+                        emitRecord(m_pending.constData(), m_pending.constData() + m_pending.size(), onRecord);
+                    }
+
+                    m_pending.resize(0);
+                    recordBegin = nullptr;
+                    m_state = Text;
+                }
+                break;
+        }
+    }
+
+    if (InRecord == m_state) {
+        const char *tail = recordBegin ? recordBegin : data;
+        if (m_pending.size() + (end - tail) > kMaxRecordSize) {
+            qWarning() << "[UabOutputFramer]" << "drop oversized output record";
+            dropRecord();
+        } else {
+            m_pending.append(tail, static_cast<int>(end - tail));
+        }
+    }
+}
+
+void UabOutputFramer::reset()
+{
+    dropRecord();
+    m_rawPercent = -1;
+    m_rawDigits = 0;
+}
+
+bool UabOutputFramer::parseRecord(const char *begin, const char *end, Record *record)
+{
+    const char *p = skipSpace(begin, end);
+    if (p < end && '[' == *p) {
+        p = skipSpace(p + 1, end);
+    }
+    if (p >= end || '{' != *p) {
+        return false;
+    }
+
+    for (p = skipSpace(p + 1, end); p < end && '}' != *p;) {
+        if ('"' != *p) {
+            return false;
+        }
+
+        const char *keyBegin = p + 1;
+        const char *keyEnd = nullptr;
+        p = scanString(p, end, &keyEnd, nullptr);
+        if (!p) {
+            return false;
+        }
+
+        p = skipSpace(p, end);
+        if (p >= end || ':' != *p) {
+            return false;
+        }
+        p = skipSpace(p + 1, end);
+
+        if (keyEquals(keyBegin, keyEnd, "percentage")) {
+            double value = 0;
+            p = parseNumber(p, end, &value, &record->hasPercentage);
+            record->percentage = static_cast<float>(value);
+        } else if (keyEquals(keyBegin, keyEnd, "code")) {
+            double value = 0;
+            p = parseNumber(p, end, &value, &record->hasCode);
+            record->code = static_cast<int>(value);
+        } else if (keyEquals(keyBegin, keyEnd, "state")) {
+            p = parseString(p, end, &record->state);
+        } else if (keyEquals(keyBegin, keyEnd, "message")) {
+            p = parseString(p, end, &record->message);
+        } else {
+            p = skipValue(p, end);
+        }
+
+        if (!p) {
+            return false;
+        }
+
+        p = skipSpace(p, end);
+        if (p < end && ',' == *p) {
+            p = skipSpace(p + 1, end);
+        }
+    }
+
+    return p < end;
+}
+
+void UabOutputFramer::emitRecord(const char *begin, const char *end, const RecordCallback &onRecord)
+{
+    Record record;
+    if (parseRecord(begin, end, &record)) {
+        onRecord(record);
+    } else {
+        qDebug() << "[UabOutputFramer]" << "ignore unknown output record";
+    }
+}
+
+void UabOutputFramer::dropRecord()
+{
+    m_pending.resize(0);
+    m_state = Text;
+    m_depth = 0;
+    m_inString = false;
+    m_escaped = false;
+}
+
+}  // namespace Uab
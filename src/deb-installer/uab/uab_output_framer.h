@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef UABOUTPUTFRAMER_H
+#define UABOUTPUTFRAMER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <functional>
+
+namespace Uab {
+
+/**
+   @brief Incremental framer of `ll-cli --json install/uninstall` output.
+
+    The PTY delivers the output in arbitrary chunks, a json record may be split
+    across reads or several records coalesced into one read, and terminal
+    control sequences are mixed in. The framer scans each byte once, tracking
+    the bracket depth of the current record outside of strings. Complete
+    records are parsed in place from the chunk, only the unfinished tail of a
+    record is kept in a reusable buffer until the next chunk arrives.
+    Only the fields used by the installer are extracted from a record.
+
+    Raw progress text "\x1B[?25l42% message" of the non-json output is reported
+    as a record with only the percentage set.
+ */
+class UabOutputFramer
+{
+public:
+    struct Record
+    {
+        bool hasPercentage{false};
+        float percentage{0};
+        bool hasCode{false};
+        int code{0};
+        QString state;
+        QString message;
+    };
+    using RecordCallback = std::function<void(const Record &record)>;
+
+    UabOutputFramer();
+
+    // scan the next chunk of output, \a onRecord is called for each complete record.
+    void feed(const char *data, int length, const RecordCallback &onRecord);
+    // drop the unfinished record, e.g. the process restarted.
+    void reset();
+
+    // parse the fields of a single json record, the first object of a top level array is used.
+    [[nodiscard]] static bool parseRecord(const char *begin, const char *end, Record *record);
+
+    // records larger than this are dropped, ll-cli never writes such output.
+    static constexpr int kMaxRecordSize = 1024 * 1024;
+
+private:
+    enum ScanState {
+        Text,      // between records
+        Escape,    // after ESC
+        Control,   // control sequence "ESC [ ... final"
+        InRecord,  // inside a json record
+    };
+
+    void emitRecord(const char *begin, const char *end, const RecordCallback &onRecord);
+    void dropRecord();
+
+    ScanState m_state{Text};
+    int m_depth{0};
+    bool m_inString{false};
+    bool m_escaped{false};
+
+    // raw progress digits, -1 if not right after a control sequence.
+    int m_rawPercent{-1};
+    int m_rawDigits{0};
+
+    QByteArray m_pending;  // unfinished record of the last chunks
+};
+
+}  // namespace Uab
+
+#endif  // UABOUTPUTFRAMER_H
@@ -32,6 +32,9 @@ UabPackageListModel::UabPackageListModel(QObject *parent)
     connect(m_processor, &UabProcessController::processOutput, this, &UabPackageListModel::signalAppendOutputInfo);
     connect(m_processor, &UabProcessController::progressChanged, this, &UabPackageListModel::slotBackendProgressChanged);
     connect(m_processor, &UabProcessController::processFinished, this, &UabPackageListModel::slotBackendProcessFinished);
+    connect(m_processor, &UabProcessController::taskStarted, this, &UabPackageListModel::slotTaskStarted);
+    connect(m_processor, &UabProcessController::taskProgressChanged, this, &UabPackageListModel::slotTaskProgressChanged);
+    connect(m_processor, &UabProcessController::taskFinished, this, &UabPackageListModel::slotTaskFinished);
 
     connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, this, &UabPackageListModel::slotFileChanged);
 
@@ -243,7 +246,8 @@ bool UabPackageListModel::slotInstallPackages()
         Q_EMIT dataChanged(index(0), index(m_uabPkgList.size() - 1), {PackageOperateStatusRole});
 
         setWorkerStatus(WorkerProcessing);
-        installNextUab();
+        // failed packages are marked by commit, include all failed.
+        commitInstallUabs();
         callRet = true;
     } while (false);
 
@@ -293,7 +297,7 @@ bool UabPackageListModel::slotUninstallPackage(const int i)
         setCurrentOperation(Pkg::Waiting);
 
         m_processor->reset();
-        m_processor->markUninstall(Uab::UabPackage::fromInfo(removeInfoPtr));
+        m_processor->markUninstall(Uab::UabPackage::fromInfo(removeInfoPtr), uabPtr);
         callRet = m_processor->commitChanges();
     } while (false);
 
@@ -331,74 +335,68 @@ void UabPackageListModel::resetInstallStatus()
     Q_EMIT dataChanged(index(0), index(m_uabPkgList.size() - 1), {PackageOperateStatusRole});
 }
 
-bool UabPackageListModel::installNextUab()
+/**
+   @brief Commit install tasks of all packages at once, the controller runs packages
+        of different id concurrently, the package status is updated by task signals.
+ */
+bool UabPackageListModel::commitInstallUabs()
 {
-    m_operatingIndex++;
-    Q_ASSERT_X(m_operatingIndex >= 0, "install uab", "operating index invalid");
-    if (m_operatingIndex < 0) {
-        setWorkerStatus(WorkerFinished);
-        return false;
-    }
-
-    // check install finish
-    if (m_operatingIndex >= rowCount()) {
-        Q_EMIT signalCurrentPacakgeProgressChanged(static_cast<int>(kCompleteProgress));
-        Q_EMIT signalWholeProgressChanged(static_cast<int>(kCompleteProgress));
-
-        setWorkerStatus(WorkerFinished);
-        return true;
-    }
-
-    // notify list view scroll to current package
-    Q_EMIT signalCurrentProcessPackageIndex(m_operatingIndex);
-
-    auto uabPtr = m_uabPkgList.value(m_operatingIndex);
-    if (!uabPtr || Pkg::DependsOk != uabPtr->m_dependsStatus) {
-        setCurrentOperation(Pkg::Failed);
-        installNextUab();
-        return false;
-    }
-
-    setCurrentOperation(Pkg::Operating);
-
     m_processor->reset();
+    m_taskRows.clear();
+    m_rowUnfinishedTasks.clear();
+
+    for (int row = 0; row < rowCount(); ++row) {
+        auto uabPtr = m_uabPkgList.value(row);
+        if (!uabPtr || Pkg::DependsOk != uabPtr->m_dependsStatus) {
+            setOperation(row, Pkg::Failed);
+            continue;
+        }
 
-    // Note: Current Linglong environment supports multi version package same time,
-    //       check if install same version package.
-    Pkg::PackageInstallStatus installStatus = uabPtr->installStatus();
-    if (Pkg::InstalledLaterVersion == installStatus) {
-        if (auto sameInfoPtr = Uab::UabBackend::instance()->findPackage(uabPtr->info()->id, uabPtr->info()->version)) {
-            const int ret = Utils::compareVersion(uabPtr->info()->version, sameInfoPtr->version);
-
-            if (ret == 0) {
-                installStatus = Pkg::InstalledSameVersion;
-            } else if (ret < 0) {
-                installStatus = Pkg::InstalledLaterVersion;
-            } else {
-                installStatus = Pkg::InstalledEarlierVersion;
+        // Note: Current Linglong environment supports multi version package same time,
+        //       check if install same version package.
+        Pkg::PackageInstallStatus installStatus = uabPtr->installStatus();
+        if (Pkg::InstalledLaterVersion == installStatus) {
+            if (auto sameInfoPtr = Uab::UabBackend::instance()->findPackage(uabPtr->info()->id, uabPtr->info()->version)) {
+                const int ret = Utils::compareVersion(uabPtr->info()->version, sameInfoPtr->version);
+
+                if (ret == 0) {
+                    installStatus = Pkg::InstalledSameVersion;
+                } else if (ret < 0) {
+                    installStatus = Pkg::InstalledLaterVersion;
+                } else {
+                    installStatus = Pkg::InstalledEarlierVersion;
+                }
             }
         }
-    }
 
-    switch (installStatus) {
-        case Pkg::NotInstalled:
-            m_processor->markInstall(uabPtr);
-            break;
-        case Pkg::InstalledSameVersion: {
-            auto oldInfoPtr = Uab::UabBackend::instance()->findPackage(uabPtr->info()->id, uabPtr->info()->version);
-            m_processor->markUninstall(Uab::UabPackage::fromInfo(oldInfoPtr));
-            m_processor->markInstall(uabPtr);
-        } break;
-        default: {
-            auto oldInfoPtr = Uab::UabBackend::instance()->findPackage(uabPtr->info()->id);
-            m_processor->markInstall(uabPtr);
-            m_processor->markUninstall(Uab::UabPackage::fromInfo(oldInfoPtr));
-        } break;
+        int taskCount = 0;
+        switch (installStatus) {
+            case Pkg::NotInstalled:
+                taskCount += m_processor->markInstall(uabPtr);
+                break;
+            case Pkg::InstalledSameVersion: {
+                auto oldInfoPtr = Uab::UabBackend::instance()->findPackage(uabPtr->info()->id, uabPtr->info()->version);
+                taskCount += m_processor->markUninstall(Uab::UabPackage::fromInfo(oldInfoPtr), uabPtr);
+                taskCount += m_processor->markInstall(uabPtr);
+            } break;
+            default: {
+                auto oldInfoPtr = Uab::UabBackend::instance()->findPackage(uabPtr->info()->id);
+                taskCount += m_processor->markInstall(uabPtr);
+                taskCount += m_processor->markUninstall(Uab::UabPackage::fromInfo(oldInfoPtr), uabPtr);
+            } break;
+        }
+
+        if (0 == taskCount) {
+            setOperation(row, Pkg::Failed);
+            continue;
+        }
+
+        m_taskRows.insert(uabPtr->info()->id, row);
+        m_rowUnfinishedTasks.insert(row, taskCount);
     }
 
-    if (!m_processor->commitChanges()) {
-        setCurrentOperation(Pkg::Failed);
-        installNextUab();
+    if (m_rowUnfinishedTasks.isEmpty() || !m_processor->commitChanges()) {
+        slotBackendProcessFinished(false);
         return false;
     }
 
@@ -409,6 +407,12 @@ void UabPackageListModel::slotBackendProgressChanged(float progress)
 {
     Q_ASSERT_X(rowCount() > 0, "check count", "row count invalid");
 
+    // progress of all packages, weighted by package size.
+    if (WorkerProcessing == m_workerStatus) {
+        Q_EMIT signalWholeProgressChanged(static_cast<int>(progress));
+        return;
+    }
+
     const float base = kCompleteProgress / rowCount();
     const float wholeProgress = (m_operatingIndex + (progress / kCompleteProgress)) * base;
 
@@ -420,43 +424,110 @@ void UabPackageListModel::slotBackendProcessFinished(bool success)
 {
     Q_ASSERT_X(rowCount() > 0, "check count", "row count invalid");
 
-    // update installed status
-    setCurrentOperation(success ? Pkg::Success : Pkg::Failed);
-    // update all data
-    Q_EMIT dataChanged(index(m_operatingIndex), index(m_operatingIndex));
+    switch (m_workerStatus) {
+        case WorkerProcessing: {
+            // tasks skipped after the failed one
+            for (auto itr = m_rowUnfinishedTasks.cbegin(); itr != m_rowUnfinishedTasks.cend(); ++itr) {
+                setOperation(itr.key(), Pkg::Failed);
+            }
+            m_rowUnfinishedTasks.clear();
+            m_taskRows.clear();
 
-    // update progress
-    const float base = kCompleteProgress / rowCount();
-    Q_EMIT signalCurrentPacakgeProgressChanged(static_cast<int>(kCompleteProgress));
-    Q_EMIT signalWholeProgressChanged(static_cast<int>(base * (m_operatingIndex + 1)));
+            Q_EMIT signalCurrentPacakgeProgressChanged(static_cast<int>(kCompleteProgress));
+            Q_EMIT signalWholeProgressChanged(static_cast<int>(kCompleteProgress));
+            setWorkerStatus(WorkerFinished);
+        } break;
+        case WorkerUnInstall: {
+            // update installed status
+            setCurrentOperation(success ? Pkg::Success : Pkg::Failed);
+
+            // update progress
+            const float base = kCompleteProgress / rowCount();
+            Q_EMIT signalCurrentPacakgeProgressChanged(static_cast<int>(kCompleteProgress));
+            Q_EMIT signalWholeProgressChanged(static_cast<int>(base * (m_operatingIndex + 1)));
 
-    switch (m_workerStatus) {
-        case WorkerProcessing:
-            installNextUab();
-            break;
-        case WorkerUnInstall:
             setWorkerStatus(WorkerFinished);
-            break;
+        } break;
         default:
             break;
     }
 }
 
+void UabPackageListModel::slotTaskStarted(const UabPackage::Ptr &package)
+{
+    if (WorkerProcessing != m_workerStatus || !package) {
+        return;
+    }
+
+    const int row = m_taskRows.value(package->info()->id, kPkgInitedIndex);
+    if (!checkIndexValid(row) || Pkg::Operating == m_uabPkgList[row]->m_operationStatus) {
+        return;
+    }
+
+    // notify list view scroll to the latest started package
+    m_operatingIndex = row;
+    setOperation(row, Pkg::Operating);
+    Q_EMIT signalCurrentProcessPackageIndex(row);
+}
+
+void UabPackageListModel::slotTaskProgressChanged(const UabPackage::Ptr &package, float progress)
+{
+    if (WorkerProcessing != m_workerStatus || !package) {
+        return;
+    }
+
+    if (m_taskRows.value(package->info()->id, kPkgInitedIndex) == m_operatingIndex) {
+        Q_EMIT signalCurrentPacakgeProgressChanged(static_cast<int>(progress));
+    }
+}
+
+void UabPackageListModel::slotTaskFinished(const UabPackage::Ptr &package, bool success)
+{
+    if (WorkerProcessing != m_workerStatus || !package) {
+        return;
+    }
+
+    const int row = m_taskRows.value(package->info()->id, kPkgInitedIndex);
+    auto countItr = m_rowUnfinishedTasks.find(row);
+    if (countItr == m_rowUnfinishedTasks.end()) {
+        return;
+    }
+
+    if (!success) {
+        // error message set by the controller is kept
+        m_rowUnfinishedTasks.erase(countItr);
+        setOperation(row, Pkg::Failed);
+    } else if (0 == --countItr.value()) {
+        m_rowUnfinishedTasks.erase(countItr);
+        setOperation(row, Pkg::Success);
+    }
+}
+
 void UabPackageListModel::setCurrentOperation(Pkg::PackageOperationStatus s)
 {
-    if (!checkIndexValid(m_operatingIndex)) {
+    setOperation(m_operatingIndex, s);
+}
+
+void UabPackageListModel::setOperation(int row, Pkg::PackageOperationStatus s)
+{
+    if (!checkIndexValid(row)) {
         return;
     }
 
-    auto &uabPtr = m_uabPkgList[m_operatingIndex];
+    auto &uabPtr = m_uabPkgList[row];
     uabPtr->m_operationStatus = s;
 
-    // mark error info
-    if (Pkg::Failed == s) {
+    // mark error info, keep the error reported by the process of this package.
+    if (Pkg::Failed == s && uabPtr->processError().isEmpty()) {
         uabPtr->setProcessError(Pkg::UnknownError, tr("Installation Failed"));
     }
 
-    Q_EMIT dataChanged(index(m_operatingIndex), index(m_operatingIndex), {PackageOperateStatusRole});
+    if (Pkg::Success == s || Pkg::Failed == s) {
+        // update all data, e.g. installed version
+        Q_EMIT dataChanged(index(row), index(row));
+    } else {
+        Q_EMIT dataChanged(index(row), index(row), {PackageOperateStatusRole});
+    }
 }
 
 bool UabPackageListModel::checkIndexValid(int index) const
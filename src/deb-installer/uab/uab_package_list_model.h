@@ -41,12 +41,16 @@ public:
     void resetInstallStatus() override;
 
 private:
-    bool installNextUab();
+    bool commitInstallUabs();
 
     Q_SLOT void slotBackendProgressChanged(float progress);
     Q_SLOT void slotBackendProcessFinished(bool success);
+    Q_SLOT void slotTaskStarted(const Uab::UabPackage::Ptr &package);
+    Q_SLOT void slotTaskProgressChanged(const Uab::UabPackage::Ptr &package, float progress);
+    Q_SLOT void slotTaskFinished(const Uab::UabPackage::Ptr &package, bool success);
 
     void setCurrentOperation(Pkg::PackageOperationStatus s);
+    void setOperation(int row, Pkg::PackageOperationStatus s);
     bool checkIndexValid(int index) const;
     UabPackage::Ptr preCheckPackage(const QString &packagePath);
     bool packageExists(const UabPackage::Ptr &uabPtr) const;
@@ -57,6 +61,8 @@ private:
 private:
     int m_operatingIndex{-1};
     QList<UabPackage::Ptr> m_uabPkgList;
+    QHash<QString, int> m_taskRows;      // package id -> row, of the committed install tasks
+    QHash<int, int> m_rowUnfinishedTasks;  // row -> count of unfinished tasks
     UabProcessController *m_processor{nullptr};
 
     QStringList m_delayAppendPackages;  // wait for backend inited.
@@ -4,16 +4,19 @@
 
 #include "uab_process_controller.h"
 
-#include <QRegularExpression>
+#include <QDir>
+#include <QFileInfo>
+#include <QSet>
 #include <QProcess>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <QJsonObject>
+#include <QSettings>
+#include <QStandardPaths>
 #include <QDebug>
 
 #include "uab_backend.h"
 #include "process/Pty.h"
 
+#include <algorithm>
+
 namespace Uab {
 
 // linglong cli command
@@ -22,31 +25,38 @@ const QString kLinglongJson = "--json";
 const QString kLinglongInstall = "install";
 const QString kLinglongUninstall = "uninstall";
 
-// ll-cli output json tag
-const QString kJsonPercentage = "percentage";
-const QString kJsonState = "state";
-const QString kJsonCode = "code";
-const QString kJsonMessage = "messsage";
-
 // transport install/uninstall task to higher level permission process.
 static const QString kPkexecBin = "pkexec";
 static const QString kInstallProcessorBin = "deepin-deb-installer-dependsInstall";
 static const QString kParamUab = "--uab";
 static const QString kParamInstall = "--install";
 static const QString kParamRemove = "--remove";
+// pkexec exit codes: authorization dialog dismissed, not authorized
+static const int kPkexecDismissed = 126;
+static const int kPkexecNotAuthorized = 127;
 
-const int kInitedIndex = -1;
+// concurrent ll-cli processes, "uab/max_concurrency" in deepin-deb-installer.conf
+static const QString kMaxConcurrencySettingKey = "uab/max_concurrency";
+static const int kDefaultMaxConcurrency = 3;
+// uninstall is fast compared with install, weight of its progress against installs.
+static const int kUninstallWeightRatio = 10;
 
 /**
  * @class UabProcessController
  * @brief Uab process controller. It manages the process of installing/uninstalling uab packages.
  *        Its uses `deepin-deb-installer-dependsInstall` command to install/uninstall uab packages
  *        with higher level permission.
+ *        Linglong layers of different package id are independent, tasks of different ids run
+ *        concurrently, each task in its own process.
  */
 UabProcessController::UabProcessController(QObject *parent)
     : QObject{parent}
 {
     setProcessType(BackendCli);
+
+    const QString confPath =
+        QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + QDir::separator() + "deepin-deb-installer.conf";
+    setMaxConcurrency(QSettings(confPath, QSettings::IniFormat).value(kMaxConcurrencySettingKey, kDefaultMaxConcurrency).toInt());
 }
 
 void UabProcessController::setProcessType(ProcessType type)
@@ -62,6 +72,16 @@ UabProcessController::ProcessType UabProcessController::processType() const
     return m_type;
 }
 
+void UabProcessController::setMaxConcurrency(int count)
+{
+    m_maxConcurrency = qMax(1, count);
+}
+
+int UabProcessController::maxConcurrency() const
+{
+    return m_maxConcurrency;
+}
+
 UabProcessController::ProcFlags UabProcessController::procFlag() const
 {
     return m_procFlag;
@@ -73,20 +93,15 @@ bool UabProcessController::isRunning() const
         return true;
     }
 
-    if (m_process && QProcess::NotRunning != m_process->state()) {
-        return true;
-    }
-
-    return false;
+    return runningCount() > 0;
 }
 
 bool UabProcessController::reset()
 {
-    if (isRunning() || !ensureProcess()) {
+    if (isRunning()) {
         return false;
     }
 
-    m_currentIndex = kInitedIndex;
     m_procList.clear();
 
     return true;
@@ -94,222 +109,334 @@ bool UabProcessController::reset()
 
 bool Uab::UabProcessController::markInstall(const UabPackage::Ptr &installPtr)
 {
-    if (isRunning() || !ensureProcess() || !installPtr || !installPtr->isValid()) {
+    if (isRunning() || !installPtr || !installPtr->isValid()) {
         return false;
     }
 
-    m_procList.append(qMakePair(Installing, installPtr));
+    ProcTask task;
+    task.type = Installing;
+    task.package = installPtr;
+    task.weight = qMax<qint64>(1, QFileInfo(installPtr->info()->filePath).size());
+    m_procList.append(task);
     return true;
 }
 
-bool Uab::UabProcessController::markUninstall(const UabPackage::Ptr &uninstallPtr)
+bool Uab::UabProcessController::markUninstall(const UabPackage::Ptr &uninstallPtr, const UabPackage::Ptr &rowPtr)
 {
-    if (isRunning() || !ensureProcess() || !uninstallPtr || !uninstallPtr->isValid()) {
+    if (isRunning() || !uninstallPtr || !uninstallPtr->isValid()) {
         return false;
     }
 
-    m_procList.append(qMakePair(Uninstalling, uninstallPtr));
+    ProcTask task;
+    task.type = Uninstalling;
+    task.package = uninstallPtr;
+    task.rowPackage = rowPtr;
+    m_procList.append(task);
     return true;
 }
 
 bool UabProcessController::commitChanges()
 {
-    if (isRunning() || !ensureProcess() || m_procList.isEmpty()) {
+    if (isRunning() || m_procList.isEmpty()) {
         return false;
     }
 
+    // no size for uninstall, weight by the average size of installs.
+    qint64 installWeight = 0;
+    int installCount = 0;
+    for (const ProcTask &task : m_procList) {
+        if (Installing == task.type) {
+            installWeight += task.weight;
+            installCount++;
+        }
+    }
+    const qint64 uninstallWeight = installCount ? qMax<qint64>(1, installWeight / installCount / kUninstallWeightRatio) : 1;
+    for (ProcTask &task : m_procList) {
+        if (Uninstalling == task.type) {
+            task.weight = uninstallWeight;
+        }
+    }
+
     m_procFlag = Processing;
-    m_currentIndex = kInitedIndex;
-    if (!nextProcess()) {
+    m_authorized = (BackendCli != m_type);
+    if (!startTask(0)) {
         m_procFlag = Error;
         return false;
     }
 
     Q_EMIT processStart();
+    scheduleTasks();
     return true;
 }
 
-bool Uab::UabProcessController::ensureProcess()
+void UabProcessController::onOutputRecord(int index, const UabOutputFramer::Record &record)
 {
-    if (!m_process) {
-        m_process = new Konsole::Pty(this);
-
-        connect(m_process, &Konsole::Pty::receivedData, this, &UabProcessController::onReadOutput);
-        connect(
-            m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &UabProcessController::onFinished);
-    } else if (QProcess::NotRunning != m_process->state()) {
-        qWarning() << "Unable to restart uab process is still running";
-        return false;
-    }
-
-    return true;
-}
-
-/**
-   @brief Parse json data from `ll-cli --json install/uninstall [path]` output.
-    Here are output example (linglong-bin 1.6.2).
-   @code
-    // progress
-    [
-        {
-            "message": "prepare for installing uab",
-            "percentage": "0",
-            "state": "preInstall"
+    if (record.hasPercentage) {
+        updateTaskProgress(index, record.percentage);
+
+    } else if (record.hasCode && UabError == record.code) {
+        if (checkIndexValid(index)) {
+            const ProcTask &task = m_procList.at(index);
+            const UabPackage::Ptr &errorPtr = task.rowPackage ? task.rowPackage : task.package;
+            if (errorPtr) {
+                errorPtr->setProcessError(Pkg::UnknownError, record.message);
+            }
         }
-    ]
 
-    // successed
-    {
-        "message": "install uab successfully",
-        "percentage": "100",
-        "state": "Success"
+        qWarning() << qPrintable("Uab process error:") << record.message;
     }
 
-    // failed
-    {"code":-1,"message":"./libs/linglong/src/linglong/cli/cli.cpp:125 download status:
-   \n./libs/linglong/src/linglong/repo/ostree_repo.cpp:915 import layer dir: main:org.deepin.editor/6.5.2.1/x86_64 exists."}
+    // TODO(renbin): signature verify error, etc.
+}
 
-   @endcode
- */
-void UabProcessController::parseProgressFromJson(const QByteArray &jsonData)
+void UabProcessController::updateTaskProgress(int index, float progress)
 {
-    const QJsonDocument doc = QJsonDocument::fromJson(jsonData);
-
-    if (doc.isArray()) {
-        // maybe percentage info
-        const QJsonObject obj = doc.array().first().toObject();
-        if (obj.contains(kJsonPercentage)) {
-            float progress = obj.value(kJsonPercentage).toDouble();
-            updateWholeProgress(progress);
-        }
-
-    } else if (doc.isObject()) {
-        // maybe percentage / code info
-        const QJsonObject obj = doc.object();
-
-        if (obj.contains(kJsonPercentage)) {
-            float progress = obj.value(kJsonPercentage).toDouble();
-            updateWholeProgress(progress);
+    if (!checkIndexValid(index)) {
+        return;
+    }
 
-        } else if (UabError == obj.value(kJsonCode).toInt()) {
-            const QString errorString = obj.value(kJsonMessage).toString();
-            auto currUabPtr = currentPackagePtr();
-            if (currUabPtr) {
-                currUabPtr->setProcessError(Pkg::UnknownError, errorString);
-            }
+    m_procList[index].progress = progress;
+    Q_EMIT taskProgressChanged(m_procList[index].package, progress);
 
-            qWarning() << qPrintable("Uab process error:") << errorString;
-        }
-
-        // TODO(renbin): signature verify error, etc.
-    }
+    updateWholeProgress();
 }
 
-void UabProcessController::parseProgressFromRawOutput(const QByteArray &output)
+void UabProcessController::updateWholeProgress()
 {
-    // Detect progress change, filter ANSI code, receive data such as:
-    // "\r\x1B[K\x1B[?25l0% prepare for installing uab\x1B[?25h"
-    // "\r\x1B[K\x1B[?25l100% install uab successfully\x1B[?25h\n"
-    //
-    // pattern: ^\r?(\x1B\[\W?\d*\w)+(\d+)%
-    static const QRegularExpression kRegExp("^\\r?(\\x1B\\[\\W?\\d*\\w)+(\\d+)%");
-    QRegularExpressionMatch match = kRegExp.match(QString(output), 0, QRegularExpression::PartialPreferFirstMatch);
-    if (match.hasMatch()) {
-        // get (\\d+) capture
-        float progress = match.captured(match.lastCapturedIndex()).toFloat();
-        updateWholeProgress(progress);
+    // progress of each task weighted by package size
+    double totalWeight = 0;
+    double finishedWeight = 0;
+    for (const ProcTask &task : m_procList) {
+        totalWeight += task.weight;
+        switch (task.state) {
+            case TaskPending:
+                break;
+            case TaskRunning:
+                finishedWeight += task.weight * task.progress / 100.0;
+                break;
+            default:
+                finishedWeight += task.weight;
+                break;
+        }
     }
-}
 
-void UabProcessController::updateWholeProgress(float currentTaskProgress)
-{
-    const int count = m_procList.size();
-    if (count > 1) {
-        currentTaskProgress = (m_currentIndex * 100.0f + currentTaskProgress) / static_cast<float>(count);
+    if (totalWeight > 0) {
+        Q_EMIT progressChanged(static_cast<float>(finishedWeight * 100.0 / totalWeight));
     }
-
-    Q_EMIT progressChanged(currentTaskProgress);
 }
 
-void UabProcessController::onReadOutput(const char *buffer, int length, bool isCommandExec)
+void UabProcessController::onReadOutput(int index, const char *buffer, int length)
 {
-    Q_UNUSED(isCommandExec)
-    QByteArray output = QByteArray::fromRawData(buffer, length);
-    Q_EMIT processOutput(output);
+    Q_EMIT processOutput(QString::fromUtf8(buffer, length));
+
+    if (!checkIndexValid(index)) {
+        return;
+    }
 
     // e.g: ll-cli --json install /path/to/file
-    parseProgressFromJson(output);
+    m_procList[index].framer.feed(
+        buffer, length, [this, index](const UabOutputFramer::Record &record) { onOutputRecord(index, record); });
 }
 
-void UabProcessController::onFinished(int exitCode, int exitStatus)
+void UabProcessController::onFinished(int index, int exitCode)
 {
-    Q_UNUSED(exitStatus)
-
     const bool exitSuccess = UabSuccess == exitCode;
 
-    // continue next process
     if (exitSuccess) {
         // update uab backend
-        commitCurrentChangeToBackend();
-
-        // continue next process, if error occurred, terminate current install/uninstall.
-        if (nextProcess()) {
-            return;
+        commitChangeToBackend(index);
+        // pkexec keeps the authorization for a while, run the other tasks concurrently.
+        m_authorized = true;
+    } else if (!m_authorized && (kPkexecDismissed == exitCode || kPkexecNotAuthorized == exitCode)) {
+        // authorization failed or canceled, do not ask again for each task.
+        // other failures belong to the package, the next task runs serially and asks again.
+        for (ProcTask &task : m_procList) {
+            if (TaskPending == task.state) {
+                task.state = TaskSkipped;
+            }
         }
     }
 
-    m_procFlag = Error;
-    Q_EMIT processFinished(false);
+    finishTask(index, exitSuccess);
 }
 
 void UabProcessController::onDBusProgressChanged(int progress, const QString &message)
 {
-    updateWholeProgress(static_cast<float>(progress));
+    // the DBus progress carries no package id, it only maps to a task while a single task runs.
+    if (1 != runningCount()) {
+        Q_EMIT processOutput(message);
+        return;
+    }
+
+    auto findItr = std::find_if(
+        m_procList.begin(), m_procList.end(), [](const ProcTask &task) { return TaskRunning == task.state; });
+    if (findItr != m_procList.end()) {
+        updateTaskProgress(static_cast<int>(std::distance(m_procList.begin(), findItr)), static_cast<float>(progress));
+    }
     Q_EMIT processOutput(message);
 }
 
-bool UabProcessController::nextProcess()
+/**
+   @brief Start pending tasks until the concurrency limit reached.
+        A task starts after all earlier tasks of the same package id finished, if one of them
+        failed, the task is skipped (e.g. not install new version while remove old version failed).
+ */
+void UabProcessController::scheduleTasks()
 {
-    m_procFlag.setFlag(Installing, false);
-    m_procFlag.setFlag(Uninstalling, false);
+    const int limit = m_authorized ? m_maxConcurrency : 1;
+    QSet<QString> busyIds;    // an earlier task of the id is running or pending
+    QSet<QString> failedIds;  // an earlier task of the id failed
+
+    for (int index = 0; index < m_procList.size(); ++index) {
+        ProcTask &task = m_procList[index];
+        const QString id = task.package->info()->id;
+
+        switch (task.state) {
+            case TaskRunning:
+                busyIds.insert(id);
+                continue;
+            case TaskFailed:
+            case TaskSkipped:
+                failedIds.insert(id);
+                continue;
+            case TaskSucceeded:
+                continue;
+            case TaskPending:
+                break;
+        }
 
-    // check process finish
-    m_currentIndex++;
-    if (m_currentIndex >= m_procList.size()) {
-        m_procFlag = Finish;
-        Q_EMIT processFinished(true);
-        return true;
+        if (failedIds.contains(id)) {
+            task.state = TaskSkipped;
+            continue;
+        }
+        if (busyIds.contains(id)) {
+            continue;
+        }
+        busyIds.insert(id);
+
+        if (runningCount() >= limit) {
+            continue;
+        }
+
+        if (!startTask(index)) {
+            finishTask(index, false);
+            return;
+        }
     }
 
-    if (!checkIndexValid()) {
-        qWarning() << qPrintable("Invalid process index") << m_currentIndex;
+    if (0 == runningCount() && !m_procFlag.testFlag(Finish) && !m_procFlag.testFlag(Error)) {
+        const bool success = std::none_of(m_procList.cbegin(), m_procList.cend(), [](const ProcTask &task) {
+            return TaskFailed == task.state || TaskSkipped == task.state;
+        });
+
+        m_procFlag = success ? Finish : Error;
+        Uab::UabBackend::instance()->flushSnapshot();
+        Q_EMIT processFinished(success);
+    }
+}
+
+bool UabProcessController::startTask(int index)
+{
+    if (!checkIndexValid(index)) {
+        qWarning() << qPrintable("Invalid process index") << index;
         return false;
     }
 
-    const auto &currentProc = m_procList.at(m_currentIndex);
-    switch (currentProc.first) {
+    ProcTask &task = m_procList[index];
+    auto process = new Konsole::Pty(this);
+    connect(process, &Konsole::Pty::receivedData, this, [this, index](const char *buffer, int length, bool) {
+        onReadOutput(index, buffer, length);
+    });
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, index](int exitCode) {
+        onFinished(index, exitCode);
+    });
+
+    task.process = process;
+    task.state = TaskRunning;
+    task.framer.reset();
+
+    bool started = false;
+    switch (task.type) {
         case Installing:
-            return (BackendCli == m_type) ? installBackendCliImpl(currentProc.second) : installCliImpl(currentProc.second);
+            m_procFlag.setFlag(Installing);
+            started = (BackendCli == m_type) ? installBackendCliImpl(process, task.package) : installCliImpl(process, task.package);
+            break;
         case Uninstalling:
-            return (BackendCli == m_type) ? uninstallBackendCliImpl(currentProc.second) : uninstallCliImpl(currentProc.second);
+            m_procFlag.setFlag(Uninstalling);
+            started =
+                (BackendCli == m_type) ? uninstallBackendCliImpl(process, task.package) : uninstallCliImpl(process, task.package);
+            break;
         default:
+            qWarning() << qPrintable("Invalid process type") << task.type;
             break;
     }
 
-    qWarning() << qPrintable("Invalid process type") << currentProc.first;
-    return false;
+    if (!started) {
+        task.state = TaskPending;
+        task.process = nullptr;
+        process->deleteLater();
+        return false;
+    }
+
+    Q_EMIT taskStarted(task.package);
+    return true;
 }
 
-bool UabProcessController::installBackendCliImpl(const UabPackage::Ptr &installPtr)
+void UabProcessController::finishTask(int index, bool success)
+{
+    if (!checkIndexValid(index)) {
+        return;
+    }
+
+    ProcTask &task = m_procList[index];
+    if (TaskRunning != task.state && TaskPending != task.state) {
+        return;
+    }
+
+    task.state = success ? TaskSucceeded : TaskFailed;
+    task.progress = success ? 100 : task.progress;
+
+    // the old version removed for the row failed without a message, name it instead of the generic failure.
+    if (!success && task.rowPackage && task.rowPackage != task.package && task.rowPackage->processError().isEmpty() &&
+        task.package && task.package->isValid()) {
+        task.rowPackage->setProcessError(
+            Pkg::UnknownError,
+            QString("Uninstall %1/%2 failed").arg(task.package->info()->id).arg(task.package->info()->version));
+    }
+    if (task.process) {
+        task.process->deleteLater();
+        task.process = nullptr;
+    }
+
+    // keep flags of the running tasks
+    m_procFlag.setFlag(Installing, false);
+    m_procFlag.setFlag(Uninstalling, false);
+    for (const ProcTask &other : m_procList) {
+        if (TaskRunning == other.state) {
+            m_procFlag.setFlag(other.type);
+        }
+    }
+
+    Q_EMIT taskFinished(task.package, success);
+    updateWholeProgress();
+
+    scheduleTasks();
+}
+
+int UabProcessController::runningCount() const
+{
+    return static_cast<int>(std::count_if(
+        m_procList.cbegin(), m_procList.cend(), [](const ProcTask &task) { return TaskRunning == task.state; }));
+}
+
+bool UabProcessController::installBackendCliImpl(Konsole::Pty *process, const UabPackage::Ptr &installPtr)
 {
     if (!installPtr || !installPtr->isValid() || installPtr->info()->filePath.isEmpty()) {
         return false;
     }
 
-    m_procFlag.setFlag(Installing);
-
     // e.g.: pkexec deepin-deb-installer-dependsInstall --uab --install [file to package].uab
-    m_process->start(
+    process->start(
         kPkexecBin, {kPkexecBin, kInstallProcessorBin, kParamUab, kParamInstall, installPtr->info()->filePath}, {}, 0, false);
 
     const QString recordCommand = QString("command: %1 %2 %3 %4/%5[uab package]")
@@ -323,17 +450,15 @@ bool UabProcessController::installBackendCliImpl(const UabPackage::Ptr &installP
     return true;
 }
 
-bool UabProcessController::uninstallBackendCliImpl(const UabPackage::Ptr &uninstallPtr)
+bool UabProcessController::uninstallBackendCliImpl(Konsole::Pty *process, const UabPackage::Ptr &uninstallPtr)
 {
     if (!uninstallPtr || !uninstallPtr->isValid()) {
         return false;
     }
 
-    m_procFlag.setFlag(Uninstalling);
-
     // e.g.: pkexec deepin-deb-installer-dependsInstall --uab --remove [id/version]
     const QString mergeInfo = QString("%1/%2").arg(uninstallPtr->info()->id).arg(uninstallPtr->info()->version);
-    m_process->start(kPkexecBin, {kPkexecBin, kInstallProcessorBin, kParamUab, kParamRemove, mergeInfo}, {}, 0, false);
+    process->start(kPkexecBin, {kPkexecBin, kInstallProcessorBin, kParamUab, kParamRemove, mergeInfo}, {}, 0, false);
 
     const QString recordCommand =
         QString("command: %1 %2 %3 %4").arg(kInstallProcessorBin).arg(kParamUab).arg(kParamRemove).arg(mergeInfo);
@@ -343,16 +468,14 @@ bool UabProcessController::uninstallBackendCliImpl(const UabPackage::Ptr &uninst
     return true;
 }
 
-bool Uab::UabProcessController::installCliImpl(const Uab::UabPackage::Ptr &installPtr)
+bool Uab::UabProcessController::installCliImpl(Konsole::Pty *process, const Uab::UabPackage::Ptr &installPtr)
 {
     if (!installPtr || !installPtr->isValid() || installPtr->info()->filePath.isEmpty()) {
         return false;
     }
 
-    m_procFlag.setFlag(Installing);
-
     // e.g.: ll-cli --json install ./path/to/file/uab_package.uab
-    m_process->start(kLinglongBin, {kLinglongBin, kLinglongJson, kLinglongInstall, installPtr->info()->filePath}, {}, 0, false);
+    process->start(kLinglongBin, {kLinglongBin, kLinglongJson, kLinglongInstall, installPtr->info()->filePath}, {}, 0, false);
 
     const QString recordCommand = QString("command: %1 %2 %3 %4/%5[uab package]")
                                       .arg(kLinglongBin)
@@ -366,16 +489,14 @@ bool Uab::UabProcessController::installCliImpl(const Uab::UabPackage::Ptr &insta
     return true;
 }
 
-bool Uab::UabProcessController::uninstallCliImpl(const Uab::UabPackage::Ptr &uninstallPtr)
+bool Uab::UabProcessController::uninstallCliImpl(Konsole::Pty *process, const Uab::UabPackage::Ptr &uninstallPtr)
 {
     if (!uninstallPtr || !uninstallPtr->isValid()) {
         return false;
     }
 
-    m_procFlag.setFlag(Uninstalling);
-
     // e.g.: ll-cli --json uninstall org.deepin.package/1.0.0
-    m_process->start(kLinglongBin,
+    process->start(kLinglongBin,
                      {kLinglongBin,
                       kLinglongJson,
                       kLinglongUninstall,
@@ -396,34 +517,24 @@ bool Uab::UabProcessController::uninstallCliImpl(const Uab::UabPackage::Ptr &uni
     return true;
 }
 
-bool UabProcessController::checkIndexValid()
-{
-    return 0 <= m_currentIndex && m_currentIndex < m_procList.size();
-}
-
-UabPackage::Ptr UabProcessController::currentPackagePtr()
+bool UabProcessController::checkIndexValid(int index) const
 {
-    if (!checkIndexValid()) {
-        return {};
-    }
-
-    return m_procList[m_currentIndex].second;
+    return 0 <= index && index < m_procList.size();
 }
 
-void UabProcessController::commitCurrentChangeToBackend()
+void UabProcessController::commitChangeToBackend(int index)
 {
-    if (!checkIndexValid()) {
+    if (!checkIndexValid(index)) {
         return;
     }
 
-    const auto &currentProc = m_procList.at(m_currentIndex);
-    UabPkgInfo::Ptr infoPtr;
-    if (!currentProc.second || !currentProc.second->isValid()) {
+    const ProcTask &task = m_procList.at(index);
+    if (!task.package || !task.package->isValid()) {
         return;
     }
-    infoPtr = currentProc.second->info();
+    UabPkgInfo::Ptr infoPtr = task.package->info();
 
-    switch (currentProc.first) {
+    switch (task.type) {
         case Installing:
             Uab::UabBackend::instance()->packageInstalled(infoPtr);
             break;
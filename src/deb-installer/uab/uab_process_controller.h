@@ -8,6 +8,7 @@
 #include <QObject>
 
 #include "uab_package.h"
+#include "uab_output_framer.h"
 
 namespace Konsole {
 class Pty;
@@ -44,44 +45,79 @@ public:
     [[nodiscard]] ProcFlags procFlag() const;
     [[nodiscard]] bool isRunning() const;
 
+    // Tasks of the same package id run in mark order, tasks of different ids run
+    // side by side, at most maxConcurrency() processes at the same time.
+    void setMaxConcurrency(int count);
+    [[nodiscard]] int maxConcurrency() const;
+
     bool reset();
     bool markInstall(const UabPackage::Ptr &installPtr);
-    bool markUninstall(const UabPackage::Ptr &unisntallPtr);
+    // \a rowPtr is the package shown to the user, e.g. the new version when the old one is removed for upgrade.
+    bool markUninstall(const UabPackage::Ptr &unisntallPtr, const UabPackage::Ptr &rowPtr = {});
     [[nodiscard]] bool commitChanges();
 
     Q_SIGNAL void processStart();
+    // all tasks finished, success is false if any task failed.
     Q_SIGNAL void processFinished(bool success);
     Q_SIGNAL void processOutput(const QString &output);
+    // whole progress of all tasks, weighted by package size.
     Q_SIGNAL void progressChanged(float progress);
 
+    Q_SIGNAL void taskStarted(const Uab::UabPackage::Ptr &package);
+    Q_SIGNAL void taskProgressChanged(const Uab::UabPackage::Ptr &package, float progress);
+    // tasks after a failed task of the same package id are skipped, without signal.
+    Q_SIGNAL void taskFinished(const Uab::UabPackage::Ptr &package, bool success);
+
 private:
-    [[nodiscard]] bool ensureProcess();
-    void parseProgressFromJson(const QByteArray &jsonData);
-    void parseProgressFromRawOutput(const QByteArray &output);
-    void updateWholeProgress(float currentTaskProgress);
-    Q_SLOT void onReadOutput(const char *buffer, int length, bool isCommandExec);
-    Q_SLOT void onFinished(int exitCode, int exitStatus);
+    enum TaskState {
+        TaskPending,
+        TaskRunning,
+        TaskSucceeded,
+        TaskFailed,
+        TaskSkipped,
+    };
+
+    struct ProcTask
+    {
+        ProcFlag type{Installing};
+        UabPackage::Ptr package;
+        UabPackage::Ptr rowPackage;  // receives the process error, same as package if not set
+        TaskState state{TaskPending};
+        float progress{0};
+        qint64 weight{1};
+        Konsole::Pty *process{nullptr};
+        UabOutputFramer framer;
+    };
+
+    void onOutputRecord(int index, const UabOutputFramer::Record &record);
+    void updateTaskProgress(int index, float progress);
+    void updateWholeProgress();
+    void onReadOutput(int index, const char *buffer, int length);
+    void onFinished(int index, int exitCode);
     Q_SLOT void onDBusProgressChanged(int progress, const QString &message);
 
-    bool nextProcess();
+    void scheduleTasks();
+    bool startTask(int index);
+    void finishTask(int index, bool success);
+    [[nodiscard]] int runningCount() const;
 
-    bool installBackendCliImpl(const UabPackage::Ptr &installPtr);
-    bool uninstallBackendCliImpl(const UabPackage::Ptr &uninstallPtr);
-    bool installCliImpl(const UabPackage::Ptr &installPtr);
-    bool uninstallCliImpl(const UabPackage::Ptr &uninstallPtr);
+    bool installBackendCliImpl(Konsole::Pty *process, const UabPackage::Ptr &installPtr);
+    bool uninstallBackendCliImpl(Konsole::Pty *process, const UabPackage::Ptr &uninstallPtr);
+    bool installCliImpl(Konsole::Pty *process, const UabPackage::Ptr &installPtr);
+    bool uninstallCliImpl(Konsole::Pty *process, const UabPackage::Ptr &uninstallPtr);
 
-    [[nodiscard]] bool checkIndexValid();
-    [[nodiscard]] UabPackage::Ptr currentPackagePtr();
+    [[nodiscard]] bool checkIndexValid(int index) const;
 
-    void commitCurrentChangeToBackend();
+    void commitChangeToBackend(int index);
 
 private:
-    Konsole::Pty *m_process{nullptr};
     ProcessType m_type{Unknown};
+    int m_maxConcurrency{1};
+    // pkexec asks authorization once, start other tasks after the first task authorized.
+    bool m_authorized{false};
 
     ProcFlags m_procFlag{Prepare};
-    int m_currentIndex{-1};
-    QList<QPair<ProcFlag, UabPackage::Ptr>> m_procList;  // install/uninstall package list
+    QList<ProcTask> m_procList;  // install/uninstall task list
 
     Q_DISABLE_COPY(UabProcessController)
 };
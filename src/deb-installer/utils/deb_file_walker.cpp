@@ -0,0 +1,170 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "deb_file_walker.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct WalkState
+{
+    QThreadPool pool;
+    DebFileWalker::FoundCallback onFound;
+
+    std::mutex mutex;
+    QVector<QStringList> results;
+    QSet<QPair<quint64, quint64>> visitedDirs;  // (st_dev, st_ino), avoid symlink loops
+};
+
+void walkDir(WalkState *state, int rootIndex, const QString &dirPath)
+{
+    const int fd = ::open(QFile::encodeName(dirPath).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        qWarning() << "[DebFileWalker]" << "open dir failed:" << dirPath << ::strerror(errno);
+        return;
+    }
+
+    struct stat dirStat;
+    if (0 == ::fstat(fd, &dirStat)) {
+        std::lock_guard<std::mutex> guard(state->mutex);
+        const QPair<quint64, quint64> dirId(static_cast<quint64>(dirStat.st_dev), static_cast<quint64>(dirStat.st_ino));
+        if (state->visitedDirs.contains(dirId)) {
+            ::close(fd);
+            return;
+        }
+        state->visitedDirs.insert(dirId);
+    }
+
+    QStringList debs;
+    QStringList subDirs;
+    alignas(struct dirent64) char buffer[32 * 1024];
+    for (;;) {
+        const long bytes = ::syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+        if (bytes <= 0) {
+            if (bytes < 0) {
+                qWarning() << "[DebFileWalker]" << "read dir failed:" << dirPath << ::strerror(errno);
+            }
+            break;
+        }
+
+        for (long offset = 0; offset < bytes;) {
+            const auto *entry = reinterpret_cast<const struct dirent64 *>(buffer + offset);
+            offset += entry->d_reclen;
+
+            const char *name = entry->d_name;
+            if ('.' == name[0]) {  // hidden entries, "." and ".."
+                continue;
+            }
+
+            const size_t nameLength = ::strlen(name);
+            const bool debSuffix = nameLength > 4 && 0 == ::memcmp(name + nameLength - 4, ".deb", 4);
+
+            unsigned char type = entry->d_type;
+            if (DT_DIR != type && DT_REG != type) {
+                // symlink or unknown file system type, follow it to tell directories.
+                struct stat entryStat;
+                if (0 != ::fstatat(fd, name, &entryStat, 0)) {
+                    continue;
+                }
+                type = S_ISDIR(entryStat.st_mode) ? DT_DIR : DT_REG;
+            }
+
+            if (DT_DIR == type) {
+                subDirs.append(dirPath + QDir::separator() + QFile::decodeName(name));
+            } else if (debSuffix) {
+                debs.append(dirPath + QDir::separator() + QFile::decodeName(name));
+            }
+        }
+    }
+    ::close(fd);
+
+    for (const QString &subDir : subDirs) {
+        QtConcurrent::run(&state->pool, [state, rootIndex, subDir]() { walkDir(state, rootIndex, subDir); });
+    }
+
+    if (debs.isEmpty()) {
+        return;
+    }
+
+    if (state->onFound) {
+        for (const QString &deb : debs) {
+            state->onFound(deb);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(state->mutex);
+    state->results[rootIndex].append(debs);
+}
+
+// same order as a recursive QDir walk sorted by QDir::Name | QDir::IgnoreCase
+void sortByPath(QStringList *paths)
+{
+    QVector<QPair<QStringList, QString>> keys;
+    keys.reserve(paths->size());
+    for (const QString &path : *paths) {
+        keys.append({path.split(QDir::separator()), path});
+    }
+
+    std::sort(keys.begin(), keys.end(), [](const QPair<QStringList, QString> &lhs, const QPair<QStringList, QString> &rhs) {
+        const int count = std::min(lhs.first.size(), rhs.first.size());
+        for (int i = 0; i < count; ++i) {
+            const int result = QString::compare(lhs.first[i], rhs.first[i], Qt::CaseInsensitive);
+            if (0 != result) {
+                return result < 0;
+            }
+        }
+        return lhs.first.size() < rhs.first.size();
+    });
+
+    paths->clear();
+    for (const auto &key : keys) {
+        paths->append(key.second);
+    }
+}
+
+}  // namespace
+
+DebFileWalker::DebFileWalker(FoundCallback onFound)
+    : m_onFound(std::move(onFound))
+{
+}
+
+QList<QStringList> DebFileWalker::walk(const QStringList &roots) const
+{
+    WalkState state;
+    state.pool.setMaxThreadCount(kMaxWalkThreads);
+    state.onFound = m_onFound;
+    state.results.resize(roots.size());
+
+    for (int i = 0; i != roots.size(); ++i) {
+        const QString root = QDir::cleanPath(roots[i]);
+        QtConcurrent::run(&state.pool, [&state, i, root]() { walkDir(&state, i, root); });
+    }
+
+    // tasks are only queued by running tasks, the pool is done when the walk is done.
+    state.pool.waitForDone();
+
+    QList<QStringList> results;
+    for (QStringList &debs : state.results) {
+        sortByPath(&debs);
+        results.append(debs);
+    }
+    return results;
+}
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEB_FILE_WALKER_H
+#define DEB_FILE_WALKER_H
+
+#include <QStringList>
+
+#include <functional>
+
+/**
+   @brief Recursive search of *.deb files, directories are read in parallel.
+
+    Directories are read with getdents64, names are filtered by the ".deb" suffix
+    before any stat, only entries without a usable d_type (symlinks, some file
+    systems) are stat'ed. Each sub directory is read by a task on a small thread
+    pool, found files are reported through the callback as soon as they are read,
+    e.g. to start parsing while the walk of a slow USB drive is still running.
+    Hidden entries are skipped, directory symlink loops are visited once.
+ */
+class DebFileWalker
+{
+public:
+    // Called from the walker threads
+    using FoundCallback = std::function<void(const QString &debPath)>;
+
+    explicit DebFileWalker(FoundCallback onFound = {});
+
+    // Walk each root and block until finished, the debs found under roots[i] are
+    // returned in result[i], ordered by path (case insensitive, per path component).
+    QList<QStringList> walk(const QStringList &roots) const;
+
+    static constexpr int kMaxWalkThreads = 4;
+
+private:
+    FoundCallback m_onFound;
+};
+
+#endif  // DEB_FILE_WALKER_H
@@ -48,6 +48,11 @@ QByteArray DebPackage::md5()
     return m_md5;
 }
 
+void DebPackage::setMd5(const QByteArray &md5)
+{
+    m_md5 = md5;
+}
+
 const QSharedPointer<QApt::DebFile> &DebPackage::debInfo() const
 {
     return m_debFilePtr;
@@ -173,6 +178,7 @@ const QSharedPointer<Compatible::CompPkgInfo> &DebPackage::compatible()
         }
 
         m_compInfoPtr->filePath = m_debFilePtr->filePath();
+        m_compInfoPtr->md5 = m_md5;
     }
 
     return m_compInfoPtr;
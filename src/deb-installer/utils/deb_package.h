@@ -33,6 +33,7 @@ public:
 
     [[nodiscard]] QString filePath() const;
     [[nodiscard]] QByteArray md5();
+    void setMd5(const QByteArray &md5);
     [[nodiscard]] const QSharedPointer<QApt::DebFile> &debInfo() const;
 
     void setOperationStatus(Pkg::PackageOperationStatus s);
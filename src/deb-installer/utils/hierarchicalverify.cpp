@@ -7,10 +7,12 @@
 
 #include <mutex>
 
-#include <QDBusInterface>
-#include <QDBusReply>
-#include <QDBusError>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDBusConnection>
+#include <QDBusMessage>
 #include <QDebug>
+#include <QThread>
 
 // 分级管控DBus接口信息
 const char DBUS_HIERARCHICAL_BUS[] = "com.deepin.daemon.ACL";
@@ -26,6 +28,9 @@ const char DBUS_DEFENDER_METHOD[] = "ShowPage";
 const char DBUS_DEFENDER_SECURITYTOOLS[] = "securitytools";
 const char DBUS_DEFENDER_APP_SAFETY[] = "application-safety";
 
+// 验签失败结果的有效时间，超时后重新以安装结果为准
+const qint64 VERIFY_RESULT_EXPIRE_MS = 24 * 60 * 60 * 1000;
+
 // 匹配正则,%1为错误码
 const char VERIFY_ERROR_REGEXP[] = "(deepin)+[^\\n]*(hook)+[^\\n]*(%1|%2)\\b";
 
@@ -44,6 +49,8 @@ enum HierarchicalError {
     1. 当分级管控接口不可用时，使用安装器校验，@sa `Utils::Digital_Verify`
     2. 当分级管控控件可用时，采用dpkg hook方式调用验签工具，错误码信息通过命令行输出，
        安装器接收输出信息并判断是否为验签错误。
+    DBus接口均采用异步调用，查询结果通过 `validChanged` 通知。首次查询未返回时( `isProbing` )，
+    安装流程在 `interfaceProbed` 后再开始，不阻塞等待DBus返回，避免查询未返回时误用安装器校验。
  */
 
 HierarchicalVerify::HierarchicalVerify() {}
@@ -56,11 +63,32 @@ HierarchicalVerify::~HierarchicalVerify() {}
 HierarchicalVerify *HierarchicalVerify::instance()
 {
     static HierarchicalVerify ins;
+    static std::once_flag threadFlag;
+    std::call_once(threadFlag, []() {
+        // DBus 异步回调投递到对象所在线程，确保在主线程事件循环中处理
+        if (qApp && QThread::currentThread() != qApp->thread()) {
+            ins.moveToThread(qApp->thread());
+        }
+    });
     return &ins;
 }
 
 /**
-   @return 返回当前分级管控签名验证是否可用，此信息通过查询DBus接口属性值取得。
+   @brief 异步查询分级管控接口状态，已有查询未返回时不重复发起。
+    在程序启动时调用，后续 `isValid` 直接使用查询结果。
+ */
+void HierarchicalVerify::initInterface()
+{
+    if (interfaceInvalid) {
+        return;
+    }
+
+    (void)checkValidImpl();
+}
+
+/**
+   @return 返回当前分级管控签名验证是否可用，此信息通过异步查询DBus接口取得，
+    查询未返回前按不可用处理，返回后通过 `validChanged` 通知。
  */
 bool HierarchicalVerify::isValid()
 {
@@ -69,22 +97,49 @@ bool HierarchicalVerify::isValid()
     }
 
     static std::once_flag checkFlag;
-    std::call_once(checkFlag, [this]() { checkValidImpl(); });
+    std::call_once(checkFlag, [this]() { initInterface(); });
 
     return valid;
 }
 
+/**
+   @return 返回是否正在等待分级管控接口的查询结果，结果返回后发送 `interfaceProbed` 信号
+ */
+bool HierarchicalVerify::isProbing()
+{
+    (void)isValid();
+    return probing;
+}
+
+/**
+   @return 返回错误信息 \a errorString 中是否包含分级管控验签不通过的错误信息，不记录校验结果。
+ */
+bool HierarchicalVerify::isVerifyError(const QString &errorString)
+{
+    static REG_EXP s_ErrorReg(QString(VERIFY_ERROR_REGEXP).arg(VerifyError).arg(VerffyErrorVer2));
+    return errorString.contains(s_ErrorReg);
+}
+
 /**
    @brief 检测软件包 \a pkgName 安装失败时的错误信息 \a errorString 中是否包含验签不通过的错误信息。
+    验签失败的结果按 包名 \a pkgName 、版本 \a version 、文件md5 \a md5 记录，在有效时间内保留，
+    调用方需与 `pkgVerifyPassed` 传入相同的 包名/版本/md5 。
 
    @warning 通过正则表达式匹配输出，当前通过 hook 标志和错误码 65280 匹配，需注意命令行输出信息更新未正常匹配的情况
     * 1071 更新错误码为 256 ,进行兼容处理
  */
-bool HierarchicalVerify::checkTransactionError(const QString &pkgName, const QString &errorString)
+bool HierarchicalVerify::checkTransactionError(const QString &pkgName,
+                                               const QString &errorString,
+                                               const QString &version,
+                                               const QByteArray &md5)
 {
-    static REG_EXP s_ErrorReg(QString(VERIFY_ERROR_REGEXP).arg(VerifyError).arg(VerffyErrorVer2));
-    if (errorString.contains(s_ErrorReg)) {
-        invalidPackages.insert(pkgName);
+    if (isVerifyError(errorString)) {
+        const qint64 current = QDateTime::currentMSecsSinceEpoch();
+        for (auto itr = invalidPackages.begin(); itr != invalidPackages.end();) {
+            itr = itr.value() <= current ? invalidPackages.erase(itr) : std::next(itr);
+        }
+
+        invalidPackages.insert(verdictKey(pkgName, version, md5), current + VERIFY_RESULT_EXPIRE_MS);
         qWarning() << QString("[Hierarchical] Package %1 detected hierarchical error!").arg(pkgName);
         return true;
     }
@@ -93,12 +148,22 @@ bool HierarchicalVerify::checkTransactionError(const QString &pkgName, const QSt
 }
 
 /**
-   @return 返回软件包 \a pkgName 是否通过校验，这个信息从校验缓存中获取，
-    通过 `clearVerifyResult` 移除
+   @return 返回软件包 \a pkgName ( \a version , \a md5 ) 是否通过校验，这个信息从校验缓存中获取，
+    通过 `clearVerifyResult` 移除，过期的结果视为通过
  */
-bool HierarchicalVerify::pkgVerifyPassed(const QString &pkgName)
+bool HierarchicalVerify::pkgVerifyPassed(const QString &pkgName, const QString &version, const QByteArray &md5)
 {
-    return !invalidPackages.contains(pkgName);
+    auto itr = invalidPackages.find(verdictKey(pkgName, version, md5));
+    if (itr == invalidPackages.end()) {
+        return true;
+    }
+
+    if (itr.value() <= QDateTime::currentMSecsSinceEpoch()) {
+        invalidPackages.erase(itr);
+        return true;
+    }
+
+    return false;
 }
 
 /**
@@ -110,77 +175,57 @@ void HierarchicalVerify::clearVerifyResult()
 }
 
 /**
-   @brief 请求弹出分级管控安全等级设置引导提示窗口，调用DBus接口，调出"安全中心-安全工具-应用安全"界面
+   @brief 请求弹出分级管控安全等级设置引导提示窗口，异步调用DBus接口，调出"安全中心-安全工具-应用安全"界面
  */
 void HierarchicalVerify::proceedDefenderSafetyPage()
 {
-    QDBusInterface interface(DBUS_DEFENDER_BUS, DBUS_DEFENDER_PATH, DBUS_DEFENDER_INTERFACE, QDBusConnection::sessionBus());
-    QDBusError error = interface.lastError();
+    // 用户可能调整安全等级，之前的验签结果不再可靠
+    clearVerifyResult();
 
-    if (interface.isValid()) {
-        QDBusMessage message = interface.call(DBUS_DEFENDER_METHOD, DBUS_DEFENDER_SECURITYTOOLS, DBUS_DEFENDER_APP_SAFETY);
-        QDBusError error = interface.lastError();
-    }
+    QDBusMessage message =
+        QDBusMessage::createMethodCall(DBUS_DEFENDER_BUS, DBUS_DEFENDER_PATH, DBUS_DEFENDER_INTERFACE, DBUS_DEFENDER_METHOD);
+    message << QString(DBUS_DEFENDER_SECURITYTOOLS) << QString(DBUS_DEFENDER_APP_SAFETY);
 
-    if (QDBusError::NoError != error.type()) {
-        qWarning() << QString("[Hierarchical] Show defender app-safety page error [%2] %3")
-                          .arg(DBUS_DEFENDER_BUS)
-                          .arg(error.name())
-                          .arg(error.message());
+    if (!QDBusConnection::sessionBus().callWithCallback(
+            message, this, SLOT(onDefenderPageShown()), SLOT(onDefenderPageError(QDBusError)))) {
+        onDefenderPageError(QDBusConnection::sessionBus().lastError());
     }
 }
 
 /**
-   @brief 检测当前系统环境下是否包含分级管控接口，并取值判断接口是否可用。
+   @brief 异步查询分级管控接口是否可用，结果在 `onInterfaceReply` / `onInterfaceError` 中处理。
+   @return 返回当前已知的接口状态
  */
 bool HierarchicalVerify::checkHierarchicalInterface()
 {
-    bool availabled = false;
-    QDBusInterface interface(
-        DBUS_HIERARCHICAL_BUS, DBUS_HIERARCHICAL_PATH, DBUS_HIERARCHICAL_INTERFACE, QDBusConnection::systemBus());
-
-    if (interface.isValid()) {
-        QDBusMessage message = interface.call(DBUS_HIERARCHICAL_METHOD);
-        QDBusError error = interface.lastError();
-        if (QDBusError::NoError != error.type()) {
-            // The log not need warning level.
-            qInfo() << QString("[Hierarchical] DBus %1 read property %2 error: type(%2) [%3] %4")
-                           .arg(DBUS_HIERARCHICAL_BUS)
-                           .arg(DBUS_HIERARCHICAL_METHOD)
-                           .arg(error.type())
-                           .arg(error.name())
-                           .arg(error.message());
-
-            // QDBusInterface 在构造时不一定能判断接口是否有效，调用后二次判断
-            if (!interface.isValid() || QDBusError::UnknownInterface == error.type() ||
-                QDBusError::InvalidInterface == error.type()) {
-                interfaceInvalid = true;
-                qInfo() << QString("[Hierarchical] Interface %1 is not valid! Disable check hierarchical control interface.")
-                               .arg(DBUS_HIERARCHICAL_INTERFACE);
-            }
-        } else {
-            QDBusReply<bool> reply(message);
-            availabled = reply.value();
-
-            qInfo() << QString("[Hierarchical] Get %1 property %2 value: %3")
-                           .arg(DBUS_HIERARCHICAL_BUS)
-                           .arg(DBUS_HIERARCHICAL_METHOD)
-                           .arg(availabled);
-        }
-    } else {
+    if (interfaceInvalid || probing) {
+        return valid;
+    }
+
+    QDBusMessage message = QDBusMessage::createMethodCall(
+        DBUS_HIERARCHICAL_BUS, DBUS_HIERARCHICAL_PATH, DBUS_HIERARCHICAL_INTERFACE, DBUS_HIERARCHICAL_METHOD);
+    probing = QDBusConnection::systemBus().callWithCallback(
+        message, this, SLOT(onInterfaceReply(bool)), SLOT(onInterfaceError(QDBusError)));
+    if (!probing) {
         interfaceInvalid = true;
         qInfo() << QString("[Hierarchical] DBus interface %1 invalid! error: [%2] %3")
                        .arg(DBUS_HIERARCHICAL_INTERFACE)
-                       .arg(interface.lastError().name())
-                       .arg(interface.lastError().message());
+                       .arg(QDBusConnection::systemBus().lastError().name())
+                       .arg(QDBusConnection::systemBus().lastError().message());
     }
 
-    return availabled;
+    return valid;
 }
 
 bool HierarchicalVerify::checkValidImpl()
 {
     const bool availabled = checkHierarchicalInterface();
+    updateValid(availabled);
+    return availabled;
+}
+
+void HierarchicalVerify::updateValid(bool availabled)
+{
     if (valid != availabled) {
         valid = availabled;
 
@@ -191,6 +236,64 @@ bool HierarchicalVerify::checkValidImpl()
 
         Q_EMIT validChanged(valid);
     }
+}
 
-    return availabled;
+QString HierarchicalVerify::verdictKey(const QString &pkgName, const QString &version, const QByteArray &md5)
+{
+    return pkgName + QLatin1Char('/') + version + QLatin1Char('/') + QString::fromLatin1(md5);
+}
+
+void HierarchicalVerify::onInterfaceReply(bool availabled)
+{
+    probing = false;
+    qInfo() << QString("[Hierarchical] Get %1 property %2 value: %3")
+                   .arg(DBUS_HIERARCHICAL_BUS)
+                   .arg(DBUS_HIERARCHICAL_METHOD)
+                   .arg(availabled);
+
+    updateValid(availabled);
+    Q_EMIT interfaceProbed();
+}
+
+void HierarchicalVerify::onInterfaceError(const QDBusError &error)
+{
+    probing = false;
+    // The log not need warning level.
+    qInfo() << QString("[Hierarchical] DBus %1 read property %2 error: type(%3) [%4] %5")
+                   .arg(DBUS_HIERARCHICAL_BUS)
+                   .arg(DBUS_HIERARCHICAL_METHOD)
+                   .arg(error.type())
+                   .arg(error.name())
+                   .arg(error.message());
+
+    // 服务或接口不存在时，不再查询分级管控接口
+    switch (error.type()) {
+        case QDBusError::ServiceUnknown:
+        case QDBusError::UnknownObject:
+        case QDBusError::UnknownInterface:
+        case QDBusError::UnknownMethod:
+        case QDBusError::InvalidInterface:
+            interfaceInvalid = true;
+            qInfo() << QString("[Hierarchical] Interface %1 is not valid! Disable check hierarchical control interface.")
+                           .arg(DBUS_HIERARCHICAL_INTERFACE);
+            break;
+        default:
+            break;
+    }
+
+    updateValid(false);
+    Q_EMIT interfaceProbed();
+}
+
+void HierarchicalVerify::onDefenderPageShown()
+{
+    qInfo() << QString("[Hierarchical] Show defender app-safety page");
+}
+
+void HierarchicalVerify::onDefenderPageError(const QDBusError &error)
+{
+    qWarning() << QString("[Hierarchical] Show defender app-safety page error [%1] %2 %3")
+                      .arg(DBUS_DEFENDER_BUS)
+                      .arg(error.name())
+                      .arg(error.message());
 }
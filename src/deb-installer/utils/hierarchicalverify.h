@@ -6,7 +6,9 @@
 #define HIERARCHICALVERIFY_H
 
 #include <QObject>
-#include <QSet>
+#include <QHash>
+#include <QByteArray>
+#include <QDBusError>
 
 class HierarchicalVerify : public QObject
 {
@@ -17,22 +19,39 @@ class HierarchicalVerify : public QObject
 public:
     static HierarchicalVerify *instance();
 
+    void initInterface();
     bool isValid();
-    bool checkTransactionError(const QString &pkgName, const QString &errorString);
-    bool pkgVerifyPassed(const QString &pkgName);
+    bool isProbing();
+
+    static bool isVerifyError(const QString &errorString);
+    bool checkTransactionError(const QString &pkgName,
+                               const QString &errorString,
+                               const QString &version,
+                               const QByteArray &md5);
+    bool pkgVerifyPassed(const QString &pkgName, const QString &version, const QByteArray &md5);
     void clearVerifyResult();
 
     Q_SLOT void proceedDefenderSafetyPage();
     Q_SIGNAL void validChanged(bool valid);
+    Q_SIGNAL void interfaceProbed();
 
 private:
     bool checkHierarchicalInterface();
     bool checkValidImpl();
+    void updateValid(bool availabled);
+
+    static QString verdictKey(const QString &pkgName, const QString &version, const QByteArray &md5);
+
+    Q_SLOT void onInterfaceReply(bool availabled);
+    Q_SLOT void onInterfaceError(const QDBusError &error);
+    Q_SLOT void onDefenderPageShown();
+    Q_SLOT void onDefenderPageError(const QDBusError &error);
 
 private:
     bool valid = false;             ///< 分级管控是否开启
     bool interfaceInvalid = false;  ///< DBus接口是否有效
-    QSet<QString> invalidPackages;  ///< 验签失败的包集合
+    bool probing = false;           ///< 是否正在异步查询分级管控接口
+    QHash<QString, qint64> invalidPackages;  ///< 验签失败的包及结果过期时间，按 包名/版本/md5 区分
 
     Q_DISABLE_COPY(HierarchicalVerify)
 };
@@ -0,0 +1,182 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "metrics.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTextStream>
+
+namespace Metrics {
+
+static const char kMetricsPrefix[] = "deepin_deb_installer_";
+static const char kTextFileEnv[] = "DEB_INSTALLER_METRICS_TEXTFILE";
+static const char kTextFileSettingKey[] = "metrics/textfile";
+
+struct MetricInfo
+{
+    const char *name;
+    const char *help;
+};
+
+// keep the order same as enum Counter / Histogram
+static const MetricInfo kCounterInfos[CounterCount]{
+    {"packages_appended_total", "Packages appended to the install list."},
+    {"packages_deduped_total", "Packages rejected because the same package was already appended."},
+    {"hashed_bytes_total", "Bytes of package files read to compute md5."},
+    {"cache_reloads_total", "Reloads of the apt backend cache."},
+    {"verifier_invocations_total", "Invocations of the package signature verifier."},
+    {"transactions_total", "Install transactions started."},
+};
+
+static const MetricInfo kHistogramInfos[HistogramCount]{
+    {"depends_resolve_seconds", "Time to resolve the depends status of a package."},
+    {"dpkg_lock_wait_seconds", "Time waiting for another dpkg process before installing."},
+    {"transaction_seconds", "Runtime of an install transaction."},
+    {"config_install_seconds", "Runtime of the debconf configure helper process."},
+    {"analyze_deb_seconds", "Time to analyze a package in PackageAnalyzer."},
+    {"install_queue_seconds", "Time to compute the install queue in PackageAnalyzer."},
+};
+
+Registry *Registry::instance()
+{
+    static Registry ins;
+    return &ins;
+}
+
+void Registry::add(Counter counter, quint64 value)
+{
+    m_counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+quint64 Registry::value(Counter counter) const
+{
+    return m_counters[counter].load(std::memory_order_relaxed);
+}
+
+void Registry::observe(Histogram histogram, double seconds)
+{
+    if (histogram <= NoHistogram || histogram >= HistogramCount) {
+        return;
+    }
+
+    HistogramData &data = m_histograms[histogram];
+    for (size_t i = 0; i < kBucketBounds.size(); ++i) {
+        if (seconds <= kBucketBounds[i]) {
+            data.buckets[i].fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+    }
+    data.count.fetch_add(1, std::memory_order_relaxed);
+    data.sumUs.fetch_add(static_cast<quint64>(qMax(0.0, seconds) * 1e6), std::memory_order_relaxed);
+}
+
+quint64 Registry::observedCount(Histogram histogram) const
+{
+    if (histogram <= NoHistogram || histogram >= HistogramCount) {
+        return 0;
+    }
+    return m_histograms[histogram].count.load(std::memory_order_relaxed);
+}
+
+QString Registry::toPrometheusText() const
+{
+    QString text;
+    QTextStream stream(&text);
+
+    for (int i = 0; i < CounterCount; ++i) {
+        const QString name = QString(kMetricsPrefix) + kCounterInfos[i].name;
+        stream << "# HELP " << name << ' ' << kCounterInfos[i].help << '\n';
+        stream << "# TYPE " << name << " counter\n";
+        stream << name << ' ' << m_counters[i].load(std::memory_order_relaxed) << '\n';
+    }
+
+    for (int i = 0; i < HistogramCount; ++i) {
+        const QString name = QString(kMetricsPrefix) + kHistogramInfos[i].name;
+        const HistogramData &data = m_histograms[i];
+        stream << "# HELP " << name << ' ' << kHistogramInfos[i].help << '\n';
+        stream << "# TYPE " << name << " histogram\n";
+
+        // count is loaded first, the +Inf bucket never less than the finite buckets.
+        const quint64 count = data.count.load(std::memory_order_relaxed);
+        quint64 cumulative = 0;
+        for (size_t bucket = 0; bucket < kBucketBounds.size(); ++bucket) {
+            cumulative += data.buckets[bucket].load(std::memory_order_relaxed);
+            stream << name << "_bucket{le=\"" << kBucketBounds[bucket] << "\"} " << qMin(cumulative, count) << '\n';
+        }
+        stream << name << "_bucket{le=\"+Inf\"} " << count << '\n';
+        stream << name << "_sum " << data.sumUs.load(std::memory_order_relaxed) / 1e6 << '\n';
+        stream << name << "_count " << count << '\n';
+    }
+
+    stream.flush();
+    return text;
+}
+
+void Registry::initFromEnvironment()
+{
+    QString path = QString::fromLocal8Bit(qgetenv(kTextFileEnv));
+    if (path.isEmpty()) {
+        const QString confPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + QDir::separator() +
+                                 "deepin-deb-installer.conf";
+        path = QSettings(confPath, QSettings::IniFormat).value(kTextFileSettingKey).toString();
+    }
+
+    if (path.isEmpty()) {
+        return;
+    }
+
+    setTextFilePath(path);
+    qInfo() << "[Metrics]" << "metrics text file:" << path;
+
+    if (auto app = QCoreApplication::instance()) {
+        QObject::connect(app, &QCoreApplication::aboutToQuit, app, [this]() { flushTextFile(); });
+    }
+}
+
+void Registry::setTextFilePath(const QString &path)
+{
+    m_textFilePath = path;
+}
+
+bool Registry::flushTextFile() const
+{
+    if (m_textFilePath.isEmpty()) {
+        return false;
+    }
+    return writeTextFile(m_textFilePath);
+}
+
+bool Registry::writeTextFile(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "[Metrics]" << "failed to write metrics" << path << file.errorString();
+        return false;
+    }
+
+    file.write(toPrometheusText().toUtf8());
+    return file.commit();
+}
+
+void Registry::reset()
+{
+    for (auto &counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    for (auto &data : m_histograms) {
+        for (auto &bucket : data.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        data.count.store(0, std::memory_order_relaxed);
+        data.sumUs.store(0, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace Metrics
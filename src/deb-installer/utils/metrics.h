@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QString>
+
+#include <array>
+#include <atomic>
+
+namespace Metrics {
+
+enum Counter {
+    PackagesAppended,
+    PackagesDeduped,
+    HashedBytes,
+    CacheReloads,
+    VerifierInvocations,
+    Transactions,
+
+    CounterCount
+};
+
+// Latency histograms, observed in seconds
+enum Histogram {
+    NoHistogram = -1,
+    DependsResolveSeconds,
+    DpkgLockWaitSeconds,
+    TransactionSeconds,
+    ConfigInstallSeconds,
+    AnalyzeDebSeconds,
+    InstallQueueSeconds,
+
+    HistogramCount
+};
+
+/**
+   @brief Process wide counters and latency histograms of the installer.
+
+    Updates are lock free (relaxed atomics) and always on. The current values are
+    exported in Prometheus text format, through the DBus method `metrics()` and,
+    if DEB_INSTALLER_METRICS_TEXTFILE=<file> or "metrics/textfile=<file>" in
+    deepin-deb-installer.conf is set, as a file for the node_exporter textfile collector.
+ */
+class Registry
+{
+public:
+    static Registry *instance();
+
+    void add(Counter counter, quint64 value = 1);
+    [[nodiscard]] quint64 value(Counter counter) const;
+
+    void observe(Histogram histogram, double seconds);
+    [[nodiscard]] quint64 observedCount(Histogram histogram) const;
+
+    [[nodiscard]] QString toPrometheusText() const;
+
+    // read the env / settings, and write the text file on application quit.
+    void initFromEnvironment();
+    [[nodiscard]] QString textFilePath() const { return m_textFilePath; }
+    void setTextFilePath(const QString &path);
+    // write to the configured text file, no-op if not configured.
+    bool flushTextFile() const;
+    // atomic replace \a path, the collector never reads a partial file.
+    bool writeTextFile(const QString &path) const;
+
+    void reset();
+
+    static constexpr int kBucketCount = 12;
+    static constexpr std::array<double, kBucketCount> kBucketBounds{0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 30, 60, 300};
+
+private:
+    Registry() = default;
+
+    struct HistogramData
+    {
+        std::array<std::atomic<quint64>, kBucketCount> buckets{};  // not cumulative
+        std::atomic<quint64> count{0};
+        std::atomic<quint64> sumUs{0};
+    };
+
+    std::array<std::atomic<quint64>, CounterCount> m_counters{};
+    std::array<HistogramData, HistogramCount> m_histograms{};
+    QString m_textFilePath;
+
+    Q_DISABLE_COPY(Registry)
+};
+
+inline void add(Counter counter, quint64 value = 1)
+{
+    Registry::instance()->add(counter, value);
+}
+
+}  // namespace Metrics
+
+#endif  // METRICS_H
@@ -0,0 +1,284 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "trace.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <chrono>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Trace {
+
+const char kCatAppend[] = "append";
+const char kCatAnalyze[] = "analyze";
+const char kCatVerify[] = "verify";
+const char kCatInstall[] = "install";
+const char kCatProcess[] = "process";
+
+static const char kTraceEnv[] = "DEB_INSTALLER_TRACE";
+static const char kTraceSettingKey[] = "trace/enabled";
+
+struct TraceEvent
+{
+    const char *category{nullptr};
+    const char *name{nullptr};
+    qint64 beginUs{0};
+    qint64 durationUs{0};
+    QString detail;
+};
+
+struct ThreadBuffer
+{
+    std::mutex mutex;  // only contended while exporting
+    std::vector<TraceEvent> events;
+    size_t next{0};
+    qint64 tid{0};
+    QString threadName;
+};
+
+static qint64 steadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Tracer::Tracer()
+    : m_startNs(steadyNs())
+{
+}
+
+Tracer *Tracer::instance()
+{
+    static Tracer ins;
+    return &ins;
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::setOutputPath(const QString &path)
+{
+    m_outputPath = path;
+}
+
+void Tracer::initFromEnvironment()
+{
+    QString output = QString::fromLocal8Bit(qgetenv(kTraceEnv));
+    bool enabled = !output.isEmpty() && "0" != output;
+
+    if (!enabled) {
+        const QString confPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + QDir::separator() +
+                                 "deepin-deb-installer.conf";
+        enabled = QSettings(confPath, QSettings::IniFormat).value(kTraceSettingKey, false).toBool();
+        output.clear();
+    }
+
+    if (!enabled) {
+        return;
+    }
+
+    if (output.isEmpty() || "1" == output) {
+        const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QDir().mkpath(cacheDir);
+        output = QString("%1/trace-%2.json").arg(cacheDir).arg(QCoreApplication::applicationPid());
+    }
+
+    setOutputPath(output);
+    setEnabled(true);
+    qInfo() << "[Trace]" << "tracing enabled, output:" << output;
+
+    if (auto app = QCoreApplication::instance()) {
+        QObject::connect(app, &QCoreApplication::aboutToQuit, app, [this]() { writeChromeTrace(m_outputPath); });
+    }
+}
+
+qint64 Tracer::now() const
+{
+    return (steadyNs() - m_startNs) / 1000;
+}
+
+ThreadBuffer *Tracer::currentBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> localBuffer;
+    if (!localBuffer) {
+        localBuffer = std::make_shared<ThreadBuffer>();
+        localBuffer->tid = static_cast<qint64>(::syscall(SYS_gettid));
+
+        QThread *thread = QThread::currentThread();
+        if (thread && QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            localBuffer->threadName = "main";
+        } else if (thread) {
+            localBuffer->threadName = thread->objectName();
+            if (localBuffer->threadName.isEmpty()) {
+                localBuffer->threadName = thread->metaObject()->className();
+            }
+        }
+
+        // buffers are kept after thread exit, so events of finished threads are exported too.
+        std::lock_guard<std::mutex> guard(m_buffersMutex);
+        m_buffers.push_back(localBuffer);
+    }
+    return localBuffer.get();
+}
+
+void Tracer::record(const char *category, const char *name, qint64 beginUs, qint64 durationUs, const QString &detail)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    ThreadBuffer *buffer = currentBuffer();
+    std::lock_guard<std::mutex> guard(buffer->mutex);
+
+    TraceEvent event{category, name, beginUs, durationUs, detail};
+    if (buffer->events.size() < static_cast<size_t>(kThreadBufferSize)) {
+        buffer->events.push_back(std::move(event));
+    } else {
+        // ring buffer full, overwrite the oldest event
+        buffer->events[buffer->next] = std::move(event);
+    }
+    buffer->next = (buffer->next + 1) % kThreadBufferSize;
+}
+
+QByteArray Tracer::toChromeTrace() const
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray traceEvents;
+    std::lock_guard<std::mutex> guard(m_buffersMutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : m_buffers) {
+        std::lock_guard<std::mutex> bufferGuard(buffer->mutex);
+
+        traceEvents.append(QJsonObject{{"name", "thread_name"},
+                                       {"ph", "M"},
+                                       {"pid", pid},
+                                       {"tid", buffer->tid},
+                                       {"args", QJsonObject{{"name", buffer->threadName}}}});
+
+        for (const TraceEvent &event : buffer->events) {
+            QJsonObject object{{"name", event.name},
+                               {"cat", event.category},
+                               {"ph", "X"},
+                               {"ts", event.beginUs},
+                               {"dur", event.durationUs},
+                               {"pid", pid},
+                               {"tid", buffer->tid}};
+            if (!event.detail.isEmpty()) {
+                object.insert("args", QJsonObject{{"detail", event.detail}});
+            }
+            traceEvents.append(object);
+        }
+    }
+
+    return QJsonDocument(QJsonObject{{"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}}).toJson(QJsonDocument::Compact);
+}
+
+bool Tracer::writeChromeTrace(const QString &path) const
+{
+    if (path.isEmpty()) {
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[Trace]" << "failed to write trace" << path << file.errorString();
+        return false;
+    }
+
+    file.write(toChromeTrace());
+    return true;
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> guard(m_buffersMutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer : m_buffers) {
+        std::lock_guard<std::mutex> bufferGuard(buffer->mutex);
+        buffer->events.clear();
+        buffer->next = 0;
+    }
+}
+
+ScopedSpan::ScopedSpan(const char *category, const char *name, const QString &detail, Metrics::Histogram histogram)
+    : m_category(category)
+    , m_name(name)
+    , m_histogram(histogram)
+{
+    Tracer *tracer = Tracer::instance();
+    const bool traced = tracer->isEnabled();
+    if (traced) {
+        m_detail = detail;
+    }
+    if (traced || Metrics::NoHistogram != m_histogram) {
+        m_beginUs = tracer->now();
+    }
+}
+
+ScopedSpan::~ScopedSpan()
+{
+    if (m_beginUs < 0) {
+        return;
+    }
+
+    Tracer *tracer = Tracer::instance();
+    const qint64 durationUs = tracer->now() - m_beginUs;
+    tracer->record(m_category, m_name, m_beginUs, durationUs, m_detail);
+    Metrics::Registry::instance()->observe(m_histogram, durationUs / 1e6);
+}
+
+void ScopedSpan::setDetail(const QString &detail)
+{
+    if (Tracer::instance()->isEnabled()) {
+        m_detail = detail;
+    }
+}
+
+AsyncSpan::AsyncSpan(const char *category, const char *name, Metrics::Histogram histogram)
+    : m_category(category)
+    , m_name(name)
+    , m_histogram(histogram)
+{
+}
+
+void AsyncSpan::begin(const QString &detail)
+{
+    Tracer *tracer = Tracer::instance();
+    const bool traced = tracer->isEnabled();
+    if (!traced && Metrics::NoHistogram == m_histogram) {
+        return;
+    }
+
+    // restart, the previous span is dropped.
+    m_beginUs = tracer->now();
+    m_detail = traced ? detail : QString();
+}
+
+void AsyncSpan::end()
+{
+    if (m_beginUs < 0) {
+        return;
+    }
+
+    Tracer *tracer = Tracer::instance();
+    const qint64 durationUs = tracer->now() - m_beginUs;
+    tracer->record(m_category, m_name, m_beginUs, durationUs, m_detail);
+    Metrics::Registry::instance()->observe(m_histogram, durationUs / 1e6);
+    m_beginUs = -1;
+    m_detail.clear();
+}
+
+}  // namespace Trace
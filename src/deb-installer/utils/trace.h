@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "metrics.h"
+
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+
+// Span categories, shown as "cat" in the trace viewer
+extern const char kCatAppend[];
+extern const char kCatAnalyze[];
+extern const char kCatVerify[];
+extern const char kCatInstall[];
+extern const char kCatProcess[];
+
+struct ThreadBuffer;
+
+/**
+   @brief Lightweight phase tracer, exports Chrome trace-event JSON (chrome://tracing, Perfetto).
+
+    Disabled by default, a disabled span only costs one atomic load.
+    Enabled by env DEB_INSTALLER_TRACE=<output file> ("1" writes to the default
+    cache location), or by "trace/enabled=true" in deepin-deb-installer.conf.
+    Each thread records complete events into its own ring buffer, the oldest events
+    are overwritten when the buffer is full. The trace is written when the application quits.
+ */
+class Tracer
+{
+public:
+    static Tracer *instance();
+
+    [[nodiscard]] inline bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled);
+
+    // read the env / settings, and write the trace file on application quit.
+    void initFromEnvironment();
+
+    [[nodiscard]] QString outputPath() const { return m_outputPath; }
+    void setOutputPath(const QString &path);
+
+    // microseconds since the tracer created, monotonic
+    [[nodiscard]] qint64 now() const;
+    void record(const char *category, const char *name, qint64 beginUs, qint64 durationUs, const QString &detail = {});
+
+    [[nodiscard]] QByteArray toChromeTrace() const;
+    bool writeChromeTrace(const QString &path) const;
+    void clear();
+
+    static constexpr int kThreadBufferSize = 4096;
+
+private:
+    Tracer();
+    ThreadBuffer *currentBuffer();
+
+    std::atomic_bool m_enabled{false};
+    QString m_outputPath;
+    qint64 m_startNs{0};
+
+    mutable std::mutex m_buffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+
+    Q_DISABLE_COPY(Tracer)
+};
+
+/**
+   @brief Record the lifetime of the object as a span.
+    If \a histogram is set, the duration is also observed by the metrics registry,
+    whether tracing is enabled or not.
+ */
+class ScopedSpan
+{
+public:
+    ScopedSpan(const char *category,
+               const char *name,
+               const QString &detail = {},
+               Metrics::Histogram histogram = Metrics::NoHistogram);
+    ~ScopedSpan();
+
+    void setDetail(const QString &detail);
+
+private:
+    const char *m_category;
+    const char *m_name;
+    Metrics::Histogram m_histogram{Metrics::NoHistogram};
+    qint64 m_beginUs{-1};  // -1 means not timed, tracer disabled and no histogram
+    QString m_detail;
+
+    Q_DISABLE_COPY(ScopedSpan)
+};
+
+/**
+   @brief Span across event loop iterations, e.g. transaction or child process.
+ */
+class AsyncSpan
+{
+public:
+    AsyncSpan(const char *category, const char *name, Metrics::Histogram histogram = Metrics::NoHistogram);
+
+    void begin(const QString &detail = {});
+    void end();
+    [[nodiscard]] bool isActive() const { return m_beginUs >= 0; }
+
+private:
+    const char *m_category;
+    const char *m_name;
+    Metrics::Histogram m_histogram{Metrics::NoHistogram};
+    qint64 m_beginUs{-1};
+    QString m_detail;
+};
+
+}  // namespace Trace
+
+#endif  // TRACE_H
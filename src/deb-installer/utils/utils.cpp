@@ -4,6 +4,7 @@
 
 #include "utils.h"
 #include "qtcompat.h"
+#include "trace.h"
 
 #include <mutex>
 
@@ -151,6 +152,8 @@ bool Utils::Return_Digital_Verify(const QString &strfilepath, const QString &str
 
 Utils::VerifyResultCode Utils::Digital_Verify(const QString &filepath_name)
 {
+    Trace::ScopedSpan span(Trace::kCatVerify, "digital_verify", filepath_name);
+    Metrics::add(Metrics::VerifierInvocations);
     QString verifyfilepath = "/usr/bin/";
     QString verifyfilename = "deepin-deb-verify";
     bool result_verify_file = Return_Digital_Verify(verifyfilepath, verifyfilename);
@@ -393,6 +396,8 @@ QIcon Utils::packageIcon(Pkg::PackageType type)
  */
 bool Utils::checkPackageContainsDebConf(const QString &filePath)
 {
+    Trace::ScopedSpan span(Trace::kCatAnalyze, "check_debconf", filePath);
+
     // create template dir
     QTemporaryDir templateDir;
     if (!templateDir.isValid()) {
@@ -16,8 +16,10 @@
 #include "view/pages/ddimerrorpage.h"
 #include "singleInstallerApplication.h"
 #include "model/packageselectmodel.h"
+#include "model/ddim_index.h"
 #include "settingdialog.h"
 #include "utils/utils.h"
+#include "utils/deb_file_walker.h"
 
 #include <DInputDialog>
 #include <DRecentManager>
@@ -330,6 +332,26 @@ int DebInstaller::checkDigitalSignature(const QString &debPath)
     return -1;
 }
 
+int DebInstaller::precheckDigitalSignature(const QString &debPath)
+{
+    if (debPath.isEmpty())
+        return -1;
+
+    // only deb package support.
+    if (auto *proxyModel = qobject_cast<ProxyPackageListModel *>(m_fileListModel)) {
+        auto *model = qobject_cast<DebListModel *>(proxyModel->modelFromType(Pkg::Deb));
+        if (model) {
+            int result = -1;
+            if (model->digitalSignatureVerifyRequired(debPath, result)) {
+                return kDigitalVerifyRequired;
+            }
+            return result;
+        }
+    }
+
+    return -1;
+}
+
 QString DebInstaller::getPackageInfo(const QString &debPath)
 {
     if (debPath.isEmpty())
@@ -535,7 +557,7 @@ void DebInstaller::slotDdimSelected(const QStringList &ddimFiles)
         return;
     }
 
-    QList<DdimSt> ddimResults;
+    QList<QPair<QJsonObject, QString>> ddimV10List;  // 清单内容，所在目录
     bool jsonError = false;
     bool versionError = false;
     bool haveDeb = false;
@@ -571,37 +593,47 @@ void DebInstaller::slotDdimSelected(const QStringList &ddimFiles)
         // 2.根据版本号信息读取JSON文件内容
         // 后续版本号多了以后，需要建立跳转表以进行速度优化，版本号少的时候使用跳转表不划算
         QFileInfo info(ddimFile);
-        DdimSt ddimResult;
         auto dirPath = info.absoluteDir().path();
         if (version == "1.0") {
-            for (auto &st : ddimResults) {
-                if (st.version == "1.0" && st.dirPath == dirPath) {  // ddim文件去重
-                    continue;
-                }
+            auto sameDdim = std::find_if(ddimV10List.begin(), ddimV10List.end(), [&dirPath](const QPair<QJsonObject, QString> &ddim) {
+                return ddim.second == dirPath;
+            });
+            if (sameDdim != ddimV10List.end()) {  // ddim文件去重
+                continue;
             }
-            ddimResult = analyzeV10(jsonObj, info.absoluteDir().path());
+            ddimV10List.append({jsonObj, dirPath});
         } else {
             versionError = true;
             continue;  // 无法处理的版本号
         }
+    }
 
-        if (!ddimResult.isAvailable) {
-            continue;
-        }
+    // 3.遍历目录较慢（如U盘），在后台线程中建立列表，遍历的同时预解析找到的包
+    QtConcurrent::run([this, ddimV10List, jsonError, versionError, haveDeb]() {
+        QList<DdimSt> ddimResults;
+        for (const auto &ddim : ddimV10List) {
+            DdimSt ddimResult = analyzeV10(ddim.first, ddim.second);
+            if (!ddimResult.isAvailable) {
+                continue;
+            }
 
-        ddimResult.dirPath = dirPath;
-        ddimResult.version = version;
+            ddimResult.dirPath = ddim.second;
+            ddimResult.version = "1.0";
+            ddimResults.push_back(ddimResult);
+        }
 
-        // 3.建立列表
-        ddimResults.push_back(ddimResult);
-    }
+        // 4.转入包数据分析模块处理
+        if (!ddimResults.isEmpty()) {
+            m_ddimModel->appendDdimPackages(ddimResults);
+            return;
+        }
 
-    // 4.转入包数据分析模块处理
-    if (!ddimResults.isEmpty()) {
-        QtConcurrent::run([this, ddimResults]() { m_ddimModel->appendDdimPackages(ddimResults); });
-    } else {
+        PackageAnalyzer::instance().clearPrefetch();
         if (SingleInstallerApplication::mode == SingleInstallerApplication::DdimChannel && haveDeb) {  // 处于流程中的报错
-            slotShowDdimFloatingMessage(tr("Installing other packages... Please open it later."));
+            QMetaObject::invokeMethod(this,
+                                      "slotShowDdimFloatingMessage",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(QString, tr("Installing other packages... Please open it later.")));
         } else {  // 初次进入时的报错，未定义二次进入时的报错提示
             QString errorString;
             if (jsonError) {
@@ -613,23 +645,7 @@ void DebInstaller::slotDdimSelected(const QStringList &ddimFiles)
             }
             QMetaObject::invokeMethod(this, "slotShowDdimErrorMessage", Qt::QueuedConnection, Q_ARG(QString, errorString));
         }
-    }
-}
-
-// 获取文件夹下的文件
-void getAllDebFileInDir(const QDir &dir, QFileInfoList &result)
-{
-    QDir root(dir);
-    auto list = root.entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
-    for (auto &eachInfo : list) {
-        if (eachInfo.isDir()) {
-            getAllDebFileInDir(eachInfo.absoluteFilePath(), result);
-        } else {
-            if (eachInfo.absoluteFilePath().endsWith(".deb")) {  // 只抓deb包
-                result.push_back(eachInfo);
-            }
-        }
-    }
+    });
 }
 
 DdimSt DebInstaller::analyzeV10(const QJsonObject &ddimobj, const QString &ddimDir)
@@ -639,21 +655,32 @@ DdimSt DebInstaller::analyzeV10(const QJsonObject &ddimobj, const QString &ddimD
     DdimSt result;
 
     // 0.搜索三个主要路径
-    QDir selectDir(ddimDir + "/Softwares");
-    QDir dependDir(ddimDir + "/Depends");
-    QDir mustInstallDir(ddimDir + "/Updates");
-
-    // 1.抓取软件包路径
-    if (selectDir.exists()) {
-        getAllDebFileInDir(selectDir, result.selectList);
-    }
-
-    if (dependDir.exists()) {
-        getAllDebFileInDir(dependDir, result.dependList);
+    const QStringList searchDirs{ddimDir + "/Softwares", ddimDir + "/Depends", ddimDir + "/Updates"};
+    QList<QFileInfoList *> resultLists{&result.selectList, &result.dependList, &result.mustInstallList};
+    QStringList existDirs;
+    QList<QFileInfoList *> existResultLists;
+    for (int i = 0; i != searchDirs.size(); ++i) {
+        if (QDir(searchDirs[i]).exists()) {
+            existDirs.append(searchDirs[i]);
+            existResultLists.append(resultLists[i]);
+        }
     }
 
-    if (mustInstallDir.exists()) {
-        getAllDebFileInDir(mustInstallDir, result.mustInstallList);
+    // 1.抓取软件包路径，三个目录并发遍历，找到的包中索引未命中的立即开始预解析
+    result.index = QSharedPointer<DdimIndex>::create(ddimDir);
+    result.index->load();
+    const QSharedPointer<DdimIndex> index = result.index;
+    DebFileWalker walker([index](const QString &debPath) {
+        DebIr ir;
+        if (!index->lookup(debPath, &ir)) {
+            PackageAnalyzer::instance().prefetchDebFile(debPath);
+        }
+    });
+    const QList<QStringList> debPaths = walker.walk(existDirs);
+    for (int i = 0; i != debPaths.size(); ++i) {
+        for (const QString &debPath : debPaths[i]) {
+            existResultLists[i]->push_back(QFileInfo(debPath));
+        }
     }
 
     // 1.1.抓取可选包的应用名
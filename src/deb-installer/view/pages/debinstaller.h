@@ -46,6 +46,9 @@ public:
     DebInstaller(QWidget *parent = nullptr);
     virtual ~DebInstaller() Q_DECL_OVERRIDE;
 
+    // precheckDigitalSignature() 返回值，表示需要调用验签工具校验签名
+    static constexpr int kDigitalVerifyRequired = -2;
+
 signals:
     void runOldProcess(const QStringList &paths);
 
@@ -214,6 +217,12 @@ private slots:
      * 查找包的数字签名
      */
     int checkDigitalSignature(const QString &debPath);
+    /**
+     * @brief precheckDigitalSignature
+     * 数字签名校验前的检查，需要调用验签工具时返回 kDigitalVerifyRequired，
+     * 验签工具可在工作线程中调用，用于批量查询
+     */
+    int precheckDigitalSignature(const QString &debPath);
     /**
      * @brief getPackageInfo
      * 查找包信息,返回(包名，包的路径，包的版本，包可用的架构，包的短描述，包的长描述)
@@ -323,7 +332,7 @@ private:
     /**
      * @brief analyzeV10
      * @param ddimobj 清单文件内部的JSON内容
-     * 根据JSON进行解析操作，仅处理1.0版本
+     * 根据JSON进行解析操作，仅处理1.0版本；会遍历目录，在后台线程中调用
      */
     DdimSt analyzeV10(const QJsonObject &ddimobj, const QString &ddimDir);
 
@@ -160,7 +160,7 @@ QWidget *SettingDialog::createProceedDefenderSafetyLabel(QObject *obj)
 void SettingDialog::showEvent(QShowEvent *e)
 {
     // 刷新分级管控接口状态
-    (void)HierarchicalVerify::instance()->isValid();
+    HierarchicalVerify::instance()->initInterface();
     DSettingsDialog::showEvent(e);
 }
 
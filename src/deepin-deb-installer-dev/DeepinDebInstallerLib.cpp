@@ -43,6 +43,26 @@ bool DeepinDebInstallerLib::checkPkgDependsStatus(int index)
     return m_pPackageManager->checkPackageDependsStatus(index);
 }
 
+QFuture<DebPackageQueryResult> DeepinDebInstallerLib::addPackagesAsync(const QStringList &debFilePaths)
+{
+    return m_pPackageManager->appendPackagesAsync(debFilePaths);
+}
+
+QFuture<DebPackageQueryResult> DeepinDebInstallerLib::queryPackagesAsync(const QList<DebPackageHandle> &handles)
+{
+    return m_pPackageManager->queryPackagesAsync(handles);
+}
+
+DebPackageQueryResult DeepinDebInstallerLib::packageStatus(DebPackageHandle handle)
+{
+    return m_pPackageManager->packageStatus(handle);
+}
+
+bool DeepinDebInstallerLib::removePackageByHandle(DebPackageHandle handle)
+{
+    return m_pPackageManager->removePackageByHandle(handle);
+}
+
 void DeepinDebInstallerLib::install()
 {
     m_pPackageManager->install();
@@ -9,6 +9,38 @@
 
 #include <QtCore>
 #include <QObject>
+#include <QFuture>
+
+/**
+ * @brief DebPackageHandle 包的句柄，添加成功后分配，包移除前保持不变，0 为无效句柄
+ */
+typedef qint64 DebPackageHandle;
+
+/**
+ * @brief DebPackageQueryResult 异步接口返回的包信息及状态
+ *  状态值与同步接口及信号中的定义一致
+ */
+struct DebPackageQueryResult
+{
+    enum Result {
+        Success,         // 添加或查询成功
+        InvalidPackage,  // 包无效
+        AlreadyExists,   // 包已经添加过
+        SignatureError,  // 签名校验失败
+        InvalidHandle,   // 句柄无效
+    };
+
+    DebPackageHandle handle = 0;
+    int result = InvalidPackage;
+    QString path;
+    QString name;
+    QString version;
+    QString architecture;
+    int dependsStatus = 0;     // 依赖状态 @sa signal_dependStatusError
+    int installStatus = 0;     // 安装状态 @sa checkInstallStatus
+    int signatureStatus = -1;  // 签名状态 @sa signal_signtureError
+};
+Q_DECLARE_METATYPE(DebPackageQueryResult)
 
 class PackagesManager;
 class DEEPINDEBINSTALLERLIBSHARED_EXPORT DeepinDebInstallerLib : public QObject
@@ -65,6 +97,34 @@ public:
      */
     int checkInstallStatus(int index = 0);
 
+    /**
+     * @brief addPackagesAsync 批量添加deb包，解析、签名校验及状态查询在共享线程池中并发执行
+     * @param debFilePaths 包的路径
+     * @return 每个包对应一个结果，下标与输入顺序一致，可通过 resultReadyAt 逐个获取，结果中的句柄用于后续查询
+     *  通过此接口添加的包不分配下标，不发送添加相关的信号
+     */
+    QFuture<DebPackageQueryResult> addPackagesAsync(const QStringList &debFilePaths);
+
+    /**
+     * @brief queryPackagesAsync 批量刷新已添加包的依赖及安装状态
+     * @param handles 包的句柄
+     * @return 每个句柄对应一个结果，下标与输入顺序一致
+     */
+    QFuture<DebPackageQueryResult> queryPackagesAsync(const QList<DebPackageHandle> &handles);
+
+    /**
+     * @brief packageStatus 获取已添加包最近一次的状态，不进行查询
+     * @param handle 包的句柄
+     */
+    DebPackageQueryResult packageStatus(DebPackageHandle handle);
+
+    /**
+     * @brief removePackageByHandle 在程序中删除指定句柄的包
+     * @param handle 包的句柄
+     * @return 是否删除成功
+     */
+    bool removePackageByHandle(DebPackageHandle handle);
+
     /**
      * @brief install 开始安装已经添加的包
      */
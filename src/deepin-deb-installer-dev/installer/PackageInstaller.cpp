@@ -5,7 +5,9 @@
 #include "PackageInstaller.h"
 #include "manager/PackagesManager.h"
 #include "package/Package.h"
+#include "status/PackageStatus.h"
 
+#include <QMutexLocker>
 #include <QTimer>
 
 #include <QApt/Transaction>
@@ -55,6 +57,8 @@ void PackageInstaller::uninstallPackage()
     }
     const QStringList rdepends = m_packages->getPackageReverseDependList();  // 检查是否有应用依赖到该包
 
+    // 后端非线程安全，线程池中可能正在查询其它包的状态，标记及提交事务期间持有后端锁
+    QMutexLocker locker(PackageStatus::backendMutex());
     for (const auto &r : rdepends) {  // 卸载所有依赖该包的应用（二者的依赖关系为depends）
         if (m_backend->package(r)) {
             // 更换卸载包的方式
@@ -68,12 +72,16 @@ void PackageInstaller::uninstallPackage()
 
     // 如果未能成功根据包名以及架构名称获取到Package*对象，直接设置为卸载失败。并退出
     if (!uninstalledPackage) {
-        emit signal_installError(QApt::CommitError, m_pTrans->errorDetails());
+        locker.unlock();
+        // 此时未创建卸载事务，m_pTrans 为空或是上一次的事务，不能使用
+        emit signal_installError(QApt::CommitError, "Uninstall package not found");
+        emit signal_uninstallFinished(QApt::ExitFailed);
         return;
     }
     uninstalledPackage->setPurge();
 
     m_pTrans = m_backend->commitChanges();
+    locker.unlock();
 
     connect(m_pTrans, &QApt::Transaction::progressChanged, this, &PackageInstaller::signal_installProgress);
 
@@ -105,6 +113,7 @@ void PackageInstaller::installPackage()
         return;
     }
 
+    bool transactionCreated = false;
     DependsStatus packageDependsStatus = m_packages->getDependStatus();
     switch (packageDependsStatus) {
         case DependsUnknown:
@@ -114,12 +123,20 @@ void PackageInstaller::installPackage()
             dealBreakPackage();
             break;
         case DependsAvailable:
-            dealAvailablePackage();
+            transactionCreated = dealAvailablePackage();
             break;
         case DependsOk:
-            dealInstallablePackage();
+            transactionCreated = dealInstallablePackage();
             break;
     }
+
+    // 未创建安装事务（依赖错误等），直接结束当前包的安装流程
+    if (!transactionCreated) {
+        m_pTrans = nullptr;
+        emit signal_installFinished(QApt::ExitFailed);
+        return;
+    }
+
     connect(m_pTrans, &QApt::Transaction::progressChanged, this, &PackageInstaller::signal_installProgress);
 
     // 详细状态信息（安装情况）展示链接
@@ -152,20 +169,30 @@ void PackageInstaller::dealBreakPackage()
     }
 }
 
-void PackageInstaller::dealAvailablePackage()
+bool PackageInstaller::dealAvailablePackage()
 {
     const QStringList availableDepends = m_packages->getPackageAvailableDepends();
+
+    // 后端非线程安全，线程池中可能正在查询其它包的状态，标记及提交事务期间持有后端锁
+    QMutexLocker locker(PackageStatus::backendMutex());
     // 获取到可用的依赖包并根据后端返回的结果判断依赖包的安装结果
     for (auto const &p : availableDepends) {
         if (p.contains(" not found")) {  // 依赖安装失败
+            locker.unlock();
             emit signal_installError(DependsAvailable, p);
 
-            return;
+            return false;
         }
         m_backend->markPackageForInstall(p);
     }
     m_pTrans = m_backend->commitChanges();
+    locker.unlock();
+    if (!m_pTrans) {
+        emit signal_installError(QApt::CommitError, "Commit changes failed");
+        return false;
+    }
     connect(m_pTrans, &QApt::Transaction::finished, this, &PackageInstaller::installAvailableDepends);
+    return true;
 }
 
 void PackageInstaller::installAvailableDepends()
@@ -181,13 +208,20 @@ void PackageInstaller::installAvailableDepends()
     installPackage();
 }
 
-void PackageInstaller::dealInstallablePackage()
+bool PackageInstaller::dealInstallablePackage()
 {
     QApt::DebFile deb(m_packages->getPath());
 
+    QMutexLocker locker(PackageStatus::backendMutex());
     m_pTrans = m_backend->installFile(deb);  // 触发Qapt授权框和安装线程
+    locker.unlock();
+    if (!m_pTrans) {
+        emit signal_installError(QApt::CommitError, "Install file failed");
+        return false;
+    }
 
     connect(m_pTrans, &QApt::Transaction::finished, this, &PackageInstaller::signal_installFinished);
+    return true;
 }
 
 PackageInstaller::~PackageInstaller() {}
@@ -47,9 +47,9 @@ private:
 
     void dealBreakPackage();
 
-    void dealAvailablePackage();
+    bool dealAvailablePackage();
 
-    void dealInstallablePackage();
+    bool dealInstallablePackage();
 
     void installAvailableDepends();
 
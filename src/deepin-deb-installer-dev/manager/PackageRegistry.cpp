@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "PackageRegistry.h"
+#include "package/Package.h"
+
+DebPackageHandle PackageRegistry::insert(Package *package)
+{
+    const QByteArray md5 = package->getMd5();
+    if (m_md5Index.contains(md5)) {
+        return 0;
+    }
+
+    m_table.append(package);
+    const DebPackageHandle handle = m_table.size();
+    package->setPackageHandle(handle);
+
+    m_md5Index.insert(md5, handle);
+    if (package->getIndex() >= 0) {
+        m_indexHandles.insert(package->getIndex(), handle);
+    }
+    ++m_count;
+    return handle;
+}
+
+Package *PackageRegistry::take(DebPackageHandle handle)
+{
+    Package *package = find(handle);
+    if (!package) {
+        return nullptr;
+    }
+
+    m_table[static_cast<int>(handle - 1)] = nullptr;
+    m_md5Index.remove(package->getMd5());
+    // a later package may have reused the index, only drop the entry pointing here
+    auto iter = m_indexHandles.find(package->getIndex());
+    if (iter != m_indexHandles.end() && iter.value() == handle) {
+        m_indexHandles.erase(iter);
+    }
+    --m_count;
+
+    // skip removed slots, amortized O(1)
+    while (m_firstSlot < m_table.size() && !m_table.at(m_firstSlot)) {
+        ++m_firstSlot;
+    }
+    return package;
+}
+
+Package *PackageRegistry::find(DebPackageHandle handle) const
+{
+    if (handle <= 0 || handle > m_table.size()) {
+        return nullptr;
+    }
+
+    return m_table.at(static_cast<int>(handle - 1));
+}
+
+Package *PackageRegistry::findByIndex(int index) const
+{
+    return find(m_indexHandles.value(index, 0));
+}
+
+bool PackageRegistry::containsMd5(const QByteArray &md5) const
+{
+    return m_md5Index.contains(md5);
+}
+
+Package *PackageRegistry::first() const
+{
+    return m_firstSlot < m_table.size() ? m_table.at(m_firstSlot) : nullptr;
+}
+
+bool PackageRegistry::isEmpty() const
+{
+    return 0 == m_count;
+}
+
+int PackageRegistry::size() const
+{
+    return m_count;
+}
+
+QList<Package *> PackageRegistry::takeAll()
+{
+    QList<Package *> packages;
+    packages.reserve(m_count);
+    for (Package *package : m_table) {
+        if (package) {
+            packages.append(package);
+        }
+    }
+
+    m_table.fill(nullptr);
+    m_firstSlot = m_table.size();
+    m_count = 0;
+    m_md5Index.clear();
+    m_indexHandles.clear();
+    return packages;
+}
@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PACKAGEREGISTRY_H
+#define PACKAGEREGISTRY_H
+
+#include "DeepinDebInstallerLib.h"
+
+#include <QHash>
+#include <QVector>
+
+class Package;
+
+/**
+   @brief Handle indexed table of the packages added to PackagesManager.
+
+    Handles are dense and never reused: handle N lives in slot N - 1 of a flat
+    table, so lookups, status updates and removal are O(1) and a stale handle
+    simply hits an empty slot. The md5 index rejects duplicates and the index
+    map serves the legacy index based API. The registry does not own the
+    packages and is not synchronized, PackagesManager guards it with its mutex.
+ */
+class PackageRegistry
+{
+public:
+    // Register \a package and assign its handle, returns 0 when a package with the same md5 exists.
+    DebPackageHandle insert(Package *package);
+
+    // Remove the package of \a handle from the registry and return it, nullptr for unknown handles.
+    Package *take(DebPackageHandle handle);
+
+    [[nodiscard]] Package *find(DebPackageHandle handle) const;
+    [[nodiscard]] Package *findByIndex(int index) const;
+    [[nodiscard]] bool containsMd5(const QByteArray &md5) const;
+
+    // The earliest registered package still in the registry, packages are installed in this order.
+    [[nodiscard]] Package *first() const;
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] int size() const;
+
+    // Remove all packages and return them, handles stay unique afterwards.
+    QList<Package *> takeAll();
+
+private:
+    QVector<Package *> m_table;
+    int m_firstSlot{0};  // no live package before this slot
+    int m_count{0};
+
+    QHash<QByteArray, DebPackageHandle> m_md5Index;
+    QHash<int, DebPackageHandle> m_indexHandles;
+};
+
+#endif  // PACKAGEREGISTRY_H
@@ -3,12 +3,21 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "PackagesManager.h"
+#include "WorkerPool.h"
 #include "status/PackageSigntureStatus.h"
 #include "status/GetStatusThread.h"
 #include "installer/PackageInstaller.h"
 #include "package/Package.h"
+#include "package/PackageMetadata.h"
 
 #include <QFileInfo>
+#include <QFutureInterface>
+#include <QSharedPointer>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 PackagesManager::PackagesManager()
     : m_pPackageStatus(new PackageStatus())
@@ -73,6 +82,9 @@ void PackagesManager::slot_getDependsStatus(int index, DependsStatus dependsStat
 void PackagesManager::slot_getInstallStatus(int index, InstallStatus installStatus)
 {
     Package *pkg = searchByIndex(index);
+    if (!pkg) {
+        return;
+    }
     pkg->setPackageInstallStatus(installStatus);
     if (!m_appendFinished) {
         m_appendFinished = true;
@@ -91,14 +103,224 @@ void PackagesManager::appendPackages(QStringList packages)
 void PackagesManager::removePackage(int index)
 {
     Package *pkg = searchByIndex(index);
-    if (pkg) {
-        m_packages.removeOne(pkg);
-        m_packagesMd5.remove(pkg->getMd5());
-        emit signal_removePackageSuccess(index);
+    if (!pkg) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        // 正在安装/卸载的包由安装器持有，不允许删除
+        if (pkg->getHandle() == m_activeHandle) {
+            qWarning() << "[PackagesManager]<< removePackage"
+                       << "package is being installed";
+            return;
+        }
+        m_registry.take(pkg->getHandle());
     }
+    emit signal_removePackageSuccess(index);
     delete pkg;
 }
 
+/**
+ * @brief runOnWorkerPool 在共享线程池中对每个输入执行 \a function ，结果下标与输入顺序一致
+ *  批量任务开始前仅重新加载一次apt缓存
+ */
+template <typename Input, typename Function>
+QFuture<DebPackageQueryResult> PackagesManager::runOnWorkerPool(const QList<Input> &inputs, Function function)
+{
+    auto interface = QSharedPointer<QFutureInterface<DebPackageQueryResult>>::create();
+    interface->reportStarted();
+    interface->setProgressRange(0, inputs.size());
+    const QFuture<DebPackageQueryResult> future = interface->future();
+
+    if (inputs.isEmpty()) {
+        interface->reportFinished();
+        return future;
+    }
+
+    auto remaining = std::make_shared<std::atomic<int>>(inputs.size());
+    auto reloadFlag = std::make_shared<std::once_flag>();
+    for (int i = 0; i < inputs.size(); ++i) {
+        const Input input = inputs.at(i);
+        WorkerPool::start([this, interface, remaining, reloadFlag, function, input, i]() {
+            if (!interface->isCanceled()) {
+                std::call_once(*reloadFlag, [this]() { m_pPackageStatus->reloadCache(); });
+                interface->reportResult(function(input), i);
+            }
+
+            // 进度由剩余任务数得出，避免多个线程读改写进度值
+            const int left = remaining->fetch_sub(1) - 1;
+            interface->setProgressValue(interface->progressMaximum() - left);
+            if (0 == left) {
+                interface->reportFinished();
+            }
+        });
+    }
+
+    // 移除已完成的任务，剩余任务在析构时等待
+    m_asyncFutures.erase(std::remove_if(m_asyncFutures.begin(),
+                                        m_asyncFutures.end(),
+                                        [](const QFuture<DebPackageQueryResult> &item) { return item.isFinished(); }),
+                         m_asyncFutures.end());
+    m_asyncFutures.append(future);
+
+    return future;
+}
+
+QFuture<DebPackageQueryResult> PackagesManager::appendPackagesAsync(const QStringList &packages)
+{
+    return runOnWorkerPool(packages, [this](const QString &packagePath) { return loadPackage(packagePath); });
+}
+
+QFuture<DebPackageQueryResult> PackagesManager::queryPackagesAsync(const QList<DebPackageHandle> &handles)
+{
+    return runOnWorkerPool(handles, [this](DebPackageHandle handle) { return refreshPackage(handle); });
+}
+
+DebPackageQueryResult PackagesManager::packageStatus(DebPackageHandle handle)
+{
+    QMutexLocker locker(&m_packagesMutex);
+    Package *package = m_registry.find(handle);
+    if (!package) {
+        DebPackageQueryResult result;
+        result.result = DebPackageQueryResult::InvalidHandle;
+        return result;
+    }
+
+    return toQueryResult(package);
+}
+
+bool PackagesManager::removePackageByHandle(DebPackageHandle handle)
+{
+    Package *package = nullptr;
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        // 正在安装/卸载的包由安装器持有，不允许删除
+        if (handle == m_activeHandle) {
+            return false;
+        }
+        package = m_registry.take(handle);
+    }
+
+    if (!package) {
+        return false;
+    }
+
+    delete package;
+    return true;
+}
+
+/**
+ * @brief loadPackage 解析包并查询状态，成功后注册到包列表，在线程池中执行
+ *  包信息只解析一次，重复的包在签名验证及状态查询前被过滤
+ */
+DebPackageQueryResult PackagesManager::loadPackage(const QString &packagePath)
+{
+    DebPackageQueryResult result;
+    result.path = packagePath;
+    if (!checkPackageSuffix(packagePath)) {
+        return result;
+    }
+
+    const PackageMetadata metadata = PackageMetadata::parse(packagePath);
+    if (!metadata.valid) {
+        return result;
+    }
+
+    auto package = std::make_unique<Package>(-1, packagePath, metadata);
+    result = toQueryResult(package.get());
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        if (m_registry.containsMd5(metadata.md5)) {
+            result.result = DebPackageQueryResult::AlreadyExists;
+            return result;
+        }
+    }
+
+    PackageSigntureStatus signtureStatus;
+    package->setPackageSigntureStatus(signtureStatus.checkPackageSignture(packagePath));
+    if (package->getSigntureStatus() != SigntureVerifySuccess) {
+        result = toQueryResult(package.get());
+        result.result = DebPackageQueryResult::SignatureError;
+        return result;
+    }
+
+    package->setPackageDependStatus(m_pPackageStatus->getPackageDependsStatus(packagePath, false));
+    package->setPackageInstallStatus(m_pPackageStatus->getPackageInstallStatus(packagePath, false));
+    result = toQueryResult(package.get());
+
+    // 并发添加相同的包时，仅第一个注册成功
+    const DebPackageHandle handle = registerPackage(package.get());
+    if (0 == handle) {
+        result.result = DebPackageQueryResult::AlreadyExists;
+        return result;
+    }
+
+    package.release();
+    result.handle = handle;
+    result.result = DebPackageQueryResult::Success;
+    return result;
+}
+
+/**
+ * @brief refreshPackage 重新查询已注册包的依赖及安装状态，在线程池中执行
+ */
+DebPackageQueryResult PackagesManager::refreshPackage(DebPackageHandle handle)
+{
+    DebPackageQueryResult result;
+    result.handle = handle;
+    result.result = DebPackageQueryResult::InvalidHandle;
+
+    QString packagePath;
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        Package *package = m_registry.find(handle);
+        if (!package) {
+            return result;
+        }
+        packagePath = package->getPath();
+    }
+
+    const DependsStatus dependsStatus = m_pPackageStatus->getPackageDependsStatus(packagePath, false);
+    const InstallStatus installStatus = m_pPackageStatus->getPackageInstallStatus(packagePath, false);
+
+    // 查询期间包可能已被移除
+    QMutexLocker locker(&m_packagesMutex);
+    Package *package = m_registry.find(handle);
+    if (!package) {
+        return result;
+    }
+
+    package->setPackageDependStatus(dependsStatus);
+    package->setPackageInstallStatus(installStatus);
+    return toQueryResult(package);
+}
+
+DebPackageQueryResult PackagesManager::toQueryResult(Package *package)
+{
+    DebPackageQueryResult result;
+    result.handle = package->getHandle();
+    result.result = DebPackageQueryResult::Success;
+    result.path = package->getPath();
+    result.name = package->getName();
+    result.version = package->getVersion();
+    result.architecture = package->getArchitecture();
+    result.dependsStatus = package->getDependStatus();
+    result.installStatus = package->getInstallStatus();
+    result.signatureStatus = package->getSigntureStatus();
+    return result;
+}
+
+/**
+ * @brief registerPackage 将包加入包列表并分配句柄
+ * @return 包的句柄，md5已存在时返回0
+ */
+DebPackageHandle PackagesManager::registerPackage(Package *package)
+{
+    QMutexLocker locker(&m_packagesMutex);
+    return m_registry.insert(package);
+}
+
 int PackagesManager::checkInstallStatus(int index)
 {
     Package *pkg = searchByIndex(index);
@@ -177,18 +399,21 @@ void PackagesManager::getPackageInfo(QString packagePath, int index)
     m_pGetStatusThread->setPackage(index, packagePath);
     m_pGetStatusThread->start();
 
-    Package *packageFile = new Package(index, packagePath);
-
-    if (!packageFile->getValid()) {
+    const PackageMetadata metadata = PackageMetadata::parse(packagePath);
+    if (!metadata.valid) {
         qWarning() << "[PackagesManager]"
                    << "getPackageInfo"
-                   << "packageFile->getValid()" << packageFile->getValid();
+                   << "packageFile->getValid()" << metadata.valid;
         emit signal_packageInvalid(index);
         return;
     }
 
-    auto md5 = packageFile->getMd5();
-    if (m_packagesMd5.contains(md5)) {
+    bool md5Exists = false;
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        md5Exists = m_registry.containsMd5(metadata.md5);
+    }
+    if (md5Exists) {
         qWarning() << "[PackagesManager]"
                    << "getPackageInfo"
                    << "md5 already exists";
@@ -196,13 +421,22 @@ void PackagesManager::getPackageInfo(QString packagePath, int index)
         return;
     }
 
-    if (packageFile->getSigntureStatus() != SigntureVerifySuccess) {
-        emit signal_signatureError(index, packageFile->getSigntureStatus());
+    // 重复的包无需签名验证
+    PackageSigntureStatus signtureStatus;
+    const SigntureStatus packageSigntureStatus = signtureStatus.checkPackageSignture(packagePath);
+    if (packageSigntureStatus != SigntureVerifySuccess) {
+        emit signal_signatureError(index, packageSigntureStatus);
         return;
     }
 
-    m_packagesMd5 << md5;
-    m_packages.append(packageFile);
+    Package *packageFile = new Package(index, packagePath, metadata);
+    packageFile->setPackageSigntureStatus(packageSigntureStatus);
+
+    if (0 == registerPackage(packageFile)) {
+        emit signal_packageAlreadyExits(index);
+        delete packageFile;
+        return;
+    }
 
     if (!m_appendFinished) {
         m_appendFinished = true;
@@ -213,8 +447,15 @@ void PackagesManager::getPackageInfo(QString packagePath, int index)
 
 void PackagesManager::install()
 {
-    if (m_packages.size() > 0) {
-        m_pPackageInstaller->appendPackage(m_packages[0]);
+    Package *package = nullptr;
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        package = m_registry.first();
+        m_activeHandle = package ? package->getHandle() : 0;
+    }
+
+    if (package) {
+        m_pPackageInstaller->appendPackage(package);
         m_pPackageInstaller->installPackage();
     } else {
         qWarning() << "PackagesManager"
@@ -239,6 +480,10 @@ void PackagesManager::uninstall(int index)
             package->setPackageReverseDependsList(reverseDepends);
         }
 
+        {
+            QMutexLocker locker(&m_packagesMutex);
+            m_activeHandle = package->getHandle();
+        }
         m_pPackageInstaller->appendPackage(package);
         m_pPackageInstaller->uninstallPackage();
     } else {
@@ -250,11 +495,15 @@ void PackagesManager::uninstall(int index)
 
 Package *PackagesManager::searchByIndex(int index)
 {
-    auto iter =
-        std::find_if(m_packages.begin(), m_packages.end(), [index](const auto &package) { return package->getIndex() == index; });
-    if (iter != m_packages.end()) {
-        return *iter;
+    Package *package = nullptr;
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        package = m_registry.findByIndex(index);
     }
+    if (package) {
+        return package;
+    }
+
     emit signal_invalidIndex(index);
     qWarning() << "[PackagesManager]<< searchByIndex"
                << "Package not found";
@@ -263,32 +512,57 @@ Package *PackagesManager::searchByIndex(int index)
 
 void PackagesManager::slot_installFinished(QApt::ExitStatus exitStatus)
 {
+    DebPackageHandle handle = 0;
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        handle = m_activeHandle;
+        m_activeHandle = 0;
+    }
+
     if (QApt::ExitSuccess == exitStatus) {
-        m_packagesMd5.remove(m_packages[0]->getMd5());
-        m_packages.removeAt(0);
+        bool finished = false;
+        {
+            // 按安装时记录的句柄结束，期间可能有其它包被移除
+            QMutexLocker locker(&m_packagesMutex);
+            m_registry.take(handle);
+            finished = m_registry.isEmpty();
+        }
 
-        if (m_packages.isEmpty()) {
+        if (finished) {
             emit signal_installFinished();
             return;
         }
-        QApt::Backend *backend = m_pPackageStatus->m_backendFuture.result();
-        backend->reloadCache();
+        // 与线程池中的状态查询共用后端，加锁重新加载缓存
+        m_pPackageStatus->reloadCache();
         install();
     }
 }
 
 void PackagesManager::slot_uninstallFinished(QApt::ExitStatus exitStatus)
 {
+    DebPackageHandle handle = 0;
+    {
+        QMutexLocker locker(&m_packagesMutex);
+        handle = m_activeHandle;
+        m_activeHandle = 0;
+        if (QApt::ExitSuccess == exitStatus) {
+            m_registry.take(handle);
+        }
+    }
+
     if (QApt::ExitSuccess == exitStatus) {
-        m_packagesMd5.remove(m_packages[0]->getMd5());
-        m_packages.removeAt(0);
         emit signal_uninstallFinished();
     }
 }
 
 PackagesManager::~PackagesManager()
 {
-    m_packages.clear();
-    m_packagesMd5.clear();
+    // 线程池中的任务访问本对象，等待结束
+    for (QFuture<DebPackageQueryResult> &future : m_asyncFutures) {
+        future.cancel();
+        future.waitForFinished();
+    }
+
+    qDeleteAll(m_registry.takeAll());
     delete m_pPackageStatus;
 }
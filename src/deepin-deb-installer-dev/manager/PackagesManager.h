@@ -6,9 +6,12 @@
 #define PackagesManager_H
 #include "result.h"
 #include "status/PackageStatus.h"
+#include "DeepinDebInstallerLib.h"
+#include "PackageRegistry.h"
 
 #include <QObject>
 #include <QFuture>
+#include <QMutex>
 
 class PackageSigntureStatus;
 class Package;
@@ -40,6 +43,15 @@ public:
 
     void removePackage(int index);
 
+public:
+    QFuture<DebPackageQueryResult> appendPackagesAsync(const QStringList &packages);
+
+    QFuture<DebPackageQueryResult> queryPackagesAsync(const QList<DebPackageHandle> &handles);
+
+    DebPackageQueryResult packageStatus(DebPackageHandle handle);
+
+    bool removePackageByHandle(DebPackageHandle handle);
+
 signals:
     void signal_backendError();
 
@@ -87,9 +99,7 @@ private slots:
     void slot_getInstallStatus(int, InstallStatus);
 
 private:
-    QList<Package *> m_packages = {};
-
-    QSet<QByteArray> m_packagesMd5 = {};
+    PackageRegistry m_registry;
 
     PackageStatus *m_pPackageStatus = nullptr;
 
@@ -99,8 +109,24 @@ private:
 
     bool m_appendFinished = false;
 
+    // 保护包注册表，异步接口在线程池中注册包，包仅在主线程中删除
+    QMutex m_packagesMutex;
+    // 正在安装/卸载的包句柄，安装器持有该包，结束前不允许删除
+    DebPackageHandle m_activeHandle = 0;
+    // 未完成的异步任务，析构时等待结束
+    QList<QFuture<DebPackageQueryResult>> m_asyncFutures;
+
 private:
     Package *searchByIndex(int index = 0);
+    DebPackageHandle registerPackage(Package *package);
+
+    DebPackageQueryResult loadPackage(const QString &packagePath);
+    DebPackageQueryResult refreshPackage(DebPackageHandle handle);
+    static DebPackageQueryResult toQueryResult(Package *package);
+
+    template <typename Input, typename Function>
+    QFuture<DebPackageQueryResult> runOnWorkerPool(const QList<Input> &inputs, Function function);
+
     void getPackageInfo(QString pkg, int index = 0);
 
     bool checkPackageSuffix(QString packagePath);
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "WorkerPool.h"
+
+#include <QRunnable>
+#include <QThread>
+
+namespace {
+
+class FunctionRunnable : public QRunnable
+{
+public:
+    explicit FunctionRunnable(std::function<void()> task)
+        : m_task(std::move(task))
+    {
+        setAutoDelete(true);
+    }
+
+    void run() override { m_task(); }
+
+private:
+    std::function<void()> m_task;
+};
+
+}  // namespace
+
+QThreadPool *WorkerPool::instance()
+{
+    // kept until the process exits, jobs may still run while the library objects are destroyed.
+    static QThreadPool *pool = []() {
+        auto *threadPool = new QThreadPool;
+        threadPool->setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+        return threadPool;
+    }();
+    return pool;
+}
+
+void WorkerPool::start(std::function<void()> task)
+{
+    instance()->start(new FunctionRunnable(std::move(task)));
+}
@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <QThreadPool>
+
+#include <functional>
+
+/**
+   @brief Thread pool shared by all DeepinDebInstallerLib instances of the process.
+
+    The library runs package parsing, signature verification and status queries
+    here instead of the global pool of the embedding application, so a bulk
+    query never starves the application's own QtConcurrent work.
+    Access to the apt backend is serialized in PackageStatus, the pool only
+    parallelizes the per-file work.
+ */
+class WorkerPool
+{
+public:
+    static QThreadPool *instance();
+
+    // run \a task on the shared pool.
+    static void start(std::function<void()> task);
+};
+
+#endif  // WORKERPOOL_H
@@ -4,58 +4,38 @@
 
 #include "Package.h"
 
-#include <QApt/DebFile>
+#include <QtDebug>
 
-Package::Package()
-    : m_pSigntureStatus(new PackageSigntureStatus)
+Package::Package() {}
+
+Package::Package(const QString &packagePath)
+    : Package(-1, packagePath)
 {
 }
 
-Package::Package(const QString &packagePath)
-    : m_packagePath(packagePath)
-    , m_pSigntureStatus(new PackageSigntureStatus)
+Package::Package(int index, const QString &packagePath)
+    : Package(index, packagePath, PackageMetadata::parse(packagePath))
 {
-    QApt::DebFile *pDebInfo = new QApt::DebFile(packagePath);
-    if (!pDebInfo || !pDebInfo->isValid()) {
+    if (!m_valid) {
         qWarning() << "Package"
                    << "Package"
                    << "获取包文件失败";
-        m_valid = false;
         return;
     }
 
-    m_signtureStatus = m_pSigntureStatus->checkPackageSignture(packagePath);
-    m_valid = pDebInfo->isValid();
-    m_name = pDebInfo->packageName();
-    m_version = pDebInfo->version();
-    m_architecture = pDebInfo->architecture();
-    m_md5 = pDebInfo->md5Sum();
-
-    delete pDebInfo;
+    PackageSigntureStatus signtureStatus;
+    m_signtureStatus = signtureStatus.checkPackageSignture(packagePath);
 }
 
-Package::Package(int index, const QString &packagePath)
+Package::Package(int index, const QString &packagePath, const PackageMetadata &metadata)
     : m_index(index)
+    , m_valid(metadata.valid)
+    , m_name(metadata.name)
+    , m_version(metadata.version)
+    , m_architecture(metadata.architecture)
+    , m_md5(metadata.md5)
     , m_packagePath(packagePath)
-    , m_pSigntureStatus(new PackageSigntureStatus)
 {
-    QApt::DebFile *pDebInfo = new QApt::DebFile(packagePath);
-
-    if (!pDebInfo || !pDebInfo->isValid()) {
-        qWarning() << "Package"
-                   << "Package"
-                   << "获取包文件失败";
-        m_valid = false;
-        return;
-    }
-
-    m_valid = pDebInfo->isValid();
-    m_name = pDebInfo->packageName();
-    m_version = pDebInfo->version();
-    m_architecture = pDebInfo->architecture();
-    m_md5 = pDebInfo->md5Sum();
-
-    m_signtureStatus = m_pSigntureStatus->checkPackageSignture(packagePath);
 }
 
 void Package::setPackageReverseDependsList(const QStringList &reverseDepends)
@@ -73,6 +53,11 @@ void Package::setPackageIndex(int index)
     m_index = index;
 }
 
+void Package::setPackageHandle(qint64 handle)
+{
+    m_handle = handle;
+}
+
 void Package::setPackagePath(const QString &packagePath)
 {
     m_packagePath = packagePath;
@@ -83,6 +68,11 @@ void Package::setPackageDependStatus(DependsStatus packageDependStatus)
     m_dependsStatus = packageDependStatus;
 }
 
+void Package::setPackageSigntureStatus(SigntureStatus signtureStatus)
+{
+    m_signtureStatus = signtureStatus;
+}
+
 void Package::setPackageAvailableDepends(const QStringList &depends)
 {
     m_packageAvailableDependList.clear();
@@ -94,6 +84,11 @@ int Package::getIndex()
     return m_index;
 }
 
+qint64 Package::getHandle()
+{
+    return m_handle;
+}
+
 bool Package::getValid()
 {
     return m_valid;
@@ -148,7 +143,4 @@ QStringList Package::getPackageReverseDependList()
 {
     return m_packageReverseDepends;
 }
-Package::~Package()
-{
-    delete m_pSigntureStatus;
-}
+Package::~Package() {}
@@ -7,6 +7,7 @@
 
 #include "status/PackageStatus.h"
 #include "status/PackageSigntureStatus.h"
+#include "PackageMetadata.h"
 
 #include <QObject>
 
@@ -15,6 +16,13 @@ class Package
 public:
     explicit Package(const QString &packagePath);
     explicit Package(int index, const QString &packagePath);
+    /**
+     * @brief Package 使用已解析的包信息构造，不再读取deb文件，也不进行签名验证
+     * @param index 包的下标，不使用下标时为-1
+     * @param packagePath 包的路径
+     * @param metadata 包的信息
+     */
+    Package(int index, const QString &packagePath, const PackageMetadata &metadata);
     Package();
 
     ~Package();
@@ -25,6 +33,12 @@ public:
      */
     void setPackageIndex(int index);
 
+    /**
+     * @brief setPackageHandle 设置包的句柄
+     * @param handle 包的句柄
+     */
+    void setPackageHandle(qint64 handle);
+
     /**
      * @brief setPackagePath 设置包的路径
      * @param packagePath   包的路径
@@ -37,6 +51,12 @@ public:
      */
     void setPackageDependStatus(DependsStatus packageDependStatus);
 
+    /**
+     * @brief setPackageSigntureStatus 设置包的签名状态
+     * @param signtureStatus 包的签名状态
+     */
+    void setPackageSigntureStatus(SigntureStatus signtureStatus);
+
     /**
      * @brief setPackageAvailableDepends 设置包的可用依赖列表
      * @param depends 依赖列表
@@ -61,6 +81,12 @@ public:
      */
     int getIndex();
 
+    /**
+     * @brief getHandle 获取包的句柄
+     * @return 包的句柄，未分配时为0
+     */
+    qint64 getHandle();
+
     /**
      * @brief getValid 获取包的有效性
      * @return 包的有效性
@@ -129,6 +155,7 @@ public:
 
 private:
     int m_index = -1;
+    qint64 m_handle = 0;
     bool m_valid = false;
     QString m_name = "";
     QString m_version = "";
@@ -143,11 +170,6 @@ private:
     QStringList m_packageReverseDepends = {};
 
 private:
-    /**
-     * @brief m_pSigntureStatus 签名状态类
-     */
-    PackageSigntureStatus *m_pSigntureStatus = nullptr;
-
     Package(const Package &rhs) = delete;
     Package &operator=(const Package &rhs) = delete;
 };
@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "PackageMetadata.h"
+
+#include <QtDebug>
+
+#include <QApt/DebFile>
+
+PackageMetadata PackageMetadata::parse(const QString &packagePath)
+{
+    PackageMetadata metadata;
+
+    QApt::DebFile debFile(packagePath);
+    if (!debFile.isValid()) {
+        qWarning() << "[PackageMetadata]"
+                   << "parse"
+                   << "invalid deb file" << packagePath;
+        return metadata;
+    }
+
+    metadata.valid = true;
+    metadata.name = debFile.packageName();
+    metadata.version = debFile.version();
+    metadata.architecture = debFile.architecture();
+    // md5Sum() hashes the whole file, only call it once.
+    metadata.md5 = debFile.md5Sum();
+    return metadata;
+}
@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PACKAGEMETADATA_H
+#define PACKAGEMETADATA_H
+
+#include <QString>
+#include <QByteArray>
+
+/**
+   @brief Control fields and md5 of a deb file.
+
+    Filled once by parse() and handed to Package, so that registering a package
+    opens the deb file and hashes its content a single time.
+ */
+struct PackageMetadata
+{
+    bool valid{false};
+    QString name;
+    QString version;
+    QString architecture;
+    QByteArray md5;
+
+    // Read the metadata of \a packagePath, valid is false when the file is not a readable deb.
+    [[nodiscard]] static PackageMetadata parse(const QString &packagePath);
+};
+
+#endif  // PACKAGEMETADATA_H
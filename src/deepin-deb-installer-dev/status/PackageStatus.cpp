@@ -8,12 +8,27 @@
 
 #include <QtConcurrent>
 #include <QDebug>
+#include <QMutex>
 #include <QSet>
 
 #include <QApt/DebFile>
 
 using namespace QApt;
 
+// QApt 后端及 libapt 缓存非线程安全，所有后端访问通过此锁串行执行
+static QMutex s_backendMutex;
+
+static void waitBackendInit(const QFuture<QApt::Backend *> &backendFuture)
+{
+    while (true) {
+        if (backendFuture.isFinished()) {
+            break;
+        }
+        qInfo() << "Initializing backend, please wait";
+        usleep(10 * 1000);
+    }
+}
+
 QApt::Backend *init_backend()
 {
     QApt::Backend *b = new QApt::Backend;
@@ -77,6 +92,11 @@ PackageStatus PackageStatus::minEq(const PackageStatus &other)
     return *this;
 }
 
+QApt::Backend *PackageStatus::backend() const
+{
+    return m_backendFuture.result();
+}
+
 bool PackageStatus::isBreak() const
 {
     return m_status == DependsBreak;
@@ -480,17 +500,27 @@ DependsStatus PackageStatus::checkDependsPackageStatus(QSet<QString> &choosed_se
     }
 }
 
-DependsStatus PackageStatus::getPackageDependsStatus(const QString &packagePath)
+QMutex *PackageStatus::backendMutex()
 {
-    while (true) {
-        if (m_backendFuture.isFinished()) {
-            break;
-        }
-        qInfo() << "Initializing backend, please wait";
-        usleep(10 * 1000);
-    }
+    return &s_backendMutex;
+}
+
+void PackageStatus::reloadCache()
+{
+    waitBackendInit(m_backendFuture);
 
+    QMutexLocker locker(&s_backendMutex);
     m_backendFuture.result()->reloadCache();
+}
+
+DependsStatus PackageStatus::getPackageDependsStatus(const QString &packagePath, bool reloadCache)
+{
+    waitBackendInit(m_backendFuture);
+
+    QMutexLocker locker(&s_backendMutex);
+    if (reloadCache) {
+        m_backendFuture.result()->reloadCache();
+    }
     DebFile *deb = new DebFile(packagePath);
     const QString architecture = deb->architecture();
     DependsStatus ret = DependsOk;
@@ -526,6 +556,7 @@ DependsStatus PackageStatus::getPackageDependsStatus(const QString &packagePath)
 
 const QStringList PackageStatus::getPackageAvailableDepends(const QString &packagePath)
 {
+    QMutexLocker locker(&s_backendMutex);
     DebFile *deb = new DebFile(packagePath);
     QSet<QString> choose_set;
     const QString debArch = deb->architecture();
@@ -537,9 +568,14 @@ const QStringList PackageStatus::getPackageAvailableDepends(const QString &packa
     return choose_set.values();
 }
 
-InstallStatus PackageStatus::getPackageInstallStatus(const QString &packagePath)
+InstallStatus PackageStatus::getPackageInstallStatus(const QString &packagePath, bool reloadCache)
 {
-    m_backendFuture.result()->reloadCache();
+    waitBackendInit(m_backendFuture);
+
+    QMutexLocker locker(&s_backendMutex);
+    if (reloadCache) {
+        m_backendFuture.result()->reloadCache();
+    }
     DebFile *debFile = new DebFile(packagePath);
 
     const QString packageName = debFile->packageName();
@@ -640,6 +676,7 @@ QMap<QString, QString> PackageStatus::specialPackage()
 
 const QStringList PackageStatus::getPackageReverseDependsList(const QString &packageName, const QString &sysArch)
 {
+    QMutexLocker locker(&s_backendMutex);
     Package *package = packageWithArch(packageName, sysArch);
 
     QSet<QString> ret{packageName};
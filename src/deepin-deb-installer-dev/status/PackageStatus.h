@@ -10,6 +10,8 @@
 #include <QFuture>
 
 #include <QApt/Backend>
+
+class QMutex;
 /**
  * @brief The PackageDependsStatus enum
  * 当前包的依赖状态
@@ -69,14 +71,25 @@ public:
     bool isAuthCancel() const;
     bool isAvailable() const;
 
-    DependsStatus getPackageDependsStatus(const QString &packagePath);
+    /**
+     * @brief getPackageDependsStatus 获取包的依赖状态，可在任意线程调用，后端访问串行执行
+     * @param packagePath 包的路径
+     * @param reloadCache 查询前是否重新加载apt缓存，批量查询时仅需加载一次
+     * @return 包的依赖状态
+     */
+    DependsStatus getPackageDependsStatus(const QString &packagePath, bool reloadCache = true);
 
     /**
      * @brief packageInstallStatus 获取指定index的包的安装状态
      * @param index 指定的index
      * @return 包的安装状态s
      */
-    InstallStatus getPackageInstallStatus(const QString &packagePath);
+    InstallStatus getPackageInstallStatus(const QString &packagePath, bool reloadCache = true);
+
+    /**
+     * @brief reloadCache 重新加载apt缓存，用于批量查询前
+     */
+    void reloadCache();
 
     /**
      * @brief packageAvailableDepends 获取指定包的可用的依赖
@@ -93,6 +106,18 @@ public:
      */
     const QStringList getPackageReverseDependsList(const QString &packageName, const QString &sysArch);
 
+    /**
+     * @brief backend 获取状态检测使用的后端，等待后端初始化完成
+     * @return 初始化失败时返回nullptr
+     */
+    QApt::Backend *backend() const;
+
+    /**
+     * @brief backendMutex 后端访问锁，在状态检测之外访问后端(标记、提交安装事务、重新加载缓存)时需持有此锁
+     * @return 与状态检测共用的后端访问锁
+     */
+    static QMutex *backendMutex();
+
 private:
     QApt::Package *packageWithArch(const QString &packageName, const QString &sysArch, const QString &annotation = QString());
 
@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_runner.h"
+#include "deb_corpus_generator.h"
+
+#include "environments.h"
+#include "model/packageanalyzer.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSysInfo>
+
+#include <cstdio>
+
+// deb-installer-bench --generate DIR [--count N ...]   write a synthetic corpus to DIR
+// deb-installer-bench --corpus DIR [--iterations N]     run the benchmarks over the debs in DIR
+int main(int argc, char **argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    app.setApplicationName("deb-installer-bench");
+    app.setApplicationVersion(VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark deepin-deb-installer, results are written as JSON.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption generateOption("generate", "Generate a synthetic deb corpus to <dir>.", "dir");
+    QCommandLineOption countOption("count", "Number of packages to generate.", "n", "100");
+    QCommandLineOption sizeOption("size", "Payload bytes of each package.", "bytes", "4096");
+    QCommandLineOption fanoutOption("fanout", "Depends on other corpus packages per package.", "n", "3");
+    QCommandLineOption orGroupsOption("or-groups", "Depends written as or-group per package.", "n", "1");
+    QCommandLineOption providesOption("provides", "Packages providing a virtual package.", "n", "0");
+    QCommandLineOption cyclesOption("cycles", "Pairs of packages depending on each other.", "n", "0");
+    QCommandLineOption seedOption("seed", "Random seed of the generator.", "n", "1");
+
+    QCommandLineOption corpusOption("corpus", "Run the benchmarks over the debs in <dir>.", "dir");
+    QCommandLineOption iterationsOption("iterations", "Timed rounds of each benchmark.", "n", "5");
+    QCommandLineOption caseOption(
+        "case", QString("Only run the named benchmark (%1), may repeat.").arg(BenchRunner::caseNames().join(", ")), "name");
+    QCommandLineOption outputOption("output", "Write the JSON result to <file> instead of stdout.", "file");
+
+    parser.addOptions({generateOption,
+                       countOption,
+                       sizeOption,
+                       fanoutOption,
+                       orGroupsOption,
+                       providesOption,
+                       cyclesOption,
+                       seedOption,
+                       corpusOption,
+                       iterationsOption,
+                       caseOption,
+                       outputOption});
+    parser.process(app);
+
+    QJsonObject report{{"version", VERSION},
+                       {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+                       {"cpu_arch", QSysInfo::currentCpuArchitecture()},
+                       {"kernel", QSysInfo::kernelVersion()}};
+
+    if (parser.isSet(generateOption)) {
+        DebCorpusGenerator::Options options;
+        options.count = parser.value(countOption).toInt();
+        options.payloadSize = parser.value(sizeOption).toLongLong();
+        options.fanout = parser.value(fanoutOption).toInt();
+        options.orGroups = parser.value(orGroupsOption).toInt();
+        options.provides = parser.value(providesOption).toInt();
+        options.cycles = parser.value(cyclesOption).toInt();
+        options.seed = parser.value(seedOption).toUInt();
+
+        DebCorpusGenerator generator(options);
+        QString error;
+        const QStringList debPaths = generator.generate(parser.value(generateOption), &error);
+        if (debPaths.isEmpty() && options.count > 0) {
+            qCritical() << "[Bench]" << "generate corpus failed:" << error;
+            return 1;
+        }
+        report.insert("corpus", generator.describe());
+    }
+
+    if (parser.isSet(corpusOption)) {
+        const QString corpusDir = parser.value(corpusOption);
+        QStringList debPaths;
+        const QFileInfoList entries = QDir(corpusDir).entryInfoList({"*.deb"}, QDir::Files, QDir::Name);
+        for (const QFileInfo &entry : entries) {
+            debPaths.append(entry.absoluteFilePath());
+        }
+        if (debPaths.isEmpty()) {
+            qCritical() << "[Bench]" << "no deb found in" << corpusDir;
+            return 1;
+        }
+
+        PackageAnalyzer::instance().initBackend();
+
+        BenchRunner runner(debPaths, parser.value(iterationsOption).toInt());
+        report.insert("corpus_dir", QDir(corpusDir).absolutePath());
+        report.insert("packages", debPaths.size());
+        report.insert("benchmarks", runner.run(parser.values(caseOption)));
+    } else if (!parser.isSet(generateOption)) {
+        parser.showHelp(2);
+    }
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile output(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "[Bench]" << "failed to write" << output.fileName() << output.errorString();
+            return 1;
+        }
+        output.write(json);
+    } else {
+        fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+
+    return 0;
+}
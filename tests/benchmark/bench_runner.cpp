@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "bench_runner.h"
+
+#include "compatible/compatible_json_parser.h"
+#include "manager/AddPackageThread.h"
+#include "manager/packagesmanager.h"
+#include "model/deblistmodel.h"
+#include "model/dependgraph.h"
+#include "model/packagelistview.h"
+#include "model/packageslistdelegate.h"
+
+#include <QApt/DebFile>
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QImage>
+#include <QPainter>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <limits>
+
+BenchRunner::BenchRunner(const QStringList &debPaths, int iterations)
+    : m_debPaths(debPaths)
+    , m_iterations(std::max(1, iterations))
+{
+}
+
+BenchRunner::~BenchRunner()
+{
+    delete m_model;
+}
+
+QStringList BenchRunner::caseNames()
+{
+    return {"append", "hash", "depend_graph", "depends_status", "model_data", "delegate_paint", "compat_app_list"};
+}
+
+QJsonArray BenchRunner::run(const QStringList &filter)
+{
+    const QList<std::function<QJsonObject()>> cases{[this]() { return benchAppend(); },
+                                                    [this]() { return benchHash(); },
+                                                    [this]() { return benchDependGraph(); },
+                                                    [this]() { return benchDependsStatus(); },
+                                                    [this]() { return benchModelData(); },
+                                                    [this]() { return benchDelegatePaint(); },
+                                                    [this]() { return benchCompatAppList(); }};
+
+    QJsonArray results;
+    const QStringList names = caseNames();
+    for (int i = 0; i < cases.size(); ++i) {
+        if (filter.isEmpty() || filter.contains(names.at(i))) {
+            results.append(cases.at(i)());
+        }
+    }
+    return results;
+}
+
+/**
+   @brief Run \a round m_iterations times after one warm up round, \a prepare runs
+    before each round and is not timed.
+ */
+QJsonObject BenchRunner::measure(const QString &name, int items, const Round &round, const Round &prepare)
+{
+    if (prepare) {
+        prepare();
+    }
+    round();
+
+    qint64 totalNs = 0;
+    qint64 minNs = std::numeric_limits<qint64>::max();
+    qint64 maxNs = 0;
+    QElapsedTimer timer;
+    for (int i = 0; i < m_iterations; ++i) {
+        if (prepare) {
+            prepare();
+        }
+
+        timer.start();
+        round();
+        const qint64 elapsed = timer.nsecsElapsed();
+
+        totalNs += elapsed;
+        minNs = std::min(minNs, elapsed);
+        maxNs = std::max(maxNs, elapsed);
+    }
+
+    const double meanMs = totalNs / 1e6 / m_iterations;
+    return {{"name", name},
+            {"items", items},
+            {"iterations", m_iterations},
+            {"total_ms", totalNs / 1e6},
+            {"mean_ms", meanMs},
+            {"min_ms", minNs / 1e6},
+            {"max_ms", maxNs / 1e6},
+            {"items_per_sec", meanMs > 0 ? items * 1000.0 / meanMs : 0.0}};
+}
+
+QJsonObject BenchRunner::benchAppend()
+{
+    // AddPackageThread records each package to the recent files, keep it out of the user home.
+    QTemporaryDir fakeHome;
+    const QByteArray home = qgetenv("HOME");
+    qputenv("HOME", fakeHome.path().toLocal8Bit());
+
+    int appended = 0;
+    AddPackageThread thread({});
+    QObject::connect(&thread, &AddPackageThread::signalAddPackageToInstaller, [&appended]() { ++appended; });
+
+    QJsonObject result = measure(
+        "append",
+        m_debPaths.size(),
+        [&thread]() { thread.run(); },
+        [&thread, &appended, this]() {
+            appended = 0;
+            thread.setAppendPackagesMd5({});
+            thread.setSamePackageMd5({});
+            thread.setPackages(m_debPaths, 0);
+        });
+    result.insert("appended", appended);
+
+    qputenv("HOME", home);
+    return result;
+}
+
+QJsonObject BenchRunner::benchHash()
+{
+    return measure("hash", m_debPaths.size(), [this]() {
+        for (const QString &path : m_debPaths) {
+            QApt::DebFile deb(path);
+            (void)deb.md5Sum();
+        }
+    });
+}
+
+QJsonObject BenchRunner::benchDependGraph()
+{
+    struct DebInfo
+    {
+        QString path;
+        QByteArray md5;
+        QString name;
+        QList<QApt::DependencyItem> depends;
+    };
+
+    // parse outside the timed round, only measure the graph
+    QList<DebInfo> infos;
+    for (const QString &path : m_debPaths) {
+        QApt::DebFile deb(path);
+        infos.append({path, deb.md5Sum(), deb.packageName(), deb.depends()});
+    }
+
+    int queueSize = 0;
+    QJsonObject result = measure("depend_graph", infos.size(), [&infos, &queueSize]() {
+        DependGraph graph;
+        for (const DebInfo &info : infos) {
+            graph.addNode(info.path, info.md5, info.name, info.depends);
+        }
+        queueSize = graph.getBestInstallQueue().first.size();
+    });
+    result.insert("queue_size", queueSize);
+    return result;
+}
+
+QJsonObject BenchRunner::benchDependsStatus()
+{
+    PackagesManager *manager = listModel()->m_packagesManager;
+    const int count = manager->m_packageTable.size();
+
+    return measure(
+        "depends_status",
+        count,
+        [manager, count]() {
+            for (int row = 0; row < count; ++row) {
+                (void)manager->getPackageDependsStatus(row);
+            }
+        },
+        [manager]() {
+            // drop the cached result, measure the resolver
+            manager->m_packageTable.forEachRecord([](PackageRecord &record) { record.dependsCached = false; });
+        });
+}
+
+QJsonObject BenchRunner::benchModelData()
+{
+    DebListModel *model = listModel();
+    const int rows = model->rowCount();
+    const QList<int> roles{AbstractPackageListModel::PackageNameRole,
+                           AbstractPackageListModel::PackageVersionRole,
+                           AbstractPackageListModel::PackagePathRole,
+                           AbstractPackageListModel::PackageInstalledVersionRole,
+                           AbstractPackageListModel::PackageShortDescriptionRole,
+                           AbstractPackageListModel::PackageVersionStatusRole,
+                           AbstractPackageListModel::PackageDependsStatusRole,
+                           AbstractPackageListModel::PackageFailReasonRole,
+                           AbstractPackageListModel::PackageOperateStatusRole,
+                           AbstractPackageListModel::PackageTypeRole};
+
+    QJsonObject result = measure("model_data", rows * roles.size(), [model, rows, &roles]() {
+        for (int row = 0; row < rows; ++row) {
+            const QModelIndex index = model->index(row);
+            for (int role : roles) {
+                (void)model->data(index, role);
+            }
+        }
+    });
+    result.insert("rows", rows);
+    return result;
+}
+
+QJsonObject BenchRunner::benchDelegatePaint()
+{
+    DebListModel *model = listModel();
+    const int rows = model->rowCount();
+
+    PackagesListView view;
+    view.setModel(model);
+    PackagesListDelegate delegate(model, &view);
+
+    QStyleOptionViewItem option;
+    option.initFrom(&view);
+    const QSize itemSize(480, std::max(1, delegate.sizeHint(option, QModelIndex()).height()));
+    QImage image(itemSize, QImage::Format_ARGB32_Premultiplied);
+
+    return measure("delegate_paint", rows, [&]() {
+        for (int row = 0; row < rows; ++row) {
+            image.fill(Qt::transparent);
+            QPainter painter(&image);
+            option.rect = QRect(QPoint(0, 0), itemSize);
+            delegate.paint(&painter, option, model->index(row));
+        }
+    });
+}
+
+QJsonObject BenchRunner::benchCompatAppList()
+{
+    // deepin-compatible-ctl --json app list output, independent of the deb corpus
+    const int kAppCount = 10000;
+    QByteArray json = "{\"Code\":0,\"Msg\":null,\"Ext\":{\"Code\":0,\"Msg\":[\"\xE6\x88\x90\xE5\x8A\x9F [\\n";
+    for (int i = 0; i < kAppCount; ++i) {
+        json += QString("  {\\n    \\\"name\\\": \\\"app-%1\\\",\\n    \\\"version\\\": \\\"1.0.%1\\\",\\n    "
+                        "\\\"arch\\\": \\\"amd64\\\"\\n  }%2\\n")
+                    .arg(i)
+                    .arg(i + 1 < kAppCount ? "," : "")
+                    .toUtf8();
+    }
+    json += "]\"]}}";
+
+    int parsed = 0;
+    QJsonObject result = measure("compat_app_list", kAppCount, [&json, &parsed]() {
+        parsed = Compatible::CompatibleJsonParser::parseAppList(Compatible::CompatibleJsonParser::parseCommonField(json)).size();
+    });
+    result.insert("bytes", json.size());
+    result.insert("parsed", parsed);
+    return result;
+}
+
+DebListModel *BenchRunner::listModel()
+{
+    if (m_model) {
+        return m_model;
+    }
+
+    m_model = new DebListModel;
+
+    bool finished = false;
+    QEventLoop loop;
+    QObject::connect(m_model, &AbstractPackageListModel::signalAppendFinished, &loop, [&finished, &loop]() {
+        finished = true;
+        loop.quit();
+    });
+
+    m_model->slotAppendPackage(m_debPaths);
+    // single package append finished synchronously
+    if (!finished) {
+        loop.exec();
+    }
+
+    return m_model;
+}
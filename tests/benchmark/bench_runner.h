@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef BENCH_RUNNER_H
+#define BENCH_RUNNER_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStringList>
+
+#include <functional>
+
+class DebListModel;
+
+/**
+   @brief Run the deb-installer-bench cases over a deb corpus.
+
+    Every case is run \a iterations times after one warm up round, the
+    min / max / mean wall time are reported. The items processed per round
+    (packages, rows, paints) give the throughput.
+ */
+class BenchRunner
+{
+public:
+    BenchRunner(const QStringList &debPaths, int iterations);
+    ~BenchRunner();
+
+    // Run the cases which name is in \a filter, all cases if empty.
+    QJsonArray run(const QStringList &filter = {});
+
+    [[nodiscard]] static QStringList caseNames();
+
+private:
+    using Round = std::function<void()>;
+
+    QJsonObject measure(const QString &name, int items, const Round &round, const Round &prepare = {});
+
+    QJsonObject benchAppend();
+    QJsonObject benchHash();
+    QJsonObject benchDependGraph();
+    QJsonObject benchDependsStatus();
+    QJsonObject benchModelData();
+    QJsonObject benchDelegatePaint();
+    QJsonObject benchCompatAppList();
+
+    // append the corpus to the list model, used by model / delegate cases
+    DebListModel *listModel();
+
+    QStringList m_debPaths;
+    int m_iterations{1};
+    DebListModel *m_model{nullptr};
+};
+
+#endif  // BENCH_RUNNER_H
@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "deb_corpus_generator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+static const qint64 kPayloadChunkSize = 64 * 1024;
+
+DebCorpusGenerator::DebCorpusGenerator(const Options &options)
+    : m_options(options)
+{
+}
+
+QString DebCorpusGenerator::packageName(int index)
+{
+    return QString("bench-pkg-%1").arg(index, 4, 10, QChar('0'));
+}
+
+QString DebCorpusGenerator::virtualName(int index)
+{
+    return QString("bench-virtual-%1").arg(index);
+}
+
+QStringList DebCorpusGenerator::generate(const QString &outputDir, QString *error)
+{
+    if (!QDir().mkpath(outputDir)) {
+        if (error) {
+            *error = QString("failed to create %1").arg(outputDir);
+        }
+        return {};
+    }
+
+    QStringList debPaths;
+    for (int index = 0; index < m_options.count; ++index) {
+        QString debPath;
+        if (!buildPackage(index, outputDir, &debPath, error)) {
+            return {};
+        }
+        debPaths.append(debPath);
+    }
+
+    return debPaths;
+}
+
+QJsonObject DebCorpusGenerator::describe() const
+{
+    return {{"count", m_options.count},
+            {"payload_size", m_options.payloadSize},
+            {"fanout", m_options.fanout},
+            {"or_groups", m_options.orGroups},
+            {"provides", m_options.provides},
+            {"cycles", m_options.cycles},
+            {"system_depends", QJsonArray::fromStringList(m_options.systemDepends)},
+            {"seed", static_cast<qint64>(m_options.seed)}};
+}
+
+/**
+   @brief Depends of package \a index, only depends on the index and the options,
+    the same options always generate the same corpus.
+ */
+QStringList DebCorpusGenerator::dependsOf(int index) const
+{
+    QRandomGenerator rng(m_options.seed + static_cast<quint32>(index) * 2654435761U);
+
+    // random distinct packages with lower index
+    QList<int> candidates;
+    for (int i = 0; i < index; ++i) {
+        candidates.append(i);
+    }
+    const int pickCount = std::min(m_options.fanout, static_cast<int>(candidates.size()));
+    for (int i = 0; i < pickCount; ++i) {
+        const int swapIndex = i + static_cast<int>(rng.bounded(static_cast<quint32>(candidates.size() - i)));
+        candidates.swap(i, swapIndex);
+    }
+
+    QStringList depends;
+    for (int i = 0; i < pickCount; ++i) {
+        QString depend = packageName(candidates.at(i));
+        if (i < m_options.orGroups) {
+            // the second choice does not exist, resolver has to try the alternatives
+            depend += QString(" | bench-missing-%1").arg(candidates.at(i));
+        }
+        depends.append(depend);
+    }
+
+    const int virtualCount = std::max(1, m_options.provides / 2);
+    if (m_options.provides > 0 && index >= m_options.provides) {
+        depends.append(virtualName(static_cast<int>(rng.bounded(static_cast<quint32>(virtualCount)))));
+    }
+
+    // cycle pairs are (2c, 2c + 1)
+    if (index < 2 * m_options.cycles && (index | 1) < m_options.count) {
+        depends.append(packageName(index ^ 1));
+    }
+
+    depends.append(m_options.systemDepends);
+    depends.removeDuplicates();
+    return depends;
+}
+
+QString DebCorpusGenerator::controlFile(int index, const QStringList &depends) const
+{
+    QString control;
+    control += QString("Package: %1\n").arg(packageName(index));
+    control += QString("Version: 1.0.%1\n").arg(index);
+    control += "Architecture: all\n";
+    control += "Maintainer: deb-installer-bench <bench@localhost>\n";
+    control += QString("Installed-Size: %1\n").arg((m_options.payloadSize + 1023) / 1024);
+    if (!depends.isEmpty()) {
+        control += QString("Depends: %1\n").arg(depends.join(", "));
+    }
+    if (index < m_options.provides) {
+        control += QString("Provides: %1\n").arg(virtualName(index % std::max(1, m_options.provides / 2)));
+    }
+    control += QString("Description: synthetic package %1 for deb-installer-bench\n").arg(index);
+    control += " Generated package, do not install.\n";
+    return control;
+}
+
+bool DebCorpusGenerator::buildPackage(int index, const QString &outputDir, QString *debPath, QString *error) const
+{
+    auto fail = [error](const QString &message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+
+    QTemporaryDir stageDir;
+    if (!stageDir.isValid()) {
+        return fail("failed to create stage directory");
+    }
+
+    const QString name = packageName(index);
+    const QString debianDir = stageDir.filePath("DEBIAN");
+    const QString payloadDir = stageDir.filePath("usr/share/" + name);
+    if (!QDir().mkpath(debianDir) || !QDir().mkpath(payloadDir)) {
+        return fail("failed to create package layout");
+    }
+
+    QFile control(debianDir + "/control");
+    if (!control.open(QIODevice::WriteOnly)) {
+        return fail(control.errorString());
+    }
+    control.write(controlFile(index, dependsOf(index)).toUtf8());
+    control.close();
+
+    QFile payload(payloadDir + "/payload.bin");
+    if (!payload.open(QIODevice::WriteOnly)) {
+        return fail(payload.errorString());
+    }
+    QRandomGenerator rng(m_options.seed ^ static_cast<quint32>(index));
+    QByteArray chunk(static_cast<int>(kPayloadChunkSize), Qt::Uninitialized);
+    for (qint64 written = 0; written < m_options.payloadSize; written += chunk.size()) {
+        rng.fillRange(reinterpret_cast<quint32 *>(chunk.data()), chunk.size() / static_cast<int>(sizeof(quint32)));
+        const qint64 size = std::min<qint64>(chunk.size(), m_options.payloadSize - written);
+        payload.write(chunk.constData(), size);
+    }
+    payload.close();
+
+    *debPath = QDir(outputDir).filePath(QString("%1_1.0.%2_all.deb").arg(name).arg(index));
+
+    QProcess dpkgDeb;
+    dpkgDeb.start("dpkg-deb", {"--root-owner-group", "-Zgzip", "-z1", "--build", stageDir.path(), *debPath});
+    if (!dpkgDeb.waitForFinished(-1) || QProcess::NormalExit != dpkgDeb.exitStatus() || 0 != dpkgDeb.exitCode()) {
+        return fail(QString("dpkg-deb failed: %1").arg(QString::fromLocal8Bit(dpkgDeb.readAllStandardError())));
+    }
+
+    return true;
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef DEB_CORPUS_GENERATOR_H
+#define DEB_CORPUS_GENERATOR_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+/**
+   @brief Write synthetic deb packages used by deb-installer-bench.
+
+    Packages are named bench-pkg-NNNN. Depends only point to packages with a lower
+    index (so the corpus is a DAG), except the injected cycles. Packages are built
+    with dpkg-deb from a staged directory, the payload is random data so the
+    compression does not hide the file size.
+ */
+class DebCorpusGenerator
+{
+public:
+    struct Options
+    {
+        int count{100};            // number of packages
+        qint64 payloadSize{4096};  // payload bytes per package
+        int fanout{3};             // depends on other packages in the corpus per package
+        int orGroups{1};           // depends written as "a | b" per package
+        int provides{0};           // packages provide a virtual package, depended by others
+        int cycles{0};             // pairs of packages depend on each other
+        QStringList systemDepends{"libc6"};  // depends satisfied by the host system
+        quint32 seed{1};
+    };
+
+    explicit DebCorpusGenerator(const Options &options);
+
+    // Generate packages to \a outputDir, return the deb file paths, empty on error.
+    QStringList generate(const QString &outputDir, QString *error = nullptr);
+
+    [[nodiscard]] QJsonObject describe() const;
+
+    [[nodiscard]] static QString packageName(int index);
+    [[nodiscard]] static QString virtualName(int index);
+
+private:
+    [[nodiscard]] QString controlFile(int index, const QStringList &depends) const;
+    [[nodiscard]] QStringList dependsOf(int index) const;
+    bool buildPackage(int index, const QString &outputDir, QString *debPath, QString *error) const;
+
+    Options m_options;
+};
+
+#endif  // DEB_CORPUS_GENERATOR_H
@@ -85,3 +85,75 @@ TEST_F(UTCompatibleJsonParser, parseSupportRootfsSuccess)
     rootfsList = Compatible::CompatibleJsonParser::parseSupportfsList(ret);
     ASSERT_EQ(rootfsList.size(), 2);
 }
+
+static const QByteArray kRootfsListJson =
+    "{\"Code\":0,\"Msg\":null,\"Ext\":{\"Code\":0,\"Msg\":[\"\xE6\x88\x90\xE5\x8A\x9F {\\n  \\\"Containers\\\": [\\n    {\\n      "
+    "\\\"ID\\\": \\\"4aeedabc79a4\\\",\\n      \\\"Name\\\":\\\"uos-rootfs-20\\\",\\n      \\\"Status\\\": \\\"Up 15 "
+    "minutes\\\",\\n      \\\"Image\\\": \\\"localhost/uos-rootfs-20:latest\\\"\\n    }\\n  ]\\n}\"]}}";
+
+TEST_F(UTCompatibleJsonParser, parseRootfsListSuccess)
+{
+    auto ret = Compatible::CompatibleJsonParser::parseCommonField(kRootfsListJson);
+    ASSERT_FALSE(ret.isNull());
+
+    auto rootfsList = Compatible::CompatibleJsonParser::parseRootfsList(ret);
+    ASSERT_EQ(rootfsList.size(), 1);
+    EXPECT_EQ(rootfsList.first()->name, QString("uos-rootfs-20"));
+    EXPECT_EQ(rootfsList.first()->osName, QString("uos-rootfs-20"));
+}
+
+TEST_F(UTCompatibleJsonParser, parseInvalidJson)
+{
+    EXPECT_TRUE(Compatible::CompatibleJsonParser::parseCommonField("{\"Code\":0,\"Msg\":").isNull());
+    EXPECT_TRUE(Compatible::CompatibleJsonParser::parseCommonField("").isNull());
+}
+
+// timing of large lists is measured by the compat_app_list case of deb-installer-bench
+TEST_F(UTCompatibleJsonParser, parseLargeAppList)
+{
+    const int kAppCount = 1000;
+    QByteArray json = "{\"Code\":0,\"Msg\":null,\"Ext\":{\"Code\":0,\"Msg\":[\"\xE6\x88\x90\xE5\x8A\x9F [\\n";
+    for (int i = 0; i < kAppCount; ++i) {
+        json += QString("  {\\n    \\\"name\\\": \\\"app-%1\\\",\\n    \\\"version\\\": \\\"1.0.%1\\\",\\n    "
+                        "\\\"arch\\\": \\\"amd64\\\"\\n  }%2\\n")
+                    .arg(i)
+                    .arg(i + 1 < kAppCount ? "," : "")
+                    .toUtf8();
+    }
+    json += "]\"]}}";
+
+    auto pkgList = Compatible::CompatibleJsonParser::parseAppList(Compatible::CompatibleJsonParser::parseCommonField(json));
+
+    ASSERT_EQ(pkgList.size(), kAppCount);
+    EXPECT_EQ(pkgList.value("app-999")->version, QString("1.0.999"));
+    EXPECT_EQ(pkgList.value("app-0")->arch, QString("amd64"));
+}
+
+TEST_F(UTCompatibleJsonParser, parseRawOutput)
+{
+    const QByteArray rootfsOutput = "ID           Name                   Image                            Status\n"
+                                    "--------------------------------------------------------------------------------\n"
+                                    "4aeedabc79a4 uos-rootfs-20          localhost/uos-rootfs-20:latest   Up 6 minutes\n"
+                                    "\n";
+    auto rootfsList = Compatible::CompatibleBackend::parseRootfsFromRawOutputV2(rootfsOutput);
+    ASSERT_EQ(rootfsList.size(), 1);
+    EXPECT_EQ(rootfsList.first()->name, QString("uos-rootfs-20"));
+
+    const QByteArray rootfsOutputV1 = "Priority Name OS CreateTime\n"
+                                      "-----------------------------\n"
+                                      "1* uos-rootfs-20 UOS Desktop 20 2024-05-01 10:00:00\n";
+    rootfsList = Compatible::CompatibleBackend::parseRootfsFromRawOutputV1(rootfsOutputV1);
+    ASSERT_EQ(rootfsList.size(), 1);
+    EXPECT_EQ(rootfsList.first()->prioriy, 1);
+    EXPECT_EQ(rootfsList.first()->name, QString("uos-rootfs-20"));
+    EXPECT_EQ(rootfsList.first()->osName, QString("UOS Desktop 20"));
+
+    const QByteArray appOutput = "Name Version Arch Rootfs\n"
+                                 "-----------------------\n"
+                                 "hello 2.10-2 amd64 uos-rootfs-20\n"
+                                 "tree 1.8.0-1 amd64 uos-rootfs-20\n";
+    auto pkgList = Compatible::CompatibleBackend::parseAppListFromRawOutput(appOutput);
+    ASSERT_EQ(pkgList.size(), 2);
+    EXPECT_EQ(pkgList.value("tree")->version, QString("1.8.0-1"));
+    EXPECT_EQ(pkgList.value("tree")->rootfs, QString("uos-rootfs-20"));
+}
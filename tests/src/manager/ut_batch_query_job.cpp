@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/manager/batch_query_job.h"
+
+#include <QEventLoop>
+#include <QHash>
+#include <QThread>
+#include <QTimer>
+
+class ut_batchQueryJob_Test : public ::testing::Test
+{
+protected:
+    // run the job until finished, return results keyed by path
+    QHash<QString, QVariant> runJob(BatchQueryJob &job)
+    {
+        QHash<QString, QVariant> results;
+        QObject::connect(&job, &BatchQueryJob::resultReady, [&results](const QString &, const QString &path, const QVariant &result) {
+            results.insert(path, result);
+        });
+
+        QEventLoop loop;
+        QObject::connect(&job, &BatchQueryJob::finished, &loop, &QEventLoop::quit);
+        QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+        job.start();
+        loop.exec();
+        return results;
+    }
+};
+
+TEST_F(ut_batchQueryJob_Test, start_ResultNotReportedBeforeEventLoop)
+{
+    BatchQueryJob job("1", {"/a.deb"});
+    job.setMainThreadCheck([](const QString &) { return QVariant(0); });
+
+    job.start();
+    EXPECT_EQ(0, job.finishedCount());
+
+    QHash<QString, QVariant> results = runJob(job);
+    EXPECT_TRUE(job.isFinished());
+    EXPECT_EQ(0, results.value("/a.deb").toInt());
+}
+
+TEST_F(ut_batchQueryJob_Test, start_EmptyJobFinished)
+{
+    BatchQueryJob job("1", {});
+    bool finished = false;
+    QObject::connect(&job, &BatchQueryJob::finished, [&finished]() { finished = true; });
+
+    runJob(job);
+    EXPECT_TRUE(finished);
+}
+
+TEST_F(ut_batchQueryJob_Test, start_InvalidMainResultRunConcurrent)
+{
+    QThread *mainThread = QThread::currentThread();
+
+    BatchQueryJob job("2", {"/a.deb", "/b.deb", "/c.deb"});
+    job.setMainThreadCheck([](const QString &path) { return "/b.deb" == path ? QVariant(1) : QVariant(); });
+    job.setConcurrentCheck([mainThread](const QString &) { return QVariant(QThread::currentThread() == mainThread ? -1 : 2); });
+
+    int lastProgress = 0;
+    QObject::connect(&job, &BatchQueryJob::progressChanged, [&lastProgress](const QString &jobId, int finished, int total) {
+        EXPECT_EQ(QString("2"), jobId);
+        EXPECT_EQ(3, total);
+        lastProgress = finished;
+    });
+
+    QHash<QString, QVariant> results = runJob(job);
+    EXPECT_EQ(3, lastProgress);
+    EXPECT_EQ(2, results.value("/a.deb").toInt());
+    EXPECT_EQ(1, results.value("/b.deb").toInt());
+    EXPECT_EQ(2, results.value("/c.deb").toInt());
+}
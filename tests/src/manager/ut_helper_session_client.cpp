@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/manager/helper_session_client.h"
+#include "../deb-installer/process/Pty.h"
+#include "../deb-installer/process/helper_session_protocol.h"
+
+#include <stub.h>
+
+#include <QList>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int g_startCount = 0;
+int stub_Pty_start()
+{
+    ++g_startCount;
+    return 0;
+}
+
+class ut_helperSessionClient_Test : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        g_startCount = 0;
+        stub.set(ADDR(Konsole::Pty, start), stub_Pty_start);
+
+        client = new HelperSessionClient(&pty);
+        QObject::connect(client, &HelperSessionClient::outputReceived, [this](const char *data, int length, bool) {
+            output.append(data, length);
+        });
+        QObject::connect(client, &HelperSessionClient::jobFinished, [this](int exitCode) { exitCodes.append(exitCode); });
+    }
+    void TearDown() { delete client; }
+
+    Stub stub;
+    Konsole::Pty pty;
+    HelperSessionClient *client = nullptr;
+    QByteArray output;
+    QList<int> exitCodes;
+};
+
+TEST_F(ut_helperSessionClient_Test, submit_AuthorizeOnce)
+{
+    client->submit({"--install_config", "/a.deb"});
+    EXPECT_EQ(1, g_startCount);
+    EXPECT_EQ(HelperSessionClient::Starting, client->m_state);
+    EXPECT_GE(client->m_listenFd, 0);
+
+    // the next job submitted when the first one finished reuses the running session.
+    QObject::connect(client, &HelperSessionClient::jobFinished, [this](int) {
+        if (1 == exitCodes.size()) {
+            client->submit({"--install_config", "/b.deb"});
+        }
+    });
+    client->handleEvent("ready");
+    EXPECT_EQ(HelperSessionClient::Running, client->m_state);
+    client->handleEvent("finished;0");
+    EXPECT_EQ(QList<int>{0}, exitCodes);
+    EXPECT_EQ(1, g_startCount);
+    EXPECT_EQ(HelperSessionClient::Running, client->m_state);
+
+    client->handleEvent("finished;2");
+    EXPECT_EQ((QList<int>{0, 2}), exitCodes);
+    EXPECT_EQ(HelperSessionClient::Quitting, client->m_state);
+}
+
+TEST_F(ut_helperSessionClient_Test, finished_BatchResults)
+{
+    QList<int> packageResults;
+    QObject::connect(client, &HelperSessionClient::jobFinished, [&packageResults](int, const QList<int> &results) {
+        packageResults = results;
+    });
+
+    client->submit({"--install_config", "/a.deb", "/b.deb", "/c.deb"});
+    client->handleEvent("ready");
+    client->handleEvent("finished;1;0;1;0");
+
+    EXPECT_EQ(QList<int>{1}, exitCodes);
+    EXPECT_EQ((QList<int>{0, 1, 0}), packageResults);
+}
+
+TEST_F(ut_helperSessionClient_Test, receivedData_MarkerNotHandled)
+{
+    client->submit({"--install_config", "/a.deb"});
+    client->handleEvent("ready");
+
+    // output printed by the package can't fake the job status.
+    const QByteArray data = "\x1B]deepin-deb-installer-session;finished;0\a\nfinished;0\n";
+    client->onReceivedData(data.constData(), data.size(), false);
+    EXPECT_EQ(data, output);
+    EXPECT_TRUE(exitCodes.isEmpty());
+    EXPECT_EQ(HelperSessionClient::Running, client->m_state);
+}
+
+TEST_F(ut_helperSessionClient_Test, queueDrained_SessionQuit)
+{
+    client->submit({"--install_config", "/a.deb"});
+    client->handleEvent("ready");
+    client->handleEvent("finished;0");
+    EXPECT_EQ(HelperSessionClient::Quitting, client->m_state);
+    EXPECT_FALSE(client->isBusy());
+
+    // submitted while quitting, started by a new session.
+    client->submit({"--install_config", "/b.deb"});
+    EXPECT_EQ(1, g_startCount);
+    client->onProcessFinished(0, QProcess::NormalExit);
+    EXPECT_EQ(2, g_startCount);
+    EXPECT_EQ(HelperSessionClient::Starting, client->m_state);
+    EXPECT_EQ(QList<int>{0}, exitCodes);
+
+    client->handleEvent("ready");
+    client->handleEvent("finished;0");
+    client->onProcessFinished(0, QProcess::NormalExit);
+    EXPECT_FALSE(client->isRunning());
+    EXPECT_EQ((QList<int>{0, 0}), exitCodes);
+}
+
+TEST_F(ut_helperSessionClient_Test, isTrustedPeer_OtherProcess_False)
+{
+    int fds[2] = {-1, -1};
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+    // the peer is this process, not the started helper.
+    EXPECT_FALSE(HelperSessionClient::isTrustedPeer(fds[0], ::getpid() + 1));
+    EXPECT_FALSE(HelperSessionClient::isTrustedPeer(fds[0], 0));
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_F(ut_helperSessionClient_Test, processFinished_AuthCanceled)
+{
+    client->submit({"--install_config", "/a.deb"});
+    client->onProcessFinished(126, QProcess::NormalExit);
+
+    EXPECT_EQ(QList<int>{126}, exitCodes);
+    EXPECT_FALSE(client->isRunning());
+    EXPECT_FALSE(client->isBusy());
+    EXPECT_LT(client->m_listenFd, 0);
+}
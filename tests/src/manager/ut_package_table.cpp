@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/manager/package_table.h"
+
+class ut_packageTable_Test : public ::testing::Test
+{
+protected:
+    PackageTable table;
+};
+
+TEST_F(ut_packageTable_Test, append_RejectDuplicateMd5)
+{
+    PackageHandle first = table.append("/a.deb", "a");
+    PackageHandle second = table.append("/b.deb", "a");
+
+    EXPECT_TRUE(first.isValid());
+    EXPECT_FALSE(second.isValid());
+    EXPECT_EQ(1, table.size());
+    EXPECT_EQ("/a.deb", table.filePathAt(0));
+}
+
+TEST_F(ut_packageTable_Test, remove_StaleHandleRejected)
+{
+    PackageHandle first = table.append("/a.deb", "a");
+    table.append("/b.deb", "b");
+
+    ASSERT_TRUE(table.remove(first));
+    EXPECT_FALSE(table.isAlive(first));
+    EXPECT_EQ(nullptr, table.record(first));
+    EXPECT_FALSE(table.contains("a"));
+    EXPECT_EQ(0, table.rowOf(table.handle("b")));
+
+    // the released slot is reused with a new generation
+    PackageHandle reused = table.append("/c.deb", "c");
+    EXPECT_EQ(first.slot, reused.slot);
+    EXPECT_NE(first, reused);
+    EXPECT_FALSE(table.remove(first));
+    EXPECT_EQ(2, table.size());
+}
+
+TEST_F(ut_packageTable_Test, setRowOrder_KeepUnlistedRows)
+{
+    table.append("/a.deb", "a");
+    table.append("/b.deb", "b");
+    table.append("/c.deb", "c");
+
+    table.setRowOrder({"c", "a", "unknown"});
+
+    EXPECT_EQ(QList<QByteArray>({"c", "a", "b"}), table.md5List());
+    EXPECT_EQ(QList<QString>({"/c.deb", "/a.deb", "/b.deb"}), table.filePaths());
+    EXPECT_EQ(2, table.rowOf(table.handle("b")));
+}
+
+TEST_F(ut_packageTable_Test, clear_ResetRecords)
+{
+    PackageHandle handle = table.append("/a.deb", "a");
+    table.record(handle)->installStatus = 1;
+    table.record(handle)->failCode = 2;
+
+    table.clear();
+    EXPECT_TRUE(table.isEmpty());
+    EXPECT_FALSE(table.isAlive(handle));
+
+    PackageRecord *record = table.record(table.append("/a.deb", "a"));
+    ASSERT_NE(nullptr, record);
+    EXPECT_EQ(-1, record->installStatus);
+    EXPECT_EQ(0, record->failCode);
+    EXPECT_FALSE(record->dependsCached);
+}
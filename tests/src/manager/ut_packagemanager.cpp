@@ -380,8 +380,8 @@ TEST_F(UT_packagesManager, PackageManager_UT_addPackage)
     stub.set(ADDR(DependGraph, getBestInstallQueue), stub_getBestInstallQueue);
     stub.set(ADDR(PackagesManager, getPackageDependsStatus), stub_getPackageDependsStatus);
     m_packageManager->addPackage(1, "/", "deb");
-    EXPECT_EQ(1, m_packageManager->m_preparedPackages.size());
-    EXPECT_EQ(1, m_packageManager->m_packageMd5.size());
+    EXPECT_EQ(1, m_packageManager->m_packageTable.size());
+    EXPECT_TRUE(m_packageManager->m_packageTable.contains("deb"));
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_dealPackagePath_space)
@@ -436,7 +436,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_appendPackage)
 
     m_packageManager->appendPackage({"/1"});
 
-    ASSERT_FALSE(m_packageManager->m_packageMd5.isEmpty());
+    ASSERT_FALSE(m_packageManager->m_packageTable.isEmpty());
     stub.set(ADDR(QThread, start), stub_qthread_start);
     m_packageManager->appendPackage(QStringList() << "/1"
                                                   << "/2");
@@ -452,7 +452,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_appendPackage_invalid)
 
     m_packageManager->appendPackage({"/1"});
 
-    ASSERT_FALSE(m_packageManager->m_packageMd5.isEmpty());
+    ASSERT_FALSE(m_packageManager->m_packageTable.isEmpty());
     stub.set(ADDR(QThread, start), stub_qthread_start);
     m_packageManager->appendPackage(QStringList() << "/1"
                                                   << "/2");
@@ -468,7 +468,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_appendPackage_openFailed)
 
     m_packageManager->appendPackage({"/1"});
 
-    ASSERT_FALSE(m_packageManager->m_packageMd5.isEmpty());
+    ASSERT_FALSE(m_packageManager->m_packageTable.isEmpty());
     stub.set(ADDR(QThread, start), stub_qthread_start);
     m_packageManager->appendPackage(QStringList() << "/1"
                                                   << "/2");
@@ -493,7 +493,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_appendPackage_multi)
     stub.set(ADDR(QThread, start), stub_qthread_start);
     m_packageManager->appendPackage({"/1", "/2"});
 
-    ASSERT_TRUE(m_packageManager->m_packageMd5.isEmpty());
+    ASSERT_TRUE(m_packageManager->m_packageTable.isEmpty());
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_refreshPage)
@@ -501,19 +501,19 @@ TEST_F(UT_packagesManager, PackageManager_UT_refreshPage)
     stub.set(ADDR(PackagesManager, getPackageDependsStatus), stub_getPackageDependsStatus);
     stub.set(ADDR(PackagesManager, dealPackagePath), stub_dealPackagePath);
 
-    m_packageManager->m_preparedPackages.clear();
-    m_packageManager->m_preparedPackages.append("/1");
+    m_packageManager->m_packageTable.clear();
+    m_packageManager->m_packageTable.append("/1", "1");
     m_packageManager->refreshPage(2);
-    m_packageManager->m_preparedPackages.append("/2");
+    m_packageManager->m_packageTable.append("/2", "2");
     m_packageManager->refreshPage(2);
-    m_packageManager->m_preparedPackages.append("/3");
+    m_packageManager->m_packageTable.append("/3", "3");
     m_packageManager->refreshPage(2);
-    EXPECT_EQ(3, m_packageManager->m_preparedPackages.size());
+    EXPECT_EQ(3, m_packageManager->m_packageTable.size());
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_isArchError)
 {
-    m_packageManager->m_preparedPackages.insert(0, "/1");
+    m_packageManager->m_packageTable.append("/1", "1");
     ASSERT_FALSE(m_packageManager->isArchError(0));
 }
 
@@ -524,7 +524,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_isArchError_1)
     stub.set(ADDR(PackagesManager, getPackageDependsStatus), stub_getPackageDependsStatus);
 
     m_packageManager->appendPackage({"/1"});
-    m_packageManager->m_preparedPackages.append("0");
+    m_packageManager->m_packageTable.append("0", "0");
     ASSERT_FALSE(m_packageManager->isArchError(0));
 }
 
@@ -544,7 +544,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_packageConflictStat)
 
     ConflictResult cr = m_packageManager->packageConflictStat(0);
     ASSERT_TRUE(cr.is_ok());
-    ASSERT_EQ(1, m_packageManager->m_preparedPackages.size());
+    ASSERT_EQ(1, m_packageManager->m_packageTable.size());
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_packageConflictStat_invalid)
@@ -873,12 +873,9 @@ TEST_F(UT_packagesManager, PackageManager_UT_packageInstallStatus_01)
     stub.set(ADDR(Package, compareVersion), package_compareVersion);
     stub.set(ADDR(DependGraph, getBestInstallQueue), stub_getBestInstallQueue);
 
-    m_packageManager->m_packageMd5.insert(0, "deb");
-
     m_packageManager->appendPackage({"/1"});
     ASSERT_EQ(m_packageManager->packageInstallStatus(0), 0);
-    ASSERT_EQ(Pkg::PackageInstallStatus::NotInstalled,
-              m_packageManager->m_packageInstallStatus[m_packageManager->m_packageMd5.value(0)]);
+    ASSERT_EQ(Pkg::PackageInstallStatus::NotInstalled, m_packageManager->m_packageTable.recordAt(0)->installStatus);
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_packageInstallStatus_02)
@@ -890,11 +887,9 @@ TEST_F(UT_packagesManager, PackageManager_UT_packageInstallStatus_02)
     stub.set(ADDR(Package, installedVersion), deb_package_version);
     stub.set(ADDR(Package, compareVersion), package_compareVersion1);
     stub.set(ADDR(DependGraph, getBestInstallQueue), stub_getBestInstallQueue);
-    m_packageManager->m_packageMd5.insert(0, "deb");
     m_packageManager->appendPackage({"/1"});
     ASSERT_EQ(m_packageManager->packageInstallStatus(0), 3);
-    ASSERT_EQ(Pkg::PackageInstallStatus::InstalledLaterVersion,
-              m_packageManager->m_packageInstallStatus[m_packageManager->m_packageMd5.value(0)]);
+    ASSERT_EQ(Pkg::PackageInstallStatus::InstalledLaterVersion, m_packageManager->m_packageTable.recordAt(0)->installStatus);
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_packageInstallStatus_03)
@@ -906,11 +901,10 @@ TEST_F(UT_packagesManager, PackageManager_UT_packageInstallStatus_03)
     stub.set(ADDR(Package, installedVersion), deb_package_version);
     stub.set(ADDR(Package, compareVersion), package_compareVersion2);
     stub.set(ADDR(DependGraph, getBestInstallQueue), stub_getBestInstallQueue);
-    m_packageManager->m_packageMd5.insert(0, "deb");
     m_packageManager->appendPackage({"/1"});
     ASSERT_EQ(m_packageManager->packageInstallStatus(0), 2);
     ASSERT_EQ(Pkg::PackageInstallStatus::InstalledEarlierVersion,
-              m_packageManager->m_packageInstallStatus[m_packageManager->m_packageMd5.value(0)]);
+              m_packageManager->m_packageTable.recordAt(0)->installStatus);
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_packageInstallStatus_04)
@@ -922,13 +916,11 @@ TEST_F(UT_packagesManager, PackageManager_UT_packageInstallStatus_04)
     stub.set(ADDR(Package, installedVersion), deb_package_version);
     stub.set(ADDR(Package, compareVersion), package_compareVersion2);
 
-    m_packageManager->m_preparedPackages.append("0");
-    m_packageManager->m_packageMd5.insert(0, "0");
-    m_packageManager->m_packageInstallStatus.insert("0", 1);
+    m_packageManager->m_packageTable.append("0", "0");
+    m_packageManager->m_packageTable.recordAt(0)->installStatus = 1;
 
     ASSERT_EQ(m_packageManager->packageInstallStatus(0), 1);
-    ASSERT_EQ(Pkg::PackageInstallStatus::InstalledSameVersion,
-              m_packageManager->m_packageInstallStatus[m_packageManager->m_packageMd5.value(0)]);
+    ASSERT_EQ(Pkg::PackageInstallStatus::InstalledSameVersion, m_packageManager->m_packageTable.recordAt(0)->installStatus);
 }
 
 bool ut_isArchError_false(int index)
@@ -976,29 +968,29 @@ TEST_F(UT_packagesManager, PackageManager_UT_DealDependResult)
     stub.set(ADDR(Package, isInstalled), stub_isInstalled);
 
     m_packageManager->m_dependInstallMark.append("deb");
-    m_packageManager->m_packageMd5.append("deb");
-    m_packageManager->m_packageMd5DependsStatus.insert("deb", PackageDependsStatus::ok());
+    m_packageManager->m_packageTable.append("deb", "deb");
+    auto record = m_packageManager->m_packageTable.recordOf("deb");
+    m_packageManager->storeDependsStatus(m_packageManager->m_packageTable.handle("deb"), PackageDependsStatus::ok());
 
     m_packageManager->m_dependInstallMark.append("test success");
     m_packageManager->slotDealDependResult(4, 0, "");
-    EXPECT_EQ(Pkg::DependsStatus::DependsOk,
-              m_packageManager->m_packageMd5DependsStatus[m_packageManager->m_dependInstallMark[0]].status);
-    EXPECT_TRUE(m_packageManager->m_errorIndex.isEmpty());
+    EXPECT_EQ(Pkg::DependsStatus::DependsOk, record->dependsStatus.status);
+    EXPECT_EQ(-1, record->dependsAuthError);
     m_packageManager->slotDealDependResult(2, 0, "");
-    EXPECT_EQ(Pkg::DependsStatus::DependsAuthCancel,
-              m_packageManager->m_packageMd5DependsStatus[m_packageManager->m_dependInstallMark[0]].status);
+    EXPECT_EQ(Pkg::DependsStatus::DependsAuthCancel, record->dependsStatus.status);
     m_packageManager->slotDealDependResult(5, 0, "");
-    EXPECT_EQ(Pkg::DependsStatus::DependsBreak,
-              m_packageManager->m_packageMd5DependsStatus[m_packageManager->m_dependInstallMark[0]].status);
+    EXPECT_EQ(Pkg::DependsStatus::DependsBreak, record->dependsStatus.status);
+    EXPECT_EQ(5, record->dependsAuthError);
     GlobalStatus::setWinePreDependsInstalling(true);
     m_packageManager->slotDealDependResult(5, 0, "");
-    EXPECT_EQ(Pkg::DependsStatus::DependsBreak,
-              m_packageManager->m_packageMd5DependsStatus[m_packageManager->m_dependInstallMark[0]].status);
-    m_packageManager->m_preparedPackages.append({"1", "2"});
+    EXPECT_EQ(Pkg::DependsStatus::DependsBreak, record->dependsStatus.status);
+    m_packageManager->m_packageTable.append("1", "1");
+    m_packageManager->m_packageTable.append("2", "2");
     m_packageManager->slotDealDependResult(5, 0, "");
     EXPECT_FALSE(GlobalStatus::winePreDependsInstalling());
-    EXPECT_EQ(Pkg::DependsStatus::DependsBreak,
-              m_packageManager->m_packageMd5DependsStatus[m_packageManager->m_dependInstallMark[0]].status);
+    // slots may be reallocated after append, fetch the record again
+    record = m_packageManager->m_packageTable.recordOf("deb");
+    EXPECT_EQ(Pkg::DependsStatus::DependsBreak, record->dependsStatus.status);
 }
 
 bool ut_isArchError(int index)
@@ -1035,7 +1027,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_getPackageDependsStatus)
     stub.set(ADDR(Package, isInstalled), stub_isInstalled);
 
     m_packageManager->m_dependInstallMark.append("deb");
-    m_packageManager->m_packageMd5.append("deb");
+    m_packageManager->m_packageTable.append("deb", "deb");
     PackageDependsStatus pd = m_packageManager->getPackageDependsStatus(0);
 
     ASSERT_TRUE(pd.isBreak());
@@ -1062,7 +1054,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_getPackageDependsStatus_01)
     stub.set(ADDR(Package, isInstalled), stub_isInstalled);
 
     m_packageManager->m_dependInstallMark.append("deb");
-    m_packageManager->m_packageMd5.append("deb1");
+    m_packageManager->m_packageTable.append("deb1", "deb1");
 
     PackageDependsStatus pd = m_packageManager->getPackageDependsStatus(0);
 
@@ -1093,7 +1085,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_getPackageDependsStatus_02)
 
     usleep(10 * 1000);
     m_packageManager->appendPackage({"/"});
-    m_packageManager->m_packageMd5DependsStatus.clear();
+    m_packageManager->m_packageTable.forEachRecord([](PackageRecord &record) { record.dependsCached = false; });
 
     stub.set(ADDR(Package, installedVersion), package_installedVersion);
     stub.set(ADDR(Package, compareVersion), package_compareVersion);
@@ -1118,7 +1110,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_getPackageDependsStatus_03)
 
     usleep(10 * 1000);
     m_packageManager->appendPackage({"/"});
-    m_packageManager->m_packageMd5DependsStatus.clear();
+    m_packageManager->m_packageTable.forEachRecord([](PackageRecord &record) { record.dependsCached = false; });
 
     stub.set(ADDR(Package, installedVersion), package_installedVersion);
     stub.set(ADDR(Package, compareVersion), package_compareVersion);
@@ -1154,7 +1146,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_getPackageDependsStatus_05)
 
     usleep(10 * 1000);
     m_packageManager->appendPackage({"/"});
-    m_packageManager->m_packageMd5DependsStatus.clear();
+    m_packageManager->m_packageTable.forEachRecord([](PackageRecord &record) { record.dependsCached = false; });
 
     stub.set(ADDR(Package, installedVersion), package_installedVersion);
     stub.set(ADDR(Package, compareVersion), package_compareVersion);
@@ -1230,7 +1222,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_getPackageDependsStatus_06)
              stub_checkDependsPackageStatus_DI);
 
     m_packageManager->appendPackage({"/"});
-    m_packageManager->m_packageMd5DependsStatus.clear();
+    m_packageManager->m_packageTable.forEachRecord([](PackageRecord &record) { record.dependsCached = false; });
 
     PackageDependsStatus pd = m_packageManager->getPackageDependsStatus(0);
 
@@ -1294,10 +1286,10 @@ TEST_F(UT_packagesManager, PackageManager_UT_getPackageDependsStatus_07)
     stub.set(ADDR(DealDependThread, setDependsList), stub_setDependsList);
     stub.set(ADDR(DealDependThread, setBrokenDepend), stub_setBrokenDepend);
 
-    m_packageManager->m_preparedPackages.insert(0, "0");
-    m_packageManager->m_packageMd5.insert(0, "0");
+    m_packageManager->m_packageTable.append("0", "0");
+    m_packageManager->m_packageTable.setRowOrder({"0"});
     m_packageManager->m_dependInstallMark.insert(0, "1");
-    m_packageManager->m_packageMd5DependsStatus.clear();
+    m_packageManager->m_packageTable.forEachRecord([](PackageRecord &record) { record.dependsCached = false; });
 
     PackageDependsStatus pd = m_packageManager->getPackageDependsStatus(0);
 
@@ -1323,7 +1315,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_packageInstalledVersion)
     stub.set(ADDR(Package, installedVersion), package_installedVersion);
     stub.set(ADDR(Package, compareVersion), package_compareVersion);
 
-    m_packageManager->m_packageInstallStatus[m_packageManager->m_packageMd5[0]] = 0;
+    m_packageManager->m_packageTable.recordAt(0)->installStatus = 0;
     QString version = m_packageManager->packageInstalledVersion(0);
 
     ASSERT_TRUE(version.isEmpty());
@@ -1582,7 +1574,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_reset)
 
     m_packageManager->reset();
 
-    ASSERT_TRUE(m_packageManager->m_appendedPackagesMd5.isEmpty());
+    ASSERT_TRUE(m_packageManager->m_packageTable.isEmpty());
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_resetPackageDependsStatus)
@@ -1602,7 +1594,7 @@ TEST_F(UT_packagesManager, PackageManager_UT_resetPackageDependsStatus)
 
     m_packageManager->resetPackageDependsStatus(0);
 
-    ASSERT_TRUE(m_packageManager->m_packageMd5DependsStatus.isEmpty());
+    ASSERT_FALSE(m_packageManager->cachedPackageDependStatus(0));
 }
 
 bool stub_reloadCache()
@@ -1624,12 +1616,12 @@ TEST_F(UT_packagesManager, PackageManager_UT_resetPackageDependsStatus_01)
 
     usleep(10 * 1000);
     m_packageManager->appendPackage({"/"});
-    m_packageManager->m_packageMd5[0] = "1";
     PackageDependsStatus st = PackageDependsStatus::ok();
-    m_packageManager->m_packageMd5DependsStatus.insert("1", st);
+    m_packageManager->storeDependsStatus(m_packageManager->m_packageTable.handleAt(0), st);
+    ASSERT_TRUE(m_packageManager->cachedPackageDependStatus(0));
     m_packageManager->resetPackageDependsStatus(0);
 
-    ASSERT_TRUE(m_packageManager->m_packageMd5DependsStatus.isEmpty());
+    ASSERT_FALSE(m_packageManager->cachedPackageDependStatus(0));
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_removePackage)
@@ -1649,28 +1641,29 @@ TEST_F(UT_packagesManager, PackageManager_UT_removePackage)
 
     m_packageManager->removePackage(0);
 
-    ASSERT_TRUE(m_packageManager->m_appendedPackagesMd5.isEmpty());
+    ASSERT_TRUE(m_packageManager->m_packageTable.isEmpty());
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_removePackage_01)
 {
-    m_packageManager->m_preparedPackages.append("1");
+    m_packageManager->m_packageTable.append("1", "1");
 
     m_packageManager->removePackage(-1);
 
-    ASSERT_EQ(m_packageManager->m_preparedPackages.size(), 1);
+    ASSERT_EQ(m_packageManager->m_packageTable.size(), 1);
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_removePackage_02)
 {
-    m_packageManager->m_preparedPackages.append("1");
+    const PackageHandle handle = m_packageManager->m_packageTable.append("1", "1");
 
-    m_packageManager->m_packageMd5.insert(0, "1");
     m_packageManager->m_dependInstallMark.append("1");
 
     m_packageManager->removePackage(0);
 
-    ASSERT_EQ(m_packageManager->m_preparedPackages.size(), 0);
+    ASSERT_EQ(m_packageManager->m_packageTable.size(), 0);
+    ASSERT_TRUE(m_packageManager->m_dependInstallMark.isEmpty());
+    ASSERT_FALSE(m_packageManager->m_packageTable.isAlive(handle));
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_removePackage_removeMulti)
@@ -1684,16 +1677,14 @@ TEST_F(UT_packagesManager, PackageManager_UT_removePackage_removeMulti)
     stub.set(ADDR(PackagesManager, dealPackagePath), stub_dealPackagePath);
 
     usleep(10 * 1000);
-    m_packageManager->m_preparedPackages.append("/0");
-    m_packageManager->m_preparedPackages.append("/1");
-    m_packageManager->m_preparedPackages.append("/2");
-    m_packageManager->m_packageMd5.append("0");
-    m_packageManager->m_packageMd5.append("0");
-    m_packageManager->m_packageMd5.append("0");
+    m_packageManager->m_packageTable.append("/0", "0");
+    m_packageManager->m_packageTable.append("/1", "1");
+    m_packageManager->m_packageTable.append("/2", "2");
 
     m_packageManager->removePackage(0);
 
-    ASSERT_EQ(m_packageManager->m_preparedPackages.size(), 2);
+    ASSERT_EQ(m_packageManager->m_packageTable.size(), 2);
+    ASSERT_EQ("/1", m_packageManager->package(0));
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_removePackage_removeTwo)
@@ -1708,14 +1699,12 @@ TEST_F(UT_packagesManager, PackageManager_UT_removePackage_removeTwo)
 
     usleep(10 * 1000);
 
-    m_packageManager->m_preparedPackages.append("/1");
-    m_packageManager->m_preparedPackages.append("/2");
-    m_packageManager->m_packageMd5.append("0");
-    m_packageManager->m_packageMd5.append("0");
+    m_packageManager->m_packageTable.append("/1", "1");
+    m_packageManager->m_packageTable.append("/2", "2");
 
     m_packageManager->removePackage(0);
 
-    ASSERT_EQ(m_packageManager->m_preparedPackages.size(), 1);
+    ASSERT_EQ(m_packageManager->m_packageTable.size(), 1);
 }
 
 TEST_F(UT_packagesManager, PackageManager_UT_rmTempDir)
@@ -1962,7 +1951,8 @@ TEST_F(UT_packagesManager, PackageManager_UT_checkDependsPackageStatus02)
 
 TEST_F(UT_packagesManager, PackageManager_UT_getPackageMd5)
 {
-    m_packageManager->m_packageMd5.append({"1", "2"});
+    m_packageManager->m_packageTable.append("/1", "1");
+    m_packageManager->m_packageTable.append("/2", "2");
     EXPECT_EQ("1", m_packageManager->getPackageMd5(0));
 }
 
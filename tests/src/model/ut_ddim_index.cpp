@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/model/ddim_index.h"
+#include "../deb-installer/model/packageselectmodel.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+class ut_ddim_index_Test : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        QDir(dir.path()).mkpath("Softwares");
+        debPath = dir.filePath("Softwares/a.deb");
+        writeFile("deb content");
+    }
+
+    void writeFile(const QByteArray &content)
+    {
+        QFile file(debPath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(content);
+    }
+
+    DebIr makeIr() const
+    {
+        DebIr ir;
+        ir.filePath = debPath;
+        ir.packageName = "a";
+        ir.version = "1.0";
+        ir.architecture = "amd64";
+        ir.shortDescription = "package a";
+        ir.md5 = "0123456789abcdef";
+        ir.virtualPackages = QStringList{"a-virtual"};
+        ir.isValid = true;
+        return ir;
+    }
+
+    QTemporaryDir dir;
+    QString debPath;
+};
+
+TEST_F(ut_ddim_index_Test, saveAndLoad)
+{
+    DdimIndex index(dir.path());
+    EXPECT_FALSE(index.load());
+
+    index.insert(makeIr());
+    EXPECT_TRUE(index.isDirty());
+    ASSERT_TRUE(index.save());
+    EXPECT_FALSE(index.isDirty());
+    EXPECT_TRUE(QFile::exists(DdimIndex::indexFilePath(dir.path())));
+
+    DdimIndex loaded(dir.path());
+    ASSERT_TRUE(loaded.load());
+    EXPECT_EQ(loaded.size(), 1);
+
+    DebIr ir;
+    ASSERT_TRUE(loaded.lookup(debPath, &ir));
+    EXPECT_EQ(ir.filePath, debPath);
+    EXPECT_EQ(ir.packageName, QString("a"));
+    EXPECT_EQ(ir.version, QString("1.0"));
+    EXPECT_EQ(ir.architecture, QString("amd64"));
+    EXPECT_EQ(ir.md5, QByteArray("0123456789abcdef"));
+    EXPECT_EQ(ir.virtualPackages, QStringList{"a-virtual"});
+    EXPECT_TRUE(ir.isValid);
+}
+
+TEST_F(ut_ddim_index_Test, lookupChangedFile)
+{
+    DdimIndex index(dir.path());
+    index.insert(makeIr());
+
+    writeFile("changed deb content");
+
+    DebIr ir;
+    EXPECT_FALSE(index.lookup(debPath, &ir));
+    EXPECT_FALSE(index.lookup(dir.filePath("Softwares/b.deb"), &ir));
+}
+
+TEST_F(ut_ddim_index_Test, loadCorrupted)
+{
+    QFile file(DdimIndex::indexFilePath(dir.path()));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("not an index");
+    file.close();
+
+    DdimIndex index(dir.path());
+    EXPECT_FALSE(index.load());
+    EXPECT_EQ(index.size(), 0);
+}
+
+TEST_F(ut_ddim_index_Test, loadTruncatedOrForgedCount)
+{
+    DdimIndex index(dir.path());
+    index.insert(makeIr());
+    ASSERT_TRUE(index.save());
+
+    QFile file(DdimIndex::indexFilePath(dir.path()));
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    const QByteArray content = file.readAll();
+
+    // entry count follows magic and format version, claim far more entries than the file holds
+    ASSERT_TRUE(file.seek(8));
+    file.write(QByteArray::fromHex("7fffffff"));
+    file.close();
+
+    DdimIndex forged(dir.path());
+    EXPECT_FALSE(forged.load());
+    EXPECT_EQ(forged.size(), 0);
+
+    // valid header, short read inside the entry
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(content.left(content.size() - 4));
+    file.close();
+
+    DdimIndex truncated(dir.path());
+    EXPECT_FALSE(truncated.load());
+    EXPECT_EQ(truncated.size(), 0);
+}
@@ -426,22 +426,21 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_reset)
     m_debListModel->reset();
     EXPECT_EQ(m_debListModel->m_workerStatus, DebListModel::WorkerPrepare);
     EXPECT_EQ(0, m_debListModel->m_operatingIndex);
-    EXPECT_TRUE(m_debListModel->m_operatingPackageMd5.isEmpty());
+    EXPECT_FALSE(m_debListModel->m_operatingHandle.isValid());
     EXPECT_EQ(0, m_debListModel->m_operatingStatusIndex);
-    EXPECT_TRUE(m_debListModel->m_packageOperateStatus.isEmpty());
-    EXPECT_TRUE(m_debListModel->m_packageFailCode.isEmpty());
-    EXPECT_TRUE(m_debListModel->m_packageFailReason.isEmpty());
-    EXPECT_TRUE(m_debListModel->m_packagesManager->m_errorIndex.isEmpty());
+    EXPECT_TRUE(m_debListModel->m_packagesManager->m_packageTable.isEmpty());
     EXPECT_FALSE(m_debListModel->m_hierarchicalVerifyError);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_reset_filestatus)
 {
-    m_debListModel->m_packageOperateStatus[0] = 1;
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "deb");
+    m_debListModel->operatingRecord()->operateStatus = Pkg::PackageOperationStatus::Failed;
+    m_debListModel->setOperatingPackageFailure(QApt::CommitError, "error");
     m_debListModel->resetFileStatus();
-    EXPECT_TRUE(m_debListModel->m_packageOperateStatus.isEmpty());
-    EXPECT_TRUE(m_debListModel->m_packageFailReason.isEmpty());
-    EXPECT_TRUE(m_debListModel->m_packageFailCode.isEmpty());
+    EXPECT_EQ(Pkg::PackageOperationStatus::Prepare, m_debListModel->operatingRecord()->operateStatus);
+    EXPECT_TRUE(m_debListModel->operatingRecord()->failReason.isEmpty());
+    EXPECT_EQ(0, m_debListModel->operatingRecord()->failCode);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_isReady)
@@ -517,9 +516,9 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_data)
 
     m_debListModel->data(index, 1);
 
-    m_debListModel->m_packageOperateStatus[""] = 1;
+    m_debListModel->m_packagesManager->m_packageTable.recordAt(0)->operateStatus = 1;
     m_debListModel->data(index, 268);
-    EXPECT_EQ(1, m_debListModel->m_packagesManager->m_preparedPackages.size());
+    EXPECT_EQ(1, m_debListModel->m_packagesManager->m_packageTable.size());
 }
 TEST_F(ut_DebListModel_test, deblistmodel_UT_data_recheck)
 {
@@ -529,7 +528,7 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_data_recheck)
 
     QModelIndex index = m_debListModel->index(0);
 
-    EXPECT_EQ(1, m_debListModel->m_packagesManager->m_preparedPackages.size());
+    EXPECT_EQ(1, m_debListModel->m_packagesManager->m_packageTable.size());
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_isDevelopMode)
@@ -546,7 +545,7 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_initPrepareStatus)
     m_debListModel->slotAppendPackage(list);
 
     m_debListModel->initPrepareStatus();
-    ASSERT_EQ(m_debListModel->m_packageOperateStatus[0], Pkg::PackageOperationStatus::Prepare);
+    ASSERT_EQ(m_debListModel->m_packagesManager->m_packageTable.recordAt(0)->operateStatus, Pkg::PackageOperationStatus::Prepare);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_index)
@@ -677,11 +676,12 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_initRowStatus)
     list << "/";
     m_debListModel->slotAppendPackage(list);
 
-    m_debListModel->m_packageMd5.insert(0, "deb");
+    m_debListModel->m_packagesManager->m_packageTable.append("deb", "deb");
 
     m_debListModel->initRowStatus();
 
-    ASSERT_EQ(m_debListModel->m_packageOperateStatus.find("deb").value(), Pkg::PackageOperationStatus::Waiting);
+    ASSERT_EQ(m_debListModel->m_packagesManager->m_packageTable.recordOf("deb")->operateStatus,
+              Pkg::PackageOperationStatus::Waiting);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_checkSystemVersion_UosEnterprise)
@@ -789,10 +789,10 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_showNoDigitalErrWindow)
 
     m_debListModel->m_operatingIndex = 0;
 
-    m_debListModel->m_packagesManager->m_preparedPackages.append("1");
+    m_debListModel->m_packagesManager->m_packageTable.append("1", "1");
 
     m_debListModel->showNoDigitalErrWindow();
-    EXPECT_TRUE(m_debListModel->m_operatingIndex < m_debListModel->m_packagesManager->m_preparedPackages.size() - 1);
+    EXPECT_TRUE(m_debListModel->m_operatingIndex < m_debListModel->m_packagesManager->m_packageTable.size() - 1);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_removePackage)
@@ -803,17 +803,16 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_removePackage)
 
     m_debListModel->m_operatingIndex = 0;
 
-    m_debListModel->m_packagesManager->m_preparedPackages.append("1");
+    m_debListModel->m_packagesManager->m_packageTable.append("1", "1");
+    m_debListModel->m_packagesManager->m_packageTable.recordOf("1")->operateStatus = Pkg::PackageOperationStatus::Failed;
 
     m_debListModel->removePackage(0);
 
-    ASSERT_EQ(m_debListModel->m_packagesManager->m_preparedPackages.size(), 1);
-    ASSERT_TRUE(m_debListModel->m_packageOperateStatus.isEmpty());
-    m_debListModel->slotAppendPackage(list);
-    m_debListModel->m_packageOperateStatus[""] = 1;
+    ASSERT_EQ(m_debListModel->m_packagesManager->m_packageTable.size(), 1);
+    ASSERT_EQ(m_debListModel->m_packagesManager->m_packageTable.recordAt(0)->operateStatus,
+              Pkg::PackageOperationStatus::Prepare);
     m_debListModel->removePackage(0);
-    ASSERT_EQ(m_debListModel->m_packagesManager->m_preparedPackages.size(), 0);
-    ASSERT_TRUE(m_debListModel->m_packageOperateStatus.isEmpty());
+    ASSERT_EQ(m_debListModel->m_packagesManager->m_packageTable.size(), 0);
 }
 
 QApt::ErrorCode model_transaction_commitError()
@@ -830,20 +829,19 @@ QObject *ut_sender()
 TEST_F(ut_DebListModel_test, deblistmodel_UT_onTransactionErrorOccurred)
 {
     stub.set(ADDR(Transaction, error), model_transaction_error);
-    m_debListModel->m_operatingPackageMd5 = "deb";
-    m_debListModel->m_packageOperateStatus.insert("deb", QApt::CommitError);
-    m_debListModel->m_packageFailCode.insert("deb", QApt::FetchError);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "deb");
+    m_debListModel->operatingRecord()->operateStatus = QApt::CommitError;
+    m_debListModel->operatingRecord()->failCode = QApt::FetchError;
     m_debListModel->m_isDevelopMode = Utils::isDevelopMode();
     m_debListModel->m_workerStatus = DebListModel::WorkerProcessing;
-    m_debListModel->m_packageMd5.insert(0, "00000");
     m_debListModel->m_operatingIndex = 0;
 
     Stub stub1;
     stub1.set(ADDR(QObject, sender), ut_sender);
 
     m_debListModel->slotTransactionErrorOccurred();
-    EXPECT_EQ(QApt::AuthError, m_debListModel->m_packageFailCode[m_debListModel->m_operatingPackageMd5]);
-    EXPECT_EQ(Pkg::PackageOperationStatus::Failed, m_debListModel->m_packageOperateStatus[m_debListModel->m_operatingPackageMd5]);
+    EXPECT_EQ(QApt::AuthError, m_debListModel->operatingRecord()->failCode);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Failed, m_debListModel->operatingRecord()->operateStatus);
     delete ut_sender();
 }
 
@@ -852,13 +850,17 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_DealDependResult)
     stub.set(ADDR(DebListModel, refreshOperatingPackageStatus), model_refreshOperatingPackageStatus);
     stub.set(ADDR(DebListModel, bumpInstallIndex), model_bumpInstallIndex);
     stub.set(ADDR(DebListModel, getPackageMd5), model_getPackageMd5);
+    m_debListModel->m_packagesManager->m_packageTable.append("1", "1");
+    auto record = m_debListModel->m_packagesManager->m_packageTable.recordOf("1");
+    record->operateStatus = Pkg::PackageOperationStatus::Failed;
 
     m_debListModel->slotDealDependResult(1, 0, "");
     m_debListModel->slotDealDependResult(2, 0, "");
-    EXPECT_EQ(Pkg::PackageOperationStatus::Prepare, m_debListModel->m_packageOperateStatus["1"]);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Prepare, record->operateStatus);
+    record->operateStatus = Pkg::PackageOperationStatus::Failed;
     m_debListModel->slotDealDependResult(3, 0, "");
     m_debListModel->slotDealDependResult(4, 0, "");
-    EXPECT_EQ(Pkg::PackageOperationStatus::Prepare, m_debListModel->m_packageOperateStatus["1"]);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Prepare, record->operateStatus);
     EXPECT_EQ(Pkg::PackageOperationStatus::Prepare, m_debListModel->m_workerStatus);
     m_debListModel->slotDealDependResult(5, 0, "");
     EXPECT_EQ("", m_debListModel->m_brokenDepend);
@@ -899,32 +901,103 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_bumpInstallIndex)
 {
     stub.set(ADDR(DebListModel, installNextDeb), model_installNextDeb);
     m_debListModel->m_operatingIndex = 0;
-    m_debListModel->m_packageMd5.append("\n");
-    m_debListModel->m_packageMd5.append("1");
+    m_debListModel->m_packagesManager->m_packageTable.append("\n", "\n");
+    m_debListModel->m_packagesManager->m_packageTable.append("1", "1");
     m_debListModel->bumpInstallIndex();
-    EXPECT_EQ("", m_debListModel->m_operatingPackageMd5);
+    EXPECT_EQ("1", m_debListModel->operatingRecord()->md5);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_slotInstallPackages_resetHierarchicalVerify)
 {
     stub.set(ADDR(DebListModel, installNextDeb), model_installNextDeb);
     m_debListModel->m_operatingIndex = 0;
-    m_debListModel->m_packageMd5.append("\n");
-    m_debListModel->m_packageMd5.append("1");
+    m_debListModel->m_packagesManager->m_packageTable.append("\n", "\n");
+    m_debListModel->m_packagesManager->m_packageTable.append("1", "1");
     m_debListModel->m_hierarchicalVerifyError = true;
 
     m_debListModel->slotInstallPackages();
     EXPECT_FALSE(m_debListModel->m_hierarchicalVerifyError);
 }
 
+static int g_startInstallCount = 0;
+bool stub_DebListModel_startInstallPackages()
+{
+    ++g_startInstallCount;
+    return true;
+}
+
+bool stub_HierarchicalVerify_isProbing_true()
+{
+    return true;
+}
+
+TEST_F(ut_DebListModel_test, deblistmodel_UT_slotInstallPackages_waitHierarchicalProbe)
+{
+    g_startInstallCount = 0;
+    stub.set(ADDR(DebListModel, startInstallPackages), stub_DebListModel_startInstallPackages);
+    stub.set(ADDR(HierarchicalVerify, isProbing), stub_HierarchicalVerify_isProbing_true);
+    m_debListModel->m_packagesManager->m_packageTable.append("1", "1");
+
+    // not started until the interface query returns, no blocking wait.
+    EXPECT_TRUE(m_debListModel->slotInstallPackages());
+    EXPECT_EQ(0, g_startInstallCount);
+
+    Q_EMIT HierarchicalVerify::instance()->interfaceProbed();
+    EXPECT_EQ(1, g_startInstallCount);
+    Q_EMIT HierarchicalVerify::instance()->interfaceProbed();
+    EXPECT_EQ(1, g_startInstallCount);
+}
+
 TEST_F(ut_DebListModel_test, deblistmodel_UT_ConfigInstallFinish)
 {
     stub.set(ADDR(DebListModel, bumpInstallIndex), model_bumpInstallIndex);
-    m_debListModel->m_packagesManager->m_preparedPackages.append("/");
+    m_debListModel->m_packagesManager->m_packageTable.append("/", "/");
     m_debListModel->slotConfigInstallFinish(1);
     EXPECT_EQ(DebListModel::WorkerPrepare, m_debListModel->m_workerStatus);
 }
 
+TEST_F(ut_DebListModel_test, deblistmodel_UT_ConfigInstallFinish_Batch)
+{
+    stub.set(ADDR(DebListModel, bumpInstallIndex), model_bumpInstallIndex);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("a", "a");
+    m_debListModel->m_packagesManager->m_packageTable.append("b", "b");
+    m_debListModel->m_packagesManager->m_packageTable.append("c", "c");
+    m_debListModel->m_operatingIndex = 0;
+    m_debListModel->m_operatingStatusIndex = 0;
+    m_debListModel->m_configBatchSize = 2;
+
+    m_debListModel->slotConfigInstallFinish(1);
+
+    // the first package of the batch shares the result, the last one is handled as single package.
+    EXPECT_EQ(1, m_debListModel->m_operatingIndex);
+    EXPECT_EQ(1, m_debListModel->m_configBatchSize);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Failed,
+              m_debListModel->m_packagesManager->m_packageTable.recordAt(0)->operateStatus);
+    EXPECT_EQ(1, m_debListModel->m_packagesManager->m_packageTable.recordAt(0)->failCode);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Failed, m_debListModel->operatingRecord()->operateStatus);
+}
+
+TEST_F(ut_DebListModel_test, deblistmodel_UT_ConfigInstallFinish_BatchPackageResults)
+{
+    stub.set(ADDR(DebListModel, bumpInstallIndex), model_bumpInstallIndex);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("a", "a");
+    m_debListModel->m_packagesManager->m_packageTable.append("b", "b");
+    m_debListModel->m_packagesManager->m_packageTable.append("c", "c");
+    m_debListModel->m_operatingIndex = 0;
+    m_debListModel->m_operatingStatusIndex = 0;
+    m_debListModel->m_configBatchSize = 3;
+
+    m_debListModel->slotConfigInstallFinish(2, {0, 2, 0});
+
+    // each package of the batch gets its own result.
+    const auto &table = m_debListModel->m_packagesManager->m_packageTable;
+    EXPECT_EQ(2, m_debListModel->m_operatingIndex);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Success, table.recordAt(0)->operateStatus);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Failed, table.recordAt(1)->operateStatus);
+    EXPECT_EQ(2, table.recordAt(1)->failCode);
+    EXPECT_NE(Pkg::PackageOperationStatus::Failed, table.recordAt(2)->operateStatus);
+}
+
 QByteArray model_readAllStandardOutput()
 {
     return "StartInstallAptConfig";
@@ -937,8 +1010,8 @@ QByteArray model_readAllStandardOutput1()
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_ConfigReadOutput)
 {
-    m_debListModel->m_operatingPackageMd5 = "deb";
-    m_debListModel->m_packageOperateStatus.insert("deb", QApt::CommitError);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "deb");
+    m_debListModel->operatingRecord()->operateStatus = QApt::CommitError;
 
     stub.set(ADDR(Konsole::Pty, receivedData), model_readAllStandardOutput);
     // asan检查 内存泄露
@@ -946,29 +1019,23 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_ConfigReadOutput)
     int length = sizeof(buffer);
     bool isCommandExec = false;
     m_debListModel->slotConfigReadOutput(buffer.toStdString().c_str(), length, isCommandExec);
-    EXPECT_EQ(Pkg::PackageOperationStatus::Operating,
-              m_debListModel->m_packageOperateStatus[m_debListModel->m_operatingPackageMd5]);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Operating, m_debListModel->operatingRecord()->operateStatus);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_onTransactionFinished)
 {
-    m_debListModel->m_operatingPackageMd5 = "deb";
-    m_debListModel->m_packageFailCode.insert("deb", QApt::CommitError);
-    m_debListModel->m_operatingPackageMd5 = "deb";
-    m_debListModel->m_packageFailCode.insert("deb", QApt::CommitError);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "test");
+    m_debListModel->m_packagesManager->m_packageTable.append("deb1", "test1");
+    m_debListModel->operatingRecord()->failCode = QApt::CommitError;
     stub.set(ADDR(DebListModel, bumpInstallIndex), model_bumpInstallIndex);
     stub.set(ADDR(Transaction, error), model_transaction_error);
     m_debListModel->m_operatingIndex = 0;
-    m_debListModel->m_packageMd5.append("test");
-    m_debListModel->m_packageMd5.append("test1");
-    m_debListModel->m_packagesManager->m_preparedPackages.append(QString("deb"));
-    m_debListModel->m_packagesManager->m_preparedPackages.append(QString("deb1"));
 
     Stub stub1;
     stub1.set(ADDR(QObject, sender), ut_sender);
     m_debListModel->slotTransactionFinished();
     EXPECT_EQ(nullptr, m_debListModel->m_currentTransaction);
-    EXPECT_EQ(QApt::AuthError, m_debListModel->m_packageFailCode[m_debListModel->m_operatingPackageMd5]);
+    EXPECT_EQ(QApt::AuthError, m_debListModel->operatingRecord()->failCode);
     delete ut_sender();
 }
 
@@ -994,17 +1061,14 @@ TEST_F(ut_DebListModel_test, onTransactionFinished_HierarchicalVerify_Failed)
     // Enable hierarchical verify
     stubHierachicalInvalid.set(ADDR(HierarchicalVerify, isValid), stub_DebListModel_Hierarchical_Valid);
 
-    m_debListModel->m_operatingPackageMd5 = "deb";
-    m_debListModel->m_packageFailCode.insert("deb", QApt::CommitError);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "test");
+    m_debListModel->m_packagesManager->m_packageTable.append("deb1", "test1");
+    m_debListModel->operatingRecord()->failCode = QApt::CommitError;
     stub.set(ADDR(DebListModel, bumpInstallIndex), model_bumpInstallIndex);
     stub.set(ADDR(DebListModel, showDigitalErrWindow), stub_showDigitalErrWindow);
     stub.set(ADDR(Transaction, error), model_transaction_error);
     stub.set(ADDR(Transaction, errorDetails), stub_Transacton_ErrorDetails_Failed);
     m_debListModel->m_operatingIndex = 0;
-    m_debListModel->m_packageMd5.append("test");
-    m_debListModel->m_packageMd5.append("test1");
-    m_debListModel->m_packagesManager->m_preparedPackages.append(QString("deb"));
-    m_debListModel->m_packagesManager->m_preparedPackages.append(QString("deb1"));
 
     Stub stub1;
     g_transaction = new Transaction("1");
@@ -1013,9 +1077,13 @@ TEST_F(ut_DebListModel_test, onTransactionFinished_HierarchicalVerify_Failed)
 
     m_debListModel->slotTransactionFinished();
     EXPECT_EQ(nullptr, m_debListModel->m_currentTransaction);
-    EXPECT_EQ(Pkg::DigitalSignatureError, m_debListModel->m_packageFailCode[m_debListModel->m_operatingPackageMd5]);
+    EXPECT_EQ(Pkg::DigitalSignatureError, m_debListModel->operatingRecord()->failCode);
     EXPECT_TRUE(m_debListModel->m_hierarchicalVerifyError);
+    // verdict recorded with the same name/version/md5 as the install loop queries
+    EXPECT_FALSE(m_debListModel->hierarchicalVerifyPassed(0));
+    EXPECT_TRUE(m_debListModel->hierarchicalVerifyPassed(1));
 
+    HierarchicalVerify::instance()->clearVerifyResult();
     delete g_transaction;
     g_transaction = nullptr;
 }
@@ -1030,17 +1098,14 @@ TEST_F(ut_DebListModel_test, onTransactionFinished_HierarchicalVerify_Pass)
     // Enable hierarchical verify
     stubHierachicalInvalid.set(ADDR(HierarchicalVerify, isValid), stub_DebListModel_Hierarchical_Valid);
 
-    m_debListModel->m_operatingPackageMd5 = "deb";
-    m_debListModel->m_packageFailCode.insert("deb", QApt::CommitError);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "test");
+    m_debListModel->m_packagesManager->m_packageTable.append("deb1", "test1");
+    m_debListModel->operatingRecord()->failCode = QApt::CommitError;
     stub.set(ADDR(DebListModel, bumpInstallIndex), model_bumpInstallIndex);
     stub.set(ADDR(DebListModel, showDigitalErrWindow), stub_showDigitalErrWindow);
     stub.set(ADDR(Transaction, error), model_transaction_error);
     stub.set(ADDR(Transaction, errorDetails), stub_Transacton_ErrorDetails_Pass);
     m_debListModel->m_operatingIndex = 0;
-    m_debListModel->m_packageMd5.append("test");
-    m_debListModel->m_packageMd5.append("test1");
-    m_debListModel->m_packagesManager->m_preparedPackages.append(QString("deb"));
-    m_debListModel->m_packagesManager->m_preparedPackages.append(QString("deb1"));
 
     Stub stub1;
     g_transaction = new Transaction("1");
@@ -1049,19 +1114,41 @@ TEST_F(ut_DebListModel_test, onTransactionFinished_HierarchicalVerify_Pass)
 
     m_debListModel->slotTransactionFinished();
     EXPECT_EQ(nullptr, m_debListModel->m_currentTransaction);
-    EXPECT_EQ(QApt::AuthError, m_debListModel->m_packageFailCode[m_debListModel->m_operatingPackageMd5]);
+    EXPECT_EQ(QApt::AuthError, m_debListModel->operatingRecord()->failCode);
     EXPECT_FALSE(m_debListModel->m_hierarchicalVerifyError);
 
     delete g_transaction;
     g_transaction = nullptr;
 }
 
+TEST_F(ut_DebListModel_test, installNextDeb_HierarchicalVerifyFailedBefore_Skip)
+{
+    // Enable hierarchical verify
+    stubHierachicalInvalid.set(ADDR(HierarchicalVerify, isValid), stub_DebListModel_Hierarchical_Valid);
+
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "test");
+    m_debListModel->m_packagesManager->m_packageTable.append("deb1", "test1");
+    stub.set(ADDR(DebListModel, bumpInstallIndex), model_bumpInstallIndex);
+    m_debListModel->m_operatingIndex = 0;
+    m_debListModel->m_operatingStatusIndex = 0;
+    m_debListModel->m_hierarchicalVerifyError = false;
+
+    ASSERT_TRUE(HierarchicalVerify::instance()->checkTransactionError("", "deepin hook exit code:65280", "version", "test"));
+
+    m_debListModel->installNextDeb();
+    EXPECT_EQ(Pkg::DigitalSignatureError, m_debListModel->operatingRecord()->failCode);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Failed, m_debListModel->operatingRecord()->operateStatus);
+    EXPECT_TRUE(m_debListModel->m_hierarchicalVerifyError);
+
+    HierarchicalVerify::instance()->clearVerifyResult();
+}
+
 TEST_F(ut_DebListModel_test, deblistmodel_UT_refreshOperatingPackageStatus)
 {
-    m_debListModel->m_operatingPackageMd5 = "deb";
-    m_debListModel->m_packageOperateStatus.insert("deb", QApt::CommitError);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "deb");
+    m_debListModel->operatingRecord()->operateStatus = QApt::CommitError;
     m_debListModel->refreshOperatingPackageStatus(Pkg::PackageOperationStatus::Failed);
-    EXPECT_EQ(Pkg::PackageOperationStatus::Failed, m_debListModel->m_packageOperateStatus[m_debListModel->m_operatingPackageMd5]);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Failed, m_debListModel->operatingRecord()->operateStatus);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_slotDependsInstallTransactionFinished)
@@ -1072,14 +1159,14 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_slotDependsInstallTransactionFinish
     stub.set(ADDR(DebListModel, bumpInstallIndex), model_installNextDeb);
     stub.set(ADDR(Transaction, error), model_transaction_error);
 
-    m_debListModel->m_operatingPackageMd5 = "deb";
-    m_debListModel->m_packageFailCode.insert("deb", QApt::CommitError);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "deb");
+    m_debListModel->operatingRecord()->failCode = QApt::CommitError;
 
     Stub stub1;
     stub1.set(ADDR(QObject, sender), ut_sender);
     m_debListModel->slotDependsInstallTransactionFinished();
     EXPECT_EQ(nullptr, m_debListModel->m_currentTransaction);
-    EXPECT_EQ(QApt::AuthError, m_debListModel->m_packageFailCode[m_debListModel->m_operatingPackageMd5]);
+    EXPECT_EQ(QApt::AuthError, m_debListModel->operatingRecord()->failCode);
     delete ut_sender();
 }
 
@@ -1096,11 +1183,16 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_slotUpWrongStatusRow)
     stub.set(ADDR(DebListModel, installNextDeb), model_installNextDeb);
     stub.set(ADDR(DebListModel, bumpInstallIndex), model_installNextDeb);
     stub.set(ADDR(Transaction, error), model_transaction_error);
-    m_debListModel->m_packageOperateStatus.insert("key", Pkg::PackageOperationStatus::Failed);
-    m_debListModel->m_packageOperateStatus.insert("key1", Pkg::PackageOperationStatus::Success);
+    PackageTable &table = m_debListModel->m_packagesManager->m_packageTable;
+    table.append("/key1", "key1");
+    table.append("/key", "key");
+    table.recordOf("key")->operateStatus = Pkg::PackageOperationStatus::Failed;
+    table.recordOf("key1")->operateStatus = Pkg::PackageOperationStatus::Success;
     m_debListModel->slotUpWrongStatusRow();
-    EXPECT_EQ(2, m_debListModel->m_packagesManager->m_packageMd5.size());
-    EXPECT_EQ(2, m_debListModel->m_packagesManager->m_preparedPackages.size());
+    EXPECT_EQ(2, table.size());
+    EXPECT_EQ("key", table.md5At(0));
+    EXPECT_EQ("/key", table.filePathAt(0));
+    EXPECT_EQ("key1", table.md5At(1));
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_ConfigInputWrite)
@@ -1115,11 +1207,9 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_onTransactionOutput)
 {
     Stub stub1;
     stub1.set(ADDR(QObject, sender), ut_sender);
-    m_debListModel->m_packageOperateStatus.insert("deb", Pkg::PackageOperationStatus::Prepare);
-    m_debListModel->m_operatingPackageMd5 = "deb";
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "deb");
     m_debListModel->slotTransactionOutput();
-    EXPECT_EQ(Pkg::PackageOperationStatus::Operating,
-              m_debListModel->m_packageOperateStatus[m_debListModel->m_operatingPackageMd5]);
+    EXPECT_EQ(Pkg::PackageOperationStatus::Operating, m_debListModel->operatingRecord()->operateStatus);
     delete ut_sender();
 }
 
@@ -1145,11 +1235,15 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_checkInstallStatus)
     stub.set(ADDR(DebListModel, bumpInstallIndex), model_installNextDeb);
     stub.set(ADDR(DebListModel, refreshOperatingPackageStatus), model_refreshOperatingPackageStatus);
 
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "deb");
+    m_debListModel->operatingRecord()->failCode = QApt::CommitError;
+    m_debListModel->operatingRecord()->failReason = "error";
+
     QString str = "Error executing command as another user: Request dismissed";
     m_debListModel->slotCheckInstallStatus(str);
     EXPECT_EQ(DebListModel::WorkerFinished, m_debListModel->m_workerStatus);
-    EXPECT_EQ(1, m_debListModel->m_packageFailCode.size());
-    EXPECT_EQ(1, m_debListModel->m_packageFailReason.size());
+    EXPECT_EQ(0, m_debListModel->operatingRecord()->failCode);
+    EXPECT_TRUE(m_debListModel->operatingRecord()->failReason.isEmpty());
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_initConnections)
@@ -1163,13 +1257,14 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_slotShowProhibitWindow)
     QStringList list;
     list << "/";
     m_debListModel->slotAppendPackage(list);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.handleAt(0);
     m_debListModel->m_isDevelopMode = true;
     m_debListModel->slotShowProhibitWindow();
-    EXPECT_EQ(1, m_debListModel->m_packageFailCode.size());
+    EXPECT_EQ(Pkg::ApplocationProhibit, m_debListModel->operatingRecord()->failCode);
     m_debListModel->showProhibitWindow();
     m_debListModel->m_operatingIndex = -1;
     m_debListModel->showProhibitWindow();
-    EXPECT_EQ(1, m_debListModel->m_packageFailCode.size());
+    EXPECT_EQ(Pkg::ApplocationProhibit, m_debListModel->operatingRecord()->failCode);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_initAppendConnection)
@@ -1254,9 +1349,10 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_digitalVerifyFailed)
     QStringList list;
     list << "/";
     m_debListModel->slotAppendPackage(list);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.handleAt(0);
     m_debListModel->m_isDevelopMode = true;
     m_debListModel->digitalVerifyFailed(Pkg::ErrorCode::DigitalSignatureError);
-    EXPECT_EQ(1, m_debListModel->m_packageFailCode.size());
+    EXPECT_EQ(Pkg::DigitalSignatureError, m_debListModel->operatingRecord()->failCode);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_slotDigitalSignatureError)
@@ -1265,9 +1361,10 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_slotDigitalSignatureError)
     QStringList list;
     list << "/";
     m_debListModel->slotAppendPackage(list);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.handleAt(0);
     m_debListModel->m_isDevelopMode = true;
     m_debListModel->slotDigitalSignatureError();
-    EXPECT_EQ(1, m_debListModel->m_packageFailCode.size());
+    EXPECT_EQ(Pkg::DigitalSignatureError, m_debListModel->operatingRecord()->failCode);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_slotNoDigitalSignature)
@@ -1275,9 +1372,10 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_slotNoDigitalSignature)
     QStringList list;
     list << "/";
     m_debListModel->slotAppendPackage(list);
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.handleAt(0);
     m_debListModel->m_isDevelopMode = true;
     m_debListModel->slotNoDigitalSignature();
-    EXPECT_EQ(1, m_debListModel->m_packageFailCode.size());
+    EXPECT_EQ(Pkg::NoDigitalSignature, m_debListModel->operatingRecord()->failCode);
 }
 
 TEST_F(ut_DebListModel_test, deblistmodel_UT_isWorkPrepare)
@@ -1285,3 +1383,31 @@ TEST_F(ut_DebListModel_test, deblistmodel_UT_isWorkPrepare)
     m_debListModel->m_workerStatus = DebListModel::WorkerPrepare;
     ASSERT_TRUE(m_debListModel->isWorkerPrepare());
 }
+
+static QList<int> g_resetDependsIndexes;
+void stub_resetPackageDependsStatus(const int index)
+{
+    g_resetDependsIndexes.append(index);
+}
+
+PackageDependsStatus stub_getPackageDependsStatus_Prohibit(const int index)
+{
+    Q_UNUSED(index);
+    PackageDependsStatus status;
+    status.status = Pkg::DependsStatus::Prohibit;
+    return status;
+}
+
+TEST_F(ut_DebListModel_test, collectConfigBatch_ProhibitPackage_StopBatch)
+{
+    g_resetDependsIndexes.clear();
+    stub.set(ADDR(PackagesManager, resetPackageDependsStatus), stub_resetPackageDependsStatus);
+    stub.set(ADDR(PackagesManager, getPackageDependsStatus), stub_getPackageDependsStatus_Prohibit);
+
+    m_debListModel->m_operatingHandle = m_debListModel->m_packagesManager->m_packageTable.append("deb", "test");
+    m_debListModel->m_packagesManager->m_packageTable.append("deb1", "test1");
+    m_debListModel->m_operatingIndex = 0;
+
+    EXPECT_TRUE(m_debListModel->collectConfigBatch().isEmpty());
+    EXPECT_EQ(QList<int>{1}, g_resetDependsIndexes);
+}
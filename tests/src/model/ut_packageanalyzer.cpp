@@ -5,6 +5,8 @@
 #include <gtest/gtest.h>
 #include <QApt/Package>
 #include <QApt/Backend>
+#include <QApt/DependencyInfo>
+#include <QThread>
 #include <stub.h>
 
 #define private public
@@ -78,3 +80,121 @@ TEST_F(ut_packageanalyzer_TEST, PackageAnalyzer_UT_versionMatched)
     result = PackageAnalyzer::instance().versionMatched("1.0", "1.1", QApt::NotEqual);
     ASSERT_EQ(result, true);
 }
+
+// md5 of the fake deb is its base name, "invalid" is filtered
+bool stub_loadDebFile(void *, const QFileInfo &info, bool, DebIr *ir, DdimIndex *, bool *indexed)
+{
+    *indexed = false;
+    if (info.baseName() == "invalid") {
+        return false;
+    }
+    ir->filePath = info.filePath();
+    ir->packageName = info.baseName();
+    ir->md5 = info.baseName().toUtf8();
+    return true;
+}
+
+// the apt backend is not thread safe, the installed filter must run on the calling thread
+static QSet<QThread *> installedFilterThreads;
+bool stub_isInstalledOrLaterVersion(void *, const DebIr &)
+{
+    installedFilterThreads.insert(QThread::currentThread());
+    return false;
+}
+
+TEST_F(ut_packageanalyzer_TEST, PackageAnalyzer_UT_analyzeDebFileGroups)
+{
+    Stub stub;
+    stub.set(ADDR(PackageAnalyzer, loadDebFile), stub_loadDebFile);
+    stub.set(ADDR(PackageAnalyzer, isInstalledOrLaterVersion), stub_isInstalledOrLaterVersion);
+    installedFilterThreads.clear();
+
+    QStringList appNames{"B", "invalid", "C"};
+    auto result = PackageAnalyzer::instance().analyzeDebFileGroups({
+        {{QFileInfo("/tmp/a.deb"), QFileInfo("/tmp/b.deb")}, nullptr, true, true},
+        {{QFileInfo("/tmp/b.deb"), QFileInfo("/tmp/invalid.deb"), QFileInfo("/tmp/c.deb")}, &appNames, false, false},
+        {{QFileInfo("/tmp/a.deb"), QFileInfo("/tmp/d.deb"), QFileInfo("/tmp/d.deb")}, nullptr, true, false},
+    });
+
+    ASSERT_EQ(result.size(), 3);
+    ASSERT_EQ(result[0].size(), 2);
+    EXPECT_EQ(result[0][0].md5, QByteArray("a"));
+    EXPECT_EQ(result[0][1].md5, QByteArray("b"));
+    ASSERT_EQ(result[1].size(), 1);
+    EXPECT_EQ(result[1][0].md5, QByteArray("c"));
+    EXPECT_EQ(appNames, QStringList{"C"});
+    ASSERT_EQ(result[2].size(), 1);
+    EXPECT_EQ(result[2][0].md5, QByteArray("d"));
+    EXPECT_EQ(installedFilterThreads, QSet<QThread *>{QThread::currentThread()});
+}
+
+QList<QApt::DependencyItem> stub_debDependNotInstalled(void *, const DebIr &ir)
+{
+    return ir.depends;
+}
+
+TEST_F(ut_packageanalyzer_TEST, PackageAnalyzer_UT_chooseDebFromDepend)
+{
+    Stub stub;
+    stub.set(ADDR(PackageAnalyzer, debDependNotInstalled), stub_debDependNotInstalled);
+
+    auto makeIr = [](const QString &name, const QString &depends, const QStringList &provides = {}) {
+        DebIr ir;
+        ir.packageName = name;
+        ir.version = "1.0";
+        ir.md5 = name.toUtf8();
+        ir.virtualPackages = provides;
+        ir.depends = QApt::DependencyInfo::parseDepends(depends, QApt::Depends);
+        return ir;
+    };
+
+    // b and c depend on each other, d provides virt
+    QList<DebIr> debIrs{makeIr("b", "c"), makeIr("c", "b (>= 1.0)"), makeIr("d", "", {"virt"}), makeIr("e", "")};
+
+    QList<DebIr> result;
+    QSet<QByteArray> md5s;
+    PackageAnalyzer::instance().chooseDebFromDepend(
+        &result, &md5s, QApt::DependencyInfo::parseDepends("b, notexist | virt", QApt::Depends), debIrs);
+
+    ASSERT_EQ(result.size(), 3);
+    EXPECT_EQ(result[0].packageName, QString("c"));
+    EXPECT_EQ(result[1].packageName, QString("b"));
+    EXPECT_EQ(result[2].packageName, QString("d"));
+}
+
+TEST_F(ut_packageanalyzer_TEST, PackageAnalyzer_UT_installOrder)
+{
+    auto makeIr = [](const QString &name, const QString &depends, const QString &preDepends = {}) {
+        DebIr ir;
+        ir.packageName = name;
+        ir.version = "1.0";
+        ir.md5 = name.toUtf8();
+        ir.depends = QApt::DependencyInfo::parseDepends(depends, QApt::Depends);
+        ir.preDepends = QApt::DependencyInfo::parseDepends(preDepends, QApt::PreDepends);
+        return ir;
+    };
+
+    // a -> b, b <-> c (b pre-depends c), e -> d
+    const QList<DebIr> irs{makeIr("a", "b"), makeIr("e", "d"), makeIr("b", "", "c"), makeIr("c", "b"), makeIr("d", "")};
+    const auto order = PackageAnalyzer::instance().installOrder(irs);
+
+    auto names = [](const QList<DebIr> &list) {
+        QStringList result;
+        for (const auto &ir : list) {
+            result.append(ir.packageName);
+        }
+        return result;
+    };
+
+    EXPECT_EQ(names(order), QStringList({"c", "d", "e", "b", "a"}));
+
+    // same input, same order
+    EXPECT_EQ(names(PackageAnalyzer::instance().installOrder(irs)), names(order));
+
+    // independent chains share the layers, the pre-depends target is a layer earlier.
+    const auto layers = PackageAnalyzer::instance().installLayers(irs);
+    ASSERT_EQ(layers.size(), 3);
+    EXPECT_EQ(names(layers[0]), QStringList({"c", "d"}));
+    EXPECT_EQ(names(layers[1]), QStringList({"e", "b"}));
+    EXPECT_EQ(names(layers[2]), QStringList({"a"}));
+}
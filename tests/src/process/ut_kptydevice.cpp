@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/process/kptydevice.h"
+
+TEST(ut_kptydevice_Test, ringBufferChunkedReserve)
+{
+    KRingBuffer buffer;
+    QByteArray written;
+
+    // write several chunks worth of data in uneven pieces
+    for (int round = 0; round < 64; ++round) {
+        int left = 1000 + round * 97;
+        while (left > 0) {
+            int reserved = 0;
+            char *ptr = buffer.reserveInChunk(left, &reserved);
+            ASSERT_GT(reserved, 0);
+            ASSERT_LE(reserved, CHUNKSIZE);
+            for (int i = 0; i < reserved; ++i) {
+                ptr[i] = static_cast<char>('a' + written.size() % 26);
+                written.append(ptr[i]);
+            }
+            left -= reserved;
+        }
+    }
+    EXPECT_EQ(buffer.size(), written.size());
+
+    QByteArray read(written.size(), '\0');
+    int readBytes = 0;
+    while (!buffer.isEmpty()) {
+        readBytes += buffer.read(read.data() + readBytes, 3000);
+    }
+    EXPECT_EQ(read, written);
+    EXPECT_EQ(buffer.size(), 0);
+}
+
+TEST(ut_kptydevice_Test, readHighWaterMark)
+{
+    KPtyDevice device;
+    device.setReadHighWaterMark(1);
+    EXPECT_EQ(device.readHighWaterMark(), CHUNKSIZE);
+
+    device.setReadHighWaterMark(1024 * 1024);
+    EXPECT_EQ(device.readHighWaterMark(), 1024 * 1024);
+}
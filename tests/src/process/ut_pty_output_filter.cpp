@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/process/pty_output_filter.h"
+
+using Konsole::PtyOutputFilter;
+
+static PtyOutputFilter::Action filter(const QByteArray &data, QByteArray *rewritten)
+{
+    return PtyOutputFilter::filter(data.constData(), data.size(), rewritten);
+}
+
+TEST(ut_pty_output_filter_Test, passCommonOutput)
+{
+    QByteArray rewritten;
+    EXPECT_EQ(filter("Unpacking deepin-editor (6.5.2) over (6.5.1) ...\r\n", &rewritten), PtyOutputFilter::Pass);
+    EXPECT_EQ(filter("Progress: [ 42%] [*****.....]\r", &rewritten), PtyOutputFilter::Pass);
+    EXPECT_EQ(filter("\xC2", &rewritten), PtyOutputFilter::Pass);
+}
+
+TEST(ut_pty_output_filter_Test, dropZmodemOutput)
+{
+    QByteArray rewritten;
+    EXPECT_EQ(filter("bash: **0800000000022d\xEF\xBC\x9A", &rewritten), PtyOutputFilter::Drop);
+    EXPECT_EQ(filter("**\x18" "B0800000000022d\r\xC2\x8A", &rewritten), PtyOutputFilter::Drop);
+    EXPECT_EQ(filter("**^XB0800000000022d", &rewritten), PtyOutputFilter::Drop);
+    EXPECT_EQ(filter("bash: $'\\212': command not found", &rewritten), PtyOutputFilter::Drop);
+}
+
+TEST(ut_pty_output_filter_Test, rewriteOutput)
+{
+    QByteArray rewritten;
+    ASSERT_EQ(filter("a\xC2\x8A" "b", &rewritten), PtyOutputFilter::Rewrite);
+    EXPECT_EQ(rewritten, QByteArray("a\b \b #b"));
+
+    ASSERT_EQ(filter("rz waiting to receive.", &rewritten), PtyOutputFilter::Rewrite);
+    EXPECT_EQ(rewritten, QByteArray("rz waiting to receive.\r\n"));
+}
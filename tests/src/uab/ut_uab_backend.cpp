@@ -5,6 +5,13 @@
 #include <gtest/gtest.h>
 
 #include <QDebug>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTimer>
+
+#include <cstring>
+
+#include <elf.h>
 
 #include "../stub.h"
 
@@ -95,10 +102,10 @@ TEST_F(utDebBackend, sortPackagesNormalSuccess)
 TEST_F(utDebBackend, findPackageContainFind)
 {
     Uab::UabBackend *insPtr = Uab::UabBackend::instance();
-    insPtr->m_packageList.clear();
-
-    initDataSet(insPtr->m_packageList);
-    Uab::UabBackend::sortPackages(insPtr->m_packageList);
+    QList<Uab::UabPkgInfo::Ptr> pkgList;
+    initDataSet(pkgList);
+    Uab::UabBackend::sortPackages(pkgList);
+    insPtr->backendInitData(pkgList, {});
 
     auto findPtr = insPtr->findPackage("com.deepin.pkg1");
     ASSERT_FALSE(findPtr.isNull());
@@ -119,11 +126,78 @@ TEST_F(utDebBackend, findPackageContainFind)
 TEST_F(utDebBackend, findPackageNotContainNotFind)
 {
     Uab::UabBackend *insPtr = Uab::UabBackend::instance();
-    insPtr->m_packageList.clear();
+    insPtr->m_packageIndex.clear();
 
     EXPECT_TRUE(insPtr->findPackage("test").isNull());
 }
 
+TEST_F(utDebBackend, packageInstalledAndRemovedKeepOrder)
+{
+    Uab::UabBackend *insPtr = Uab::UabBackend::instance();
+    QList<Uab::UabPkgInfo::Ptr> pkgList;
+    initDataSet(pkgList);
+    Uab::UabBackend::sortPackages(pkgList);
+    insPtr->backendInitData(pkgList, {});
+
+    insPtr->packageInstalled(createPtr("com.deepin.pkg1", "1.0.3"));
+    insPtr->packageInstalled(createPtr("com.deepin.pkg3", "1.0.0"));
+    EXPECT_EQ(insPtr->findPackage("com.deepin.pkg1")->version, QString("1.0.3"));
+    EXPECT_FALSE(insPtr->findPackage("com.deepin.pkg3").isNull());
+
+    insPtr->packageRemoved(createPtr("com.deepin.pkg1", "1.0.3"));
+    insPtr->packageRemoved(createPtr("com.deepin.pkg3", "1.0.0"));
+    EXPECT_EQ(insPtr->findPackage("com.deepin.pkg1")->version, QString("1.0.2"));
+    EXPECT_FALSE(insPtr->findPackage("com.deepin.pkg1", "1.0.1").isNull());
+    EXPECT_TRUE(insPtr->findPackage("com.deepin.pkg3").isNull());
+
+    const QList<Uab::UabPkgInfo::Ptr> list = insPtr->packageList();
+    ASSERT_EQ(list.size(), pkgList.size());
+    for (int i = 0; i < list.size(); ++i) {
+        EXPECT_EQ(list[i]->id, pkgList[i]->id);
+        EXPECT_EQ(list[i]->version, pkgList[i]->version);
+    }
+}
+
+TEST_F(utDebBackend, packageInstalledSnapshotDelayed)
+{
+    Uab::UabBackend *insPtr = Uab::UabBackend::instance();
+    insPtr->backendInitData({}, {});
+
+    // the snapshot is written once after consecutive changes, or flushed at the end of the batch.
+    insPtr->packageInstalled(createPtr("com.deepin.pkg1", "1.0.0"));
+    insPtr->packageInstalled(createPtr("com.deepin.pkg2", "1.0.0"));
+    EXPECT_TRUE(insPtr->m_snapshotTimer->isActive());
+
+    insPtr->flushSnapshot();
+    EXPECT_FALSE(insPtr->m_snapshotTimer->isActive());
+
+    insPtr->packageRemoved(createPtr("com.deepin.pkg1", "1.0.0"));
+    insPtr->packageRemoved(createPtr("com.deepin.pkg2", "1.0.0"));
+    insPtr->flushSnapshot();
+}
+
+TEST_F(utDebBackend, snapshotValidatedByFingerprint)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString snapshotPath = dir.filePath("snapshot.json");
+
+    QList<Uab::UabPkgInfo::Ptr> pkgList;
+    initDataSet(pkgList);
+    pkgList.first()->architecture = QStringList{"x86_64"};
+    ASSERT_TRUE(Uab::UabBackend::saveSnapshot(snapshotPath, "state:1", pkgList));
+
+    QList<Uab::UabPkgInfo::Ptr> loadList;
+    ASSERT_TRUE(Uab::UabBackend::loadSnapshot(snapshotPath, "state:1", loadList));
+    ASSERT_EQ(loadList.size(), pkgList.size());
+    EXPECT_EQ(loadList.first()->id, pkgList.first()->id);
+    EXPECT_EQ(loadList.first()->version, pkgList.first()->version);
+    EXPECT_EQ(loadList.first()->architecture, QStringList{"x86_64"});
+
+    EXPECT_FALSE(Uab::UabBackend::loadSnapshot(snapshotPath, "state:2", loadList));
+    EXPECT_FALSE(Uab::UabBackend::loadSnapshot(snapshotPath, QString(), loadList));
+}
+
 TEST_F(utDebBackend, packageFromMetaJsonNormalSuccess)
 {
     Uab::UabBackend *insPtr = Uab::UabBackend::instance();
@@ -139,3 +213,84 @@ TEST_F(utDebBackend, packageFromMetaJsonNormalSuccess)
     QStringList cmpArch { "x86_64" };
     EXPECT_EQ(uabPtr->architecture, cmpArch);
 }
+
+// minimal ELF file: header, section names, meta section, section header table
+static QByteArray createElfWithMeta(const QByteArray &meta)
+{
+    const QByteArray names = QByteArray("\0.shstrtab\0linglong.meta\0", 25);
+
+    Elf64_Ehdr ehdr;
+    ::memset(&ehdr, 0, sizeof(ehdr));
+    ::memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+    ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_type = ET_EXEC;
+    ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr.e_shentsize = sizeof(Elf64_Shdr);
+    ehdr.e_shnum = 3;
+    ehdr.e_shstrndx = 1;
+    ehdr.e_shoff = sizeof(Elf64_Ehdr) + names.size() + meta.size();
+
+    Elf64_Shdr shdrs[3];
+    ::memset(shdrs, 0, sizeof(shdrs));
+    shdrs[1].sh_name = 1;
+    shdrs[1].sh_type = SHT_STRTAB;
+    shdrs[1].sh_offset = sizeof(Elf64_Ehdr);
+    shdrs[1].sh_size = names.size();
+    shdrs[2].sh_name = 11;
+    shdrs[2].sh_type = SHT_PROGBITS;
+    shdrs[2].sh_offset = sizeof(Elf64_Ehdr) + names.size();
+    shdrs[2].sh_size = meta.size();
+
+    QByteArray elf(reinterpret_cast<const char *>(&ehdr), sizeof(ehdr));
+    elf.append(names);
+    elf.append(meta);
+    elf.append(reinterpret_cast<const char *>(shdrs), sizeof(shdrs));
+    return elf;
+}
+
+TEST_F(utDebBackend, uabMetaSectionReadWithoutExecute)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString uabPath = dir.filePath("test.uab");
+    QFile uabFile(uabPath);
+    ASSERT_TRUE(uabFile.open(QIODevice::WriteOnly));
+    uabFile.write(createElfWithMeta(kUabJsonDataExample + QByteArray(4, '\0')));
+    uabFile.close();
+
+    QString error;
+    EXPECT_EQ(Uab::UabBackend::uabMetaSection(uabPath, &error), kUabJsonDataExample);
+    EXPECT_TRUE(error.isEmpty());
+
+    Uab::UabBackend *insPtr = Uab::UabBackend::instance();
+    insPtr->m_supportArchSet.clear();
+    insPtr->m_supportArchSet.insert("x86_64");
+
+    auto uabPtr = Uab::UabBackend::packageFromMetaData(uabPath);
+    ASSERT_FALSE(uabPtr.isNull());
+    EXPECT_EQ(uabPtr->id, QString("org.dde.calendar"));
+    EXPECT_EQ(uabPtr->filePath, uabPath);
+
+    // memoized result is a copy
+    uabPtr->id = "modified";
+    auto cachedPtr = Uab::UabBackend::packageFromMetaData(uabPath);
+    ASSERT_FALSE(cachedPtr.isNull());
+    EXPECT_EQ(cachedPtr->id, QString("org.dde.calendar"));
+}
+
+TEST_F(utDebBackend, uabMetaSectionNotElf)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString filePath = dir.filePath("test.uab");
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("#!/bin/sh\necho not a uab\n");
+    file.close();
+
+    QString error;
+    EXPECT_TRUE(Uab::UabBackend::uabMetaSection(filePath, &error).isEmpty());
+    EXPECT_FALSE(error.isEmpty());
+}
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QList>
+
+#include "../deb-installer/uab/uab_output_framer.h"
+
+class utUabOutputFramer : public ::testing::Test
+{
+protected:
+    void feed(const QByteArray &data, int chunkSize)
+    {
+        for (int i = 0; i < data.size(); i += chunkSize) {
+            framer.feed(data.constData() + i, qMin(chunkSize, data.size() - i), [this](const Uab::UabOutputFramer::Record &record) {
+                records.append(record);
+            });
+        }
+    }
+
+    Uab::UabOutputFramer framer;
+    QList<Uab::UabOutputFramer::Record> records;
+};
+
+static const QByteArray kOutputExample{"[\r\n"
+                                       "    {\r\n"
+                                       "        \"message\": \"prepare for installing uab\",\r\n"
+                                       "        \"percentage\": \"10\",\r\n"
+                                       "        \"state\": \"preInstall\"\r\n"
+                                       "    }\r\n"
+                                       "]\r\n"
+                                       "{\"percentage\":\"20\",\"extra\":{\"list\":[1,\"}\"]}}"
+                                       "{\"code\":-1,\"message\":\"layer \\\"main\\\" exists.\\n\"}"};
+
+TEST_F(utUabOutputFramer, splitRecords)
+{
+    feed(kOutputExample, 3);
+
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_TRUE(records[0].hasPercentage);
+    EXPECT_FLOAT_EQ(records[0].percentage, 10);
+    EXPECT_EQ(records[0].state, QString("preInstall"));
+    EXPECT_EQ(records[0].message, QString("prepare for installing uab"));
+
+    EXPECT_TRUE(records[1].hasPercentage);
+    EXPECT_FLOAT_EQ(records[1].percentage, 20);
+
+    EXPECT_FALSE(records[2].hasPercentage);
+    EXPECT_TRUE(records[2].hasCode);
+    EXPECT_EQ(records[2].code, -1);
+    EXPECT_EQ(records[2].message, QString("layer \"main\" exists.\n"));
+}
+
+TEST_F(utUabOutputFramer, coalescedRecords)
+{
+    feed(kOutputExample, kOutputExample.size());
+
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_FLOAT_EQ(records[1].percentage, 20);
+    EXPECT_EQ(records[2].code, -1);
+}
+
+TEST_F(utUabOutputFramer, rawProgress)
+{
+    feed("\r\x1B[K\x1B[?25l42% prepare for installing uab, 50% ignored\x1B[?25h\n", 5);
+
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_TRUE(records[0].hasPercentage);
+    EXPECT_FLOAT_EQ(records[0].percentage, 42);
+}
+
+TEST_F(utUabOutputFramer, resetDropsPartialRecord)
+{
+    feed("{\"percentage\":\"30\"", 64);
+    framer.reset();
+    feed("{\"percentage\":\"40\"}", 64);
+
+    ASSERT_EQ(records.size(), 1);
+    EXPECT_FLOAT_EQ(records[0].percentage, 40);
+}
@@ -39,7 +39,7 @@ bool stub_isValid_true()
     return true;
 }
 
-bool stub_installBackendCliImpl_true(const Uab::UabPackage::Ptr &)
+bool stub_installBackendCliImpl_true(Konsole::Pty *, const Uab::UabPackage::Ptr &)
 {
     return true;
 }
@@ -59,3 +59,112 @@ TEST_F(utDebProcessController, installExecSuccess)
 
     EXPECT_TRUE(uabController.m_procFlag.testFlag(Uab::UabProcessController::Processing));
 }
+
+bool stub_installCliImpl_true(Konsole::Pty *, const Uab::UabPackage::Ptr &)
+{
+    return true;
+}
+
+void stub_commitChangeToBackend(int) {}
+
+Uab::UabPackage::Ptr createUabPackage(const QString &id, const QString &version)
+{
+    auto infoPtr = Uab::UabPkgInfo::Ptr::create();
+    infoPtr->id = id;
+    infoPtr->version = version;
+    infoPtr->filePath = "localtest";
+    return Uab::UabPackage::fromInfo(infoPtr);
+}
+
+TEST_F(utDebProcessController, concurrentTasksScheduled)
+{
+    Stub s;
+    s.set(ADDR(Uab::UabPackage, isValid), stub_isValid_true);
+    s.set(ADDR(Uab::UabProcessController, installCliImpl), stub_installCliImpl_true);
+    s.set(ADDR(Uab::UabProcessController, commitChangeToBackend), stub_commitChangeToBackend);
+
+    Uab::UabProcessController uabController;
+    uabController.setProcessType(Uab::UabProcessController::DirectCli);
+    uabController.setMaxConcurrency(2);
+    uabController.reset();
+    uabController.markInstall(createUabPackage("org.deepin.pkg1", "1.0.0"));
+    uabController.markInstall(createUabPackage("org.deepin.pkg1", "1.0.1"));
+    uabController.markInstall(createUabPackage("org.deepin.pkg2", "1.0.0"));
+    uabController.markInstall(createUabPackage("org.deepin.pkg3", "1.0.0"));
+
+    int finishedCount = 0;
+    bool finishedSuccess = true;
+    QObject::connect(&uabController, &Uab::UabProcessController::processFinished, [&](bool success) {
+        finishedCount++;
+        finishedSuccess = success;
+    });
+
+    ASSERT_TRUE(uabController.commitChanges());
+    // the same package id runs in order
+    EXPECT_EQ(uabController.runningCount(), 2);
+    EXPECT_EQ(uabController.m_procList[0].state, Uab::UabProcessController::TaskRunning);
+    EXPECT_EQ(uabController.m_procList[1].state, Uab::UabProcessController::TaskPending);
+    EXPECT_EQ(uabController.m_procList[2].state, Uab::UabProcessController::TaskRunning);
+
+    // failed task skips the later tasks of the same id
+    uabController.onFinished(0, Uab::UabError);
+    EXPECT_EQ(uabController.m_procList[1].state, Uab::UabProcessController::TaskSkipped);
+    EXPECT_EQ(uabController.m_procList[3].state, Uab::UabProcessController::TaskRunning);
+
+    uabController.onFinished(2, Uab::UabSuccess);
+    uabController.onFinished(3, Uab::UabSuccess);
+    EXPECT_EQ(uabController.runningCount(), 0);
+    EXPECT_EQ(finishedCount, 1);
+    EXPECT_FALSE(finishedSuccess);
+}
+
+TEST_F(utDebProcessController, backendFailureRunsNextTask)
+{
+    Stub s;
+    s.set(ADDR(Uab::UabPackage, isValid), stub_isValid_true);
+    s.set(ADDR(Uab::UabProcessController, installBackendCliImpl), stub_installBackendCliImpl_true);
+    s.set(ADDR(Uab::UabProcessController, commitChangeToBackend), stub_commitChangeToBackend);
+
+    Uab::UabProcessController uabController;
+    uabController.setMaxConcurrency(2);
+    uabController.reset();
+    uabController.markInstall(createUabPackage("org.deepin.pkg1", "1.0.0"));
+    uabController.markInstall(createUabPackage("org.deepin.pkg2", "1.0.0"));
+    uabController.markInstall(createUabPackage("org.deepin.pkg3", "1.0.0"));
+
+    ASSERT_TRUE(uabController.commitChanges());
+    EXPECT_EQ(uabController.runningCount(), 1);
+
+    // a broken package is not an authorization failure, keep serial and run the next one
+    uabController.onFinished(0, Uab::UabError);
+    EXPECT_EQ(uabController.m_procList[0].state, Uab::UabProcessController::TaskFailed);
+    EXPECT_EQ(uabController.m_procList[1].state, Uab::UabProcessController::TaskRunning);
+    EXPECT_EQ(uabController.m_procList[2].state, Uab::UabProcessController::TaskPending);
+    EXPECT_EQ(uabController.runningCount(), 1);
+
+    // authorization dismissed, skip the rest
+    uabController.onFinished(1, 126);
+    EXPECT_EQ(uabController.m_procList[2].state, Uab::UabProcessController::TaskSkipped);
+    EXPECT_EQ(uabController.runningCount(), 0);
+}
+
+TEST_F(utDebProcessController, uninstallErrorSetOnRowPackage)
+{
+    Stub s;
+    s.set(ADDR(Uab::UabPackage, isValid), stub_isValid_true);
+
+    Uab::UabProcessController uabController;
+    auto oldPtr = createUabPackage("org.deepin.pkg1", "1.0.0");
+    auto rowPtr = createUabPackage("org.deepin.pkg1", "1.0.1");
+    ASSERT_TRUE(uabController.markUninstall(oldPtr, rowPtr));
+
+    // the error of removing the old version is shown on the row of the new version
+    Uab::UabOutputFramer::Record record;
+    record.hasCode = true;
+    record.code = Uab::UabError;
+    record.message = "remove failed";
+    uabController.onOutputRecord(0, record);
+
+    EXPECT_EQ(rowPtr->processError(), QString("remove failed"));
+    EXPECT_TRUE(oldPtr->processError().isEmpty());
+}
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/utils/deb_file_walker.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <mutex>
+
+static void touchFile(const QString &path)
+{
+    QFile file(path);
+    file.open(QIODevice::WriteOnly);
+    file.close();
+}
+
+class ut_deb_file_walker_Test : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(dir.isValid());
+        QDir root(dir.path());
+        root.mkpath("Softwares/b");
+        root.mkpath("Softwares/A/sub");
+        root.mkpath("Softwares/.hidden");
+        root.mkpath("Depends");
+
+        touchFile(dir.filePath("Softwares/c.deb"));
+        touchFile(dir.filePath("Softwares/b/b.deb"));
+        touchFile(dir.filePath("Softwares/A/a.deb"));
+        touchFile(dir.filePath("Softwares/A/sub/z.deb"));
+        touchFile(dir.filePath("Softwares/A/readme.txt"));
+        touchFile(dir.filePath("Softwares/.hidden/h.deb"));
+        touchFile(dir.filePath("Depends/d.deb"));
+
+        // directory symlink loop
+        QFile::link(dir.filePath("Softwares"), dir.filePath("Softwares/b/loop"));
+    }
+
+    QTemporaryDir dir;
+};
+
+TEST_F(ut_deb_file_walker_Test, walkOrderedPerRoot)
+{
+    DebFileWalker walker;
+    const QList<QStringList> result = walker.walk({dir.filePath("Softwares"), dir.filePath("Depends"), dir.filePath("Updates")});
+
+    ASSERT_EQ(result.size(), 3);
+    EXPECT_EQ(result[0],
+              QStringList({dir.filePath("Softwares/A/a.deb"),
+                           dir.filePath("Softwares/A/sub/z.deb"),
+                           dir.filePath("Softwares/b/b.deb"),
+                           dir.filePath("Softwares/c.deb")}));
+    EXPECT_EQ(result[1], QStringList({dir.filePath("Depends/d.deb")}));
+    EXPECT_TRUE(result[2].isEmpty());
+}
+
+TEST_F(ut_deb_file_walker_Test, foundCallback)
+{
+    std::mutex mutex;
+    QStringList found;
+    DebFileWalker walker([&](const QString &debPath) {
+        std::lock_guard<std::mutex> guard(mutex);
+        found.append(debPath);
+    });
+
+    const QList<QStringList> result = walker.walk({dir.filePath("Softwares")});
+    ASSERT_EQ(result.size(), 1);
+
+    found.sort();
+    QStringList expected = result[0];
+    expected.sort();
+    EXPECT_EQ(found, expected);
+}
@@ -21,6 +21,8 @@ protected:
 void ut_HierarchicalVerify_TEST::SetUp()
 {
     HierarchicalVerify::instance()->interfaceInvalid = false;
+    HierarchicalVerify::instance()->probing = false;
+    HierarchicalVerify::instance()->valid = false;
 }
 
 void ut_HierarchicalVerify_TEST::TearDown()
@@ -62,40 +64,38 @@ TEST_F(ut_HierarchicalVerify_TEST, isValid_NoInterface_False)
 TEST_F(ut_HierarchicalVerify_TEST, checkTransactionError_TestRegExp_True)
 {
     auto hVerify = HierarchicalVerify::instance();
-    ASSERT_TRUE(hVerify->checkTransactionError("pkg", "deepinhook65280"));
-    ASSERT_TRUE(hVerify->checkTransactionError("pkg", "\r\ndeepindeehook+++65280\n"));
-    ASSERT_TRUE(hVerify->checkTransactionError("pkg2", "deepinhookhook65280"));
-    ASSERT_TRUE(hVerify->checkTransactionError("pkg2", "Error:deepin hook exit code 65280"));
+    ASSERT_TRUE(hVerify->checkTransactionError("pkg", "deepinhook65280", "1.0", "md5"));
+    ASSERT_TRUE(hVerify->checkTransactionError("pkg", "\r\ndeepindeehook+++65280\n", "1.0", "md5"));
+    ASSERT_TRUE(hVerify->checkTransactionError("pkg2", "deepinhookhook65280", "1.0", "md5"));
+    ASSERT_TRUE(hVerify->checkTransactionError("pkg2", "Error:deepin hook exit code 65280", "1.0", "md5"));
 
     // 1071 调整错误码为 256
-    ASSERT_TRUE(hVerify->checkTransactionError("pkg2", "deepinhookhook256"));
-    ASSERT_TRUE(hVerify->checkTransactionError("pkg2", "Error:deepin hook exit code 256"));
-    ASSERT_TRUE(hVerify->checkTransactionError("pkg2",
-                                               "执行钩子 if test -x /usr/sbin/deepin-pkg-install-hook;then /usr/sbin/deepin-pkg "
-                                               "install-hook -e hc-verifysign;fi 出错，退出状态为 256"));
-
-    QSet<QString> pkgSet{"pkg", "pkg2"};
-    ASSERT_EQ(hVerify->invalidPackages, pkgSet);
+    ASSERT_TRUE(HierarchicalVerify::isVerifyError("deepinhookhook256"));
+    ASSERT_TRUE(HierarchicalVerify::isVerifyError("Error:deepin hook exit code 256"));
+    ASSERT_TRUE(HierarchicalVerify::isVerifyError("执行钩子 if test -x /usr/sbin/deepin-pkg-install-hook;then /usr/sbin/deepin-pkg "
+                                                  "install-hook -e hc-verifysign;fi 出错，退出状态为 256"));
+
+    ASSERT_EQ(hVerify->invalidPackages.size(), 2);
+    ASSERT_FALSE(hVerify->pkgVerifyPassed("pkg", "1.0", "md5"));
+    ASSERT_FALSE(hVerify->pkgVerifyPassed("pkg2", "1.0", "md5"));
 }
 
 TEST_F(ut_HierarchicalVerify_TEST, checkTransactionError_TestRegExp_False)
 {
     auto hVerify = HierarchicalVerify::instance();
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg", ""));
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg", "deepihoo65280"));
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg", "\r\ndeepin\ndeehook+++65280\n"));
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg2", "deepinh-ookh-ook65280"));
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg2", "Error:deepin hook \n exit code 65280"));
+    ASSERT_FALSE(hVerify->checkTransactionError("pkg", "", "1.0", "md5"));
+    ASSERT_FALSE(hVerify->checkTransactionError("pkg", "deepihoo65280", "1.0", "md5"));
+    ASSERT_FALSE(hVerify->checkTransactionError("pkg", "\r\ndeepin\ndeehook+++65280\n", "1.0", "md5"));
+    ASSERT_FALSE(hVerify->checkTransactionError("pkg2", "deepinh-ookh-ook65280", "1.0", "md5"));
+    ASSERT_FALSE(hVerify->checkTransactionError("pkg2", "Error:deepin hook \n exit code 65280", "1.0", "md5"));
 
     // 1071 调整错误码为 256
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg2", "deepinhookhook25"));
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg2", "Error:deepin hook exit code 255"));
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg2",
-                                                "执行钩子 if test -x /usr/sbin/deepin-pkg-install-hook;then /usr/sbin/deepin-pkg "
-                                                "install-hook -e hc-verifysign;fi 出错，退出状态为 \n测试代码"));
-    ASSERT_FALSE(hVerify->checkTransactionError("pkg2",
-                                                "执行钩子 if test -x /usr/sbin/deepin-pkg-install-hook;then /usr/sbin/deepin-pkg "
-                                                "install-hook -e hc-verifysign;fi 出错，退出状态为 xxx"));
+    ASSERT_FALSE(HierarchicalVerify::isVerifyError("deepinhookhook25"));
+    ASSERT_FALSE(HierarchicalVerify::isVerifyError("Error:deepin hook exit code 255"));
+    ASSERT_FALSE(HierarchicalVerify::isVerifyError("执行钩子 if test -x /usr/sbin/deepin-pkg-install-hook;then /usr/sbin/deepin-pkg "
+                                                   "install-hook -e hc-verifysign;fi 出错，退出状态为 \n测试代码"));
+    ASSERT_FALSE(HierarchicalVerify::isVerifyError("执行钩子 if test -x /usr/sbin/deepin-pkg-install-hook;then /usr/sbin/deepin-pkg "
+                                                   "install-hook -e hc-verifysign;fi 出错，退出状态为 xxx"));
 
     ASSERT_TRUE(hVerify->invalidPackages.isEmpty());
 }
@@ -103,12 +103,72 @@ TEST_F(ut_HierarchicalVerify_TEST, checkTransactionError_TestRegExp_False)
 TEST_F(ut_HierarchicalVerify_TEST, verifyResult_Store_True)
 {
     auto hVerify = HierarchicalVerify::instance();
-    hVerify->invalidPackages.insert("deb");
+    ASSERT_TRUE(hVerify->checkTransactionError("deb", "deepinhook65280", "1.0", "md5"));
 
     // Passed when not contains invalid package name.
-    ASSERT_TRUE(hVerify->pkgVerifyPassed(""));
-    ASSERT_FALSE(hVerify->pkgVerifyPassed("deb"));
+    ASSERT_TRUE(hVerify->pkgVerifyPassed("", "1.0", "md5"));
+    ASSERT_FALSE(hVerify->pkgVerifyPassed("deb", "1.0", "md5"));
 
     hVerify->clearVerifyResult();
-    ASSERT_TRUE(hVerify->pkgVerifyPassed("deb"));
+    ASSERT_TRUE(hVerify->pkgVerifyPassed("deb", "1.0", "md5"));
+}
+
+TEST_F(ut_HierarchicalVerify_TEST, verifyResult_KeyByVersionAndMd5_True)
+{
+    auto hVerify = HierarchicalVerify::instance();
+    ASSERT_TRUE(hVerify->checkTransactionError("deb", "deepinhook65280", "1.0", "md5-1"));
+
+    ASSERT_FALSE(hVerify->pkgVerifyPassed("deb", "1.0", "md5-1"));
+    // Other build of the same package is not affected.
+    ASSERT_TRUE(hVerify->pkgVerifyPassed("deb", "1.0", "md5-2"));
+    ASSERT_TRUE(hVerify->pkgVerifyPassed("deb", "1.1", "md5-1"));
+}
+
+TEST_F(ut_HierarchicalVerify_TEST, verifyResult_Expired_True)
+{
+    auto hVerify = HierarchicalVerify::instance();
+    ASSERT_TRUE(hVerify->checkTransactionError("deb", "deepinhook65280", "1.0", "md5"));
+
+    // Expire the stored result.
+    for (auto itr = hVerify->invalidPackages.begin(); itr != hVerify->invalidPackages.end(); ++itr) {
+        itr.value() = 0;
+    }
+    ASSERT_TRUE(hVerify->pkgVerifyPassed("deb", "1.0", "md5"));
+    ASSERT_TRUE(hVerify->invalidPackages.isEmpty());
+}
+
+TEST_F(ut_HierarchicalVerify_TEST, interfaceReply_UpdateValid_True)
+{
+    auto hVerify = HierarchicalVerify::instance();
+    hVerify->valid = false;
+    QSignalSpy spy(hVerify, &HierarchicalVerify::validChanged);
+
+    hVerify->probing = true;
+    hVerify->onInterfaceReply(true);
+    ASSERT_FALSE(hVerify->probing);
+    ASSERT_TRUE(hVerify->isValid());
+    ASSERT_EQ(spy.count(), 1);
+
+    // Transient error keeps querying the interface later.
+    hVerify->onInterfaceError(QDBusError(QDBusError::Timeout, "timeout"));
+    ASSERT_FALSE(hVerify->valid);
+    ASSERT_FALSE(hVerify->interfaceInvalid);
+    ASSERT_EQ(spy.count(), 2);
+
+    hVerify->onInterfaceError(QDBusError(QDBusError::ServiceUnknown, "unknown"));
+    ASSERT_TRUE(hVerify->interfaceInvalid);
+    ASSERT_FALSE(hVerify->isValid());
+}
+
+TEST_F(ut_HierarchicalVerify_TEST, isProbing_ReplyNotify_True)
+{
+    auto hVerify = HierarchicalVerify::instance();
+    QSignalSpy spy(hVerify, &HierarchicalVerify::interfaceProbed);
+
+    hVerify->probing = true;
+    ASSERT_TRUE(hVerify->isProbing());
+
+    hVerify->onInterfaceReply(true);
+    ASSERT_FALSE(hVerify->isProbing());
+    ASSERT_EQ(spy.count(), 1);
 }
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/utils/metrics.h"
+#include "../deb-installer/utils/trace.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+class ut_metrics_Test : public ::testing::Test
+{
+protected:
+    void SetUp() override { Metrics::Registry::instance()->reset(); }
+
+    void TearDown() override { Metrics::Registry::instance()->reset(); }
+};
+
+TEST_F(ut_metrics_Test, counterAdd)
+{
+    Metrics::add(Metrics::PackagesAppended);
+    Metrics::add(Metrics::HashedBytes, 1024);
+    Metrics::add(Metrics::HashedBytes, 1024);
+
+    EXPECT_EQ(Metrics::Registry::instance()->value(Metrics::PackagesAppended), 1u);
+    EXPECT_EQ(Metrics::Registry::instance()->value(Metrics::HashedBytes), 2048u);
+    EXPECT_EQ(Metrics::Registry::instance()->value(Metrics::Transactions), 0u);
+}
+
+TEST_F(ut_metrics_Test, histogramBuckets)
+{
+    Metrics::Registry *registry = Metrics::Registry::instance();
+    registry->observe(Metrics::TransactionSeconds, 0.002);
+    registry->observe(Metrics::TransactionSeconds, 2);
+    registry->observe(Metrics::TransactionSeconds, 1000);
+    registry->observe(Metrics::NoHistogram, 1);
+
+    EXPECT_EQ(registry->observedCount(Metrics::TransactionSeconds), 3u);
+
+    const QString text = registry->toPrometheusText();
+    EXPECT_TRUE(text.contains("# TYPE deepin_deb_installer_transaction_seconds histogram"));
+    EXPECT_TRUE(text.contains("deepin_deb_installer_transaction_seconds_bucket{le=\"0.001\"} 0\n"));
+    EXPECT_TRUE(text.contains("deepin_deb_installer_transaction_seconds_bucket{le=\"0.005\"} 1\n"));
+    EXPECT_TRUE(text.contains("deepin_deb_installer_transaction_seconds_bucket{le=\"5\"} 2\n"));
+    EXPECT_TRUE(text.contains("deepin_deb_installer_transaction_seconds_bucket{le=\"+Inf\"} 3\n"));
+    EXPECT_TRUE(text.contains("deepin_deb_installer_transaction_seconds_count 3\n"));
+}
+
+TEST_F(ut_metrics_Test, spanObserveWithoutTracing)
+{
+    Trace::Tracer::instance()->setEnabled(false);
+    {
+        Trace::ScopedSpan span(Trace::kCatAnalyze, "resolve_depends", {}, Metrics::DependsResolveSeconds);
+    }
+
+    Trace::AsyncSpan asyncSpan(Trace::kCatInstall, "transaction", Metrics::TransactionSeconds);
+    asyncSpan.begin();
+    EXPECT_TRUE(asyncSpan.isActive());
+    asyncSpan.end();
+
+    EXPECT_EQ(Metrics::Registry::instance()->observedCount(Metrics::DependsResolveSeconds), 1u);
+    EXPECT_EQ(Metrics::Registry::instance()->observedCount(Metrics::TransactionSeconds), 1u);
+}
+
+TEST_F(ut_metrics_Test, writeTextFile)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    Metrics::add(Metrics::CacheReloads, 3);
+
+    const QString path = dir.filePath("deb_installer.prom");
+    ASSERT_TRUE(Metrics::Registry::instance()->writeTextFile(path));
+
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_TRUE(file.readAll().contains("deepin_deb_installer_cache_reloads_total 3\n"));
+}
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "../deb-installer/utils/trace.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <thread>
+
+class ut_trace_Test : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Trace::Tracer::instance()->clear();
+        Trace::Tracer::instance()->setEnabled(true);
+    }
+
+    void TearDown() override
+    {
+        Trace::Tracer::instance()->setEnabled(false);
+        Trace::Tracer::instance()->clear();
+    }
+
+    // complete events ("ph": "X") of the exported trace
+    QJsonArray completeEvents()
+    {
+        const QJsonObject root = QJsonDocument::fromJson(Trace::Tracer::instance()->toChromeTrace()).object();
+        QJsonArray events;
+        for (const QJsonValue &value : root.value("traceEvents").toArray()) {
+            if ("X" == value.toObject().value("ph").toString()) {
+                events.append(value);
+            }
+        }
+        return events;
+    }
+};
+
+TEST_F(ut_trace_Test, disabledSpanNotRecorded)
+{
+    Trace::Tracer::instance()->setEnabled(false);
+    {
+        Trace::ScopedSpan span(Trace::kCatAppend, "disabled");
+    }
+    Trace::Tracer::instance()->setEnabled(true);
+
+    EXPECT_TRUE(completeEvents().isEmpty());
+}
+
+TEST_F(ut_trace_Test, scopedSpanExported)
+{
+    {
+        Trace::ScopedSpan span(Trace::kCatAnalyze, "md5sum", "/tmp/a.deb");
+    }
+
+    const QJsonArray events = completeEvents();
+    ASSERT_EQ(events.size(), 1);
+    const QJsonObject event = events.first().toObject();
+    EXPECT_EQ(event.value("name").toString(), QString("md5sum"));
+    EXPECT_EQ(event.value("cat").toString(), QString("analyze"));
+    EXPECT_GE(event.value("dur").toDouble(), 0);
+    EXPECT_EQ(event.value("args").toObject().value("detail").toString(), QString("/tmp/a.deb"));
+}
+
+TEST_F(ut_trace_Test, asyncSpanEndOnce)
+{
+    Trace::AsyncSpan span(Trace::kCatInstall, "transaction");
+    EXPECT_FALSE(span.isActive());
+
+    span.begin();
+    EXPECT_TRUE(span.isActive());
+    span.end();
+    span.end();
+    EXPECT_FALSE(span.isActive());
+
+    EXPECT_EQ(completeEvents().size(), 1);
+}
+
+TEST_F(ut_trace_Test, ringBufferKeepsLatest)
+{
+    Trace::Tracer *tracer = Trace::Tracer::instance();
+    const int total = Trace::Tracer::kThreadBufferSize + 10;
+    for (int i = 0; i < total; ++i) {
+        tracer->record(Trace::kCatAppend, "event", i, 1);
+    }
+
+    const QJsonArray events = completeEvents();
+    ASSERT_EQ(events.size(), Trace::Tracer::kThreadBufferSize);
+
+    double minTs = total;
+    for (const QJsonValue &value : events) {
+        minTs = std::min(minTs, value.toObject().value("ts").toDouble());
+    }
+    EXPECT_EQ(static_cast<int>(minTs), 10);
+}
+
+TEST_F(ut_trace_Test, threadsUseOwnBuffer)
+{
+    std::thread worker([]() { Trace::ScopedSpan span(Trace::kCatAppend, "worker"); });
+    worker.join();
+    {
+        Trace::ScopedSpan span(Trace::kCatAppend, "main");
+    }
+
+    const QJsonArray events = completeEvents();
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_NE(events.at(0).toObject().value("tid").toInt(), events.at(1).toObject().value("tid").toInt());
+}
+
+TEST_F(ut_trace_Test, writeChromeTrace)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    {
+        Trace::ScopedSpan span(Trace::kCatVerify, "digital_verify");
+    }
+
+    EXPECT_TRUE(Trace::Tracer::instance()->writeChromeTrace(dir.filePath("trace.json")));
+    EXPECT_FALSE(Trace::Tracer::instance()->writeChromeTrace(QString()));
+}
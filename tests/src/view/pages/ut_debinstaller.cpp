@@ -174,7 +174,7 @@ TEST_F(UT_Debinstaller, UT_Debinstaller_slotSetAuthingStatus)
 TEST_F(UT_Debinstaller, UT_Debinstaller_single2Multi)
 {
     deb->single2Multi();
-    EXPECT_TRUE(debListModel->m_packageOperateStatus.isEmpty());
+    EXPECT_TRUE(debListModel->m_packagesManager->m_packageTable.isEmpty());
     EXPECT_EQ(1, deb->m_Filterflag);
     EXPECT_EQ(1, deb->m_dragflag);
 }
@@ -188,7 +188,7 @@ TEST_F(UT_Debinstaller, UT_Debinstaller_slotChangeDragFlag)
 TEST_F(UT_Debinstaller, UT_Debinstaller_slotDealDependResult)
 {
     deb->slotDealDependResult(DebListModel::AuthDependsSuccess, "test");
-    EXPECT_TRUE(debListModel->m_packageOperateStatus.isEmpty());
+    EXPECT_TRUE(debListModel->m_packagesManager->m_packageTable.isEmpty());
     deb->slotDealDependResult(DebListModel::AuthBefore, "test");
 }
 
@@ -206,7 +206,7 @@ TEST_F(UT_Debinstaller, UT_Debinstaller_slotSetEnableButton)
     deb->slotShowHiddenButton();
     EXPECT_FALSE(deb->m_packageAppending);
     EXPECT_EQ(1, deb->m_dragflag);
-    EXPECT_TRUE(debListModel->m_packageOperateStatus.isEmpty());
+    EXPECT_TRUE(debListModel->m_packagesManager->m_packageTable.isEmpty());
     deb->m_packageAppending = true;
     deb->slotSetEnableButton(true);
     EXPECT_TRUE(deb->m_packageAppending);
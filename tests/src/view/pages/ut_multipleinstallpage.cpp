@@ -138,7 +138,7 @@ TEST_F(UT_MultipleInstallPage, UT_MultipleInstallPage_slotRequestRemoveItemClick
 {
     multiplepage->slotRequestRemoveItemClicked(debListModel->index(0));
     EXPECT_TRUE(debListModel->isWorkerPrepare());
-    EXPECT_TRUE(debListModel->m_packageOperateStatus.isEmpty());
+    EXPECT_TRUE(debListModel->m_packagesManager->m_packageTable.isEmpty());
     EXPECT_FALSE(multiplepage->m_showDependsButton->isVisible());
 }
 
@@ -142,8 +142,8 @@ TEST_F(UT_SingleInstallpage, UT_SingleInstallpage_total)
     stub.set(ADDR(DebListModel, recheckPackagePath), stud_recheckPackagePath);
 
     model = new DebListModel();
-    model->m_packagesManager->m_preparedPackages.append("test");
-    model->m_packagesManager->m_preparedPackages.append("test1");
+    model->m_packagesManager->m_packageTable.append("test", "test");
+    model->m_packagesManager->m_packageTable.append("test1", "test1");
     page = new SingleInstallPage(model);
     page->slotReinstall();
     EXPECT_FALSE(page->m_reinstallButton->hasFocus());
@@ -295,8 +295,8 @@ TEST_F(UT_SingleInstallpage, UT_SingleInstallpage_onWorkFinishedFailed)
 
     model = new DebListModel();
     usleep(100 * 1000);
-    model->m_packagesManager->m_preparedPackages.append("test");
-    model->m_packagesManager->m_preparedPackages.append("test1");
+    model->m_packagesManager->m_packageTable.append("test", "test");
+    model->m_packagesManager->m_packageTable.append("test1", "test1");
     page = new SingleInstallPage(model);
     usleep(100 * 1000);
     stub.set(ADDR(QVariant, toInt), stud_failedtoInt);
@@ -331,8 +331,8 @@ TEST_F(UT_SingleInstallpage, UT_SingleInstallpage_onWorkFinishedSuccees)
     stub.set(ADDR(DebListModel, recheckPackagePath), stud_recheckPackagePath);
     model = new DebListModel();
     usleep(100 * 1000);
-    model->m_packagesManager->m_preparedPackages.append("test");
-    model->m_packagesManager->m_preparedPackages.append("test1");
+    model->m_packagesManager->m_packageTable.append("test", "test");
+    model->m_packagesManager->m_packageTable.append("test1", "test1");
     page = new SingleInstallPage(model);
     usleep(100 * 1000);
     page->showPackageInfo();
@@ -382,8 +382,8 @@ TEST_F(UT_SingleInstallpage, UT_SingleInstallpage_initTabOrder)
     stub.set(ADDR(DebListModel, recheckPackagePath), stud_recheckPackagePath);
     model = new DebListModel();
     usleep(100 * 1000);
-    model->m_packagesManager->m_preparedPackages.append("test");
-    model->m_packagesManager->m_preparedPackages.append("test1");
+    model->m_packagesManager->m_packageTable.append("test", "test");
+    model->m_packagesManager->m_packageTable.append("test1", "test1");
     page = new SingleInstallPage(model);
     usleep(100 * 1000);
 
@@ -421,8 +421,8 @@ TEST_F(UT_SingleInstallpage, UT_SingleInstallpage_paintEvent)
     stub.set(ADDR(DebListModel, recheckPackagePath), stud_recheckPackagePath);
     model = new DebListModel();
     usleep(100 * 1000);
-    model->m_packagesManager->m_preparedPackages.append("test");
-    model->m_packagesManager->m_preparedPackages.append("test1");
+    model->m_packagesManager->m_packageTable.append("test", "test");
+    model->m_packagesManager->m_packageTable.append("test1", "test1");
     page = new SingleInstallPage(model);
     usleep(100 * 1000);
     QPaintEvent paint(QRect(page->rect()));
@@ -447,8 +447,8 @@ TEST_F(UT_SingleInstallpage, UT_SingleInstallpage_slotDependPackages)
     stub.set(ADDR(DebListModel, recheckPackagePath), stud_recheckPackagePath);
     model = new DebListModel();
     usleep(100 * 1000);
-    model->m_packagesManager->m_preparedPackages.append("test");
-    model->m_packagesManager->m_preparedPackages.append("test1");
+    model->m_packagesManager->m_packageTable.append("test", "test");
+    model->m_packagesManager->m_packageTable.append("test1", "test1");
     page = new SingleInstallPage(model);
     usleep(100 * 1000);
     //    QMap<QByteArray, QPair<QList<Pkg::DependInfo>, QList<Pkg::DependInfo>>> dependPackages;